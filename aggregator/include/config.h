@@ -30,6 +30,9 @@ struct Config {
     // 로그 레벨
     std::string log_level;
 
+    // Prometheus /metrics 포트 (0이면 비활성)
+    int metrics_port;
+
     static Config from_env();
 };
 
@@ -7,6 +7,11 @@
 #include <chrono>
 #include <iomanip>
 
+// 빌드 시 최소 로그 레벨 (0=DEBUG, 1=INFO, 2=WARN, 3=ERROR). 예: -DLOGGER_MIN_LEVEL=1
+#ifndef LOGGER_MIN_LEVEL
+#define LOGGER_MIN_LEVEL 0
+#endif
+
 namespace aggregator {
 
 enum class LogLevel { DEBUG, INFO, WARN, ERROR };
@@ -15,25 +20,32 @@ class Logger {
 public:
     static void set_level(const std::string& level);
     static LogLevel get_level();
+
+    // 런타임 레벨 + 빌드 시 최소 레벨
+    template<LogLevel L>
+    static bool enabled() {
+        if constexpr (static_cast<int>(L) < LOGGER_MIN_LEVEL) return false;
+        else return level_ <= L;
+    }
     
     template<typename... Args>
     static void debug(Args&&... args) {
-        if (level_ <= LogLevel::DEBUG) log("[DEBUG]", std::forward<Args>(args)...);
+        if (enabled<LogLevel::DEBUG>()) log("[DEBUG]", std::forward<Args>(args)...);
     }
     
     template<typename... Args>
     static void info(Args&&... args) {
-        if (level_ <= LogLevel::INFO) log("[INFO]", std::forward<Args>(args)...);
+        if (enabled<LogLevel::INFO>()) log("[INFO]", std::forward<Args>(args)...);
     }
     
     template<typename... Args>
     static void warn(Args&&... args) {
-        if (level_ <= LogLevel::WARN) log("[WARN]", std::forward<Args>(args)...);
+        if (enabled<LogLevel::WARN>()) log("[WARN]", std::forward<Args>(args)...);
     }
     
     template<typename... Args>
     static void error(Args&&... args) {
-        if (level_ <= LogLevel::ERROR) log("[ERROR]", std::forward<Args>(args)...);
+        if (enabled<LogLevel::ERROR>()) log("[ERROR]", std::forward<Args>(args)...);
     }
 
 private:
@@ -56,3 +68,32 @@ private:
 };
 
 } // namespace aggregator
+
+// === 로그 매크로 (엔진 wrapper/include/logger.h와 같은 이름·규칙) ===
+// 레벨이 꺼져 있으면 인자를 평가하지 않고, LOGGER_MIN_LEVEL 미만은 코드가 생성되지 않는다.
+#define LOGGER_LOG_AT_(LEVEL, FN, ...)                                                  \
+    do {                                                                                \
+        if (::aggregator::Logger::enabled<::aggregator::LogLevel::LEVEL>())             \
+            ::aggregator::Logger::FN(__VA_ARGS__);                                      \
+    } while (0)
+#define LOGGER_ELIDED_(FN, ...)                                                         \
+    do {                                                                                \
+        if (false) ::aggregator::Logger::FN(__VA_ARGS__);                               \
+    } while (0)
+
+#if LOGGER_MIN_LEVEL > 0
+#define LOGGER_DEBUG(...) LOGGER_ELIDED_(debug, __VA_ARGS__)
+#else
+#define LOGGER_DEBUG(...) LOGGER_LOG_AT_(DEBUG, debug, __VA_ARGS__)
+#endif
+#if LOGGER_MIN_LEVEL > 1
+#define LOGGER_INFO(...) LOGGER_ELIDED_(info, __VA_ARGS__)
+#else
+#define LOGGER_INFO(...) LOGGER_LOG_AT_(INFO, info, __VA_ARGS__)
+#endif
+#if LOGGER_MIN_LEVEL > 2
+#define LOGGER_WARN(...) LOGGER_ELIDED_(warn, __VA_ARGS__)
+#else
+#define LOGGER_WARN(...) LOGGER_LOG_AT_(WARN, warn, __VA_ARGS__)
+#endif
+#define LOGGER_ERROR(...) LOGGER_LOG_AT_(ERROR, error, __VA_ARGS__)
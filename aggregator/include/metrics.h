@@ -0,0 +1,115 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <thread>
+
+namespace aggregator {
+
+// HDR 방식 로그-선형 지연 히스토그램 (나노초, 옥타브당 8칸 → 상대 오차 ≤ 12.5%)
+// 엔진(wrapper/include/metrics.h)과 같은 버킷 구조라 대시보드 쿼리를 공유할 수 있다.
+class LatencyHistogram {
+public:
+    static constexpr int SUB_BITS = 3;
+    static constexpr size_t SUB_COUNT = size_t(1) << SUB_BITS;
+    static constexpr size_t BUCKETS = (64 - SUB_BITS + 1) * SUB_COUNT;
+
+    void record(uint64_t ns) {
+        buckets_[bucket_of(ns)].fetch_add(1, std::memory_order_relaxed);
+        count_.fetch_add(1, std::memory_order_relaxed);
+        sum_ns_.fetch_add(ns, std::memory_order_relaxed);
+        uint64_t prev = max_ns_.load(std::memory_order_relaxed);
+        while (ns > prev &&
+               !max_ns_.compare_exchange_weak(prev, ns, std::memory_order_relaxed)) {
+        }
+    }
+
+    uint64_t count() const { return count_.load(std::memory_order_relaxed); }
+    uint64_t sum_ns() const { return sum_ns_.load(std::memory_order_relaxed); }
+    uint64_t max_ns() const { return max_ns_.load(std::memory_order_relaxed); }
+    uint64_t percentile(double q) const;
+    uint64_t count_at_or_below(uint64_t limit_ns) const;
+
+    static size_t bucket_of(uint64_t ns) {
+        if (ns < SUB_COUNT) return static_cast<size_t>(ns);
+        int e = 63 - __builtin_clzll(ns);
+        return (static_cast<size_t>(e - SUB_BITS + 1) << SUB_BITS) +
+               static_cast<size_t>((ns >> (e - SUB_BITS)) & (SUB_COUNT - 1));
+    }
+    static uint64_t bucket_lower(size_t idx);
+    static uint64_t bucket_upper(size_t idx);
+
+private:
+    std::array<std::atomic<uint64_t>, BUCKETS> buckets_{};
+    std::atomic<uint64_t> count_{0};
+    std::atomic<uint64_t> sum_ns_{0};
+    std::atomic<uint64_t> max_ns_{0};
+};
+
+class ScopedLatency {
+public:
+    explicit ScopedLatency(LatencyHistogram& hist)
+        : hist_(hist), start_(std::chrono::steady_clock::now()) {}
+    ~ScopedLatency() {
+        hist_.record(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start_).count()));
+    }
+    ScopedLatency(const ScopedLatency&) = delete;
+    ScopedLatency& operator=(const ScopedLatency&) = delete;
+
+private:
+    LatencyHistogram& hist_;
+    std::chrono::steady_clock::time_point start_;
+};
+
+// 집계기 메트릭. 폴링 루프가 단일 스레드라 카운터는 평범한 relaxed atomic이면 충분하다
+// (읽는 쪽은 HTTP 스레드 하나).
+struct Metrics {
+    static Metrics& instance() {
+        static Metrics inst;
+        return inst;
+    }
+
+    std::atomic<uint64_t> poll_cycles{0};
+    std::atomic<uint64_t> candles_1m_processed{0};
+    std::atomic<uint64_t> candles_closed{0};        // 상위 타임프레임 마감
+    std::atomic<uint64_t> rds_write_failures{0};
+    std::atomic<uint64_t> known_symbols{0};         // gauge
+
+    LatencyHistogram cycle_latency;      // 폴링 1회 처리 (sleep 제외)
+    LatencyHistogram valkey_rtt;         // hiredis 명령 왕복
+    LatencyHistogram rds_write_latency;  // 캔들/전일종가 upsert
+
+    // Prometheus 텍스트 (version 0.0.4)
+    std::string render_prometheus() const;
+};
+
+// Prometheus 스크레이프용 최소 HTTP 서버 (GET /metrics, /healthz). 스레드 하나, 연결당 응답 후 close.
+class MetricsHttpServer {
+public:
+    using Renderer = std::function<std::string()>;
+
+    MetricsHttpServer(int port, Renderer renderer);
+    ~MetricsHttpServer();
+
+    bool start();
+    void stop();
+    int port() const { return port_; }
+
+private:
+    void run();
+    void handle(int client_fd);
+
+    int port_;
+    Renderer renderer_;
+    int listen_fd_ = -1;
+    std::thread thread_;
+    std::atomic<bool> running_{false};
+};
+
+} // namespace aggregator
@@ -116,7 +116,7 @@ Aggregator::UpdateResult Aggregator::update_candle_incremental(
         result.current_candle.close = source.close;
         result.current_candle.volume = source.volume;
 
-        Logger::debug("[INC-NEW]", source.symbol, tf.interval, "@", aligned_time,
+        LOGGER_DEBUG("[INC-NEW]", source.symbol, tf.interval, "@", aligned_time,
                      "O:", source.open, "H:", source.high, "L:", source.low, "C:", source.close);
     } else {
         // 기존 캔들 업데이트
@@ -126,7 +126,7 @@ Aggregator::UpdateResult Aggregator::update_candle_incremental(
         result.current_candle.close = source.close;
         result.current_candle.volume = current.volume + source.volume;
 
-        Logger::debug("[INC-UPD]", source.symbol, tf.interval, "@", aligned_time,
+        LOGGER_DEBUG("[INC-UPD]", source.symbol, tf.interval, "@", aligned_time,
                      "H:", result.current_candle.high, "L:", result.current_candle.low,
                      "C:", result.current_candle.close);
     }
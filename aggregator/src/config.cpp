@@ -35,6 +35,9 @@ Config Config::from_env() {
     // 로그 레벨
     cfg.log_level = std::getenv("LOG_LEVEL") ? std::getenv("LOG_LEVEL") : "INFO";
 
+    // 메트릭 엔드포인트
+    cfg.metrics_port = std::getenv("METRICS_PORT") ? std::atoi(std::getenv("METRICS_PORT")) : 9102;
+
     return cfg;
 }
 
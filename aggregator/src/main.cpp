@@ -7,6 +7,7 @@
 #include "aggregator.h"
 #include "rds_client.h"
 #include "secrets_manager.h"
+#include "metrics.h"
 
 #include <aws/core/Aws.h>
 #include <iostream>
@@ -164,6 +165,7 @@ int main(int argc, char* argv[]) {
     Logger::info("AWS Region:", cfg.aws_region);
     Logger::info("DB Secret:", cfg.db_credentials_secret_name);
     Logger::info("Poll Interval:", cfg.poll_interval_ms, "ms");
+    Logger::info("Metrics Port:", cfg.metrics_port);
     Logger::info("=====================");
 
     // Secrets Manager에서 DB credentials 가져오기
@@ -217,6 +219,14 @@ int main(int argc, char* argv[]) {
     }
     
     Aggregator aggregator;
+
+    // Prometheus /metrics (폴링 루프와는 원자 카운터만 공유)
+    auto& metrics = Metrics::instance();
+    MetricsHttpServer metrics_server(cfg.metrics_port,
+                                     [&metrics] { return metrics.render_prometheus(); });
+    if (cfg.metrics_port > 0) {
+        metrics_server.start();
+    }
     
     Logger::info("=== Aggregator Running ===");
     Logger::info("Polling for closed candles every", cfg.poll_interval_ms, "ms");
@@ -253,6 +263,7 @@ int main(int argc, char* argv[]) {
     int consecutive_health_failures = 0;
 
     while (running) {
+        auto cycle_start = std::chrono::steady_clock::now();
         try {
             int64_t now = get_current_epoch();
 
@@ -295,6 +306,7 @@ int main(int argc, char* argv[]) {
                 if (closed_1m.empty()) continue;
 
                 Logger::info("[INC]", symbol, "- processing", closed_1m.size(), "closed 1m candles");
+                metrics.candles_1m_processed += closed_1m.size();
 
                 // 새 심볼 발견 시 RDS 파티션 확인/생성
                 if (known_symbols.find(symbol) == known_symbols.end()) {
@@ -307,6 +319,7 @@ int main(int argc, char* argv[]) {
                 // 심볼 활동 기록
                 symbol_last_seen[symbol] = now;
                 known_symbols.insert(symbol);
+                metrics.known_symbols = known_symbols.size();
 
                 // 3. 각 1분봉에 대해 상위 타임프레임 증분 업데이트
                 for (const auto& candle_1m : closed_1m) {
@@ -328,6 +341,7 @@ int main(int argc, char* argv[]) {
 
                         // 구간 마감 시 RDS 저장 (연결된 경우만)
                         if (result.is_closed) {
+                            metrics.candles_closed++;
                             if (rds_connected && rds.put_candle(symbol, tf.interval, result.closed_candle)) {
                                 Logger::info("[CLOSED]", symbol, tf.interval, "@",
                                             result.closed_candle.time,
@@ -440,7 +454,9 @@ int main(int argc, char* argv[]) {
             // 7. 주기적 통계 로깅 (5분마다)
             if (now - last_stats_time > 300) {
                 Logger::info("[STATS] Symbols:", known_symbols.size(),
-                            "Active:", symbol_last_seen.size());
+                            "Active:", symbol_last_seen.size(),
+                            "cycle p99 us:", metrics.cycle_latency.percentile(0.99) / 1000,
+                            "valkey p99 us:", metrics.valkey_rtt.percentile(0.99) / 1000);
                 last_stats_time = now;
             }
 
@@ -470,10 +486,16 @@ int main(int argc, char* argv[]) {
             Logger::error("Processing error:", e.what());
         }
 
+        metrics.poll_cycles++;
+        metrics.cycle_latency.record(static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - cycle_start).count()));
+
         // 폴링 간격 대기
         std::this_thread::sleep_for(std::chrono::milliseconds(cfg.poll_interval_ms));
     }
     
+    metrics_server.stop();
     Logger::info("Aggregator stopped");
     rds.disconnect();
 
@@ -0,0 +1,246 @@
+#include "metrics.h"
+#include "logger.h"
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+
+namespace aggregator {
+
+namespace {
+
+constexpr int LE_MIN_SHIFT = 10;   // 1µs
+constexpr int LE_MAX_SHIFT = 34;   // 약 17s
+const double QUANTILES[] = {0.5, 0.9, 0.99, 0.999};
+
+std::string fmt(double v) {
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "%.9g", v);
+    return buf;
+}
+
+void write_header(std::string& out, const std::string& name, const std::string& help,
+                  const char* type) {
+    out += "# HELP " + name + " " + help + "\n";
+    out += "# TYPE " + name + " " + type + "\n";
+}
+
+void write_counter(std::string& out, const std::string& name, const std::string& help,
+                   uint64_t value) {
+    write_header(out, name, help, "counter");
+    out += name + " " + std::to_string(value) + "\n";
+}
+
+void write_histogram(std::string& out, const std::string& name, const std::string& help,
+                     const LatencyHistogram& hist) {
+    uint64_t total = hist.count();
+    write_header(out, name, help, "histogram");
+    for (int shift = LE_MIN_SHIFT; shift <= LE_MAX_SHIFT; ++shift) {
+        uint64_t limit_ns = uint64_t(1) << shift;
+        uint64_t n = std::min(hist.count_at_or_below(limit_ns - 1), total);
+        out += name + "_bucket{le=\"" + fmt(static_cast<double>(limit_ns) / 1e9) + "\"} " +
+               std::to_string(n) + "\n";
+    }
+    out += name + "_bucket{le=\"+Inf\"} " + std::to_string(total) + "\n";
+    out += name + "_sum " + fmt(static_cast<double>(hist.sum_ns()) / 1e9) + "\n";
+    out += name + "_count " + std::to_string(total) + "\n";
+
+    const std::string qname = name.substr(0, name.rfind("_seconds")) + "_quantile_seconds";
+    write_header(out, qname, help + " (HDR quantile)", "gauge");
+    for (double q : QUANTILES) {
+        out += qname + "{quantile=\"" + fmt(q) + "\"} " +
+               fmt(static_cast<double>(hist.percentile(q)) / 1e9) + "\n";
+    }
+    out += qname + "{quantile=\"1\"} " + fmt(static_cast<double>(hist.max_ns()) / 1e9) + "\n";
+}
+
+std::string http_response(const char* status, const char* content_type,
+                          const std::string& body) {
+    return std::string("HTTP/1.0 ") + status + "\r\nContent-Type: " + content_type +
+           "\r\nContent-Length: " + std::to_string(body.size()) +
+           "\r\nConnection: close\r\n\r\n" + body;
+}
+
+void send_all(int fd, const std::string& data) {
+    size_t sent = 0;
+    while (sent < data.size()) {
+        ssize_t n = ::send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+        if (n <= 0) {
+            if (n < 0 && errno == EINTR) continue;
+            return;
+        }
+        sent += static_cast<size_t>(n);
+    }
+}
+
+}  // namespace
+
+// === LatencyHistogram ===
+
+uint64_t LatencyHistogram::bucket_lower(size_t idx) {
+    if (idx < SUB_COUNT) return idx;
+    size_t octave = idx >> SUB_BITS;
+    uint64_t sub = idx & (SUB_COUNT - 1);
+    return (SUB_COUNT + sub) << (octave - 1);
+}
+
+uint64_t LatencyHistogram::bucket_upper(size_t idx) {
+    if (idx + 1 >= BUCKETS) return std::numeric_limits<uint64_t>::max();
+    return bucket_lower(idx + 1) - 1;
+}
+
+uint64_t LatencyHistogram::percentile(double q) const {
+    uint64_t total = count();
+    if (total == 0) return 0;
+    q = std::min(std::max(q, 0.0), 1.0);
+    uint64_t rank = static_cast<uint64_t>(q * static_cast<double>(total));
+    if (static_cast<double>(rank) < q * static_cast<double>(total)) ++rank;
+    if (rank == 0) rank = 1;
+
+    uint64_t seen = 0;
+    for (size_t i = 0; i < BUCKETS; ++i) {
+        seen += buckets_[i].load(std::memory_order_relaxed);
+        if (seen >= rank) {
+            uint64_t upper = bucket_upper(i);
+            uint64_t max = max_ns();
+            return (max != 0 && upper > max) ? max : upper;
+        }
+    }
+    return max_ns();
+}
+
+uint64_t LatencyHistogram::count_at_or_below(uint64_t limit_ns) const {
+    uint64_t n = 0;
+    for (size_t i = 0; i < BUCKETS && bucket_upper(i) <= limit_ns; ++i) {
+        n += buckets_[i].load(std::memory_order_relaxed);
+    }
+    return n;
+}
+
+// === Metrics ===
+
+std::string Metrics::render_prometheus() const {
+    std::string out;
+    out.reserve(8192);
+    write_counter(out, "aggregator_poll_cycles_total", "Polling loop iterations",
+                  poll_cycles.load());
+    write_counter(out, "aggregator_candles_1m_processed_total", "Closed 1m candles consumed",
+                  candles_1m_processed.load());
+    write_counter(out, "aggregator_candles_closed_total", "Higher timeframe candles closed",
+                  candles_closed.load());
+    write_counter(out, "aggregator_rds_write_failures_total", "Failed RDS upserts",
+                  rds_write_failures.load());
+    write_header(out, "aggregator_known_symbols", "Symbols seen since start", "gauge");
+    out += "aggregator_known_symbols " + std::to_string(known_symbols.load()) + "\n";
+
+    write_histogram(out, "aggregator_cycle_latency_seconds",
+                    "Polling cycle processing time (excluding sleep)", cycle_latency);
+    write_histogram(out, "aggregator_valkey_rtt_seconds", "Valkey command round trip",
+                    valkey_rtt);
+    write_histogram(out, "aggregator_rds_write_latency_seconds", "RDS upsert latency",
+                    rds_write_latency);
+    return out;
+}
+
+// === MetricsHttpServer ===
+
+MetricsHttpServer::MetricsHttpServer(int port, Renderer renderer)
+    : port_(port), renderer_(std::move(renderer)) {}
+
+MetricsHttpServer::~MetricsHttpServer() {
+    stop();
+}
+
+bool MetricsHttpServer::start() {
+    if (running_.load()) return true;
+
+    listen_fd_ = ::socket(AF_INET, SOCK_STREAM, 0);
+    if (listen_fd_ < 0) {
+        Logger::error("[METRICS] socket() failed:", std::strerror(errno));
+        return false;
+    }
+    int reuse = 1;
+    ::setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    addr.sin_port = htons(static_cast<uint16_t>(port_));
+    if (::bind(listen_fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0 ||
+        ::listen(listen_fd_, 16) < 0) {
+        Logger::error("[METRICS] bind/listen on port", port_, "failed:", std::strerror(errno));
+        ::close(listen_fd_);
+        listen_fd_ = -1;
+        return false;
+    }
+    socklen_t len = sizeof(addr);
+    if (::getsockname(listen_fd_, reinterpret_cast<sockaddr*>(&addr), &len) == 0) {
+        port_ = ntohs(addr.sin_port);
+    }
+
+    running_ = true;
+    thread_ = std::thread(&MetricsHttpServer::run, this);
+    Logger::info("[METRICS] Listening on port", port_, "(/metrics)");
+    return true;
+}
+
+void MetricsHttpServer::stop() {
+    if (!running_.exchange(false)) return;
+    if (thread_.joinable()) thread_.join();
+    if (listen_fd_ >= 0) {
+        ::close(listen_fd_);
+        listen_fd_ = -1;
+    }
+}
+
+void MetricsHttpServer::run() {
+    while (running_.load()) {
+        pollfd pfd{listen_fd_, POLLIN, 0};
+        if (::poll(&pfd, 1, 200) <= 0) continue;
+
+        int client = ::accept(listen_fd_, nullptr, nullptr);
+        if (client < 0) continue;
+        timeval tv{1, 0};
+        ::setsockopt(client, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+        ::setsockopt(client, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+        handle(client);
+        ::close(client);
+    }
+}
+
+void MetricsHttpServer::handle(int client_fd) {
+    std::string request;
+    char buf[1024];
+    while (request.find("\r\n\r\n") == std::string::npos &&
+           request.find("\n\n") == std::string::npos && request.size() < 4096) {
+        ssize_t n = ::recv(client_fd, buf, sizeof(buf), 0);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) break;
+        request.append(buf, static_cast<size_t>(n));
+    }
+
+    std::string line = request.substr(0, request.find_first_of("\r\n"));
+    bool is_get = line.compare(0, 4, "GET ") == 0;
+    std::string path = is_get ? line.substr(4, line.find(' ', 4) - 4) : "";
+    path = path.substr(0, path.find('?'));
+
+    if (!is_get) {
+        send_all(client_fd, http_response("405 Method Not Allowed", "text/plain", "method not allowed\n"));
+    } else if (path == "/metrics") {
+        send_all(client_fd, http_response("200 OK", "text/plain; version=0.0.4; charset=utf-8",
+                                          renderer_ ? renderer_() : std::string()));
+    } else if (path == "/healthz") {
+        send_all(client_fd, http_response("200 OK", "text/plain", "ok\n"));
+    } else {
+        send_all(client_fd, http_response("404 Not Found", "text/plain", "not found\n"));
+    }
+}
+
+} // namespace aggregator
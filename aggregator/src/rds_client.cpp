@@ -1,5 +1,6 @@
 #include "rds_client.h"
 #include "logger.h"
+#include "metrics.h"
 
 #include <libpq-fe.h>
 #include <sstream>
@@ -7,6 +8,16 @@
 
 namespace aggregator {
 
+namespace {
+
+// 쓰기(upsert) 실행 + 지연 기록
+PGresult* exec_write(PGconn* conn, const std::string& sql, int n_params, const char* const* params) {
+    ScopedLatency timer(Metrics::instance().rds_write_latency);
+    return PQexecParams(conn, sql.c_str(), n_params, nullptr, params, nullptr, nullptr, 0);
+}
+
+}  // namespace
+
 RdsClient::RdsClient(const std::string& host, int port, const std::string& dbname,
                      const std::string& user, const std::string& password)
     : host_(host), port_(port), dbname_(dbname), user_(user), password_(password),
@@ -29,14 +40,14 @@ bool RdsClient::connect() {
     conn_ = PQconnectdb(conninfo.str().c_str());
     
     if (PQstatus(conn_) != CONNECTION_OK) {
-        Logger::error("RDS connection failed:", PQerrorMessage(conn_));
+        LOGGER_ERROR("RDS connection failed:", PQerrorMessage(conn_));
         PQfinish(conn_);
         conn_ = nullptr;
         return false;
     }
     
     connected_ = true;
-    Logger::info("RDS connected:", host_, ":", port_, "/", dbname_);
+    LOGGER_INFO("RDS connected:", host_, ":", port_, "/", dbname_);
     return true;
 }
 
@@ -72,13 +83,13 @@ bool RdsClient::ensure_partition(const std::string& symbol) {
     PGresult* res = PQexec(conn_, create_sql.c_str());
     
     if (PQresultStatus(res) != PGRES_COMMAND_OK) {
-        Logger::error("RDS partition creation failed:", PQerrorMessage(conn_));
+        LOGGER_ERROR("RDS partition creation failed:", PQerrorMessage(conn_));
         PQclear(res);
         return false;
     }
     
     PQclear(res);
-    Logger::info("Created partition: candle_history_", lower_symbol);
+    LOGGER_INFO("Created partition: candle_history_", lower_symbol);
     return true;
 }
 
@@ -112,10 +123,11 @@ bool RdsClient::put_candle(const std::string& symbol, const std::string& interva
         open_str.c_str(), high_str.c_str(), low_str.c_str(), close_str.c_str(), volume_str.c_str()
     };
     
-    PGresult* res = PQexecParams(conn_, sql.c_str(), 9, nullptr, params, nullptr, nullptr, 0);
+    PGresult* res = exec_write(conn_, sql, 9, params);
     
     if (PQresultStatus(res) != PGRES_COMMAND_OK) {
-        Logger::error("RDS put_candle failed:", PQerrorMessage(conn_));
+        LOGGER_ERROR("RDS put_candle failed:", PQerrorMessage(conn_));
+        Metrics::instance().rds_write_failures++;
         PQclear(res);
         return false;
     }
@@ -154,10 +166,11 @@ bool RdsClient::put_candle_replace(const std::string& symbol, const std::string&
         open_str.c_str(), high_str.c_str(), low_str.c_str(), close_str.c_str(), volume_str.c_str()
     };
 
-    PGresult* res = PQexecParams(conn_, sql.c_str(), 9, nullptr, params, nullptr, nullptr, 0);
+    PGresult* res = exec_write(conn_, sql, 9, params);
 
     if (PQresultStatus(res) != PGRES_COMMAND_OK) {
-        Logger::error("RDS put_candle_replace failed:", PQerrorMessage(conn_));
+        LOGGER_ERROR("RDS put_candle_replace failed:", PQerrorMessage(conn_));
+        Metrics::instance().rds_write_failures++;
         PQclear(res);
         return false;
     }
@@ -176,7 +189,7 @@ int RdsClient::batch_put_candles(const std::string& symbol, const std::string& i
     // BEGIN TRANSACTION
     PGresult* res = PQexec(conn_, "BEGIN");
     if (PQresultStatus(res) != PGRES_COMMAND_OK) {
-        Logger::error("RDS BEGIN failed:", PQerrorMessage(conn_));
+        LOGGER_ERROR("RDS BEGIN failed:", PQerrorMessage(conn_));
         PQclear(res);
         return 0;
     }
@@ -192,7 +205,7 @@ int RdsClient::batch_put_candles(const std::string& symbol, const std::string& i
     // COMMIT
     res = PQexec(conn_, "COMMIT");
     if (PQresultStatus(res) != PGRES_COMMAND_OK) {
-        Logger::error("RDS COMMIT failed:", PQerrorMessage(conn_));
+        LOGGER_ERROR("RDS COMMIT failed:", PQerrorMessage(conn_));
         PQexec(conn_, "ROLLBACK");
         PQclear(res);
         return 0;
@@ -235,7 +248,7 @@ std::vector<Candle> RdsClient::get_candles_by_interval(
     PGresult* res = PQexecParams(conn_, sql.c_str(), 4, nullptr, params, nullptr, nullptr, 0);
 
     if (PQresultStatus(res) != PGRES_TUPLES_OK) {
-        Logger::error("RDS get_candles_by_interval failed:", PQerrorMessage(conn_));
+        LOGGER_ERROR("RDS get_candles_by_interval failed:", PQerrorMessage(conn_));
         PQclear(res);
         return candles;
     }
@@ -254,7 +267,7 @@ std::vector<Candle> RdsClient::get_candles_by_interval(
     }
 
     PQclear(res);
-    Logger::debug("RDS get_candles:", symbol, interval, "range:",
+    LOGGER_DEBUG("RDS get_candles:", symbol, interval, "range:",
                  start_epoch, "-", end_epoch, "found:", rows);
     return candles;
 }
@@ -287,16 +300,17 @@ bool RdsClient::update_prev_close(const std::string& symbol, double close_price,
         upper_symbol.c_str(), close_str.c_str(), trading_date.c_str()
     };
 
-    PGresult* res = PQexecParams(conn_, sql.c_str(), 3, nullptr, params, nullptr, nullptr, 0);
+    PGresult* res = exec_write(conn_, sql, 3, params);
 
     if (PQresultStatus(res) != PGRES_COMMAND_OK) {
-        Logger::error("RDS update_prev_close failed:", PQerrorMessage(conn_));
+        LOGGER_ERROR("RDS update_prev_close failed:", PQerrorMessage(conn_));
+        Metrics::instance().rds_write_failures++;
         PQclear(res);
         return false;
     }
 
     PQclear(res);
-    Logger::info("[PREV-CLOSE] RDS updated:", upper_symbol, "=", close_price, "date:", trading_date);
+    LOGGER_INFO("[PREV-CLOSE] RDS updated:", upper_symbol, "=", close_price, "date:", trading_date);
     return true;
 }
 
@@ -1,6 +1,8 @@
 #include "valkey_client.h"
 #include "logger.h"
+#include "metrics.h"
 #include <hiredis/hiredis.h>
+#include <cstdarg>
 #include <nlohmann/json.hpp>
 #include <ctime>
 #include <sstream>
@@ -10,6 +12,20 @@ using json = nlohmann::json;
 
 namespace aggregator {
 
+namespace {
+
+// 모든 Valkey 명령은 이 경로로 나가며 왕복 시간을 valkey_rtt에 남긴다
+void* timed_command(redisContext* ctx, const char* format, ...) {
+    ScopedLatency rtt(Metrics::instance().valkey_rtt);
+    va_list ap;
+    va_start(ap, format);
+    void* reply = redisvCommand(ctx, format, ap);
+    va_end(ap);
+    return reply;
+}
+
+}  // namespace
+
 // 타임존 독립적 YYYYMMDDHHmm (KST) → UTC epoch 변환
 // mktime()은 시스템 타임존에 의존하므로 수동 계산
 int64_t Candle::ymdhm_to_utc_epoch(const std::string& ymdhm_kst) {
@@ -47,7 +63,7 @@ int64_t Candle::ymdhm_to_utc_epoch(const std::string& ymdhm_kst) {
         const int64_t KST_OFFSET = 9 * 3600;
         return kst_epoch - KST_OFFSET;
     } catch (const std::exception& e) {
-        Logger::warn("ymdhm_to_utc_epoch parse error:", e.what(), "input:", ymdhm_kst);
+        LOGGER_WARN("ymdhm_to_utc_epoch parse error:", e.what(), "input:", ymdhm_kst);
         return 0;
     }
 }
@@ -78,7 +94,7 @@ bool ValkeyClient::connect() {
     
     if (ctx_ == nullptr || ctx_->err) {
         if (ctx_) {
-            Logger::error("Valkey connection error:", ctx_->errstr);
+            LOGGER_ERROR("Valkey connection error:", ctx_->errstr);
             redisFree(ctx_);
             ctx_ = nullptr;
         }
@@ -106,14 +122,14 @@ bool ValkeyClient::ensureConnected() {
     // 그 상태로 두면 모든 명령이 실패하는데 프로세스는 살아 있어(systemd
     // Restart=on-failure가 발동하지 않음) 캔들 집계가 무경보로 영구 중단된다.
     if (ctx_ && ctx_->err == 0 && ping()) return true;
-    Logger::warn("Valkey 연결 이상 감지 — 재연결 시도:", host_, port_);
+    LOGGER_WARN("Valkey 연결 이상 감지 — 재연결 시도:", host_, port_);
     return reconnect();
 }
 
 bool ValkeyClient::ping() {
     if (!ctx_) return false;
 
-    redisReply* reply = (redisReply*)redisCommand(ctx_, "PING");
+    redisReply* reply = (redisReply*)timed_command(ctx_, "PING");
     if (!reply) return false;
     
     bool ok = (reply->type == REDIS_REPLY_STATUS && 
@@ -126,7 +142,7 @@ std::vector<std::string> ValkeyClient::get_closed_symbols() {
     std::vector<std::string> symbols;
     if (!ctx_) return symbols;
     
-    redisReply* reply = (redisReply*)redisCommand(ctx_, "KEYS candle:closed:1m:*");
+    redisReply* reply = (redisReply*)timed_command(ctx_, "KEYS candle:closed:1m:*");
     if (!reply) return symbols;
     
     if (reply->type == REDIS_REPLY_ARRAY) {
@@ -147,7 +163,7 @@ Candle ValkeyClient::get_candle(const std::string& key) {
     Candle c;
     if (!ctx_) return c;
 
-    redisReply* reply = (redisReply*)redisCommand(ctx_, "HGETALL %s", key.c_str());
+    redisReply* reply = (redisReply*)timed_command(ctx_, "HGETALL %s", key.c_str());
     if (!reply) return c;
 
     if (reply->type == REDIS_REPLY_ARRAY && reply->elements >= 2 && reply->elements % 2 == 0) {
@@ -174,7 +190,7 @@ bool ValkeyClient::set_candle(const std::string& key, const Candle& candle, int
     if (!ctx_) return false;
 
     // HMSET으로 캔들 데이터 저장
-    redisReply* reply = (redisReply*)redisCommand(ctx_,
+    redisReply* reply = (redisReply*)timed_command(ctx_,
         "HMSET %s s %s t %s o %.8f h %.8f l %.8f c %.8f v %.8f",
         key.c_str(),
         candle.symbol.c_str(),
@@ -217,7 +233,7 @@ std::vector<Candle> ValkeyClient::pop_closed_candles(const std::string& symbol,
 
     // RPOP으로 오래된 순서로 가져오기 (리스트 끝에서 pop)
     for (size_t i = 0; i < max_count; i++) {
-        redisReply* reply = (redisReply*)redisCommand(ctx_, "RPOP %s", key.c_str());
+        redisReply* reply = (redisReply*)timed_command(ctx_, "RPOP %s", key.c_str());
         if (!reply) break;
 
         if (reply->type == REDIS_REPLY_NIL) {
@@ -250,7 +266,7 @@ std::vector<Candle> ValkeyClient::pop_closed_candles(const std::string& symbol,
                     candles.push_back(c);
                 }
             } catch (const std::exception& e) {
-                Logger::warn("Failed to parse candle JSON:", e.what());
+                LOGGER_WARN("Failed to parse candle JSON:", e.what());
             }
         }
         freeReplyObject(reply);
@@ -262,7 +278,7 @@ std::vector<Candle> ValkeyClient::pop_closed_candles(const std::string& symbol,
 size_t ValkeyClient::get_list_length(const std::string& key) {
     if (!ctx_) return 0;
 
-    redisReply* reply = (redisReply*)redisCommand(ctx_, "LLEN %s", key.c_str());
+    redisReply* reply = (redisReply*)timed_command(ctx_, "LLEN %s", key.c_str());
     if (!reply) return 0;
 
     size_t len = 0;
@@ -276,7 +292,7 @@ size_t ValkeyClient::get_list_length(const std::string& key) {
 bool ValkeyClient::set_expire(const std::string& key, int ttl_seconds) {
     if (!ctx_ || ttl_seconds <= 0) return false;
 
-    redisReply* reply = (redisReply*)redisCommand(ctx_, "EXPIRE %s %d", key.c_str(), ttl_seconds);
+    redisReply* reply = (redisReply*)timed_command(ctx_, "EXPIRE %s %d", key.c_str(), ttl_seconds);
     if (!reply) return false;
 
     bool ok = (reply->type == REDIS_REPLY_INTEGER && reply->integer == 1);
@@ -296,14 +312,14 @@ bool ValkeyClient::set_prev_close(const std::string& symbol, double close_price)
     std::string key = "prev:" + symbol;
     std::string value = prev.dump();
 
-    redisReply* reply = (redisReply*)redisCommand(ctx_, "SET %s %s", key.c_str(), value.c_str());
+    redisReply* reply = (redisReply*)timed_command(ctx_, "SET %s %s", key.c_str(), value.c_str());
     if (!reply) return false;
 
     bool ok = (reply->type == REDIS_REPLY_STATUS && std::string(reply->str) == "OK");
     freeReplyObject(reply);
 
     if (ok) {
-        Logger::info("[PREV-CLOSE] Set prev:", symbol, "=", close_price);
+        LOGGER_INFO("[PREV-CLOSE] Set prev:", symbol, "=", close_price);
     }
     return ok;
 }
@@ -312,7 +328,7 @@ double ValkeyClient::get_prev_close(const std::string& symbol) {
     if (!ctx_) return 0.0;
 
     std::string key = "prev:" + symbol;
-    redisReply* reply = (redisReply*)redisCommand(ctx_, "GET %s", key.c_str());
+    redisReply* reply = (redisReply*)timed_command(ctx_, "GET %s", key.c_str());
     if (!reply) return 0.0;
 
     double close_price = 0.0;
@@ -327,7 +343,7 @@ double ValkeyClient::get_prev_close(const std::string& symbol) {
                 }
             }
         } catch (const std::exception& e) {
-            Logger::warn("Failed to parse prev close for", symbol, ":", e.what());
+            LOGGER_WARN("Failed to parse prev close for", symbol, ":", e.what());
         }
     }
     freeReplyObject(reply);
@@ -341,26 +357,26 @@ bool ValkeyClient::update_ranking(const std::string& symbol, double change_pct)
     int64_t change_score = static_cast<int64_t>(change_pct * 1000000.0);
 
     // gainers: 등락률 내림차순 (높은 순)
-    redisReply* reply1 = (redisReply*)redisCommand(ctx_,
+    redisReply* reply1 = (redisReply*)timed_command(ctx_,
         "ZADD ranking:gainers %lld %s", change_score, symbol.c_str());
     if (reply1) freeReplyObject(reply1);
 
     // losers: 등락률 오름차순 (낮은 순, 음수 점수로 저장)
-    redisReply* reply2 = (redisReply*)redisCommand(ctx_,
+    redisReply* reply2 = (redisReply*)timed_command(ctx_,
         "ZADD ranking:losers %lld %s", -change_score, symbol.c_str());
     if (reply2) freeReplyObject(reply2);
 
     // 급등/급락은 상위 100개만 유지
     const int MAX_GAINERS_LOSERS = 100;
-    redisReply* reply3 = (redisReply*)redisCommand(ctx_,
+    redisReply* reply3 = (redisReply*)timed_command(ctx_,
         "ZREMRANGEBYRANK ranking:gainers 0 %d", -MAX_GAINERS_LOSERS - 1);
     if (reply3) freeReplyObject(reply3);
 
-    redisReply* reply4 = (redisReply*)redisCommand(ctx_,
+    redisReply* reply4 = (redisReply*)timed_command(ctx_,
         "ZREMRANGEBYRANK ranking:losers 0 %d", -MAX_GAINERS_LOSERS - 1);
     if (reply4) freeReplyObject(reply4);
 
-    Logger::debug("[RANKING] Updated ranking for", symbol, "change:", change_pct, "%");
+    LOGGER_DEBUG("[RANKING] Updated ranking for", symbol, "change:", change_pct, "%");
     return true;
 }
 
@@ -368,7 +384,7 @@ double ValkeyClient::get_ticker_price(const std::string& symbol) {
     if (!ctx_) return 0.0;
 
     std::string key = "ticker:" + symbol;
-    redisReply* reply = (redisReply*)redisCommand(ctx_, "GET %s", key.c_str());
+    redisReply* reply = (redisReply*)timed_command(ctx_, "GET %s", key.c_str());
     if (!reply) return 0.0;
 
     double price = 0.0;
@@ -383,7 +399,7 @@ double ValkeyClient::get_ticker_price(const std::string& symbol) {
                 }
             }
         } catch (const std::exception& e) {
-            Logger::warn("Failed to parse ticker price for", symbol, ":", e.what());
+            LOGGER_WARN("Failed to parse ticker price for", symbol, ":", e.what());
         }
     }
     freeReplyObject(reply);
@@ -419,7 +435,7 @@ int ValkeyClient::close_stale_candles(const std::string& current_minute_kst) {
         return closed
     )";
 
-    redisReply* reply = (redisReply*)redisCommand(ctx_,
+    redisReply* reply = (redisReply*)timed_command(ctx_,
         "EVAL %s 0 %s", lua_script.c_str(), current_minute_kst.c_str());
 
     if (!reply) return 0;
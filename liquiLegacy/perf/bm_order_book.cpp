@@ -0,0 +1,518 @@
+// Google Benchmark suite for the liquibook core.
+//
+// Every scenario runs against three bindings:
+//   simple - SimpleOrderBook<10> over raw SimpleOrder pointers (the unit test book)
+//   engine - DepthOrderBook<std::shared_ptr<aws_wrapper::Order>, 10> with order,
+//            depth and bbo listeners attached through the virtual interfaces.
+//            The listener only keeps the order objects current (fill / replace),
+//            which is the part of MarketDataHandler that liquibook relies on.
+//   engine_static - the same book and listener with the listener bound as a
+//            template argument, as EngineCore creates it.
+//
+// Book shapes are "levels x orders per level" on each side and can be chosen
+// at run time:  bm_order_book --book_shapes=10x10,100x10
+// JSON for regression tracking:  --benchmark_out=bm.json --benchmark_out_format=json
+#include <book/depth_order_book.h>
+#include <simple/simple_order_book.h>
+#ifdef LIQUIBOOK_BM_ENGINE_ORDER
+#include "order.h"
+#include "logger.h"
+#endif
+
+#include <benchmark/benchmark.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace liquibook;
+using book::Price;
+using book::Quantity;
+
+namespace {
+
+const Price MID = 100000;     // best bid is MID - 1, best ask MID + 1
+const Quantity LOT = 100;
+const size_t BATCH = 256;     // orders per timed batch (add / cancel)
+
+struct Shape {
+  int levels;
+  int per_level;
+};
+
+std::vector<Shape> g_shapes = {{1, 1}, {10, 10}, {100, 10}, {10, 100}};
+
+/// @brief binding for the unit test book
+struct SimpleBinding {
+  typedef simple::SimpleOrderBook<10> Book;
+  typedef simple::SimpleOrder* OrderPtr;
+
+  static const char* name() { return "simple"; }
+
+  /// @brief owns the orders handed to the book
+  class Orders {
+  public:
+    OrderPtr make(bool is_buy, Price price, Quantity qty,
+                  Price stop_price = 0, book::OrderConditions conditions = 0)
+    {
+      pool_.emplace_back(is_buy, price, qty, stop_price, conditions);
+      return &pool_.back();
+    }
+  private:
+    std::deque<simple::SimpleOrder> pool_;
+  };
+
+  static void attach(Book&) {}
+};
+
+#ifdef LIQUIBOOK_BM_ENGINE_ORDER
+typedef std::shared_ptr<aws_wrapper::Order> EngineOrderPtr;
+
+/// @brief keeps engine orders current, like MarketDataHandler
+template <class Book>
+class EngineListener
+  : public book::OrderListener<EngineOrderPtr>
+  , public book::DepthListener<Book>
+  , public book::BboListener<Book>
+{
+public:
+  typedef EngineOrderPtr OrderPtr;
+  virtual void on_accept(const OrderPtr&) {}
+  virtual void on_reject(const OrderPtr&, const char*) {}
+  virtual void on_fill(const OrderPtr& order,
+                       const OrderPtr& matched_order,
+                       Quantity fill_qty,
+                       Price fill_price)
+  {
+    book::Cost fill_cost = fill_qty * fill_price;
+    order->fill(fill_qty, fill_cost, 0);
+    matched_order->fill(fill_qty, fill_cost, 0);
+  }
+  virtual void on_cancel(const OrderPtr&) {}
+  virtual void on_cancel_reject(const OrderPtr&, const char*) {}
+  virtual void on_replace(const OrderPtr& order,
+                          const int64_t& size_delta,
+                          Price new_price)
+  {
+    order->setOrderQty(Quantity(int64_t(order->order_qty()) + size_delta));
+    if (new_price != book::PRICE_UNCHANGED) {
+      order->setPrice(new_price);
+    }
+  }
+  virtual void on_replace_reject(const OrderPtr&, const char*) {}
+  virtual void on_depth_change(const Book*, const typename Book::DepthTracker*) {}
+  virtual void on_bbo_change(const Book*, const typename Book::DepthTracker*) {}
+};
+
+class EngineStaticListener;
+typedef book::DepthOrderBook<EngineOrderPtr, 10> EngineVirtualBook;
+typedef book::DepthOrderBook<EngineOrderPtr, 10, EngineStaticListener> EngineStaticBook;
+
+class EngineStaticListener : public EngineListener<EngineStaticBook> {};
+
+/// @brief binding for the matching engine book
+/// BookT is the virtual-listener book (engine) or the book with the listener
+/// bound at compile time (engine_static, what EngineCore uses).
+template <class BookT, class ListenerT>
+struct EngineBinding {
+  typedef EngineOrderPtr OrderPtr;
+  typedef BookT Book;
+
+  static const char* name()
+  {
+    return Book::static_listener ? "engine_static" : "engine";
+  }
+
+  class Orders {
+  public:
+    OrderPtr make(bool is_buy, Price price, Quantity qty,
+                  Price stop_price = 0, book::OrderConditions conditions = 0)
+    {
+      auto order = std::make_shared<aws_wrapper::Order>();
+      order->setOrderId("bm-" + std::to_string(++seq_));
+      order->setUserId("bench");
+      order->setSymbol("BENCH");
+      order->setIsBuy(is_buy);
+      order->setPrice(price);
+      order->setOrderQty(qty);
+      order->setStopPrice(stop_price);
+      order->setConditions(conditions);
+      order->setOrderType(price ? "LIMIT" : "MARKET");
+      return order;
+    }
+  private:
+    uint64_t seq_ = 0;
+  };
+
+  static void attach(Book& book)
+  {
+    static ListenerT listener;
+    book.set_symbol("BENCH");
+    if constexpr (Book::static_listener) {
+      book.set_listener(&listener);
+    } else {
+      book.set_order_listener(&listener);
+      book.set_depth_listener(&listener);
+      book.set_bbo_listener(&listener);
+    }
+  }
+};
+#endif
+
+/// @brief a book filled to a shape, plus the orders resting in it
+template <class Binding>
+struct Fixture {
+  typedef typename Binding::Book Book;
+  typedef typename Binding::OrderPtr OrderPtr;
+
+  std::unique_ptr<typename Binding::Orders> orders;
+  std::unique_ptr<Book> book;
+  std::vector<OrderPtr> bids;
+  std::vector<OrderPtr> asks;
+
+  /// @brief (re)build the book; ask_conditions is applied to every other ask
+  void build(const Shape& shape, book::OrderConditions ask_conditions = 0)
+  {
+    book.reset();
+    orders.reset(new typename Binding::Orders());
+    book.reset(new Book());
+    Binding::attach(*book);
+    bids.clear();
+    asks.clear();
+    for (int level = 0; level < shape.levels; ++level) {
+      for (int i = 0; i < shape.per_level; ++i) {
+        OrderPtr bid = orders->make(true, MID - 1 - level, LOT);
+        book->add(bid);
+        bids.push_back(bid);
+        bool aon = ask_conditions && (i % 2 == 0);
+        OrderPtr ask = orders->make(false, MID + 1 + level,
+                                    aon ? 2 * LOT : LOT, 0,
+                                    aon ? ask_conditions : 0);
+        book->add(ask, aon ? ask_conditions : 0);
+        asks.push_back(ask);
+      }
+    }
+  }
+};
+
+Shape shape_of(const benchmark::State& state)
+{
+  return Shape{int(state.range(0)), int(state.range(1))};
+}
+
+/// @brief passive limit orders joining existing levels (queue append)
+template <class Binding>
+void BM_Add(benchmark::State& state)
+{
+  Shape shape = shape_of(state);
+  Fixture<Binding> fx;
+  fx.build(shape);
+  std::vector<typename Binding::OrderPtr> batch;
+  for (size_t i = 0; i < BATCH; ++i) {
+    batch.push_back(fx.orders->make(true, MID - 1 - Price(i % shape.levels), LOT));
+  }
+  while (state.KeepRunningBatch(BATCH)) {
+    for (auto& order : batch) {
+      fx.book->add(order);
+    }
+    state.PauseTiming();
+    for (auto& order : batch) {
+      fx.book->cancel(order);
+    }
+    state.ResumeTiming();
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+/// @brief cancel of the most recently queued order at each level
+template <class Binding>
+void BM_Cancel(benchmark::State& state)
+{
+  Shape shape = shape_of(state);
+  Fixture<Binding> fx;
+  fx.build(shape);
+  std::vector<typename Binding::OrderPtr> batch;
+  for (size_t i = 0; i < BATCH; ++i) {
+    batch.push_back(fx.orders->make(false, MID + 1 + Price(i % shape.levels), LOT));
+  }
+  while (state.KeepRunningBatch(BATCH)) {
+    state.PauseTiming();
+    for (auto& order : batch) {
+      fx.book->add(order);
+    }
+    state.ResumeTiming();
+    for (auto& order : batch) {
+      fx.book->cancel(order);
+    }
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+/// @brief price-changing replace that walks resting bids one level deeper
+template <class Binding>
+void BM_Replace(benchmark::State& state)
+{
+  Shape shape = shape_of(state);
+  Fixture<Binding> fx;
+  fx.build(shape);
+  size_t next = 0;
+  for (auto _ : state) {
+    auto& order = fx.bids[next];
+    if (++next == fx.bids.size()) {
+      next = 0;
+    }
+    Price depth = (MID - 1 - order->price() + 1) % shape.levels;
+    fx.book->replace(order, 0, MID - 1 - depth);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+/// @brief one market order that takes out the whole ask side
+template <class Binding>
+void BM_MarketSweep(benchmark::State& state)
+{
+  Shape shape = shape_of(state);
+  Fixture<Binding> fx;
+  Quantity sweep_qty = Quantity(shape.levels) * shape.per_level * LOT;
+  for (auto _ : state) {
+    state.PauseTiming();
+    fx.build(shape);
+    auto order = fx.orders->make(true, 0, sweep_qty);
+    state.ResumeTiming();
+    fx.book->add(order);
+  }
+  if (!fx.book->asks().empty()) {
+    state.SkipWithError("market sweep left asks on the book");
+  }
+  state.SetItemsProcessed(state.iterations() * shape.levels * shape.per_level);
+}
+
+/// @brief all-or-none buy for the full ask side where half the asks are AON
+template <class Binding>
+void BM_AonSweep(benchmark::State& state)
+{
+  Shape shape = shape_of(state);
+  Fixture<Binding> fx;
+  for (auto _ : state) {
+    state.PauseTiming();
+    fx.build(shape, book::oc_all_or_none);
+    Quantity total = 0;
+    for (auto& ask : fx.asks) {
+      total += ask->order_qty();
+    }
+    auto order = fx.orders->make(true, MID + shape.levels, total, 0,
+                                 book::oc_all_or_none);
+    state.ResumeTiming();
+    fx.book->add(order, book::oc_all_or_none);
+  }
+  if (!fx.book->asks().empty()) {
+    state.SkipWithError("AON sweep left asks on the book");
+  }
+  state.SetItemsProcessed(state.iterations() * shape.levels * shape.per_level);
+}
+
+/// @brief all-or-none buys just larger than the AON-heavy ask side: none fill
+template <class Binding>
+void BM_AonReject(benchmark::State& state)
+{
+  Shape shape = shape_of(state);
+  Fixture<Binding> fx;
+  fx.build(shape, book::oc_all_or_none);
+  Quantity total = 0;
+  for (auto& ask : fx.asks) {
+    total += ask->order_qty();
+  }
+  std::vector<typename Binding::OrderPtr> batch;
+  for (size_t i = 0; i < BATCH; ++i) {
+    batch.push_back(fx.orders->make(true, MID + shape.levels, total + LOT, 0,
+                                    book::oc_all_or_none));
+  }
+  while (state.KeepRunningBatch(BATCH)) {
+    for (auto& order : batch) {
+      fx.book->add(order, book::oc_all_or_none);
+    }
+    state.PauseTiming();
+    for (auto& order : batch) {
+      fx.book->cancel(order);
+    }
+    state.ResumeTiming();
+  }
+  if (fx.book->asks().size() != fx.asks.size()) {
+    state.SkipWithError("AON reject traded against the asks");
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+/// @brief one trade that lifts the market through every resting stop
+template <class Binding>
+void BM_StopTrigger(benchmark::State& state)
+{
+  Shape shape = shape_of(state);
+  Fixture<Binding> fx;
+  for (auto _ : state) {
+    state.PauseTiming();
+    fx.build(shape);
+    fx.book->set_market_price(MID - shape.levels);
+    // stop-limit buys below the bids: once triggered they rest without trading
+    for (int level = 0; level < shape.levels; ++level) {
+      for (int i = 0; i < shape.per_level; ++i) {
+        auto stop = fx.orders->make(true, MID - 1 - shape.levels, LOT,
+                                    MID + 1 - level);
+        fx.book->add(stop);
+      }
+    }
+    auto order = fx.orders->make(true, MID + 1, LOT);
+    state.ResumeTiming();
+    fx.book->add(order);
+  }
+  if (!fx.book->stopBids().empty()) {
+    state.SkipWithError("stop orders were not triggered");
+  }
+  state.SetItemsProcessed(state.iterations() * shape.levels * shape.per_level);
+}
+
+/// @brief stops that trigger each other level by level up the ask side
+template <class Binding>
+void BM_StopCascade(benchmark::State& state)
+{
+  Shape shape = shape_of(state);
+  Fixture<Binding> fx;
+  for (auto _ : state) {
+    state.PauseTiming();
+    fx.build(shape);
+    fx.book->set_market_price(MID);
+    // stop-market buys at each ask level: filling them reaches the next level
+    for (int level = 0; level < shape.levels; ++level) {
+      for (int i = 0; i < shape.per_level; ++i) {
+        auto stop = fx.orders->make(true, 0, LOT, MID + 1 + level,
+                                    book::oc_immediate_or_cancel);
+        fx.book->add(stop, book::oc_immediate_or_cancel);
+      }
+    }
+    auto order = fx.orders->make(true, MID + 1, LOT);
+    state.ResumeTiming();
+    fx.book->add(order);
+  }
+  if (!fx.book->stopBids().empty() || !fx.book->asks().empty()) {
+    state.SkipWithError("stop cascade did not reach the top of the asks");
+  }
+  state.SetItemsProcessed(state.iterations() * shape.levels * shape.per_level);
+}
+
+/// @brief call auction over crossing bids that take the whole ask side
+template <class Binding>
+void BM_AuctionUncross(benchmark::State& state)
+{
+  Shape shape = shape_of(state);
+  Fixture<Binding> fx;
+  for (auto _ : state) {
+    state.PauseTiming();
+    fx.build(shape);
+    fx.book->start_auction();
+    for (size_t i = 0; i < fx.asks.size(); ++i) {
+      fx.book->add(fx.orders->make(true, MID + shape.levels, LOT));
+    }
+    state.ResumeTiming();
+    fx.book->uncross(MID);
+  }
+  if (!fx.book->asks().empty()) {
+    state.SkipWithError("auction did not cross the whole ask side");
+  }
+  state.SetItemsProcessed(state.iterations() * shape.levels * shape.per_level);
+}
+
+template <class Binding>
+void register_binding()
+{
+  typedef void (*Function)(benchmark::State&);
+  struct Scenario {
+    const char* name;
+    Function function;
+  };
+  const Scenario scenarios[] = {
+    {"add", &BM_Add<Binding>},
+    {"cancel", &BM_Cancel<Binding>},
+    {"replace", &BM_Replace<Binding>},
+    {"market_sweep", &BM_MarketSweep<Binding>},
+    {"aon_sweep", &BM_AonSweep<Binding>},
+    {"aon_reject", &BM_AonReject<Binding>},
+    {"stop_trigger", &BM_StopTrigger<Binding>},
+    {"stop_cascade", &BM_StopCascade<Binding>},
+    {"auction_uncross", &BM_AuctionUncross<Binding>},
+  };
+  for (const auto& scenario : scenarios) {
+    std::string name = std::string(scenario.name) + "/" + Binding::name();
+    auto* bm = benchmark::RegisterBenchmark(name.c_str(), scenario.function);
+    bm->ArgNames({"levels", "per_level"});
+    for (const auto& shape : g_shapes) {
+      bm->Args({shape.levels, shape.per_level});
+    }
+  }
+}
+
+/// @brief parse "10x10,100x10"; false on a malformed list
+bool parse_shapes(const char* text, std::vector<Shape>& shapes)
+{
+  shapes.clear();
+  std::string list(text);
+  size_t pos = 0;
+  while (pos <= list.size()) {
+    size_t comma = list.find(',', pos);
+    std::string item = list.substr(pos, comma == std::string::npos ? std::string::npos : comma - pos);
+    int levels = 0;
+    int per_level = 0;
+    char trailing = 0;
+    if (std::sscanf(item.c_str(), "%dx%d%c", &levels, &per_level, &trailing) != 2 ||
+        levels <= 0 || per_level <= 0) {
+      return false;
+    }
+    shapes.push_back(Shape{levels, per_level});
+    if (comma == std::string::npos) {
+      break;
+    }
+    pos = comma + 1;
+  }
+  return !shapes.empty();
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+  // strip our own flag before google benchmark sees the command line
+  const char* SHAPES_FLAG = "--book_shapes=";
+  int out = 1;
+  for (int i = 1; i < argc; ++i) {
+    if (std::strncmp(argv[i], SHAPES_FLAG, std::strlen(SHAPES_FLAG)) == 0) {
+      if (!parse_shapes(argv[i] + std::strlen(SHAPES_FLAG), g_shapes)) {
+        std::cerr << "bad " << argv[i] << " (expected e.g. 10x10,100x10)" << std::endl;
+        return 1;
+      }
+    } else {
+      argv[out++] = argv[i];
+    }
+  }
+  argc = out;
+
+  register_binding<SimpleBinding>();
+#ifdef LIQUIBOOK_BM_ENGINE_ORDER
+  // Order::fill logs every fill at INFO; measure the book, not the log ring
+  aws_wrapper::Logger::setLevel(aws_wrapper::LogLevel::WARN);
+  register_binding<EngineBinding<EngineVirtualBook,
+                                 EngineListener<EngineVirtualBook> > >();
+  register_binding<EngineBinding<EngineStaticBook, EngineStaticListener> >();
+#endif
+
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+  benchmark::RunSpecifiedBenchmarks();
+  benchmark::Shutdown();
+  return 0;
+}
@@ -0,0 +1,89 @@
+// Copyright (c) 2012, 2013 Object Computing, Inc.
+// All rights reserved.
+// See the file license.txt for licensing information.
+#include <simple/simple_order_book.h>
+#include <book/types.h>
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <stdlib.h>
+#include <vector>
+
+using namespace liquibook;
+using namespace liquibook::book;
+
+typedef simple::SimpleOrderBook<5> DepthBook;
+
+// Build an uncrossed resting book: bids below and asks above a fixed mid,
+// spread over levels prices per side, each side sorted best price first.
+std::vector<simple::SimpleOrder*> build_orders(size_t count, int levels)
+{
+  std::vector<simple::SimpleOrder*> orders;
+  orders.reserve(count);
+  for (size_t i = 0; i < count; ++i) {
+    bool is_buy = (i % 2) == 0;
+    Price offset = Price(rand() % levels) + 1;
+    Price price = is_buy ? 100000 - offset : 100000 + offset;
+    orders.push_back(new simple::SimpleOrder(is_buy, price, 100 + rand() % 100));
+  }
+  std::stable_sort(orders.begin(), orders.end(),
+    [](const simple::SimpleOrder* lhs, const simple::SimpleOrder* rhs) {
+      if (lhs->is_buy() != rhs->is_buy()) {
+        return lhs->is_buy();
+      }
+      return lhs->is_buy() ? lhs->price() > rhs->price()
+                           : lhs->price() < rhs->price();
+    });
+  return orders;
+}
+
+double seconds_since(std::chrono::steady_clock::time_point start)
+{
+  std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start;
+  return elapsed.count();
+}
+
+int main(int argc, const char* argv[])
+{
+  size_t count = 1000000;
+  if (argc > 1) {
+    count = size_t(atol(argv[1]));
+    if (!count) {
+      count = 1000000;
+    }
+  }
+  srand(1);
+  const int levels = 2000;
+  std::vector<simple::SimpleOrder*> orders = build_orders(count, levels);
+  std::cout << "restore of " << count << " resting orders over "
+            << levels << " price levels per side" << std::endl;
+
+  {
+    DepthBook book;
+    std::chrono::steady_clock::time_point start =
+        std::chrono::steady_clock::now();
+    for (size_t i = 0; i < orders.size(); ++i) {
+      book.add(orders[i]);
+    }
+    std::cout << "add one at a time: " << seconds_since(start) << " s"
+              << std::endl;
+  }
+  {
+    DepthBook book;
+    std::chrono::steady_clock::time_point start =
+        std::chrono::steady_clock::now();
+    const char* reason = book.bulk_load(orders);
+    std::cout << "bulk_load:         " << seconds_since(start) << " s";
+    if (reason) {
+      std::cout << " (rejected: " << reason << ")";
+    }
+    std::cout << std::endl;
+  }
+
+  for (size_t i = 0; i < orders.size(); ++i) {
+    delete orders[i];
+  }
+  return 0;
+}
@@ -0,0 +1,253 @@
+// Copyright (c) 2012, 2013 Object Computing, Inc.
+// All rights reserved.
+// See the file license.txt for licensing information.
+#include <book/depth.h>
+#include <book/types.h>
+
+#include <chrono>
+#include <iostream>
+#include <map>
+#include <stdlib.h>
+#include <vector>
+
+using namespace liquibook;
+using namespace liquibook::book;
+
+// Reference depth using a linear scan over the level structs, the way
+// Depth<SIZE> searched and shifted before the price lanes were added.
+// Only the operations exercised below are implemented.
+template <int SIZE>
+class ReferenceDepth {
+public:
+  ReferenceDepth()
+  : last_change_(0)
+  {
+    for (int i = 0; i < SIZE * 2; ++i) {
+      levels_[i].init(INVALID_LEVEL_PRICE, false);
+    }
+  }
+
+  void add_order(Price price, Quantity qty, bool is_bid)
+  {
+    DepthLevel* level = find_level(price, is_bid, true);
+    level->add_order(qty);
+    if (!level->is_excess()) {
+      level->last_change(++last_change_);
+    }
+  }
+
+  void close_order(Price price, Quantity qty, bool is_bid)
+  {
+    DepthLevel* level = find_level(price, is_bid, false);
+    if (level) {
+      if (level->close_order(qty)) {
+        erase_level(level, is_bid);
+      } else {
+        level->last_change(++last_change_);
+      }
+    }
+  }
+
+  const DepthLevel* bids() const { return levels_; }
+
+private:
+  DepthLevel levels_[SIZE * 2];
+  ChangeId last_change_;
+  std::map<Price, DepthLevel, std::greater<Price> > excess_bids_;
+  std::map<Price, DepthLevel, std::less<Price> > excess_asks_;
+
+  DepthLevel* find_level(Price price, bool is_bid, bool should_create)
+  {
+    DepthLevel* level = is_bid ? levels_ : levels_ + SIZE;
+    DepthLevel* past_end = level + SIZE;
+    for ( ; level != past_end; ++level) {
+      if (level->price() == price) {
+        return level;
+      } else if (should_create && level->price() == INVALID_LEVEL_PRICE) {
+        level->init(price, false);
+        return level;
+      } else if (is_bid && should_create && level->price() < price) {
+        insert_level_before(level, is_bid, price);
+        return level;
+      } else if ((!is_bid) && should_create && level->price() > price) {
+        insert_level_before(level, is_bid, price);
+        return level;
+      }
+    }
+    if (is_bid) {
+      return excess_level(excess_bids_, price, should_create);
+    }
+    return excess_level(excess_asks_, price, should_create);
+  }
+
+  template <class LevelMap>
+  DepthLevel* excess_level(LevelMap& excess, Price price, bool should_create)
+  {
+    typename LevelMap::iterator pos = excess.find(price);
+    if (pos != excess.end()) {
+      return &pos->second;
+    } else if (should_create) {
+      DepthLevel new_level;
+      new_level.init(price, true);
+      return &excess.insert(std::make_pair(price, new_level)).first->second;
+    }
+    return nullptr;
+  }
+
+  void insert_level_before(DepthLevel* level, bool is_bid, Price price)
+  {
+    DepthLevel* last = is_bid ? levels_ + SIZE - 1 : levels_ + SIZE * 2 - 1;
+    if (last->price() != INVALID_LEVEL_PRICE) {
+      DepthLevel excess;
+      excess.init(0, true);
+      excess = *last;
+      if (is_bid) {
+        excess_bids_.insert(std::make_pair(last->price(), excess));
+      } else {
+        excess_asks_.insert(std::make_pair(last->price(), excess));
+      }
+    }
+    ++last_change_;
+    for (DepthLevel* current = last - 1; current >= level; --current) {
+      *(current + 1) = *current;
+      if (current->price() != INVALID_LEVEL_PRICE) {
+        (current + 1)->last_change(last_change_);
+      }
+    }
+    level->init(price, false);
+  }
+
+  void erase_level(DepthLevel* level, bool is_bid)
+  {
+    if (level->is_excess()) {
+      if (is_bid) {
+        excess_bids_.erase(level->price());
+      } else {
+        excess_asks_.erase(level->price());
+      }
+      return;
+    }
+    DepthLevel* last = is_bid ? levels_ + SIZE - 1 : levels_ + SIZE * 2 - 1;
+    ++last_change_;
+    for (DepthLevel* current = level; current < last; ++current) {
+      if ((current->price() != INVALID_LEVEL_PRICE) || (current == level)) {
+        *current = *(current + 1);
+        current->last_change(last_change_);
+      }
+    }
+    if ((level == last) || (last->price() != INVALID_LEVEL_PRICE)) {
+      if (is_bid && !excess_bids_.empty()) {
+        *last = excess_bids_.begin()->second;
+        excess_bids_.erase(excess_bids_.begin());
+      } else if (!is_bid && !excess_asks_.empty()) {
+        *last = excess_asks_.begin()->second;
+        excess_asks_.erase(excess_asks_.begin());
+      } else {
+        last->init(INVALID_LEVEL_PRICE, false);
+      }
+      last->last_change(last_change_);
+    }
+  }
+};
+
+struct DepthOp {
+  Price price;
+  bool is_bid;
+  bool is_add;
+};
+
+// Build a balanced add/close sequence around a fixed mid price.  Prices span
+// spread levels on each side; a spread beyond the depth size sends part of
+// the flow to the excess levels.
+std::vector<DepthOp> build_ops(int spread, size_t count)
+{
+  std::vector<DepthOp> ops;
+  ops.reserve(count);
+  std::vector<DepthOp> open;
+  while (ops.size() < count) {
+    if (open.empty() || (rand() % 2) == 0) {
+      DepthOp op;
+      op.is_bid = (rand() % 2) == 0;
+      Price offset = Price(rand() % spread) + 1;
+      op.price = op.is_bid ? 10000 - offset : 10000 + offset;
+      op.is_add = true;
+      ops.push_back(op);
+      open.push_back(op);
+    } else {
+      size_t pick = size_t(rand()) % open.size();
+      DepthOp op = open[pick];
+      op.is_add = false;
+      ops.push_back(op);
+      open[pick] = open.back();
+      open.pop_back();
+    }
+  }
+  return ops;
+}
+
+template <class TypedDepth>
+double run_ops(const std::vector<DepthOp>& ops, int passes)
+{
+  std::chrono::steady_clock::time_point start =
+      std::chrono::steady_clock::now();
+  Quantity checksum = 0;
+  for (int pass = 0; pass < passes; ++pass) {
+    TypedDepth depth;
+    for (size_t i = 0; i < ops.size(); ++i) {
+      const DepthOp& op = ops[i];
+      if (op.is_add) {
+        depth.add_order(op.price, 100, op.is_bid);
+      } else {
+        depth.close_order(op.price, 100, op.is_bid);
+      }
+    }
+    checksum += depth.bids()->aggregate_qty();
+  }
+  std::chrono::nanoseconds elapsed = std::chrono::steady_clock::now() - start;
+  // Keep the work observable
+  if (checksum == 1) {
+    std::cout << "";
+  }
+  return double(elapsed.count()) / double(ops.size() * passes);
+}
+
+template <int SIZE>
+void compare(size_t op_count, int passes, int spread)
+{
+  std::vector<DepthOp> ops = build_ops(spread, op_count);
+  // Warm up both before measuring
+  run_ops<ReferenceDepth<SIZE> >(ops, 1);
+  run_ops<Depth<SIZE> >(ops, 1);
+
+  double reference_ns = run_ops<ReferenceDepth<SIZE> >(ops, passes);
+  double lane_ns = run_ops<Depth<SIZE> >(ops, passes);
+  std::cout << "SIZE " << SIZE << ", " << spread << " price levels"
+            << ": scalar scan " << reference_ns << " ns/op"
+            << ", price lane " << lane_ns << " ns/op"
+            << ", speedup " << reference_ns / lane_ns << "x" << std::endl;
+}
+
+int main(int argc, const char* argv[])
+{
+  int passes = 20;
+  if (argc > 1) {
+    passes = atoi(argv[1]);
+    if (!passes) {
+      passes = 20;
+    }
+  }
+  const size_t op_count = 200000;
+  std::cout << "depth level search/shift test, " << op_count << " ops x "
+            << passes << " passes" << std::endl;
+  srand(passes);
+
+  // Flow inside the visible levels
+  compare<5>(op_count, passes, 5);
+  compare<10>(op_count, passes, 10);
+  compare<20>(op_count, passes, 20);
+  // Flow spilling into the excess levels
+  compare<5>(op_count, passes, 10);
+  compare<10>(op_count, passes, 20);
+  compare<20>(op_count, passes, 40);
+  return 0;
+}
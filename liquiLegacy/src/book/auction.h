@@ -0,0 +1,114 @@
+// Copyright (c) 2012 - 2017 Object Computing, Inc.
+// All rights reserved.
+// See the file license.txt for licensing information.
+#pragma once
+
+#include "level_quantities.h"
+#include <algorithm>
+
+namespace liquibook { namespace book {
+
+/// @brief outcome of a call auction: the single price it uncrosses at
+struct AuctionResult {
+  AuctionResult() : price(MARKET_ORDER_PRICE), volume(0), imbalance(0) {}
+  /// Equilibrium price, MARKET_ORDER_PRICE if nothing crosses
+  Price price;
+  /// Quantity that executes at price
+  Quantity volume;
+  /// Demand and supply at price that are left unmatched
+  Quantity imbalance;
+};
+
+/// @brief find the equilibrium price of a call auction.
+///   Cumulative demand at a price is the bid quantity at or above it, supply
+///   the ask quantity at or below it; market orders count at every price.
+///   The price executing the most volume wins, then the one leaving the
+///   least imbalance, then the one nearest the reference price, then the
+///   lower one.  All-or-none quantity takes no part.  One pass over the
+///   price levels of both sides.
+/// @param bids open quantity per bid level
+/// @param asks open quantity per ask level
+/// @param reference price used when only the tiebreak or market orders
+///        decide (typically the last trade), MARKET_ORDER_PRICE if none
+inline AuctionResult
+auction_equilibrium(const LevelQuantities& bids,
+                    const LevelQuantities& asks,
+                    Price reference)
+{
+  typedef LevelQuantities::Levels Levels;
+  const Levels& bid_levels = bids.levels();
+  const Levels& ask_levels = asks.levels();
+
+  // Market levels sort first on either side
+  Quantity market_bids = 0;
+  Quantity limit_bids = 0;
+  for (const auto& level : bid_levels) {
+    if (level.first == MARKET_ORDER_PRICE) {
+      market_bids += level.second.regular;
+    } else {
+      limit_bids += level.second.regular;
+    }
+  }
+  auto ask = ask_levels.begin();
+  Quantity supply = 0;
+  if (ask != ask_levels.end() && ask->first == MARKET_ORDER_PRICE) {
+    supply = ask->second.regular;
+    ++ask;
+  }
+  const Quantity market_asks = supply;
+
+  // Bids are kept highest first; walk both sides up from the lowest price
+  auto bid = bid_levels.rbegin();
+  auto bid_end = bid_levels.rend();
+  if (!bid_levels.empty() &&
+      bid_levels.begin()->first == MARKET_ORDER_PRICE) {
+    --bid_end;
+  }
+  Quantity bids_below = 0;
+  AuctionResult best;
+  Price best_distance = 0;
+  while (bid != bid_end || ask != ask_levels.end()) {
+    Price price;
+    if (bid == bid_end) {
+      price = ask->first.price();
+    } else if (ask == ask_levels.end()) {
+      price = bid->first.price();
+    } else {
+      price = (std::min)(bid->first.price(), ask->first.price());
+    }
+    if (ask != ask_levels.end() && ask->first.price() == price) {
+      supply += ask->second.regular;
+      ++ask;
+    }
+    Quantity demand = market_bids + limit_bids - bids_below;
+    Quantity volume = (std::min)(demand, supply);
+    Quantity imbalance = demand > supply ? demand - supply : supply - demand;
+    Price distance = price > reference ? price - reference : reference - price;
+    if (volume > 0 &&
+        (volume > best.volume ||
+         (volume == best.volume &&
+          (imbalance < best.imbalance ||
+           (imbalance == best.imbalance && distance < best_distance))))) {
+      best.price = price;
+      best.volume = volume;
+      best.imbalance = imbalance;
+      best_distance = distance;
+    }
+    if (bid != bid_end && bid->first.price() == price) {
+      bids_below += bid->second.regular;
+      ++bid;
+    }
+  }
+
+  // Market orders alone cross at the reference price
+  if (best.volume == 0 && reference != MARKET_ORDER_PRICE &&
+      market_bids > 0 && market_asks > 0) {
+    best.price = reference;
+    best.volume = (std::min)(market_bids, market_asks);
+    best.imbalance = market_bids > market_asks ?
+      market_bids - market_asks : market_asks - market_bids;
+  }
+  return best;
+}
+
+} }
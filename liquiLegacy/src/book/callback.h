@@ -7,7 +7,8 @@
 
 namespace liquibook { namespace book {
 
-template <class OrderPtr>
+// Default template arguments of OrderBook live on this first declaration
+template <class OrderPtr, class Listener = void, class Derived = void>
 class OrderBook;
 
 // Callback events
@@ -35,11 +36,33 @@ class OrderBook;
 //   Order replace reject
 //     - order replace reject
 
+/// @brief non-owning reference to an order pointer held by the book.
+///   The book keeps the referenced OrderPtr alive until the callback has been
+///   performed, so queuing a callback never copies (or reference counts) it.
+///   Converts to const OrderPtr& and forwards -> to the order.
+template <typename OrderPtr>
+class OrderHandle {
+public:
+  OrderHandle() : ptr_(nullptr) {}
+  explicit OrderHandle(const OrderPtr& order) : ptr_(&order) {}
+
+  operator const OrderPtr&() const { return *ptr_; }
+  const OrderPtr& operator->() const { return *ptr_; }
+  const OrderPtr& get() const { return *ptr_; }
+
+  /// @brief does this handle refer to an order?
+  bool valid() const { return ptr_ != nullptr; }
+
+private:
+  const OrderPtr* ptr_;
+};
+
 /// @brief notification from OrderBook of an event
 template <typename OrderPtr>
 class Callback {
 public:
   typedef OrderBook<OrderPtr > TypedOrderBook;
+  typedef OrderHandle<OrderPtr > Handle;
 
   enum CbType {
     cb_unknown,
@@ -99,8 +122,8 @@ public:
 
   static Callback<OrderPtr> book_update(const TypedOrderBook* book = nullptr);
   CbType type;
-  OrderPtr order;
-  OrderPtr matched_order;
+  Handle order;
+  Handle matched_order;
   Quantity quantity;
   Price price;
   uint8_t flags;
@@ -111,8 +134,8 @@ public:
 template <class OrderPtr>
 Callback<OrderPtr>::Callback()
 : type(cb_unknown),
-  order(nullptr),
-  matched_order(nullptr),
+  order(),
+  matched_order(),
   quantity(0),
   price(0),
   flags(0),
@@ -127,7 +150,7 @@ Callback<OrderPtr> Callback<OrderPtr>::accept(
 {
   Callback<OrderPtr> result;
   result.type = cb_order_accept;
-  result.order = order;
+  result.order = Handle(order);
   return result;
 }
 
@@ -137,7 +160,7 @@ Callback<OrderPtr> Callback<OrderPtr>::accept_stop(
 {
   Callback<OrderPtr> result;
   result.type = cb_order_accept_stop;
-  result.order = order;
+  result.order = Handle(order);
   return result;
 }
 
@@ -147,7 +170,7 @@ Callback<OrderPtr> Callback<OrderPtr>::trigger_stop(
 {
   Callback<OrderPtr> result;
   result.type = cb_order_trigger_stop;
-  result.order = order;
+  result.order = Handle(order);
   return result;
 }
 
@@ -158,7 +181,7 @@ Callback<OrderPtr> Callback<OrderPtr>::reject(
 {
   Callback<OrderPtr> result;
   result.type = cb_order_reject;
-  result.order = order;
+  result.order = Handle(order);
   result.reject_reason = reason;
   return result;
 }
@@ -173,8 +196,8 @@ Callback<OrderPtr> Callback<OrderPtr>::fill(
 {
   Callback<OrderPtr> result;
   result.type = cb_order_fill;
-  result.order = inbound_order;
-  result.matched_order = matched_order;
+  result.order = Handle(inbound_order);
+  result.matched_order = Handle(matched_order);
   result.quantity = fill_qty;
   result.price = fill_price;
   result.flags = fill_flags;
@@ -189,7 +212,7 @@ Callback<OrderPtr> Callback<OrderPtr>::cancel(
   // TODO save the open qty
   Callback<OrderPtr> result;
   result.type = cb_order_cancel;
-  result.order = order;
+  result.order = Handle(order);
   result.quantity = open_qty;
   return result;
 }
@@ -200,7 +223,7 @@ Callback<OrderPtr> Callback<OrderPtr>::cancel_stop(
 {
   Callback<OrderPtr> result;
   result.type = cb_order_cancel_stop;
-  result.order = order;
+  result.order = Handle(order);
   return result;
 }
 
@@ -211,7 +234,7 @@ Callback<OrderPtr> Callback<OrderPtr>::cancel_reject(
 {
   Callback<OrderPtr> result;
   result.type = cb_order_cancel_reject;
-  result.order = order;
+  result.order = Handle(order);
   result.reject_reason = reason;
   return result;
 }
@@ -223,10 +246,9 @@ Callback<OrderPtr> Callback<OrderPtr>::replace(
   const int64_t& size_delta,
   const Price& new_price)
 {
-  // TODO save the order open qty
   Callback<OrderPtr> result;
   result.type = cb_order_replace;
-  result.order = order;
+  result.order = Handle(order);
   result.quantity = curr_open_qty;
   result.delta = size_delta;
   result.price = new_price;
@@ -240,7 +262,7 @@ Callback<OrderPtr> Callback<OrderPtr>::replace_reject(
 {
   Callback<OrderPtr> result;
   result.type = cb_order_replace_reject;
-  result.order = order;
+  result.order = Handle(order);
   result.reject_reason = reason;
   return result;
 }
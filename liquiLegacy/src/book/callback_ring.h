@@ -0,0 +1,99 @@
+// Copyright (c) 2012 - 2017 Object Computing, Inc.
+// All rights reserved.
+// See the file license.txt for licensing information.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+namespace liquibook { namespace book {
+
+/// @brief FIFO of callback records in a preallocated power-of-two ring.
+///   Records are copied in and out by value, so they must be trivially
+///   copyable.  The ring only allocates when a command queues more records
+///   than it has ever held before; it then doubles and keeps its contents.
+template <typename Record>
+class CallbackRing {
+  static_assert(std::is_trivially_copyable<Record>::value,
+                "callback records must be trivially copyable");
+public:
+  /// @brief construct
+  /// @param capacity initial capacity, rounded up to a power of two
+  explicit CallbackRing(size_t capacity = 64);
+
+  /// @brief grow to hold at least capacity records (never shrinks)
+  void reserve(size_t capacity);
+
+  /// @brief number of queued records
+  size_t size() const { return size_t(tail_ - head_); }
+
+  /// @brief is the ring empty?
+  bool empty() const { return head_ == tail_; }
+
+  /// @brief number of records the ring holds without growing
+  size_t capacity() const { return slots_.size(); }
+
+  /// @brief queue a record at the back
+  void push_back(const Record& record);
+
+  /// @brief access a queued record, 0 being the front
+  Record& operator[](size_t index) { return slots_[(head_ + index) & mask_]; }
+
+  /// @brief remove and return the front record
+  Record pop_front() { return slots_[head_++ & mask_]; }
+
+  /// @brief drop all queued records
+  void clear() { head_ = tail_; }
+
+private:
+  std::vector<Record> slots_;
+  size_t mask_;
+  uint64_t head_;
+  uint64_t tail_;
+};
+
+template <typename Record>
+CallbackRing<Record>::CallbackRing(size_t capacity)
+: mask_(0),
+  head_(0),
+  tail_(0)
+{
+  reserve(capacity);
+}
+
+template <typename Record>
+void
+CallbackRing<Record>::reserve(size_t capacity)
+{
+  size_t rounded = 1;
+  while (rounded < capacity) {
+    rounded <<= 1;
+  }
+  if (rounded <= slots_.size()) {
+    return;
+  }
+  // Unwrap the queued records to the front of the new ring
+  std::vector<Record> slots(rounded);
+  size_t count = size();
+  for (size_t i = 0; i < count; ++i) {
+    slots[i] = (*this)[i];
+  }
+  slots_.swap(slots);
+  mask_ = rounded - 1;
+  head_ = 0;
+  tail_ = count;
+}
+
+template <typename Record>
+inline void
+CallbackRing<Record>::push_back(const Record& record)
+{
+  if (size() == slots_.size()) {
+    reserve(slots_.size() * 2);
+  }
+  slots_[tail_++ & mask_] = record;
+}
+
+} }
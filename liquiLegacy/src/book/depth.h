@@ -10,12 +10,19 @@
 #include <cmath>
 #include <string.h>
 #include <functional>
+#include <algorithm>
 
 namespace liquibook { namespace book {
 /// @brief container of limit order data aggregated by price.  Designed so that
 ///    the depth levels themselves are easily copyable with a single memcpy
 ///    when used with a separate callback thread.
 ///
+///    Alongside the levels, each side keeps an aligned lane holding just the
+///    level prices.  Level search is a branch-free count over that lane, which
+///    the compiler can vectorize, instead of a walk over the level structs.
+///    The lanes mirror levels_ and are only written by this class, so levels
+///    must not be re-priced through the mutable accessors.
+///
 /// TODO: Fix the bid and ask methods to behave like a normal iterator (i.e. begin(), back(), and end()
 
 template <int SIZE=5> 
@@ -50,6 +57,13 @@ public:
   /// @param is_bid indicator of bid or ask
   void add_order(Price price, Quantity qty, bool is_bid);
 
+  /// @brief add several orders resting at one price
+  /// @param price the price level of the orders
+  /// @param qty the total open quantity of the orders
+  /// @param count the number of orders
+  /// @param is_bid indicator of bid or ask
+  void add_orders(Price price, Quantity qty, uint32_t count, bool is_bid);
+
   /// @brief ignore future fill quantity on a side, due to a match at 
   ///        accept time for an order
   /// @param qty the open quantity to ignore
@@ -115,6 +129,12 @@ public:
 
 private:
   DepthLevel levels_[SIZE*2];
+  // Price lanes mirroring levels_ (bids best first, then asks best first)
+  alignas(64) Price bid_prices_[SIZE];
+  alignas(64) Price ask_prices_[SIZE];
+  // Number of valid visible levels on each side
+  size_t bid_level_count_;
+  size_t ask_level_count_;
   ChangeId last_change_;
   ChangeId last_published_change_;
   Quantity ignore_bid_fill_qty_;
@@ -144,16 +164,39 @@ private:
   /// @param level the level to erase
   /// @param is_bid indicator of bid or ask
   void erase_level(DepthLevel* level, bool is_bid);
+
+  /// @brief count the visible levels priced better than price
+  /// @param price the price to compare to
+  /// @param is_bid indicator of bid or ask
+  /// @return index of the first visible level not better than price
+  size_t better_level_count(Price price, bool is_bid) const;
+
+  /// @brief count of the valid visible levels on a side
+  size_t& valid_level_count(bool is_bid)
+  {
+    return is_bid ? bid_level_count_ : ask_level_count_;
+  }
+
+  /// @brief get the price lane of a side
+  Price* price_lane(bool is_bid) { return is_bid ? bid_prices_ : ask_prices_; }
+  const Price* price_lane(bool is_bid) const
+  {
+    return is_bid ? bid_prices_ : ask_prices_;
+  }
 };
 
 template <int SIZE> 
 Depth<SIZE>::Depth()
-: last_change_(0),
+: bid_level_count_(0),
+  ask_level_count_(0),
+  last_change_(0),
   last_published_change_(0),
   ignore_bid_fill_qty_(0),
   ignore_ask_fill_qty_(0)
 {
   memset(levels_, 0, sizeof(DepthLevel) * SIZE * 2);
+  memset(bid_prices_, 0, sizeof(bid_prices_));
+  memset(ask_prices_, 0, sizeof(ask_prices_));
 }
 
 template <int SIZE> 
@@ -237,6 +280,21 @@ Depth<SIZE>::add_order(Price price, Quantity qty, bool is_bid)
   }
 }
 
+template <int SIZE> 
+inline void
+Depth<SIZE>::add_orders(Price price, Quantity qty, uint32_t count, bool is_bid)
+{
+  ChangeId last_change_copy = last_change_;
+  DepthLevel* level = find_level(price, is_bid);
+  if (level) {
+    level->add_orders(qty, count);
+    if (!level->is_excess()) {
+      last_change_ = last_change_copy + 1; // Ensure incremented
+      level->last_change(last_change_copy + 1);
+    }
+  }
+}
+
 template <int SIZE> 
 inline void
 Depth<SIZE>::ignore_fill_qty(Quantity qty, bool is_bid)
@@ -375,35 +433,54 @@ Depth<SIZE>::needs_ask_restoration(Price& restoration_price)
   throw std::runtime_error("Depth size less than one not allowed");
 }
 
+template <int SIZE> 
+inline size_t
+Depth<SIZE>::better_level_count(Price price, bool is_bid) const
+{
+  // Visible levels are contiguous from the front of each side and sorted, so
+  // the position of price is the number of valid levels priced better.
+  // Written as a branch-free reduction over the lane so it vectorizes.
+  const Price* lane = price_lane(is_bid);
+  size_t count = 0;
+  if (is_bid) {
+    // Blank bid levels are 0, never better than a limit price
+    for (int i = 0; i < SIZE; ++i) {
+      count += (lane[i] > price);
+    }
+  } else {
+    // Blank ask levels are 0, which wraps to the largest value here
+    for (int i = 0; i < SIZE; ++i) {
+      count += ((lane[i] - 1) < (price - 1));
+    }
+  }
+  return count;
+}
+
 template <int SIZE> 
 DepthLevel*
 Depth<SIZE>::find_level(Price price, bool is_bid, bool should_create)
 {
-  // Find starting and ending point
-  DepthLevel* level = is_bid ? bids() : asks();
-  const DepthLevel* past_end = is_bid ? asks() : end();
-  // Linear search each level
-  for ( ; level != past_end; ++level) {
-    if (level->price() == price) {
-      break;
+  DepthLevel* side = is_bid ? bids() : asks();
+  Price* lane = price_lane(is_bid);
+  DepthLevel* level = nullptr;
+  size_t index = better_level_count(price, is_bid);
+  if (index < size_t(SIZE)) {
+    if (lane[index] == price) {
+      level = side + index;
     // Else if the level is blank
-    } else if (should_create && level->price() == INVALID_LEVEL_PRICE) {
+    } else if (should_create && lane[index] == INVALID_LEVEL_PRICE) {
+      level = side + index;
       level->init(price, false);  // Change ID will be assigned by caller
-      break;  // Blank slot
-    // Else if the bid level price is too low
-    } else if (is_bid && should_create && level->price() < price) {
-      // Insert a slot
-      insert_level_before(level, is_bid, price);
-      break;
-    // Else if the ask level price is too high
-    } else if ((!is_bid) && should_create && level->price() > price) {
-      // Insert a slot
+      lane[index] = price;
+      ++valid_level_count(is_bid);
+    // Else the level is worse, insert a slot
+    } else if (should_create) {
+      level = side + index;
       insert_level_before(level, is_bid, price);
-      break;
     }
   }
-  // If level was not found
-  if (level == past_end) {
+  // If level was not found among the visible levels
+  if (!level) {
     if (is_bid) {
       // Search in excess bid levels
       BidLevelMap::iterator find_result = excess_bid_levels_.find(price);
@@ -445,10 +522,14 @@ Depth<SIZE>::insert_level_before(DepthLevel* level,
                                  bool is_bid,
                                  Price price)
 {
-  DepthLevel* last_side_level = is_bid ? last_bid_level() : last_ask_level();
+  DepthLevel* side = is_bid ? bids() : asks();
+  Price* lane = price_lane(is_bid);
+  DepthLevel* last_side_level = side + (SIZE - 1);
+  const size_t index = level - side;
+  size_t& valid = valid_level_count(is_bid);
 
   // If the last level has valid data
-  if (last_side_level->price() != INVALID_LEVEL_PRICE) {
+  if (valid == size_t(SIZE)) {
     DepthLevel excess_level;
     excess_level.init(0, true);  // Will assign over price
     excess_level = *last_side_level;
@@ -461,23 +542,22 @@ Depth<SIZE>::insert_level_before(DepthLevel* level,
       std::make_pair(last_side_level->price(), excess_level));
     }
   }
-  // Back from end
-  DepthLevel* current_level = last_side_level - 1;
+  // Only valid levels need to move; blank levels past them stay blank
+  const size_t moved_end = valid < size_t(SIZE - 1) ? valid : size_t(SIZE - 1);
   // Increment only once
   ++last_change_;
-  // Last level to process is one passed in
-  while (current_level >= level) {
-    // Copy level to level one lower
-    *(current_level + 1) = *current_level;
-    // If the level being copied is valid
-    if (current_level->price() != INVALID_LEVEL_PRICE) {
-      // Update change Id
-      (current_level + 1)->last_change(last_change_);
+  if (index < moved_end) {
+    std::copy_backward(side + index, side + moved_end, side + moved_end + 1);
+    std::copy_backward(lane + index, lane + moved_end, lane + moved_end + 1);
+    for (size_t i = index + 1; i <= moved_end; ++i) {
+      side[i].last_change(last_change_);
     }
-    // Move back one
-    --current_level;
-   }
-   level->init(price, false);
+  }
+  level->init(price, false);
+  lane[index] = price;
+  if (valid < size_t(SIZE)) {
+    ++valid;
+  }
 }
 
 template <int SIZE> 
@@ -493,28 +573,25 @@ Depth<SIZE>::erase_level(DepthLevel* level, bool is_bid)
     }
   // Else the level being erased is not excess, copy over from those worse
   } else {
-    DepthLevel* last_side_level = is_bid ? last_bid_level() : last_ask_level();
+    DepthLevel* side = is_bid ? bids() : asks();
+    Price* lane = price_lane(is_bid);
+    DepthLevel* last_side_level = side + (SIZE - 1);
+    const size_t index = level - side;
+    size_t& valid = valid_level_count(is_bid);
     // Increment once
     ++last_change_;
-    DepthLevel* current_level = level;
-    // Level to end
-    while (current_level < last_side_level) {
-      // If this is the first level, or the level to be overwritten is valid
-      // (must force first level, when called already should be invalidated)
-      if ((current_level->price() != INVALID_LEVEL_PRICE) ||
-          (current_level == level)) {
-        // Copy to current level from one lower
-        *current_level = *(current_level + 1);
-        // Mark the current level as updated
-        current_level->last_change(last_change_);
+    // Shift the worse valid levels (and the first blank, if any) up by one
+    const size_t shift_end = valid < size_t(SIZE - 1) ? valid : size_t(SIZE - 1);
+    if (index < shift_end) {
+      std::copy(side + index + 1, side + shift_end + 1, side + index);
+      std::copy(lane + index + 1, lane + shift_end + 1, lane + index);
+      for (size_t i = index; i < shift_end; ++i) {
+        side[i].last_change(last_change_);
       }
-      // Move forward one
-      ++current_level;
     }
 
     // If I erased the last level, or the last level was valid
-    if ((level == last_side_level) ||
-        (last_side_level->price() != INVALID_LEVEL_PRICE)) {
+    if ((level == last_side_level) || (valid == size_t(SIZE))) {
       // Attempt to restore last level from excess
       if (is_bid) {
         BidLevelMap::iterator best_bid = excess_bid_levels_.begin();
@@ -524,7 +601,6 @@ Depth<SIZE>::erase_level(DepthLevel* level, bool is_bid)
         } else {
           // Nothing to restore, last level is blank
           last_side_level->init(INVALID_LEVEL_PRICE, false);
-          last_side_level->last_change(last_change_);
         }
       } else {
         AskLevelMap::iterator best_ask = excess_ask_levels_.begin();
@@ -534,10 +610,15 @@ Depth<SIZE>::erase_level(DepthLevel* level, bool is_bid)
         } else {
           // Nothing to restore, last level is blank
           last_side_level->init(INVALID_LEVEL_PRICE, false);
-          last_side_level->last_change(last_change_);
         }
       }
       last_side_level->last_change(last_change_);
+      lane[SIZE - 1] = last_side_level->price();
+      if (lane[SIZE - 1] == INVALID_LEVEL_PRICE) {
+        --valid;
+      }
+    } else {
+      --valid;
     }
   }
 }
@@ -31,6 +31,11 @@ public:
   /// @param qty open quantity of the order
   void add_order(Quantity qty);
 
+  /// @brief add several orders to the level at once
+  /// @param qty total open quantity of the orders
+  /// @param count number of orders
+  void add_orders(Quantity qty, uint32_t count);
+
   /// @brief increase the quantity of existing orders
   /// @param qty amount to increase the quantity by
   void increase_qty(Quantity qty);
@@ -143,6 +148,14 @@ DepthLevel::add_order(Quantity qty)
   aggregate_qty_ += qty;
 }
 
+inline
+void
+DepthLevel::add_orders(Quantity qty, uint32_t count)
+{
+  order_count_ += count;
+  aggregate_qty_ += qty;
+}
+
 inline
 bool
 DepthLevel::close_order(Quantity qty)
@@ -5,16 +5,35 @@
 
 #include "order_book.h"
 #include "depth.h"
+#include "full_depth.h"
 #include "bbo_listener.h"
 #include "depth_listener.h"
 
 namespace liquibook { namespace book {
 
+template <typename OrderPtr, int SIZE = 5, class Listener = void>
+class DepthOrderBook;
+
+/// @brief base of DepthOrderBook: the plain OrderBook with virtual hooks, or
+///        with a compile-time Listener, one that calls back into the depth
+///        book directly
+template <typename OrderPtr, int SIZE, class Listener>
+using DepthOrderBookBase = OrderBook<OrderPtr, Listener,
+  typename std::conditional<std::is_void<Listener>::value,
+    void, DepthOrderBook<OrderPtr, SIZE, Listener> >::type>;
+
 /// @brief Implementation of order book child class, that incorporates
 ///        aggregate depth tracking.  
-template <typename OrderPtr, int SIZE = 5>
-class DepthOrderBook : public OrderBook<OrderPtr> {
+///
+/// With a Listener type, depth and BBO changes also go to that listener
+/// directly if it implements DepthListener / BboListener for this book.
+///
+/// Depth and BBO listeners hear at most once per book update: once per
+/// request, or once per hold_book_updates() scope.
+template <typename OrderPtr, int SIZE, class Listener>
+class DepthOrderBook : public DepthOrderBookBase<OrderPtr, SIZE, Listener> {
 public:
+  typedef DepthOrderBookBase<OrderPtr, SIZE, Listener> Base;
   typedef Depth<SIZE> DepthTracker;
   typedef BboListener<DepthOrderBook >TypedBboListener;
   typedef DepthListener<DepthOrderBook >TypedDepthListener;
@@ -34,6 +53,9 @@ public:
   // @brief access the depth tracker
   const DepthTracker& depth() const;
 
+  // @brief access the unbounded depth tracker
+  const FullDepth& full_depth() const;
+
   protected:
   //////////////////////////////////
   // Implement virtual callback methods
@@ -59,37 +81,43 @@ public:
 
   virtual void on_order_book_change();
 
+  virtual void on_bulk_load(const std::vector<OrderPtr>& orders);
+
 private:
+  // Base calls the hooks above directly when Listener is given
+  friend Base;
+
   DepthTracker depth_;
+  FullDepth full_depth_;
   TypedBboListener* bbo_listener_;
   TypedDepthListener* depth_listener_;
 };
 
-template <class OrderPtr, int SIZE>
-DepthOrderBook<OrderPtr, SIZE>::DepthOrderBook(const std::string & symbol)
-: OrderBook<OrderPtr>(symbol),
+template <class OrderPtr, int SIZE, class Listener>
+DepthOrderBook<OrderPtr, SIZE, Listener>::DepthOrderBook(const std::string & symbol)
+: Base(symbol),
   bbo_listener_(nullptr),
   depth_listener_(nullptr)
 {
 }
 
-template <class OrderPtr, int SIZE>
+template <class OrderPtr, int SIZE, class Listener>
 void
-DepthOrderBook<OrderPtr, SIZE>::set_bbo_listener(TypedBboListener* listener)
+DepthOrderBook<OrderPtr, SIZE, Listener>::set_bbo_listener(TypedBboListener* listener)
 {
   bbo_listener_ = listener;
 }
 
-template <class OrderPtr, int SIZE>
+template <class OrderPtr, int SIZE, class Listener>
 void
-DepthOrderBook<OrderPtr, SIZE>::set_depth_listener(TypedDepthListener* listener)
+DepthOrderBook<OrderPtr, SIZE, Listener>::set_depth_listener(TypedDepthListener* listener)
 {
   depth_listener_ = listener;
 }
 
-template <class OrderPtr, int SIZE> 
+template <class OrderPtr, int SIZE, class Listener> 
 void 
-DepthOrderBook<OrderPtr, SIZE>::on_accept(const OrderPtr& order, Quantity quantity)
+DepthOrderBook<OrderPtr, SIZE, Listener>::on_accept(const OrderPtr& order, Quantity quantity)
 {
   // If the order is a limit order
   if (order->is_limit())
@@ -101,6 +129,7 @@ DepthOrderBook<OrderPtr, SIZE>::on_accept(const OrderPtr& order, Quantity quanti
       // Don't tell depth about this order - it's going away immediately.
       // Instead tell Depth about future fills to ignore
       depth_.ignore_fill_qty(quantity, order->is_buy());
+      full_depth_.ignore_fill_qty(quantity, order->is_buy());
     } 
     else 
     {
@@ -108,27 +137,31 @@ DepthOrderBook<OrderPtr, SIZE>::on_accept(const OrderPtr& order, Quantity quanti
       depth_.add_order(order->price(), 
         order->order_qty(), 
         order->is_buy());
+      full_depth_.add_order(order->price(),
+        order->order_qty(),
+        order->is_buy());
     }
   }
 }
 
-template <class OrderPtr, int SIZE> 
+template <class OrderPtr, int SIZE, class Listener> 
 void 
-DepthOrderBook<OrderPtr, SIZE>::on_accept_stop(const OrderPtr& order)
+DepthOrderBook<OrderPtr, SIZE, Listener>::on_accept_stop(const OrderPtr& order)
 {
 }
 
-template <class OrderPtr, int SIZE> 
+template <class OrderPtr, int SIZE, class Listener> 
 void 
-DepthOrderBook<OrderPtr, SIZE>::on_trigger_stop(const OrderPtr& order)
+DepthOrderBook<OrderPtr, SIZE, Listener>::on_trigger_stop(const OrderPtr& order)
 {
   // Add to depth
   depth_.add_order(order->price(), order->order_qty(), order->is_buy());
+  full_depth_.add_order(order->price(), order->order_qty(), order->is_buy());
 }
 
-template <class OrderPtr, int SIZE> 
+template <class OrderPtr, int SIZE, class Listener> 
 void 
-DepthOrderBook<OrderPtr, SIZE>::on_fill(const OrderPtr& order, 
+DepthOrderBook<OrderPtr, SIZE, Listener>::on_fill(const OrderPtr& order, 
   const OrderPtr& matched_order, 
   Quantity quantity, 
   Price fill_price,
@@ -142,6 +175,10 @@ DepthOrderBook<OrderPtr, SIZE>::on_fill(const OrderPtr& order,
       quantity,
       matched_order_filled,
       matched_order->is_buy());
+    full_depth_.fill_order(matched_order->price(),
+      quantity,
+      matched_order_filled,
+      matched_order->is_buy());
   }
   // If the inbound order is a limit order
   if (order->is_limit()) {
@@ -150,12 +187,16 @@ DepthOrderBook<OrderPtr, SIZE>::on_fill(const OrderPtr& order,
       quantity,
       inbound_order_filled,
       order->is_buy());
+    full_depth_.fill_order(order->price(),
+      quantity,
+      inbound_order_filled,
+      order->is_buy());
   }
 }
 
-template <class OrderPtr, int SIZE> 
+template <class OrderPtr, int SIZE, class Listener> 
 void 
-DepthOrderBook<OrderPtr, SIZE>::on_cancel(const OrderPtr& order, Quantity quantity)
+DepthOrderBook<OrderPtr, SIZE, Listener>::on_cancel(const OrderPtr& order, Quantity quantity)
 {
   // If the order is a limit order
   if (order->is_limit()) {
@@ -163,19 +204,22 @@ DepthOrderBook<OrderPtr, SIZE>::on_cancel(const OrderPtr& order, Quantity quanti
     depth_.close_order(order->price(), 
       quantity, 
       order->is_buy());
+    full_depth_.close_order(order->price(),
+      quantity,
+      order->is_buy());
   }
 }
 
-template <class OrderPtr, int SIZE> 
+template <class OrderPtr, int SIZE, class Listener> 
 void 
-DepthOrderBook<OrderPtr, SIZE>::on_cancel_stop(const OrderPtr& order)
+DepthOrderBook<OrderPtr, SIZE, Listener>::on_cancel_stop(const OrderPtr& order)
 {
   // nothing to do for STOP until triggered/submitted
 }
 
-template <class OrderPtr, int SIZE> 
+template <class OrderPtr, int SIZE, class Listener> 
 void 
-DepthOrderBook<OrderPtr, SIZE>::on_replace(const OrderPtr& order,
+DepthOrderBook<OrderPtr, SIZE, Listener>::on_replace(const OrderPtr& order,
   Quantity current_qty, 
   Quantity new_qty,
   Price new_price)
@@ -183,42 +227,98 @@ DepthOrderBook<OrderPtr, SIZE>::on_replace(const OrderPtr& order,
   // Notify the depth
   depth_.replace_order(order->price(), new_price, 
     current_qty, new_qty, order->is_buy());
+  full_depth_.replace_order(order->price(), new_price,
+    current_qty, new_qty, order->is_buy());
 }
 
-template <class OrderPtr, int SIZE> 
+template <class OrderPtr, int SIZE, class Listener> 
 void 
-DepthOrderBook<OrderPtr, SIZE>::on_order_book_change()
+DepthOrderBook<OrderPtr, SIZE, Listener>::on_bulk_load(const std::vector<OrderPtr>& orders)
 {
-  // Book was updated, see if the depth we track was effected
-  if (depth_.changed()) {
-    if (depth_listener_) {
-      depth_listener_->on_depth_change(this, &depth_);
+  // Aggregate each run of same side, same price orders into one level update
+  auto run = orders.begin();
+  while (run != orders.end()) {
+    bool is_bid = (*run)->is_buy();
+    Price price = (*run)->price();
+    Quantity qty = 0;
+    uint32_t count = 0;
+    auto pos = run;
+    for (; pos != orders.end() && (*pos)->is_buy() == is_bid &&
+           (*pos)->price() == price; ++pos) {
+      qty += (*pos)->order_qty();
+      ++count;
     }
-    if (bbo_listener_) {
-      ChangeId last_change = depth_.last_published_change();
-      // May have been the first level which changed
-      if ((depth_.bids()->changed_since(last_change)) ||
-        (depth_.asks()->changed_since(last_change))) {
-        bbo_listener_->on_bbo_change(this, &depth_);
+    depth_.add_orders(price, qty, count, is_bid);
+    full_depth_.add_orders(price, qty, count, is_bid);
+    run = pos;
+  }
+}
+
+template <class OrderPtr, int SIZE, class Listener> 
+void 
+DepthOrderBook<OrderPtr, SIZE, Listener>::on_order_book_change()
+{
+  // Book was updated, see if the depth we track was effected.  Levels
+  // beyond the fixed Depth only show up as a FullDepth change.
+  if (depth_.changed() || full_depth_.changed()) {
+    if constexpr (Base::static_listener) {
+      constexpr bool depth_role =
+        std::is_base_of<TypedDepthListener, Listener>::value;
+      constexpr bool bbo_role =
+        std::is_base_of<TypedBboListener, Listener>::value;
+      Listener* listener = this->listener();
+      if constexpr (depth_role) {
+        if (listener) {
+          listener->Listener::on_depth_change(this, &depth_);
+        }
+      }
+      if constexpr (bbo_role) {
+        if (listener) {
+          ChangeId last_change = depth_.last_published_change();
+          if ((depth_.bids()->changed_since(last_change)) ||
+            (depth_.asks()->changed_since(last_change))) {
+            listener->Listener::on_bbo_change(this, &depth_);
+          }
+        }
+      }
+    } else {
+      if (depth_listener_) {
+        depth_listener_->on_depth_change(this, &depth_);
+      }
+      if (bbo_listener_) {
+        ChangeId last_change = depth_.last_published_change();
+        // May have been the first level which changed
+        if ((depth_.bids()->changed_since(last_change)) ||
+          (depth_.asks()->changed_since(last_change))) {
+          bbo_listener_->on_bbo_change(this, &depth_);
+        }
       }
     }
     // Start tracking changes again...
     depth_.published();
+    full_depth_.published();
   }
 }
 
-template <class OrderPtr, int SIZE>
-inline typename DepthOrderBook<OrderPtr, SIZE>::DepthTracker&
-DepthOrderBook<OrderPtr, SIZE>::depth()
+template <class OrderPtr, int SIZE, class Listener>
+inline typename DepthOrderBook<OrderPtr, SIZE, Listener>::DepthTracker&
+DepthOrderBook<OrderPtr, SIZE, Listener>::depth()
 {
   return depth_;
 }
 
-template <class OrderPtr, int SIZE>
-inline const typename DepthOrderBook<OrderPtr, SIZE>::DepthTracker&
-DepthOrderBook<OrderPtr, SIZE>::depth() const
+template <class OrderPtr, int SIZE, class Listener>
+inline const typename DepthOrderBook<OrderPtr, SIZE, Listener>::DepthTracker&
+DepthOrderBook<OrderPtr, SIZE, Listener>::depth() const
 {
   return depth_;
 }
 
+template <class OrderPtr, int SIZE, class Listener>
+inline const FullDepth&
+DepthOrderBook<OrderPtr, SIZE, Listener>::full_depth() const
+{
+  return full_depth_;
+}
+
 } }
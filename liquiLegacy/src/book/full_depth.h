@@ -0,0 +1,360 @@
+// Copyright (c) 2012 - 2017 Object Computing, Inc.
+// All rights reserved.
+// See the file license.txt for licensing information.
+#pragma once
+
+#include "depth_constants.h"
+#include "depth_level.h"
+#include <stdexcept>
+#include <map>
+#include <vector>
+#include <cmath>
+#include <functional>
+
+namespace liquibook { namespace book {
+
+/// @brief one step of a cumulative quantity ladder
+struct LadderStep {
+  Price price;
+  Quantity qty;
+  Quantity cumulative_qty;
+  uint32_t order_count;
+};
+
+/// @brief unbounded container of limit order data aggregated by price.
+///    Unlike Depth<SIZE>, every price level is visible.  Each side is kept in
+///    a price-ordered map so a level update is O(log n) in the number of
+///    levels on that side, and the best N levels are read from the front of
+///    the map without touching individual orders.
+///
+///    Mutations mirror those of Depth<SIZE>, so the two can be driven from the
+///    same order book callbacks.
+class FullDepth {
+public:
+  typedef std::map<Price, DepthLevel, std::greater<Price> > BidLevelMap;
+  typedef std::map<Price, DepthLevel, std::less<Price> > AskLevelMap;
+
+  /// @brief construct
+  FullDepth();
+
+  /// @brief add an order
+  /// @param price the price level of the order
+  /// @param qty the open quantity of the order
+  /// @param is_bid indicator of bid or ask
+  void add_order(Price price, Quantity qty, bool is_bid);
+
+  /// @brief add several orders resting at one price
+  /// @param price the price level of the orders
+  /// @param qty the total open quantity of the orders
+  /// @param count the number of orders
+  /// @param is_bid indicator of bid or ask
+  void add_orders(Price price, Quantity qty, uint32_t count, bool is_bid);
+
+  /// @brief ignore future fill quantity on a side, due to a match at
+  ///        accept time for an order
+  /// @param qty the open quantity to ignore
+  /// @param is_bid indicator of bid or ask
+  void ignore_fill_qty(Quantity qty, bool is_bid);
+
+  /// @brief handle an order fill
+  /// @param price the price level of the order
+  /// @param fill_qty the quantity of this fill
+  /// @param filled was this order completely filled?
+  /// @param is_bid indicator of bid or ask
+  void fill_order(Price price,
+                  Quantity fill_qty,
+                  bool filled,
+                  bool is_bid);
+
+  /// @brief cancel or fill an order
+  /// @param price the price level of the order
+  /// @param open_qty the open quantity of the order
+  /// @param is_bid indicator of bid or ask
+  /// @return true if the close erased a level
+  bool close_order(Price price, Quantity open_qty, bool is_bid);
+
+  /// @brief change quantity of an order
+  /// @param price the price level of the order
+  /// @param qty_delta the change in open quantity of the order (+ or -)
+  /// @param is_bid indicator of bid or ask
+  void change_qty_order(Price price, int64_t qty_delta, bool is_bid);
+
+  /// @brief replace a order
+  /// @param current_price the current price level of the order
+  /// @param new_price the new price level of the order
+  /// @param current_qty the current open quantity of the order
+  /// @param new_qty the new open quantity of the order
+  /// @param is_bid indicator of bid or ask
+  /// @return true if the close erased a level
+  bool replace_order(Price current_price,
+                     Price new_price,
+                     Quantity current_qty,
+                     Quantity new_qty,
+                     bool is_bid);
+
+  /// @brief number of bid price levels
+  size_t bid_level_count() const { return bids_.size(); }
+  /// @brief number of ask price levels
+  size_t ask_level_count() const { return asks_.size(); }
+
+  /// @brief access all bid levels, best first
+  const BidLevelMap& bids() const { return bids_; }
+  /// @brief access all ask levels, best first
+  const AskLevelMap& asks() const { return asks_; }
+
+  /// @brief copy the best levels of a side, best first
+  /// @param is_bid indicator of bid or ask
+  /// @param n maximum number of levels to copy (0 for all)
+  /// @param levels destination, cleared first (out)
+  /// @return number of levels copied
+  size_t top_n(bool is_bid, size_t n, std::vector<DepthLevel>& levels) const;
+
+  /// @brief build a cumulative quantity ladder for a side, best first
+  /// @param is_bid indicator of bid or ask
+  /// @param n maximum number of levels to include (0 for all)
+  /// @param ladder destination, cleared first (out)
+  /// @return number of steps produced
+  size_t ladder(bool is_bid, size_t n, std::vector<LadderStep>& ladder) const;
+
+  /// @brief what was the ID of the last change?
+  ChangeId last_change() const { return last_change_; }
+
+  /// @brief has any level changed since the last publish
+  bool changed() const { return last_change_ > last_published_change_; }
+
+  /// @brief what was the ID of the last published change?
+  ChangeId last_published_change() const { return last_published_change_; }
+
+  /// @brief note the ID of last published change
+  void published() { last_published_change_ = last_change_; }
+
+private:
+  BidLevelMap bids_;
+  AskLevelMap asks_;
+  ChangeId last_change_;
+  ChangeId last_published_change_;
+  Quantity ignore_bid_fill_qty_;
+  Quantity ignore_ask_fill_qty_;
+
+  /// @brief find the level associated with the price
+  /// @param price the price to find
+  /// @param is_bid indicator of bid or ask
+  /// @param should_create should a level for the price be created, if necessary
+  /// @return the level, or nullptr if not found and not created
+  DepthLevel* find_level(Price price, bool is_bid, bool should_create = true);
+
+  /// @brief erase an emptied level
+  void erase_level(Price price, bool is_bid);
+
+  template <class LevelMap>
+  static size_t copy_levels(const LevelMap& side,
+                            size_t n,
+                            std::vector<DepthLevel>& levels);
+
+  template <class LevelMap>
+  static size_t build_ladder(const LevelMap& side,
+                             size_t n,
+                             std::vector<LadderStep>& ladder);
+};
+
+inline
+FullDepth::FullDepth()
+: last_change_(0),
+  last_published_change_(0),
+  ignore_bid_fill_qty_(0),
+  ignore_ask_fill_qty_(0)
+{
+}
+
+inline void
+FullDepth::add_order(Price price, Quantity qty, bool is_bid)
+{
+  DepthLevel* level = find_level(price, is_bid);
+  level->add_order(qty);
+  level->last_change(++last_change_);
+}
+
+inline void
+FullDepth::add_orders(Price price, Quantity qty, uint32_t count, bool is_bid)
+{
+  DepthLevel* level = find_level(price, is_bid);
+  level->add_orders(qty, count);
+  level->last_change(++last_change_);
+}
+
+inline void
+FullDepth::ignore_fill_qty(Quantity qty, bool is_bid)
+{
+  if (is_bid) {
+    if (ignore_bid_fill_qty_) {
+      throw std::runtime_error("Unexpected ignore_bid_fill_qty_");
+    }
+    ignore_bid_fill_qty_ = qty;
+  } else {
+    if (ignore_ask_fill_qty_) {
+      throw std::runtime_error("Unexpected ignore_ask_fill_qty_");
+    }
+    ignore_ask_fill_qty_ = qty;
+  }
+}
+
+inline void
+FullDepth::fill_order(
+  Price price,
+  Quantity fill_qty,
+  bool filled,
+  bool is_bid)
+{
+  if (is_bid && ignore_bid_fill_qty_) {
+    ignore_bid_fill_qty_ -= fill_qty;
+  } else if ((!is_bid) && ignore_ask_fill_qty_) {
+    ignore_ask_fill_qty_ -= fill_qty;
+  } else if (filled) {
+    close_order(price, fill_qty, is_bid);
+  } else {
+    change_qty_order(price, -(int64_t)fill_qty, is_bid);
+  }
+}
+
+inline bool
+FullDepth::close_order(Price price, Quantity open_qty, bool is_bid)
+{
+  DepthLevel* level = find_level(price, is_bid, false);
+  if (level) {
+    ++last_change_;
+    // If this is the last order on the level
+    if (level->close_order(open_qty)) {
+      erase_level(price, is_bid);
+      return true;
+    }
+    level->last_change(last_change_);
+  }
+  return false;
+}
+
+inline void
+FullDepth::change_qty_order(Price price, int64_t qty_delta, bool is_bid)
+{
+  DepthLevel* level = find_level(price, is_bid, false);
+  if (level && qty_delta) {
+    if (qty_delta > 0) {
+      level->increase_qty(Quantity(qty_delta));
+    } else {
+      level->decrease_qty(Quantity(std::abs(qty_delta)));
+    }
+    level->last_change(++last_change_);
+  }
+}
+
+inline bool
+FullDepth::replace_order(
+  Price current_price,
+  Price new_price,
+  Quantity current_qty,
+  Quantity new_qty,
+  bool is_bid)
+{
+  bool erased = false;
+  // If the price is unchanged, modify this level only
+  if (current_price == new_price) {
+    int64_t qty_delta = ((int64_t)new_qty) - current_qty;
+    change_qty_order(current_price, qty_delta, is_bid);
+  // Else this is a price change
+  } else {
+    add_order(new_price, new_qty, is_bid);
+    erased = close_order(current_price, current_qty, is_bid);
+  }
+  return erased;
+}
+
+inline size_t
+FullDepth::top_n(bool is_bid, size_t n, std::vector<DepthLevel>& levels) const
+{
+  return is_bid ? copy_levels(bids_, n, levels)
+                : copy_levels(asks_, n, levels);
+}
+
+inline size_t
+FullDepth::ladder(bool is_bid, size_t n, std::vector<LadderStep>& ladder) const
+{
+  return is_bid ? build_ladder(bids_, n, ladder)
+                : build_ladder(asks_, n, ladder);
+}
+
+inline DepthLevel*
+FullDepth::find_level(Price price, bool is_bid, bool should_create)
+{
+  if (is_bid) {
+    BidLevelMap::iterator pos = bids_.lower_bound(price);
+    if (pos != bids_.end() && pos->first == price) {
+      return &pos->second;
+    } else if (should_create) {
+      DepthLevel new_level;
+      new_level.init(price, false);
+      pos = bids_.emplace_hint(pos, price, new_level);
+      return &pos->second;
+    }
+  } else {
+    AskLevelMap::iterator pos = asks_.lower_bound(price);
+    if (pos != asks_.end() && pos->first == price) {
+      return &pos->second;
+    } else if (should_create) {
+      DepthLevel new_level;
+      new_level.init(price, false);
+      pos = asks_.emplace_hint(pos, price, new_level);
+      return &pos->second;
+    }
+  }
+  return nullptr;
+}
+
+inline void
+FullDepth::erase_level(Price price, bool is_bid)
+{
+  if (is_bid) {
+    bids_.erase(price);
+  } else {
+    asks_.erase(price);
+  }
+}
+
+template <class LevelMap>
+size_t
+FullDepth::copy_levels(const LevelMap& side,
+                       size_t n,
+                       std::vector<DepthLevel>& levels)
+{
+  levels.clear();
+  size_t count = (n == 0 || n > side.size()) ? side.size() : n;
+  levels.reserve(count);
+  typename LevelMap::const_iterator pos = side.begin();
+  for (size_t i = 0; i < count; ++i, ++pos) {
+    levels.push_back(pos->second);
+  }
+  return count;
+}
+
+template <class LevelMap>
+size_t
+FullDepth::build_ladder(const LevelMap& side,
+                        size_t n,
+                        std::vector<LadderStep>& ladder)
+{
+  ladder.clear();
+  size_t count = (n == 0 || n > side.size()) ? side.size() : n;
+  ladder.reserve(count);
+  Quantity cumulative_qty = 0;
+  typename LevelMap::const_iterator pos = side.begin();
+  for (size_t i = 0; i < count; ++i, ++pos) {
+    cumulative_qty += pos->second.aggregate_qty();
+    LadderStep step;
+    step.price = pos->first;
+    step.qty = pos->second.aggregate_qty();
+    step.cumulative_qty = cumulative_qty;
+    step.order_count = pos->second.order_count();
+    ladder.push_back(step);
+  }
+  return count;
+}
+
+} }
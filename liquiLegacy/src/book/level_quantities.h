@@ -0,0 +1,116 @@
+// Copyright (c) 2012 - 2017 Object Computing, Inc.
+// All rights reserved.
+// See the file license.txt for licensing information.
+#pragma once
+
+#include "comparable_price.h"
+#include <cstdint>
+#include <map>
+
+namespace liquibook { namespace book {
+
+/// @brief open quantity resting at each price level of one side of a book.
+///   Quantity of orders that can fill partially is kept apart from
+///   all-or-none quantity.  The book updates it as orders rest, fill and
+///   leave, so an all-or-none order can tell whether the levels it crosses
+///   could fill it at all without walking the orders on them.
+class LevelQuantities {
+public:
+  struct Level {
+    Level() : regular(0), aon(0), orders(0), aon_orders(0) {}
+    Quantity regular;
+    Quantity aon;
+    uint32_t orders;
+    uint32_t aon_orders;
+  };
+  typedef std::map<ComparablePrice, Level> Levels;
+
+  /// @brief an order starts resting at price with qty open
+  void add(const ComparablePrice& price, Quantity qty, bool aon);
+
+  /// @brief an order stops resting at price with qty still open
+  void remove(const ComparablePrice& price, Quantity qty, bool aon);
+
+  /// @brief open quantity of an order still resting at price went down
+  void reduce(const ComparablePrice& price, Quantity qty, bool aon);
+
+  /// @brief open quantity of an order still resting at price went up
+  void increase(const ComparablePrice& price, Quantity qty, bool aon);
+
+  /// @brief open quantity at levels that match the opposite side price,
+  ///        counting no further than needed
+  Quantity available(Price price, Quantity needed) const;
+
+  /// @brief access the levels, best first
+  const Levels& levels() const { return levels_; }
+
+  void clear() { levels_.clear(); }
+
+private:
+  Levels levels_;
+};
+
+inline void
+LevelQuantities::add(const ComparablePrice& price, Quantity qty, bool aon)
+{
+  Level& level = levels_[price];
+  ++level.orders;
+  if (aon) {
+    level.aon += qty;
+    ++level.aon_orders;
+  } else {
+    level.regular += qty;
+  }
+}
+
+inline void
+LevelQuantities::remove(const ComparablePrice& price, Quantity qty, bool aon)
+{
+  auto pos = levels_.find(price);
+  if (pos == levels_.end()) {
+    return;
+  }
+  Level& level = pos->second;
+  if (--level.orders == 0) {
+    levels_.erase(pos);
+    return;
+  }
+  if (aon) {
+    level.aon -= qty;
+    --level.aon_orders;
+  } else {
+    level.regular -= qty;
+  }
+}
+
+inline void
+LevelQuantities::reduce(const ComparablePrice& price, Quantity qty, bool aon)
+{
+  auto pos = levels_.find(price);
+  if (pos != levels_.end()) {
+    (aon ? pos->second.aon : pos->second.regular) -= qty;
+  }
+}
+
+inline void
+LevelQuantities::increase(const ComparablePrice& price, Quantity qty, bool aon)
+{
+  auto pos = levels_.find(price);
+  if (pos != levels_.end()) {
+    (aon ? pos->second.aon : pos->second.regular) += qty;
+  }
+}
+
+inline Quantity
+LevelQuantities::available(Price price, Quantity needed) const
+{
+  Quantity total = 0;
+  for (auto pos = levels_.begin();
+       pos != levels_.end() && total < needed && pos->first.matches(price);
+       ++pos) {
+    total += pos->second.regular + pos->second.aon;
+  }
+  return total;
+}
+
+} }
@@ -6,6 +6,10 @@
 #include "version.h"
 #include "order_tracker.h"
 #include "callback.h"
+#include "callback_ring.h"
+#include "level_quantities.h"
+#include "auction.h"
+#include "small_vector.h"
 #include "order_listener.h"
 #include "order_book_listener.h"
 #include "trade_listener.h"
@@ -17,9 +21,12 @@
 #include <vector>
 #include <stdexcept>
 #include <cmath>
+#include <deque>
 #include <list>
 #include <functional>
 #include <algorithm>
+#include <iterator>
+#include <type_traits>
 
 #ifdef LIQUIBOOK_IGNORES_DEPRECATED_CALLS
 #define COMPLAIN_ONCE(message)
@@ -46,23 +53,48 @@ class OrderBookListener;
 /// @brief The limit order book of a security.  Template implementation allows
 ///        user to supply common or smart pointers, and to provide a different
 ///        Order class completely (as long as interface is obeyed).
-template <typename OrderPtr>
+///
+/// Listener selects how events are delivered.  By default (void) each event
+/// goes to the virtual on_* hooks below and then through the listener
+/// interfaces registered with set_*_listener().  Given a concrete class, the
+/// book instead calls that one listener directly, for every listener
+/// interface it implements, and calls the hooks of Derived (the most derived
+/// book class, which must befriend this one) directly as well.  Both are then
+/// bound at compile time and can inline into the matching loop.
+template <typename OrderPtr, class Listener, class Derived>
 class OrderBook {
 public:
   typedef OrderTracker<OrderPtr > Tracker;
   typedef Callback<OrderPtr > TypedCallback;
   typedef OrderListener<OrderPtr > TypedOrderListener;
-  typedef OrderBook<OrderPtr > MyClass;
+  typedef OrderBook<OrderPtr, Listener, Derived > MyClass;
+  /// The book whose hooks receive events (Derived, if given)
+  typedef typename std::conditional<std::is_void<Derived>::value,
+    MyClass, Derived>::type TypedBook;
+  /// True when Listener is bound at compile time
+  static constexpr bool static_listener = !std::is_void<Listener>::value;
   typedef TradeListener<MyClass > TypedTradeListener;
   typedef OrderBookListener<MyClass > TypedOrderBookListener;
   typedef std::vector<TypedCallback > Callbacks;
+  typedef CallbackRing<TypedCallback > CallbackQueue;
   typedef std::multimap<ComparablePrice, Tracker> TrackerMap;
   typedef std::vector<Tracker> TrackerVec;
   // Keep this around briefly for compatibility.
   typedef TrackerMap Bids;
   typedef TrackerMap Asks;
 
-  typedef std::list<typename TrackerMap::iterator> DeferredMatches;
+  typedef SmallVector<typename TrackerMap::iterator, 8> DeferredMatches;
+
+  /// @brief counts of stop orders triggered by this book
+  struct StopStats {
+    StopStats() : triggered(0), batches(0), capped(0) {}
+    /// Stops submitted to the market after their stop price was reached
+    uint64_t triggered;
+    /// Batches they were submitted in (one per trigger generation)
+    uint64_t batches;
+    /// Commands whose cascade reached the stop cascade limit
+    uint64_t capped;
+  };
 
   /// @brief construct
   OrderBook(const std::string & symbol = "unknown");
@@ -83,10 +115,67 @@ public:
   /// @brief set the order book listener
   void set_order_book_listener(TypedOrderBookListener* listener);
 
+  /// @brief set the compile-time bound listener (static_listener only)
+  void set_listener(Listener* listener);
+
+  /// @brief access the compile-time bound listener (static_listener only)
+  Listener* listener() const { return listener_; }
+
   /// @brief let the application handle reporting errors.
   void set_logger(Logger * logger);
 
+  /// @brief preallocate room for the callbacks of one command
+  /// Callbacks queue in a ring that only grows when a command produces more
+  /// of them than the book has seen before (e.g. a sweep of many orders).
+  /// @param capacity number of callbacks, rounded up to a power of two
+  void reserve_callbacks(size_t capacity);
+
+  /// @brief hold book updates until the matching release_book_updates()
+  /// Requests in between still perform their order and trade callbacks
+  /// before returning, but their book updates (and so depth and BBO
+  /// notifications) are delivered once, for the final state, on release.
+  /// Holds nest.
+  void hold_book_updates();
+
+  /// @brief release a hold, performing the book update it deferred, if any
+  void release_book_updates();
+
+  /// @brief limit the stops one command submits to the market
+  /// Stops triggered beyond the limit stay pending, in trigger order, and
+  /// go ahead of the next order added or replaced.
+  /// @param limit number of stops per command, 0 (the default) for no limit
+  void set_stop_cascade_limit(size_t limit) { stop_cascade_limit_ = limit; }
+
+  /// @brief submit triggered stops that are still pending, within the limit
+  /// add() and replace() do this before handling their order.
+  /// @return true if no triggered stops remain pending
+  bool submit_triggered_stops();
+
+  /// @brief start collecting orders for a call auction
+  /// Until uncross(), orders added or replaced rest on the book without
+  /// matching, so the book may cross.  Immediate-or-cancel orders take part
+  /// too; like market orders, what they do not fill is cancelled when the
+  /// auction ends.  All-or-none orders are rejected.  Cancels work as usual.
+  void start_auction() { auction_ = true; }
+
+  /// @brief true between start_auction() and uncross()
+  bool in_auction() const { return auction_; }
+
+  /// @brief end the call auction, executing every cross at one price
+  /// The price comes from auction_equilibrium() over the open quantity per
+  /// level.  Bids and asks fill in priority order against each other at
+  /// that price; market and IOC orders left over are cancelled.  Stops reached by
+  /// the price are handled as after any trade, and listeners see one book
+  /// update for the whole batch.
+  /// @param reference price for the auction tiebreak (see
+  ///        auction_equilibrium), typically the last trade before it began
+  /// @return the price and volume the auction executed
+  AuctionResult uncross(Price reference);
+
   /// @brief add an order to book
+  /// Callbacks refer to the order pointers passed to add, cancel and replace
+  /// rather than copying them, so those must stay valid until the call
+  /// returns (listeners must not destroy them).
   /// @param order the order to add
   /// @param conditions special conditions on the order
   /// @return true if the add resulted in a fill
@@ -104,6 +193,18 @@ public:
                        int64_t size_delta = SIZE_UNCHANGED,
                        Price new_price = PRICE_UNCHANGED);
 
+  /// @brief load a batch of resting orders without matching
+  /// Intended to be used when rebuilding a book from a snapshot.  Each side
+  /// of the batch must be sorted best price first; orders at one price keep
+  /// their batch order as time priority.  The whole batch is rejected if
+  /// any order cannot rest (zero quantity, market, stop or IOC), a side is
+  /// out of order, or the batch crosses itself or the orders already on
+  /// the book.  Crossing is allowed while the book is in an auction.  No
+  /// per-order callbacks are generated; listeners see a single book update.
+  /// @param orders the resting orders to load
+  /// @return nullptr if the batch was loaded, otherwise the reject reason
+  virtual const char* bulk_load(const std::vector<OrderPtr>& orders);
+
   /// @brief Set the current market price
   /// Intended to be used during initialization to establish the market
   /// price before this order book has generated any exceptions.
@@ -128,6 +229,18 @@ public:
   /// @brief access stop ask orders
   const TrackerMap & stopAsks() const { return stopAsks_;}
 
+  /// @brief access stops that were triggered but not yet submitted
+  const TrackerVec & pendingStops() const { return pendingOrders_;}
+
+  /// @brief access counts of triggered stops
+  const StopStats & stop_stats() const { return stopStats_;}
+
+  /// @brief access open quantity per bid price level
+  const LevelQuantities & bidLevels() const { return bidLevels_;}
+
+  /// @brief access open quantity per ask price level
+  const LevelQuantities & askLevels() const { return askLevels_;}
+
   /// @brief move callbacks to another thread's container
   /// @deprecated  This doesn't do anything now
   /// so don't bother to call it in new code.
@@ -150,6 +263,26 @@ protected:
   /// @brief perform an individual callback
   virtual void perform_callback(TypedCallback& cb);
 
+  /// @brief queue a callback.  Callbacks queued while callbacks are being
+  ///        performed (a listener issued a request) pin their orders, since
+  ///        that request returns before they are performed.
+  void push_callback(const TypedCallback& cb);
+
+  /// @brief start the per-command stop cascade count
+  void begin_command();
+
+  /// @brief remove a tracker from a container, keeping its order pointer
+  ///        alive until the queued callbacks have been performed
+  void retire(TrackerMap& trackers, typename TrackerMap::iterator pos);
+
+  /// @brief the open quantity per level kept for bids_ or asks_
+  LevelQuantities& levels_of(const TrackerMap& trackers);
+
+  /// @brief perform an individual callback with hooks and listener bound at
+  ///        compile time (used instead of perform_callback when
+  ///        static_listener)
+  void perform_static_callback(TypedCallback& cb);
+
   /// @brief match a new order to current orders
   /// @param inbound_order the inbound order
   /// @param inbound_price price of the inbound order
@@ -197,6 +330,19 @@ protected:
                     Tracker& current_tracker,
                     Quantity max_quantity = QUANTITY_MAX);
 
+  /// @brief fill two orders against each other
+  /// @param inbound_tracker the order reported as inbound
+  /// @param current_tracker the order reported as matched
+  /// @param fill_qty quantity to trade, no more than either has open
+  /// @param cross_price price of the trade
+  void fill_trackers(Tracker& inbound_tracker,
+                     Tracker& current_tracker,
+                     Quantity fill_qty,
+                     Price cross_price);
+
+  /// @brief cancel market and IOC orders an auction left on one side
+  void cancel_auction_remainders(TrackerMap& trackers);
+
   /// @brief find an order in a container
   /// @param order is the the order we are looking for
   /// @param[OUT] result will point to the entry in the container if we find a match
@@ -219,11 +365,22 @@ protected:
   bool add_stop_order(Tracker & tracker);
 
   /// @brief See if any stop orders should go on the market.
+  /// Stops are kept in the order they trigger, so those reached by price
+  /// are a leading range of stops, moved to the pending orders at once.
   void check_stop_orders(bool side, Price price, TrackerMap & stops);
 
-  /// @brief accept pending (formerly stop) orders.
+  /// @brief accept pending (formerly stop) orders, as far as the stop
+  /// cascade limit allows.
   void submit_pending_orders();
 
+  /// @brief key of a stop order in stopBids_ or stopAsks_.
+  /// Buy stops trigger as the price rises to them, so the lowest sorts
+  /// first; sell stops the other way round.
+  static ComparablePrice stop_key(bool buySide, Price stop_price)
+  {
+    return ComparablePrice(!buySide, stop_price);
+  }
+
   ///////////////////////////////
   // Callback interfaces as
   // virtual methods to simplify
@@ -261,7 +418,8 @@ protected:
 
   /// @brief callback for an order replace
   /// @param order the replaced order
-  /// @param size_delta the change to order quantity
+  /// @param current_qty the open quantity before the replace
+  /// @param new_qty the open quantity after the replace
   /// @param new_price the updated order price
   virtual void on_replace(const OrderPtr& order,
     Quantity current_qty, 
@@ -290,6 +448,10 @@ protected:
   // End of BookListener Interface
   ///////////////////////////////
 
+  /// @brief callback after bulk_load placed a batch on the book
+  virtual void on_bulk_load(const std::vector<OrderPtr>& orders){}
+  ///////////////////////////////
+
 
 private:
     bool submit_order(Tracker & inbound);
@@ -303,56 +465,109 @@ private:
   TrackerMap stopBids_;
   TrackerMap stopAsks_;
   TrackerVec pendingOrders_;
-
-  Callbacks callbacks_;
-  Callbacks workingCallbacks_;
+  size_t stop_cascade_limit_;
+  size_t stops_submitted_;
+  bool cascade_capped_;
+  StopStats stopStats_;
+  bool auction_;
+  // IOC orders accepted since start_auction()
+  size_t auction_iocs_;
+
+  LevelQuantities bidLevels_;
+  LevelQuantities askLevels_;
+
+  CallbackQueue callbacks_;
+  // Storage of order pointers that queued callbacks refer to; released
+  // once the callbacks have been performed
+  std::vector<typename TrackerMap::node_type> retired_;
+  std::vector<TrackerVec> retiredPending_;
+  std::deque<OrderPtr> pinned_;
   bool handling_callbacks_;
+  // Only the last queued book update is performed; see hold_book_updates()
+  size_t queued_book_updates_;
+  size_t book_update_holds_;
+  bool book_update_deferred_;
   TypedOrderListener* order_listener_;
   TypedTradeListener* trade_listener_;
   TypedOrderBookListener* order_book_listener_;
+  Listener* listener_;
   Logger * logger_;
   Price marketPrice_;
 };
 
-template <class OrderPtr>
-OrderBook<OrderPtr>::OrderBook(const std::string & symbol)
+template <class OrderPtr, class Listener, class Derived>
+OrderBook<OrderPtr, Listener, Derived>::OrderBook(const std::string & symbol)
 : symbol_(symbol),
+  stop_cascade_limit_(0),
+  stops_submitted_(0),
+  cascade_capped_(false),
+  auction_(false),
+  auction_iocs_(0),
   handling_callbacks_(false),
+  queued_book_updates_(0),
+  book_update_holds_(0),
+  book_update_deferred_(false),
   order_listener_(nullptr),
   trade_listener_(nullptr),
   order_book_listener_(nullptr),
+  listener_(nullptr),
   logger_(nullptr),
   marketPrice_(MARKET_ORDER_PRICE)
 {
-  callbacks_.reserve(16);  // Why 16?  Why not?  
-  workingCallbacks_.reserve(callbacks_.capacity());
+  retired_.reserve(16);
 }
 
-template <class OrderPtr>
+template <class OrderPtr, class Listener, class Derived>
 void
-OrderBook<OrderPtr>::set_logger(Logger * logger)
+OrderBook<OrderPtr, Listener, Derived>::set_logger(Logger * logger)
 {
   logger_ = logger;
 }
 
+template <class OrderPtr, class Listener, class Derived>
+void
+OrderBook<OrderPtr, Listener, Derived>::reserve_callbacks(size_t capacity)
+{
+  callbacks_.reserve(capacity);
+}
+
+template <class OrderPtr, class Listener, class Derived>
+void
+OrderBook<OrderPtr, Listener, Derived>::hold_book_updates()
+{
+  ++book_update_holds_;
+}
 
-template <class OrderPtr>
+template <class OrderPtr, class Listener, class Derived>
+void
+OrderBook<OrderPtr, Listener, Derived>::release_book_updates()
+{
+  if(book_update_holds_ && --book_update_holds_ == 0 && book_update_deferred_)
+  {
+    book_update_deferred_ = false;
+    push_callback(TypedCallback::book_update());
+    callback_now();
+  }
+}
+
+
+template <class OrderPtr, class Listener, class Derived>
 void 
-OrderBook<OrderPtr>::set_symbol(const std::string & symbol)
+OrderBook<OrderPtr, Listener, Derived>::set_symbol(const std::string & symbol)
 {
     symbol_ = symbol;
 }
 
-template <class OrderPtr>
+template <class OrderPtr, class Listener, class Derived>
 const std::string &
-OrderBook<OrderPtr>::symbol() const
+OrderBook<OrderPtr, Listener, Derived>::symbol() const
 {
     return symbol_;
 }
 
-template <class OrderPtr>
+template <class OrderPtr, class Listener, class Derived>
 void
-OrderBook<OrderPtr>:: set_market_price(Price price)
+OrderBook<OrderPtr, Listener, Derived>:: set_market_price(Price price)
 {
   Price oldMarketPrice = marketPrice_;
   marketPrice_ = price;
@@ -372,82 +587,254 @@ OrderBook<OrderPtr>:: set_market_price(Price price)
 
 /// @brief Get current market price.
 /// The market price is normally the price at which the last trade happened.
-template <class OrderPtr>
+template <class OrderPtr, class Listener, class Derived>
 Price
-OrderBook<OrderPtr>::market_price() const
+OrderBook<OrderPtr, Listener, Derived>::market_price() const
 {
   return marketPrice_;
 }
 
-template <class OrderPtr>
+template <class OrderPtr, class Listener, class Derived>
 void
-OrderBook<OrderPtr>::set_order_listener(TypedOrderListener* listener)
+OrderBook<OrderPtr, Listener, Derived>::set_order_listener(TypedOrderListener* listener)
 {
   order_listener_ = listener;
 }
 
-template <class OrderPtr>
+template <class OrderPtr, class Listener, class Derived>
 void
-OrderBook<OrderPtr>::set_trade_listener(TypedTradeListener* listener)
+OrderBook<OrderPtr, Listener, Derived>::set_trade_listener(TypedTradeListener* listener)
 {
   trade_listener_ = listener;
 }
 
-template <class OrderPtr>
+template <class OrderPtr, class Listener, class Derived>
 void
-OrderBook<OrderPtr>::set_order_book_listener(TypedOrderBookListener* listener)
+OrderBook<OrderPtr, Listener, Derived>::set_order_book_listener(TypedOrderBookListener* listener)
 {
   order_book_listener_ = listener;
 }
 
-template <class OrderPtr>
+template <class OrderPtr, class Listener, class Derived>
+void
+OrderBook<OrderPtr, Listener, Derived>::set_listener(Listener* listener)
+{
+  static_assert(static_listener, "set_listener requires a Listener type");
+  listener_ = listener;
+}
+
+template <class OrderPtr, class Listener, class Derived>
 bool
-OrderBook<OrderPtr>::add(const OrderPtr& order, OrderConditions conditions)
+OrderBook<OrderPtr, Listener, Derived>::add(const OrderPtr& order, OrderConditions conditions)
 {
   bool matched = false;
 
   // If the order is invalid, ignore it
   if (order->order_qty() == 0) {
-    callbacks_.push_back(TypedCallback::reject(order, "size must be positive"));
+    push_callback(TypedCallback::reject(order, "size must be positive"));
+    callback_now();
   }
   else 
   {
+    // Stops a capped cascade left pending go ahead of this order
+    begin_command();
+    submit_triggered_stops();
+
+    // Callbacks refer to the inbound tracker, so perform them in its scope
     Tracker inbound(order, conditions);
     if(inbound.ptr()->stop_price() != 0 && add_stop_order(inbound))
     {
       // The order has been added to stops
-      callbacks_.push_back(TypedCallback::accept_stop(order));
+      push_callback(TypedCallback::accept_stop(order));
+    }
+    else if (auction_ && inbound.all_or_none())
+    {
+      // An auction fills at one price in quantities it cannot guarantee
+      push_callback(TypedCallback::reject(order,
+        "all-or-none orders are not accepted during an auction"));
     }
     else
     {
       size_t accept_cb_index = callbacks_.size();
-      callbacks_.push_back(TypedCallback::accept(order));
+      push_callback(TypedCallback::accept(order));
       matched = submit_order(inbound);
       // Note the filled qty in the accept callback
       callbacks_[accept_cb_index].quantity = inbound.filled_qty();
 
-      // Cancel any unfilled IOC order
-      if (inbound.immediate_or_cancel() && !inbound.filled()) 
+      // Cancel any unfilled IOC order (an auction cancels it when it ends)
+      if (auction_ && inbound.immediate_or_cancel())
+      {
+        ++auction_iocs_;
+      }
+      else if (inbound.immediate_or_cancel() && !inbound.filled()) 
       {
         // NOTE - this may need he actual open qty???
-        callbacks_.push_back(TypedCallback::cancel(order, 0));
+        push_callback(TypedCallback::cancel(order, 0));
       }
     }
     // If adding this order triggered any stops
     // handle those stops now
-    while(!pendingOrders_.empty())
-    {
-      submit_pending_orders();
+    submit_triggered_stops();
+    push_callback(TypedCallback::book_update());
+    callback_now();
+  }
+  return matched;
+}
+
+template <class OrderPtr, class Listener, class Derived>
+const char*
+OrderBook<OrderPtr, Listener, Derived>::bulk_load(const std::vector<OrderPtr>& orders)
+{
+  // Validate the whole batch before touching the book
+  const OrderPtr* best_bid = nullptr;
+  const OrderPtr* best_ask = nullptr;
+  Price last_bid = 0;
+  Price last_ask = 0;
+  for (const OrderPtr& order : orders) {
+    if (order->order_qty() == 0) {
+      return "size must be positive";
+    }
+    if (!order->is_limit() || order->stop_price() != 0 ||
+        order->immediate_or_cancel()) {
+      return "only resting limit orders can be loaded";
+    }
+    Price price = order->price();
+    if (order->is_buy()) {
+      if (best_bid && price > last_bid) {
+        return "bids not sorted best price first";
+      }
+      if (!best_bid) {
+        best_bid = &order;
+      }
+      last_bid = price;
+    } else {
+      if (best_ask && price < last_ask) {
+        return "asks not sorted best price first";
+      }
+      if (!best_ask) {
+        best_ask = &order;
+      }
+      last_ask = price;
     }
-    callbacks_.push_back(TypedCallback::book_update(this));
   }
+  // A book collecting an auction may cross; it uncrosses at the end
+  if (!auction_) {
+    if (best_bid && best_ask &&
+        (*best_bid)->price() >= (*best_ask)->price()) {
+      return "batch is crossed";
+    }
+    if (best_bid && !asks_.empty() &&
+        asks_.begin()->first.matches((*best_bid)->price())) {
+      return "batch crosses the book";
+    }
+    if (best_ask && !bids_.empty() &&
+        bids_.begin()->first.matches((*best_ask)->price())) {
+      return "batch crosses the book";
+    }
+  }
+
+  // Sorted input lets every insert land next to the previous one
+  typename TrackerMap::iterator bid_hint = bids_.end();
+  typename TrackerMap::iterator ask_hint = asks_.end();
+  for (const OrderPtr& order : orders) {
+    Tracker tracker(order,
+      order->all_or_none() ? oc_all_or_none : oc_no_conditions);
+    if (order->is_buy()) {
+      bid_hint = std::next(bids_.emplace_hint(bid_hint,
+        ComparablePrice(true, order->price()), tracker));
+      bidLevels_.add(ComparablePrice(true, order->price()),
+        tracker.open_qty(), tracker.all_or_none());
+    } else {
+      ask_hint = std::next(asks_.emplace_hint(ask_hint,
+        ComparablePrice(false, order->price()), tracker));
+      askLevels_.add(ComparablePrice(false, order->price()),
+        tracker.open_qty(), tracker.all_or_none());
+    }
+  }
+
+  if constexpr (static_listener) {
+    static_cast<TypedBook&>(*this).TypedBook::on_bulk_load(orders);
+  } else {
+    on_bulk_load(orders);
+  }
+  push_callback(TypedCallback::book_update());
   callback_now();
-  return matched;
+  return nullptr;
+}
+
+template <class OrderPtr, class Listener, class Derived>
+AuctionResult
+OrderBook<OrderPtr, Listener, Derived>::uncross(Price reference)
+{
+  AuctionResult result =
+    auction_equilibrium(bidLevels_, askLevels_, reference);
+  auction_ = false;
+  begin_command();
+
+  // Every bid and ask counted into the volume crosses the price, so
+  // filling them in priority order executes exactly the volume
+  Quantity remaining = result.volume;
+  typename TrackerMap::iterator bid = bids_.begin();
+  typename TrackerMap::iterator ask = asks_.begin();
+  while (remaining > 0 && bid != bids_.end() && ask != asks_.end()) {
+    if (bid->second.all_or_none()) {
+      ++bid;
+      continue;
+    }
+    if (ask->second.all_or_none()) {
+      ++ask;
+      continue;
+    }
+    Tracker& buyer = bid->second;
+    Tracker& seller = ask->second;
+    Quantity fill_qty = (std::min)(remaining,
+      (std::min)(buyer.open_qty(), seller.open_qty()));
+    fill_trackers(buyer, seller, fill_qty, result.price);
+    bidLevels_.reduce(bid->first, fill_qty, false);
+    askLevels_.reduce(ask->first, fill_qty, false);
+    remaining -= fill_qty;
+    if (buyer.filled()) {
+      retire(bids_, bid++);
+    }
+    if (seller.filled()) {
+      retire(asks_, ask++);
+    }
+  }
+
+  // Market and IOC orders only ever rest during an auction
+  cancel_auction_remainders(bids_);
+  cancel_auction_remainders(asks_);
+  auction_iocs_ = 0;
+  submit_triggered_stops();
+  push_callback(TypedCallback::book_update());
+  callback_now();
+  return result;
+}
+
+template <class OrderPtr, class Listener, class Derived>
+void
+OrderBook<OrderPtr, Listener, Derived>::cancel_auction_remainders(
+  TrackerMap& trackers)
+{
+  typename TrackerMap::iterator pos = trackers.begin();
+  while (pos != trackers.end()) {
+    if (pos->first == MARKET_ORDER_PRICE ||
+        pos->second.immediate_or_cancel()) {
+      push_callback(TypedCallback::cancel(pos->second.ptr(),
+        pos->second.open_qty()));
+      retire(trackers, pos++);
+    } else if (auction_iocs_ == 0) {
+      // Only market orders to cancel, and they sort first
+      break;
+    } else {
+      ++pos;
+    }
+  }
 }
 
-template <class OrderPtr>
+template <class OrderPtr, class Listener, class Derived>
 void
-OrderBook<OrderPtr>::cancel(const OrderPtr& order)
+OrderBook<OrderPtr, Listener, Derived>::cancel(const OrderPtr& order)
 {
   bool found = false;
   bool foundStop = false;
@@ -459,7 +846,7 @@ OrderBook<OrderPtr>::cancel(const OrderPtr& order)
     if (bid != bids_.end()) {
       open_qty = bid->second.open_qty();
       // Remove from container for cancel
-      bids_.erase(bid);
+      retire(bids_, bid);
       found = true;
     }
     else if (order->stop_price()) {
@@ -476,7 +863,7 @@ OrderBook<OrderPtr>::cancel(const OrderPtr& order)
     if (ask != asks_.end()) {
       open_qty = ask->second.open_qty();
       // Remove from container for cancel
-      asks_.erase(ask);
+      retire(asks_, ask);
       found = true;
     }
     else if (order->stop_price()) {
@@ -487,24 +874,34 @@ OrderBook<OrderPtr>::cancel(const OrderPtr& order)
       }
     }
   } 
+  // A stop that triggered but is held back by the stop cascade limit
+  if (!found && !foundStop && order->stop_price()) {
+    for (auto pos = pendingOrders_.begin(); pos != pendingOrders_.end(); ++pos) {
+      if (pos->ptr() == order) {
+        pendingOrders_.erase(pos);
+        foundStop = true;
+        break;
+      }
+    }
+  }
   // If the cancel was found, issue callback
   if (found) {
-    callbacks_.push_back(TypedCallback::cancel(order, open_qty));
-    callbacks_.push_back(TypedCallback::book_update(this));
+    push_callback(TypedCallback::cancel(order, open_qty));
+    push_callback(TypedCallback::book_update());
   }
   else if (foundStop) {
-    callbacks_.push_back(TypedCallback::cancel_stop(order));
-    callbacks_.push_back(TypedCallback::book_update(this));
+    push_callback(TypedCallback::cancel_stop(order));
+    push_callback(TypedCallback::book_update());
   }
   else {
-    callbacks_.push_back(TypedCallback::cancel_reject(order, "not found"));
+    push_callback(TypedCallback::cancel_reject(order, "not found"));
   }
   callback_now();
 }
 
-template <class OrderPtr>
+template <class OrderPtr, class Listener, class Derived>
 bool
-OrderBook<OrderPtr>::replace(
+OrderBook<OrderPtr, Listener, Derived>::replace(
   const OrderPtr& order, 
   int64_t size_delta,
   Price new_price)
@@ -514,6 +911,11 @@ OrderBook<OrderPtr>::replace(
 
   Price price = (new_price == PRICE_UNCHANGED) ? order->price() : new_price;
 
+  // Stops a capped cascade left pending go ahead of this request
+  begin_command();
+  bool stops_pending = !pendingOrders_.empty();
+  submit_triggered_stops();
+
   // If the order to replace is a buy order
   TrackerMap & market = order->is_buy() ? bids_ : asks_;
   typename TrackerMap::iterator pos;
@@ -530,55 +932,62 @@ OrderBook<OrderPtr>::replace(
       {
         // if there is nothing to get rid of
         // Reject the replace
-        callbacks_.push_back(TypedCallback::replace_reject(tracker.ptr(), 
+        push_callback(TypedCallback::replace_reject(order, 
           "order is already filled"));
+        callback_now();
         return false;
       }
     }
 
     // Accept the replace
-    callbacks_.push_back(
+    push_callback(
         TypedCallback::replace(order, pos->second.open_qty(), size_delta, 
                                 price));
     Quantity new_open_qty = pos->second.open_qty() + size_delta;
+    // The order leaves its level either way; count it out before the change
+    levels_of(market).remove(pos->first, pos->second.open_qty(),
+      pos->second.all_or_none());
     pos->second.change_qty(size_delta);  // Update my copy
     // If the size change will close the order
     if (!new_open_qty) 
     {
       // Cancel with NO open qty (should be zero after replace)
-      callbacks_.push_back(TypedCallback::cancel(order, 0));
-      market.erase(pos); // Remove order
+      push_callback(TypedCallback::cancel(order, 0));
+      retired_.push_back(market.extract(pos)); // Remove order
     } 
     else 
     {
       // Else rematch the new order - there could be a price change
       // or size change - that could cause all or none match
-      auto order = pos->second;
-      market.erase(pos); // Remove old order order
-      matched = add_order(order, price); // Add order
+      // Take the tracker out without copying it; callbacks of the rematch
+      // refer to its order pointer, so the node is retired afterwards
+      auto node = market.extract(pos); // Remove old order order
+      matched = add_order(node.mapped(), price); // Add order
+      retired_.push_back(std::move(node));
     }
     // If replace any order this order triggered any trades
     // which triggered any stops
     // handle those stops now
-    while(!pendingOrders_.empty())
-    {
-      submit_pending_orders();
-    }
-    callbacks_.push_back(TypedCallback::book_update(this));
+    submit_triggered_stops();
+    push_callback(TypedCallback::book_update());
   }
   else
   {
     // not found
-    callbacks_.push_back(
+    push_callback(
           TypedCallback::replace_reject(order, "not found"));
+    if(stops_pending)
+    {
+      push_callback(TypedCallback::book_update());
+    }
   }
   callback_now();
   return matched;
 }
 
-template <class OrderPtr>
+template <class OrderPtr, class Listener, class Derived>
 bool
-OrderBook<OrderPtr>::add_stop_order(Tracker & tracker)
+OrderBook<OrderPtr, Listener, Derived>::add_stop_order(Tracker & tracker)
 {
   bool isBuy = tracker.ptr()->is_buy();
   ComparablePrice key(isBuy, tracker.ptr()->stop_price());
@@ -588,59 +997,110 @@ OrderBook<OrderPtr>::add_stop_order(Tracker & tracker)
   {
     if(isBuy)
     {
-      stopBids_.emplace(key, std::move(tracker));
+      stopBids_.emplace(stop_key(isBuy, key.price()), std::move(tracker));
     }
     else
     {
-      stopAsks_.emplace(key, std::move(tracker));
+      stopAsks_.emplace(stop_key(isBuy, key.price()), std::move(tracker));
     }
   }
   return isStopped;
 }
 
-template <class OrderPtr>
+template <class OrderPtr, class Listener, class Derived>
 void
-OrderBook<OrderPtr>::check_stop_orders(bool side, Price price, TrackerMap & stops)
+OrderBook<OrderPtr, Listener, Derived>::check_stop_orders(bool side, Price price, TrackerMap & stops)
 {
-  ComparablePrice until(side, price);
-  auto pos = stops.begin(); 
-  while(pos != stops.end())
+  // Every stop reached by price sorts ahead of the first one that is not
+  auto last = stops.upper_bound(stop_key(side, price));
+  for(auto pos = stops.begin(); pos != last; ++pos)
   {
-    auto here = pos++;
-    if(until > here->first)
-    {
-      break;
-    }
-    pendingOrders_.push_back(std::move(here->second));
-    stops.erase(here);
+    pendingOrders_.push_back(std::move(pos->second));
   }
+  stops.erase(stops.begin(), last);
 }
 
-template <class OrderPtr>
+template <class OrderPtr, class Listener, class Derived>
 void
-OrderBook<OrderPtr>::submit_pending_orders()
+OrderBook<OrderPtr, Listener, Derived>::submit_pending_orders()
 {
   TrackerVec pending;
   pending.swap(pendingOrders_);
-  for(auto pos = pending.begin(); pos != pending.end(); ++pos)
+  size_t count = pending.size();
+  if(stop_cascade_limit_ != 0)
+  {
+    count = std::min(count, stop_cascade_limit_ - stops_submitted_);
+  }
+  for(size_t index = 0; index < count; ++index)
   {
-    Tracker & tracker = *pos;
+    Tracker & tracker = pending[index];
+    // Like an accept, the trigger goes ahead of the fills it causes
+    push_callback(TypedCallback::trigger_stop(tracker.ptr()));
     submit_order(tracker);
-    callbacks_.push_back(TypedCallback::trigger_stop(tracker.ptr()));
   }
+  stops_submitted_ += count;
+  stopStats_.triggered += count;
+  ++stopStats_.batches;
+  if(count < pending.size())
+  {
+    // Stops over the limit stay ahead of any this batch triggered
+    TrackerVec waiting;
+    waiting.reserve(pending.size() - count + pendingOrders_.size());
+    std::move(pending.begin() + count, pending.end(),
+      std::back_inserter(waiting));
+    std::move(pendingOrders_.begin(), pendingOrders_.end(),
+      std::back_inserter(waiting));
+    pendingOrders_.swap(waiting);
+    pending.erase(pending.begin() + count, pending.end());
+  }
+  // Callbacks refer to these trackers; moving the vector keeps them in place
+  retiredPending_.push_back(std::move(pending));
+}
+
+template <class OrderPtr, class Listener, class Derived>
+bool
+OrderBook<OrderPtr, Listener, Derived>::submit_triggered_stops()
+{
+  while(!pendingOrders_.empty())
+  {
+    if(stop_cascade_limit_ != 0 && stops_submitted_ >= stop_cascade_limit_)
+    {
+      // The rest wait for the next command
+      if(!cascade_capped_)
+      {
+        cascade_capped_ = true;
+        ++stopStats_.capped;
+      }
+      return false;
+    }
+    submit_pending_orders();
+  }
+  return true;
 }
 
-template <class OrderPtr>
+template <class OrderPtr, class Listener, class Derived>
+void
+OrderBook<OrderPtr, Listener, Derived>::begin_command()
+{
+  // Requests issued from callbacks belong to the command being handled
+  if(!handling_callbacks_)
+  {
+    stops_submitted_ = 0;
+    cascade_capped_ = false;
+  }
+}
+
+template <class OrderPtr, class Listener, class Derived>
 bool
-OrderBook<OrderPtr>::submit_order(Tracker & inbound)
+OrderBook<OrderPtr, Listener, Derived>::submit_order(Tracker & inbound)
 {
   Price order_price = inbound.ptr()->price();
   return add_order(inbound, order_price);
 }
 
-template <class OrderPtr>
+template <class OrderPtr, class Listener, class Derived>
 bool
-OrderBook<OrderPtr>::find_on_market(
+OrderBook<OrderPtr, Listener, Derived>::find_on_market(
   const OrderPtr& order,
   typename TrackerMap::iterator& result)
 {
@@ -663,13 +1123,13 @@ OrderBook<OrderPtr>::find_on_market(
   return false;
 }
 
-template <class OrderPtr>
+template <class OrderPtr, class Listener, class Derived>
 bool
-OrderBook<OrderPtr>::find_in_stop_orders(
+OrderBook<OrderPtr, Listener, Derived>::find_in_stop_orders(
   const OrderPtr& order,
   typename TrackerMap::iterator& result)
 {
-  const ComparablePrice key(order->is_buy(), order->stop_price());
+  const ComparablePrice key = stop_key(order->is_buy(), order->stop_price());
   TrackerMap & sideMap = order->is_buy() ? stopBids_ : stopAsks_;
 
   for (result = sideMap.find(key); result != sideMap.end(); ++result) {
@@ -691,27 +1151,32 @@ OrderBook<OrderPtr>::find_in_stop_orders(
 // Try to match order.  Generate trades.
 // If not completely filled and not IOC,
 // add the order to the order book
-template <class OrderPtr>
+template <class OrderPtr, class Listener, class Derived>
 bool
-OrderBook<OrderPtr>::add_order(Tracker& inbound, Price order_price)
+OrderBook<OrderPtr, Listener, Derived>::add_order(Tracker& inbound, Price order_price)
 {
   bool matched = false;
   OrderPtr& order = inbound.ptr();
   DeferredMatches deferred_aons;
-  // Try to match with current orders
-  if (order->is_buy()) {
+  // Try to match with current orders (during an auction orders only rest)
+  if (auction_) {
+    // matched stays false
+  } else if (order->is_buy()) {
     matched = match_order(inbound, order_price, asks_, deferred_aons);
   } else {
     matched = match_order(inbound, order_price, bids_, deferred_aons);
   }
 
   // If order has remaining open quantity and is not immediate or cancel
-  if (inbound.open_qty() && !inbound.immediate_or_cancel()) {
+  // (during an auction those rest until it ends)
+  if (inbound.open_qty() && (auction_ || !inbound.immediate_or_cancel())) {
     // If this is a buy order
     if (order->is_buy()) 
     {
       // Insert into bids
       bids_.insert(std::make_pair(ComparablePrice(true, order_price), inbound));
+      bidLevels_.add(ComparablePrice(true, order_price),
+        inbound.open_qty(), inbound.all_or_none());
       // and see if that satisfies any ask orders
       if(check_deferred_aons(deferred_aons, asks_, bids_))
       {
@@ -723,6 +1188,8 @@ OrderBook<OrderPtr>::add_order(Tracker& inbound, Price order_price)
       // Else this is a sell order
       // Insert into asks
       asks_.insert(std::make_pair(ComparablePrice(false, order_price), inbound));
+      askLevels_.add(ComparablePrice(false, order_price),
+        inbound.open_qty(), inbound.all_or_none());
       if(check_deferred_aons(deferred_aons, bids_, asks_))
       {
         matched = true;
@@ -732,26 +1199,35 @@ OrderBook<OrderPtr>::add_order(Tracker& inbound, Price order_price)
   return matched;
 }
 
-template <class OrderPtr>
+template <class OrderPtr, class Listener, class Derived>
 bool
-OrderBook<OrderPtr>::check_deferred_aons(DeferredMatches & aons, 
+OrderBook<OrderPtr, Listener, Derived>::check_deferred_aons(DeferredMatches & aons, 
   TrackerMap & deferredTrackers, 
   TrackerMap & marketTrackers)
 {
   bool result = false;
   DeferredMatches ignoredAons;
+  LevelQuantities & levels = levels_of(deferredTrackers);
 
   for(auto pos = aons.begin(); pos != aons.end(); ++pos)
   {
     auto entry = *pos;
     ComparablePrice current_price = entry->first;
     Tracker & tracker = entry->second;
+    // The tracker fills as the inbound side here; count its quantity out
+    // while it matches and back in for what is left
+    Quantity open_qty = tracker.open_qty();
+    levels.reduce(current_price, open_qty, tracker.all_or_none());
     bool matched = match_order(tracker, current_price.price(), 
       marketTrackers, ignoredAons);
     result |= matched;
     if(tracker.filled())
     {
-      deferredTrackers.erase(entry);
+      retire(deferredTrackers, entry);
+    }
+    else
+    {
+      levels.increase(current_price, tracker.open_qty(), tracker.all_or_none());
     }
   }
   return result;
@@ -761,9 +1237,9 @@ OrderBook<OrderPtr>::check_deferred_aons(DeferredMatches & aons,
 ///  If successful
 ///    generate trade(s)
 ///    if any current order is complete, remove from 'current' orders
-template <class OrderPtr>
+template <class OrderPtr, class Listener, class Derived>
 bool
-OrderBook<OrderPtr>::match_order(Tracker& inbound, 
+OrderBook<OrderPtr, Listener, Derived>::match_order(Tracker& inbound, 
   Price inbound_price, 
   TrackerMap& current_orders,
   DeferredMatches & deferred_aons)
@@ -775,9 +1251,9 @@ OrderBook<OrderPtr>::match_order(Tracker& inbound,
   return match_regular_order(inbound, inbound_price, current_orders, deferred_aons);
 }
 
-template <class OrderPtr>
+template <class OrderPtr, class Listener, class Derived>
 bool
-OrderBook<OrderPtr>::match_regular_order(Tracker& inbound, 
+OrderBook<OrderPtr, Listener, Derived>::match_regular_order(Tracker& inbound, 
   Price inbound_price, 
   TrackerMap& current_orders,
   DeferredMatches & deferred_aons)
@@ -818,7 +1294,8 @@ OrderBook<OrderPtr>::match_regular_order(Tracker& inbound,
         {
           matched = true;
           // assert traded == current_quantity
-          current_orders.erase(entry);
+          levels_of(current_orders).reduce(current_price, traded, true);
+          retire(current_orders, entry);
           inbound_qty -= traded;
         }
       }
@@ -836,9 +1313,10 @@ OrderBook<OrderPtr>::match_regular_order(Tracker& inbound,
       if(traded > 0)
       {
         matched = true;
+        levels_of(current_orders).reduce(current_price, traded, false);
         if(current_order.filled())
         {
-          current_orders.erase(entry);
+          retire(current_orders, entry);
         }
         inbound_qty -= traded;
       }
@@ -847,9 +1325,9 @@ OrderBook<OrderPtr>::match_regular_order(Tracker& inbound,
   return matched;
 }
 
-template <class OrderPtr>
+template <class OrderPtr, class Listener, class Derived>
 bool
-OrderBook<OrderPtr>::match_aon_order(Tracker& inbound, 
+OrderBook<OrderPtr, Listener, Derived>::match_aon_order(Tracker& inbound, 
   Price inbound_price, 
   TrackerMap& current_orders,
   DeferredMatches & deferred_aons)
@@ -858,6 +1336,16 @@ OrderBook<OrderPtr>::match_aon_order(Tracker& inbound,
   Quantity inbound_qty = inbound.open_qty();
   Quantity deferred_qty = 0;
 
+  LevelQuantities & levels = levels_of(current_orders);
+
+  // If the levels that cross cannot supply the whole quantity no trade is
+  // possible.  Nothing is deferred either: none of their AON orders can be
+  // larger than the inbound one.
+  if(levels.available(inbound_price, inbound_qty) < inbound_qty)
+  {
+    return false;
+  }
+
   DeferredMatches deferred_matches;
 
   typename TrackerMap::iterator pos = current_orders.begin(); 
@@ -905,7 +1393,8 @@ OrderBook<OrderPtr>::match_aon_order(Tracker& inbound,
               // assert traded == current_quantity
               inbound_qty -= traded;
               matched = true;
-              current_orders.erase(entry);
+              levels.reduce(current_price, traded, true);
+              retire(current_orders, entry);
             }
           }
         }
@@ -938,7 +1427,9 @@ OrderBook<OrderPtr>::match_aon_order(Tracker& inbound,
           current_orders);
         if(inbound_qty <= current_quantity + traded)
         {
-          traded += create_trade(inbound, current_order);
+          Quantity current_traded = create_trade(inbound, current_order);
+          levels.reduce(current_price, current_traded, false);
+          traded += current_traded;
           if(traded > 0)
           {
             inbound_qty -= traded;
@@ -946,7 +1437,7 @@ OrderBook<OrderPtr>::match_aon_order(Tracker& inbound,
           }
           if(current_order.filled())
           {
-            current_orders.erase(entry);
+            retire(current_orders, entry);
           }
         }
       }
@@ -961,13 +1452,9 @@ OrderBook<OrderPtr>::match_aon_order(Tracker& inbound,
   }
   return matched;
 }
-namespace {
-  const size_t AON_LIMIT = 5;
-}
-
-template <class OrderPtr>
+template <class OrderPtr, class Listener, class Derived>
 Quantity
-OrderBook<OrderPtr>::try_create_deferred_trades(
+OrderBook<OrderPtr, Listener, Derived>::try_create_deferred_trades(
   Tracker& inbound,
   DeferredMatches & deferred_matches, 
   Quantity maxQty, // do not exceed
@@ -975,14 +1462,11 @@ OrderBook<OrderPtr>::try_create_deferred_trades(
   TrackerMap& current_orders)
 {
   Quantity traded = 0;
-  // create a vector of proposed trade quantities:
-  std::vector<int> fills(deferred_matches.size());
-  std::fill(fills.begin(), fills.end(), 0);
+  // proposed trade quantities, one per deferred match visited below
+  SmallVector<Quantity, 8> fills;
   Quantity foundQty = 0;
   auto pos = deferred_matches.begin(); 
-  for(size_t index = 0;
-    foundQty < maxQty && pos != deferred_matches.end();
-    ++index)
+  while(foundQty < maxQty && pos != deferred_matches.end())
   {
     auto entry = *pos++;
     Tracker & tracker = entry->second;
@@ -1001,7 +1485,7 @@ OrderBook<OrderPtr>::try_create_deferred_trades(
       }
     }
     foundQty += qty;
-    fills[index] = qty;
+    fills.push_back(qty);
   }
 
   if(foundQty >= minQty && foundQty <= maxQty)
@@ -1009,24 +1493,27 @@ OrderBook<OrderPtr>::try_create_deferred_trades(
     // pass through deferred matches again, doing the trades.
     auto pos = deferred_matches.begin(); 
     for(size_t index = 0;
-      traded < foundQty && pos != deferred_matches.end();
+      traded < foundQty && index < fills.size();
       ++index)
     {
       auto entry = *pos++;
       Tracker & tracker = entry->second;
-      traded += create_trade(inbound, tracker, fills[index]);
+      Quantity fill_qty = create_trade(inbound, tracker, fills[index]);
+      levels_of(current_orders).reduce(entry->first, fill_qty,
+        tracker.all_or_none());
+      traded += fill_qty;
       if(tracker.filled())
       {
-        current_orders.erase(entry);
+        retire(current_orders, entry);
       }
     }
   }
   return traded;
 }
 
-template <class OrderPtr>
+template <class OrderPtr, class Listener, class Derived>
 Quantity
-OrderBook<OrderPtr>::create_trade(Tracker& inbound_tracker, 
+OrderBook<OrderPtr, Listener, Derived>::create_trade(Tracker& inbound_tracker, 
                                   Tracker& current_tracker,
                                   Quantity maxQuantity)
 {
@@ -1050,50 +1537,106 @@ OrderBook<OrderPtr>::create_trade(Tracker& inbound_tracker,
                current_tracker.open_qty()));
   if(fill_qty > 0)
   {
-    inbound_tracker.fill(fill_qty);
-    current_tracker.fill(fill_qty);
-    set_market_price(cross_price);
-
-    typename TypedCallback::FillFlags fill_flags = 
-                                TypedCallback::ff_neither_filled;
-    if (!inbound_tracker.open_qty()) {
-      fill_flags = (typename TypedCallback::FillFlags)(
-                       fill_flags | TypedCallback::ff_inbound_filled);
-    }
-    if (!current_tracker.open_qty()) {
-      fill_flags = (typename TypedCallback::FillFlags)(
-                       fill_flags | TypedCallback::ff_matched_filled);
-    }
-
-    callbacks_.push_back(TypedCallback::fill(inbound_tracker.ptr(),
-                                             current_tracker.ptr(),
-                                             fill_qty,
-                                             cross_price,
-                                             fill_flags));
+    fill_trackers(inbound_tracker, current_tracker, fill_qty, cross_price);
   }
   return fill_qty;
 }
 
-template <class OrderPtr>
+template <class OrderPtr, class Listener, class Derived>
 void
-OrderBook<OrderPtr>::move_callbacks(Callbacks& target)
+OrderBook<OrderPtr, Listener, Derived>::fill_trackers(Tracker& inbound_tracker,
+                                  Tracker& current_tracker,
+                                  Quantity fill_qty,
+                                  Price cross_price)
+{
+  inbound_tracker.fill(fill_qty);
+  current_tracker.fill(fill_qty);
+  set_market_price(cross_price);
+
+  typename TypedCallback::FillFlags fill_flags = 
+                              TypedCallback::ff_neither_filled;
+  if (!inbound_tracker.open_qty()) {
+    fill_flags = (typename TypedCallback::FillFlags)(
+                     fill_flags | TypedCallback::ff_inbound_filled);
+  }
+  if (!current_tracker.open_qty()) {
+    fill_flags = (typename TypedCallback::FillFlags)(
+                     fill_flags | TypedCallback::ff_matched_filled);
+  }
+
+  push_callback(TypedCallback::fill(inbound_tracker.ptr(),
+                                           current_tracker.ptr(),
+                                           fill_qty,
+                                           cross_price,
+                                           fill_flags));
+}
+
+template <class OrderPtr, class Listener, class Derived>
+void
+OrderBook<OrderPtr, Listener, Derived>::move_callbacks(Callbacks& target)
 {
   COMPLAIN_ONCE("Ignoring call to deprecated method: move_callbacks");
   // We get to decide when callbacks happen.
   // And it *certainly* doesn't happen on another thread!
 }
 
-template <class OrderPtr>
+template <class OrderPtr, class Listener, class Derived>
 void
-OrderBook<OrderPtr>::perform_callbacks()
+OrderBook<OrderPtr, Listener, Derived>::perform_callbacks()
 {
   COMPLAIN_ONCE("Ignoring call to deprecated method: perform_callbacks");
   // We get to decide when callbacks happen.
 }
 
-template <class OrderPtr>
+template <class OrderPtr, class Listener, class Derived>
+inline void
+OrderBook<OrderPtr, Listener, Derived>::push_callback(const TypedCallback& cb)
+{
+  if(cb.type == TypedCallback::cb_book_update)
+  {
+    ++queued_book_updates_;
+  }
+  if(!handling_callbacks_)
+  {
+    callbacks_.push_back(cb);
+    return;
+  }
+  // The request that queued this callback returns before it is performed,
+  // so its order pointers may not outlive it.  Keep copies.
+  TypedCallback pinned = cb;
+  if(pinned.order.valid())
+  {
+    pinned_.push_back(pinned.order);
+    pinned.order = typename TypedCallback::Handle(pinned_.back());
+  }
+  if(pinned.matched_order.valid())
+  {
+    pinned_.push_back(pinned.matched_order);
+    pinned.matched_order = typename TypedCallback::Handle(pinned_.back());
+  }
+  callbacks_.push_back(pinned);
+}
+
+template <class OrderPtr, class Listener, class Derived>
+inline void
+OrderBook<OrderPtr, Listener, Derived>::retire(
+  TrackerMap& trackers, typename TrackerMap::iterator pos)
+{
+  levels_of(trackers).remove(pos->first, pos->second.open_qty(),
+    pos->second.all_or_none());
+  retired_.push_back(trackers.extract(pos));
+}
+
+template <class OrderPtr, class Listener, class Derived>
+inline LevelQuantities&
+OrderBook<OrderPtr, Listener, Derived>::levels_of(const TrackerMap& trackers)
+{
+  return &trackers == &bids_ ? bidLevels_ : askLevels_;
+}
+
+template <class OrderPtr, class Listener, class Derived>
 void
-OrderBook<OrderPtr>::callback_now()
+OrderBook<OrderPtr, Listener, Derived>::callback_now()
 {
   // protect against recursive calls
   // callbacks generated in response to previous callbacks
@@ -1101,50 +1644,65 @@ OrderBook<OrderPtr>::callback_now()
   if(!handling_callbacks_)
   {
     handling_callbacks_ = true;
-    // remove all accumulated callbacks in case
-    // new callbacks are generated by the application code.
+    // callbacks queued by the application code while these are being
+    // performed join the back of the ring
     while(!callbacks_.empty())
     {
-      // if we needed more entries, be sure that both containers have them.
-      workingCallbacks_.reserve(callbacks_.capacity());
-      workingCallbacks_.swap(callbacks_);
-      for (auto cb = workingCallbacks_.begin(); cb != workingCallbacks_.end(); ++cb) {
-        try
+      TypedCallback cb = callbacks_.pop_front();
+      if(cb.type == TypedCallback::cb_book_update)
+      {
+        // A later book update (e.g. from a request a listener issued) or
+        // the release of a hold reports the final state instead
+        --queued_book_updates_;
+        if(queued_book_updates_ || book_update_holds_)
         {
-          perform_callback(*cb);
+          book_update_deferred_ = book_update_deferred_ || book_update_holds_;
+          continue;
         }
-        catch(const std::exception & ex)
+        book_update_deferred_ = false;
+      }
+      try
+      {
+        if constexpr (static_listener) {
+          perform_static_callback(cb);
+        } else {
+          perform_callback(cb);
+        }
+      }
+      catch(const std::exception & ex)
+      {
+        if(logger_)
         {
-          if(logger_)
-          {
-            logger_->log_exception("Caught exception during callback: ", ex);
-          }
-          else
-          {
-            std::cerr << "Caught exception during callback: " << ex.what() << std::endl;
-          }
+          logger_->log_exception("Caught exception during callback: ", ex);
+        }
+        else
+        {
+          std::cerr << "Caught exception during callback: " << ex.what() << std::endl;
         }
-        catch(...)
+      }
+      catch(...)
+      {
+        if(logger_)
         {
-          if(logger_)
-          {
-            logger_->log_message("Caught unknown exception during callback");
-          }
-          else
-          {
-            std::cerr << "Caught unknown exception during callback" << std::endl;
-          }
+          logger_->log_message("Caught unknown exception during callback");
+        }
+        else
+        {
+          std::cerr << "Caught unknown exception during callback" << std::endl;
         }
       }
-      workingCallbacks_.clear();
     }
+    // every callback has been performed; release what they referred to
+    retired_.clear();
+    retiredPending_.clear();
+    pinned_.clear();
     handling_callbacks_ = false;
   }
 }
 
-template <class OrderPtr>
+template <class OrderPtr, class Listener, class Derived>
 void
-OrderBook<OrderPtr>::perform_callback(TypedCallback& cb)
+OrderBook<OrderPtr, Listener, Derived>::perform_callback(TypedCallback& cb)
 {
   switch (cb.type) 
   {
@@ -1179,7 +1737,7 @@ OrderBook<OrderPtr>::perform_callback(TypedCallback& cb)
       on_accept_stop(cb.order);
       if(order_listener_)
       {
-        order_listener_->on_accept(cb.order);
+        order_listener_->on_accept_stop(cb.order);
       }
       break;
     case TypedCallback::cb_order_trigger_stop:
@@ -1207,7 +1765,7 @@ OrderBook<OrderPtr>::perform_callback(TypedCallback& cb)
       on_cancel_stop(cb.order);
       if(order_listener_)
       {
-        order_listener_->on_cancel(cb.order);
+        order_listener_->on_cancel_stop(cb.order);
       }
       break;
     case TypedCallback::cb_order_cancel_reject:
@@ -1218,9 +1776,11 @@ OrderBook<OrderPtr>::perform_callback(TypedCallback& cb)
       }
       break;
     case TypedCallback::cb_order_replace:
+      // Depth tracks open quantity, so pass the open quantity captured
+      // when the replace was accepted (differs from order_qty once filled)
       on_replace(cb.order, 
-        cb.order->order_qty(), 
-        cb.order->order_qty() + cb.delta,
+        cb.quantity, 
+        cb.quantity + cb.delta,
         cb.price);
       if(order_listener_)
       {
@@ -1253,9 +1813,149 @@ OrderBook<OrderPtr>::perform_callback(TypedCallback& cb)
   }
 }
 
-template <class OrderPtr>
+template <class OrderPtr, class Listener, class Derived>
+inline void
+OrderBook<OrderPtr, Listener, Derived>::perform_static_callback(TypedCallback& cb)
+{
+  // Qualified calls bind to TypedBook's and Listener's own overrides, so
+  // nothing here goes through a vtable.  Listener takes every role whose
+  // interface it implements.
+  constexpr bool order_role =
+    std::is_base_of<OrderListener<OrderPtr>, Listener>::value;
+  constexpr bool trade_role =
+    std::is_base_of<TradeListener<TypedBook>, Listener>::value;
+  constexpr bool book_role =
+    std::is_base_of<OrderBookListener<TypedBook>, Listener>::value;
+  TypedBook& book = static_cast<TypedBook&>(*this);
+  Listener* listener = listener_;
+
+  switch (cb.type) 
+  {
+    case TypedCallback::cb_order_fill: 
+    {
+      bool inbound_filled = (cb.flags & (TypedCallback::ff_inbound_filled | TypedCallback::ff_both_filled)) != 0;
+      bool matched_filled = (cb.flags & (TypedCallback::ff_matched_filled | TypedCallback::ff_both_filled)) != 0;
+      book.TypedBook::on_fill(cb.order, cb.matched_order, 
+        cb.quantity, cb.price,
+        inbound_filled,
+        matched_filled);
+      if constexpr (order_role) {
+        if(listener)
+        {
+          listener->Listener::on_fill(cb.order, cb.matched_order, 
+                                      cb.quantity, cb.price);
+        }
+      }
+      book.TypedBook::on_trade(&book, cb.quantity, cb.price);
+      if constexpr (trade_role) {
+        if(listener)
+        {
+          listener->Listener::on_trade(&book, cb.quantity, cb.price);
+        }
+      }
+      break;
+    }
+    case TypedCallback::cb_order_accept:
+      book.TypedBook::on_accept(cb.order, cb.quantity);
+      if constexpr (order_role) {
+        if(listener)
+        {
+          listener->Listener::on_accept(cb.order);
+        }
+      }
+      break;
+    case TypedCallback::cb_order_accept_stop:
+      book.TypedBook::on_accept_stop(cb.order);
+      if constexpr (order_role) {
+        if(listener)
+        {
+          listener->Listener::on_accept_stop(cb.order);
+        }
+      }
+      break;
+    case TypedCallback::cb_order_trigger_stop:
+      book.TypedBook::on_trigger_stop(cb.order);
+      if constexpr (order_role) {
+        if(listener)
+        {
+          listener->Listener::on_trigger_stop(cb.order);
+        }
+      }
+      break;
+    case TypedCallback::cb_order_reject:
+      book.TypedBook::on_reject(cb.order, cb.reject_reason);
+      if constexpr (order_role) {
+        if(listener)
+        {
+          listener->Listener::on_reject(cb.order, cb.reject_reason);
+        }
+      }
+      break;
+    case TypedCallback::cb_order_cancel:
+      book.TypedBook::on_cancel(cb.order, cb.quantity);
+      if constexpr (order_role) {
+        if(listener)
+        {
+          listener->Listener::on_cancel(cb.order);
+        }
+      }
+      break;
+    case TypedCallback::cb_order_cancel_stop:
+      book.TypedBook::on_cancel_stop(cb.order);
+      if constexpr (order_role) {
+        if(listener)
+        {
+          listener->Listener::on_cancel_stop(cb.order);
+        }
+      }
+      break;
+    case TypedCallback::cb_order_cancel_reject:
+      book.TypedBook::on_cancel_reject(cb.order, cb.reject_reason);
+      if constexpr (order_role) {
+        if(listener)
+        {
+          listener->Listener::on_cancel_reject(cb.order, cb.reject_reason);
+        }
+      }
+      break;
+    case TypedCallback::cb_order_replace:
+      book.TypedBook::on_replace(cb.order, 
+        cb.quantity, 
+        cb.quantity + cb.delta,
+        cb.price);
+      if constexpr (order_role) {
+        if(listener)
+        {
+          listener->Listener::on_replace(cb.order, cb.delta, cb.price);
+        }
+      }
+      break;
+    case TypedCallback::cb_order_replace_reject:
+      book.TypedBook::on_replace_reject(cb.order, cb.reject_reason);
+      if constexpr (order_role) {
+        if(listener)
+        {
+          listener->Listener::on_replace_reject(cb.order, cb.reject_reason);
+        }
+      }
+      break;
+    case TypedCallback::cb_book_update:
+      book.TypedBook::on_order_book_change();
+      if constexpr (book_role) {
+        if(listener)
+        {
+          listener->Listener::on_order_book_change(&book);
+        }
+      }
+      break;
+    default:
+      break;
+  }
+}
+
+template <class OrderPtr, class Listener, class Derived>
 std::ostream &
-OrderBook<OrderPtr>::log(std::ostream & out) const
+OrderBook<OrderPtr, Listener, Derived>::log(std::ostream & out) const
 {
   for(auto ask = asks_.rbegin(); ask != asks_.rend(); ++ask) {
     out << "  Ask " << ask->second.open_qty() << " @ " << ask->first
@@ -16,7 +16,11 @@ public:
   /// @brief callback for an order accept
   virtual void on_accept(const OrderPtr& order) = 0;
 
-  /// @brief callback for triggered STOP order
+  /// @brief callback for a STOP order accepted but held until triggered.
+  ///        Defaults to on_accept.
+  virtual void on_accept_stop(const OrderPtr& order) { on_accept(order); }
+
+  /// @brief callback for triggered STOP order, made before any of its fills
   virtual void on_trigger_stop(const OrderPtr& order) {}
 
   /// @brief callback for an order reject
@@ -35,6 +39,10 @@ public:
   /// @brief callback for an order cancellation
   virtual void on_cancel(const OrderPtr& order) = 0;
 
+  /// @brief callback for a cancelled STOP order that never reached the
+  ///        market.  Defaults to on_cancel.
+  virtual void on_cancel_stop(const OrderPtr& order) { on_cancel(order); }
+
   /// @brief callback for an order cancel rejection
   virtual void on_cancel_reject(const OrderPtr& order, const char* reason) = 0;
 
@@ -0,0 +1,65 @@
+// Copyright (c) 2012 - 2017 Object Computing, Inc.
+// All rights reserved.
+// See the file license.txt for licensing information.
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace liquibook { namespace book {
+
+/// @brief append-only vector that keeps its first N elements inline.
+///   Meant for short-lived lists built during one match: no allocation until
+///   more than N elements are added, then one contiguous heap buffer.
+///   Not copyable; elements must be default constructible.
+template <typename T, size_t N>
+class SmallVector {
+public:
+  typedef T* iterator;
+  typedef const T* const_iterator;
+
+  SmallVector() : data_(inline_), size_(0), capacity_(N) {}
+  SmallVector(const SmallVector&) = delete;
+  SmallVector& operator=(const SmallVector&) = delete;
+
+  /// @brief append an element
+  void push_back(const T& value);
+
+  size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+  void clear() { size_ = 0; }
+
+  T& operator[](size_t index) { return data_[index]; }
+  const T& operator[](size_t index) const { return data_[index]; }
+
+  iterator begin() { return data_; }
+  iterator end() { return data_ + size_; }
+  const_iterator begin() const { return data_; }
+  const_iterator end() const { return data_ + size_; }
+
+private:
+  T* data_;
+  size_t size_;
+  size_t capacity_;
+  T inline_[N];
+  std::vector<T> heap_;
+};
+
+template <typename T, size_t N>
+inline void
+SmallVector<T, N>::push_back(const T& value)
+{
+  if (size_ == capacity_) {
+    // Move everything to a heap buffer of twice the size
+    std::vector<T> grown(capacity_ * 2);
+    for (size_t i = 0; i < size_; ++i) {
+      grown[i] = data_[i];
+    }
+    heap_.swap(grown);
+    data_ = heap_.data();
+    capacity_ = heap_.size();
+  }
+  data_[size_++] = value;
+}
+
+} }
@@ -992,4 +992,44 @@ BOOST_AUTO_TEST_CASE(TestReplaceBidLargerMatchAon)
   BOOST_CHECK_EQUAL(2, order_book.asks().size());
 }
 
+BOOST_AUTO_TEST_CASE(TestAonBidExceedsCrossingLevels)
+{
+  SimpleOrderBook order_book;
+  SimpleOrder ask2(sellSide, prc2, qty1);
+  SimpleOrder ask1(sellSide, prc2, qty2); // AON
+  SimpleOrder ask0(sellSide, prc1, qty1);
+  SimpleOrder bid0(buySide, prc2, qty4);  // AON
+
+  // No match - the crossing levels hold only qty3
+  BOOST_CHECK(add_and_verify(order_book, &ask0, expectNoMatch));
+  BOOST_CHECK(add_and_verify(order_book, &ask1, expectNoMatch, expectNoComplete, AON));
+  BOOST_CHECK(add_and_verify(order_book, &bid0, expectNoMatch, expectNoComplete, AON));
+
+  // Verify sizes
+  BOOST_CHECK_EQUAL(1, order_book.bids().size());
+  BOOST_CHECK_EQUAL(2, order_book.asks().size());
+  BOOST_CHECK_EQUAL(2, order_book.askLevels().levels().size());
+
+  // Verify depth
+  DepthCheck<SimpleOrderBook> dc(order_book.depth());
+  BOOST_CHECK(dc.verify_bid(prc2, 1, qty4));
+  BOOST_CHECK(dc.verify_ask(prc1, 1, qty1));
+  BOOST_CHECK(dc.verify_ask(prc2, 1, qty2));
+
+  // Match - complete, the new ask makes the levels deep enough
+  {
+    SimpleFillCheck fc0(&bid0, qty4, prc1 * qty1 + prc2 * qty3);
+    SimpleFillCheck fc1(&ask0, qty1, prc1 * qty1);
+    SimpleFillCheck fc2(&ask1, qty2, prc2 * qty2);
+    SimpleFillCheck fc3(&ask2, qty1, prc2 * qty1);
+    BOOST_CHECK(add_and_verify(order_book, &ask2, expectMatch, expectComplete));
+  }
+
+  // Verify sizes
+  BOOST_CHECK_EQUAL(0, order_book.bids().size());
+  BOOST_CHECK_EQUAL(0, order_book.asks().size());
+  BOOST_CHECK(order_book.bidLevels().levels().empty());
+  BOOST_CHECK(order_book.askLevels().levels().empty());
+}
+
 } // Namespace
@@ -0,0 +1,225 @@
+// Copyright (c) 2012 - 2017 Object Computing, Inc.
+// All rights reserved.
+// See the file license.txt for licensing information.
+
+#define BOOST_TEST_NO_MAIN LiquibookTest
+#include <boost/test/unit_test.hpp>
+
+#include "ut_utils.h"
+#include <book/auction.h>
+
+namespace liquibook {
+
+using simple::SimpleOrder;
+typedef FillCheck<SimpleOrder*> SimpleFillCheck;
+
+namespace {
+const OrderConditions AON(oc_all_or_none);
+const OrderConditions IOC(oc_immediate_or_cancel);
+
+const Quantity qty1 = 100;
+const Quantity qty2 = qty1 + qty1;
+
+const Price prc0 = 1250;
+const Price prc1 = 1251;
+const Price prc2 = 1252;
+const Price prc3 = 1253;
+const Price prcMkt = 0;
+
+const bool buySide = true;
+const bool sellSide = false;
+const bool expectMatch = true;
+const bool expectNoMatch = false;
+const bool expectComplete = true;
+
+void add_level(LevelQuantities& levels, bool buy, Price price, Quantity qty)
+{
+  levels.add(ComparablePrice(buy, price), qty, false);
+}
+}
+
+BOOST_AUTO_TEST_CASE(TestAuctionEquilibriumMaxVolume)
+{
+  LevelQuantities bids;
+  LevelQuantities asks;
+  add_level(bids, buySide, prc3, qty1);
+  add_level(bids, buySide, prc2, qty1);
+  add_level(bids, buySide, prc1, qty1);
+  add_level(asks, sellSide, prc0, qty1);
+  add_level(asks, sellSide, prc1, qty1);
+  add_level(asks, sellSide, prc3, qty1);
+
+  // 1251 and 1252 both execute 200; 1252 leaves no imbalance
+  AuctionResult result = auction_equilibrium(bids, asks, prc1);
+  BOOST_CHECK_EQUAL(prc2, result.price);
+  BOOST_CHECK_EQUAL(qty2, result.volume);
+  BOOST_CHECK_EQUAL(0U, result.imbalance);
+}
+
+BOOST_AUTO_TEST_CASE(TestAuctionEquilibriumReferenceTiebreak)
+{
+  LevelQuantities bids;
+  LevelQuantities asks;
+  add_level(bids, buySide, prc2, qty1);
+  add_level(asks, sellSide, prc0, qty1);
+
+  // Any price from 1250 to 1252 executes 100 with no imbalance
+  BOOST_CHECK_EQUAL(prc2, auction_equilibrium(bids, asks, 1260).price);
+  BOOST_CHECK_EQUAL(prc0, auction_equilibrium(bids, asks, 1240).price);
+  // Equally near: the lower price
+  BOOST_CHECK_EQUAL(prc0, auction_equilibrium(bids, asks, prc1).price);
+  BOOST_CHECK_EQUAL(prc0, auction_equilibrium(bids, asks, prcMkt).price);
+}
+
+BOOST_AUTO_TEST_CASE(TestAuctionEquilibriumMarketOrders)
+{
+  LevelQuantities bids;
+  LevelQuantities asks;
+  add_level(bids, buySide, prcMkt, qty1);
+  add_level(asks, sellSide, prcMkt, qty1);
+
+  // Nothing but market orders: cross at the reference, if there is one
+  AuctionResult result = auction_equilibrium(bids, asks, prc1);
+  BOOST_CHECK_EQUAL(prc1, result.price);
+  BOOST_CHECK_EQUAL(qty1, result.volume);
+  BOOST_CHECK_EQUAL(0U, auction_equilibrium(bids, asks, prcMkt).volume);
+
+  // A market bid counts at every price
+  add_level(bids, buySide, prcMkt, qty2);
+  add_level(asks, sellSide, prc1, qty1);
+  add_level(asks, sellSide, prc2, qty1);
+  result = auction_equilibrium(bids, asks, prc1);
+  BOOST_CHECK_EQUAL(prc2, result.price);
+  BOOST_CHECK_EQUAL(qty2 + qty1, result.volume);
+  BOOST_CHECK_EQUAL(0U, result.imbalance);
+}
+
+BOOST_AUTO_TEST_CASE(TestAuctionEquilibriumNoCross)
+{
+  LevelQuantities bids;
+  LevelQuantities asks;
+  add_level(bids, buySide, prc0, qty1);
+  add_level(asks, sellSide, prc1, qty1);
+  AuctionResult result = auction_equilibrium(bids, asks, prc0);
+  BOOST_CHECK_EQUAL(0U, result.volume);
+  BOOST_CHECK_EQUAL(prcMkt, result.price);
+}
+
+BOOST_AUTO_TEST_CASE(TestAuctionUncross)
+{
+  SimpleOrderBook order_book;
+  order_book.start_auction();
+  BOOST_CHECK(order_book.in_auction());
+
+  SimpleOrder bid3(buySide, prc3, qty1);
+  SimpleOrder bid2(buySide, prc2, qty1);
+  SimpleOrder bid1(buySide, prc1, qty1);
+  SimpleOrder ask0(sellSide, prc0, qty1);
+  SimpleOrder ask1(sellSide, prc1, qty1);
+  SimpleOrder ask3(sellSide, prc3, qty1);
+
+  // Crossing orders rest without matching
+  BOOST_CHECK(add_and_verify(order_book, &bid1, expectNoMatch));
+  BOOST_CHECK(add_and_verify(order_book, &ask0, expectNoMatch));
+  BOOST_CHECK(add_and_verify(order_book, &bid3, expectNoMatch));
+  BOOST_CHECK(add_and_verify(order_book, &ask3, expectNoMatch));
+  BOOST_CHECK(add_and_verify(order_book, &bid2, expectNoMatch));
+  BOOST_CHECK(add_and_verify(order_book, &ask1, expectNoMatch));
+  BOOST_CHECK_EQUAL(3U, order_book.bids().size());
+  BOOST_CHECK_EQUAL(3U, order_book.asks().size());
+
+  // All-or-none orders are rejected, never accepted
+  SimpleOrder aon(buySide, prc3, qty1);
+  BOOST_CHECK(!order_book.add(&aon, AON));
+  BOOST_CHECK_EQUAL(simple::os_new, aon.state());
+  BOOST_CHECK_EQUAL(3U, order_book.bids().size());
+
+  DepthCheck<SimpleOrderBook> dc(order_book.depth());
+  BOOST_CHECK(dc.verify_bid(prc3, 1, qty1));
+  BOOST_CHECK(dc.verify_ask(prc0, 1, qty1));
+
+  // Best bids fill against best asks, all at 1252
+  {
+    SimpleFillCheck fc1(&bid3, qty1, qty1 * prc2);
+    SimpleFillCheck fc2(&bid2, qty1, qty1 * prc2);
+    SimpleFillCheck fc3(&ask0, qty1, qty1 * prc2);
+    SimpleFillCheck fc4(&ask1, qty1, qty1 * prc2);
+    AuctionResult result = order_book.uncross(prc1);
+    BOOST_CHECK_EQUAL(prc2, result.price);
+    BOOST_CHECK_EQUAL(qty2, result.volume);
+  }
+  BOOST_CHECK(!order_book.in_auction());
+  BOOST_CHECK_EQUAL(prc2, order_book.market_price());
+  BOOST_CHECK(verify_levels(order_book));
+
+  // What is left no longer crosses
+  dc.reset();
+  BOOST_CHECK(dc.verify_bid(prc1, 1, qty1));
+  BOOST_CHECK(dc.verify_ask(prc3, 1, qty1));
+  BOOST_CHECK(dc.verify_bids_done());
+  BOOST_CHECK_EQUAL(1U, order_book.asks().size());
+
+  // Back to continuous matching
+  SimpleOrder ask2(sellSide, prc1, qty1);
+  {
+    SimpleFillCheck fc1(&bid1, qty1, qty1 * prc1);
+    BOOST_CHECK(add_and_verify(order_book, &ask2, expectMatch, expectComplete));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(TestAuctionCancelsRemainders)
+{
+  SimpleOrderBook order_book;
+  order_book.start_auction();
+  SimpleOrder bid0(buySide, prcMkt, qty2);
+  SimpleOrder bid1(buySide, prc0, qty1);
+  SimpleOrder ask0(sellSide, prc1, qty1);
+  BOOST_CHECK(add_and_verify(order_book, &bid0, expectNoMatch));
+  // IOC orders rest until the auction ends
+  BOOST_CHECK(!order_book.add(&bid1, IOC));
+  BOOST_CHECK_EQUAL(simple::os_accepted, bid1.state());
+  BOOST_CHECK(add_and_verify(order_book, &ask0, expectNoMatch));
+  BOOST_CHECK_EQUAL(2U, order_book.bids().size());
+
+  {
+    SimpleFillCheck fc1(&ask0, qty1, qty1 * prc1);
+    AuctionResult result = order_book.uncross(prc0);
+    BOOST_CHECK_EQUAL(prc1, result.price);
+    BOOST_CHECK_EQUAL(qty1, result.volume);
+    BOOST_CHECK_EQUAL(qty1, result.imbalance);
+  }
+  BOOST_CHECK_EQUAL(qty1, bid0.filled_qty());
+  BOOST_CHECK_EQUAL(simple::os_cancelled, bid0.state());
+  BOOST_CHECK_EQUAL(simple::os_cancelled, bid1.state());
+  BOOST_CHECK(order_book.bids().empty());
+  BOOST_CHECK(order_book.asks().empty());
+  BOOST_CHECK(verify_levels(order_book));
+}
+
+BOOST_AUTO_TEST_CASE(TestAuctionTriggersStops)
+{
+  SimpleOrderBook order_book;
+  order_book.set_market_price(prc0);
+  SimpleOrder stop(buySide, prcMkt, qty1, prc2);
+  BOOST_CHECK(add_and_verify(order_book, &stop, expectNoMatch));
+  BOOST_CHECK_EQUAL(1U, order_book.stopBids().size());
+
+  order_book.start_auction();
+  SimpleOrder bid0(buySide, prc2, qty1);
+  SimpleOrder ask0(sellSide, prc2, qty1);
+  SimpleOrder ask1(sellSide, prc3, qty1);
+  BOOST_CHECK(add_and_verify(order_book, &bid0, expectNoMatch));
+  BOOST_CHECK(add_and_verify(order_book, &ask0, expectNoMatch));
+  BOOST_CHECK(add_and_verify(order_book, &ask1, expectNoMatch));
+
+  // The auction price reaches the stop, which then trades continuously
+  {
+    SimpleFillCheck fc1(&stop, qty1, qty1 * prc3);
+    SimpleFillCheck fc2(&ask1, qty1, qty1 * prc3);
+    BOOST_CHECK_EQUAL(prc2, order_book.uncross(prc0).price);
+  }
+  BOOST_CHECK(order_book.stopBids().empty());
+  BOOST_CHECK_EQUAL(prc3, order_book.market_price());
+}
+
+} // namespace
@@ -0,0 +1,139 @@
+// Copyright (c) 2012 - 2017 Object Computing, Inc.
+// All rights reserved.
+// See the file license.txt for licensing information.
+
+#define BOOST_TEST_NO_MAIN LiquibookTest
+#include <boost/test/unit_test.hpp>
+
+#include "ut_utils.h"
+#include <simple/simple_order.h>
+#include <simple/simple_order_book.h>
+
+namespace liquibook {
+
+using simple::SimpleOrder;
+
+typedef std::vector<SimpleOrder*> OrderBatch;
+
+BOOST_AUTO_TEST_CASE(TestBulkLoadBuildsLevelsAndDepth)
+{
+  SimpleOrderBook order_book;
+  SimpleOrder bid0(true, 1250, 100);
+  SimpleOrder bid1(true, 1250, 200);
+  SimpleOrder bid2(true, 1240, 300);
+  SimpleOrder ask0(false, 1260, 400);
+  SimpleOrder ask1(false, 1270, 500);
+  SimpleOrder ask2(false, 1270, 600);
+
+  // Sides may interleave, each side is best price first
+  OrderBatch batch = { &bid0, &ask0, &bid1, &ask1, &bid2, &ask2 };
+  BOOST_CHECK(order_book.bulk_load(batch) == nullptr);
+  BOOST_CHECK_EQUAL(3, order_book.bids().size());
+  BOOST_CHECK_EQUAL(3, order_book.asks().size());
+
+  DepthCheck<SimpleOrderBook> dc(order_book.depth());
+  BOOST_CHECK(dc.verify_bid(1250, 2, 300));
+  BOOST_CHECK(dc.verify_bid(1240, 1, 300));
+  BOOST_CHECK(dc.verify_ask(1260, 1, 400));
+  BOOST_CHECK(dc.verify_ask(1270, 2, 1100));
+
+  BOOST_CHECK_EQUAL(2, order_book.full_depth().bid_level_count());
+  BOOST_CHECK_EQUAL(2, order_book.full_depth().ask_level_count());
+
+  // Batch order is time priority within a level
+  SimpleOrder sell(false, 1250, 150);
+  BOOST_CHECK(add_and_verify(order_book, &sell, true, true));
+  BOOST_CHECK_EQUAL(100, bid0.filled_qty());
+  BOOST_CHECK_EQUAL(50, bid1.filled_qty());
+
+  dc.reset();
+  BOOST_CHECK(dc.verify_bid(1250, 1, 150));
+  BOOST_CHECK(dc.verify_bid(1240, 1, 300));
+}
+
+BOOST_AUTO_TEST_CASE(TestBulkLoadQueuesBehindRestingOrders)
+{
+  SimpleOrderBook order_book;
+  SimpleOrder resting(true, 1250, 100);
+  BOOST_CHECK(add_and_verify(order_book, &resting, false));
+
+  SimpleOrder bid0(true, 1250, 200);
+  OrderBatch batch = { &bid0 };
+  BOOST_CHECK(order_book.bulk_load(batch) == nullptr);
+
+  DepthCheck<SimpleOrderBook> dc(order_book.depth());
+  BOOST_CHECK(dc.verify_bid(1250, 2, 300));
+
+  SimpleOrder sell(false, 1250, 100);
+  BOOST_CHECK(add_and_verify(order_book, &sell, true, true));
+  BOOST_CHECK_EQUAL(100, resting.filled_qty());
+  BOOST_CHECK_EQUAL(0, bid0.filled_qty());
+}
+
+BOOST_AUTO_TEST_CASE(TestBulkLoadRejectsCrossedBatch)
+{
+  SimpleOrderBook order_book;
+  SimpleOrder bid0(true, 1260, 100);
+  SimpleOrder ask0(false, 1260, 100);
+  OrderBatch batch = { &bid0, &ask0 };
+  BOOST_CHECK(order_book.bulk_load(batch) != nullptr);
+  BOOST_CHECK(order_book.bids().empty());
+  BOOST_CHECK(order_book.asks().empty());
+  BOOST_CHECK_EQUAL(0, order_book.full_depth().bid_level_count());
+}
+
+BOOST_AUTO_TEST_CASE(TestBulkLoadRejectsBatchCrossingBook)
+{
+  SimpleOrderBook order_book;
+  SimpleOrder resting(false, 1250, 100);
+  BOOST_CHECK(add_and_verify(order_book, &resting, false));
+
+  SimpleOrder bid0(true, 1240, 100);
+  SimpleOrder bid1(true, 1250, 100);
+  OrderBatch crossing = { &bid1 };
+  BOOST_CHECK(order_book.bulk_load(crossing) != nullptr);
+  BOOST_CHECK(order_book.bids().empty());
+
+  OrderBatch passive = { &bid0 };
+  BOOST_CHECK(order_book.bulk_load(passive) == nullptr);
+  BOOST_CHECK_EQUAL(1, order_book.bids().size());
+}
+
+BOOST_AUTO_TEST_CASE(TestBulkLoadRejectsUnsortedBatch)
+{
+  SimpleOrderBook order_book;
+  SimpleOrder bid0(true, 1240, 100);
+  SimpleOrder bid1(true, 1250, 100);
+  OrderBatch bids = { &bid0, &bid1 };
+  BOOST_CHECK(order_book.bulk_load(bids) != nullptr);
+
+  SimpleOrder ask0(false, 1270, 100);
+  SimpleOrder ask1(false, 1260, 100);
+  OrderBatch asks = { &ask0, &ask1 };
+  BOOST_CHECK(order_book.bulk_load(asks) != nullptr);
+
+  BOOST_CHECK(order_book.bids().empty());
+  BOOST_CHECK(order_book.asks().empty());
+}
+
+BOOST_AUTO_TEST_CASE(TestBulkLoadRejectsOrdersThatCannotRest)
+{
+  SimpleOrderBook order_book;
+  SimpleOrder good(true, 1250, 100);
+  SimpleOrder market(true, MARKET_ORDER_PRICE, 100);
+  SimpleOrder stop(true, 1240, 100, 1260);
+  SimpleOrder ioc(true, 1240, 100, 0, oc_immediate_or_cancel);
+  SimpleOrder empty(true, 1240, 0);
+
+  OrderBatch batch = { &good, &market };
+  BOOST_CHECK(order_book.bulk_load(batch) != nullptr);
+  batch = { &good, &stop };
+  BOOST_CHECK(order_book.bulk_load(batch) != nullptr);
+  batch = { &good, &ioc };
+  BOOST_CHECK(order_book.bulk_load(batch) != nullptr);
+  batch = { &good, &empty };
+  BOOST_CHECK(order_book.bulk_load(batch) != nullptr);
+  BOOST_CHECK(order_book.bids().empty());
+}
+
+} // namespace
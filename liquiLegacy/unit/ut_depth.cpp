@@ -1067,4 +1067,45 @@ BOOST_AUTO_TEST_CASE(TestReplaceAsk)
   cc.reset();
 }
 
+BOOST_AUTO_TEST_CASE(TestCloseUnknownPriceLeavesBookAlone)
+{
+  SizedDepth depth;
+  depth.add_order(1234, 100, true);
+  depth.add_order(1236, 300, false);
+  ChangedChecker cc(depth);
+  // Not a level on either side
+  BOOST_CHECK(!depth.close_order(1230, 100, true));
+  BOOST_CHECK(!depth.close_order(1240, 300, false));
+  depth.change_qty_order(1230, -50, true);
+  BOOST_CHECK(cc.verify_bid_changed(false, false, false, false, false));
+  BOOST_CHECK(cc.verify_ask_changed(false, false, false, false, false));
+
+  const DepthLevel* bid = depth.bids();
+  const DepthLevel* ask = depth.asks();
+  BOOST_CHECK(verify_level(bid, 1234, 1, 100));
+  BOOST_CHECK(verify_level(ask, 1236, 1, 300));
+}
+
+BOOST_AUTO_TEST_CASE(TestInsertEraseAcrossExcess)
+{
+  SizedDepth depth;
+  // Fill the visible bids and two excess levels
+  for (book::Price price = 1230; price <= 1242; price += 2) {
+    depth.add_order(price, 100, true);
+  }
+  // Insert between visible levels, pushing 1234 into the excess
+  depth.add_order(1239, 50, true);
+  // Erase the best level, restoring 1234 from the excess
+  BOOST_CHECK(depth.close_order(1242, 100, true));
+  // Erase a middle level, restoring 1232 from the excess
+  BOOST_CHECK(depth.close_order(1239, 50, true));
+
+  const DepthLevel* bid = depth.bids();
+  BOOST_CHECK(verify_level(bid, 1240, 1, 100));
+  BOOST_CHECK(verify_level(bid, 1238, 1, 100));
+  BOOST_CHECK(verify_level(bid, 1236, 1, 100));
+  BOOST_CHECK(verify_level(bid, 1234, 1, 100));
+  BOOST_CHECK(verify_level(bid, 1232, 1, 100));
+}
+
 } // namespace
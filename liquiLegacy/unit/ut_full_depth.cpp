@@ -0,0 +1,206 @@
+// Copyright (c) 2012 - 2017 Object Computing, Inc.
+// All rights reserved.
+// See the file license.txt for licensing information.
+
+#define BOOST_TEST_NO_MAIN LiquibookTest
+#include <boost/test/unit_test.hpp>
+
+#include <book/full_depth.h>
+#include <simple/simple_order.h>
+#include <simple/simple_order_book.h>
+#include "ut_utils.h"
+#include <iostream>
+
+namespace liquibook {
+
+using book::FullDepth;
+using book::DepthLevel;
+using book::LadderStep;
+using simple::SimpleOrder;
+
+namespace {
+bool verify_full_level(const DepthLevel& level,
+                       book::Price price,
+                       uint32_t order_count,
+                       book::Quantity aggregate_qty)
+{
+  bool matched = true;
+  if (price != level.price()) {
+    std::cout << "Level price " << level.price() << std::endl;
+    matched = false;
+  }
+  if (order_count != level.order_count()) {
+    std::cout << "Level order count " << level.order_count() << std::endl;
+    matched = false;
+  }
+  if (aggregate_qty != level.aggregate_qty()) {
+    std::cout << "Level aggregate qty " << level.aggregate_qty() << std::endl;
+    matched = false;
+  }
+  return matched;
+}
+}
+
+BOOST_AUTO_TEST_CASE(TestFullDepthKeepsAllBidLevels)
+{
+  FullDepth depth;
+  // More levels than any fixed Depth<SIZE> in use
+  for (book::Price price = 1000; price < 1030; ++price) {
+    depth.add_order(price, 100, true);
+  }
+  depth.add_order(1010, 50, true);
+  BOOST_CHECK_EQUAL(30, depth.bid_level_count());
+  BOOST_CHECK_EQUAL(0, depth.ask_level_count());
+
+  std::vector<DepthLevel> levels;
+  BOOST_CHECK_EQUAL(30, depth.top_n(true, 0, levels));
+  BOOST_CHECK(verify_full_level(levels[0], 1029, 1, 100));
+  BOOST_CHECK(verify_full_level(levels[19], 1010, 2, 150));
+  BOOST_CHECK(verify_full_level(levels[29], 1000, 1, 100));
+}
+
+BOOST_AUTO_TEST_CASE(TestFullDepthTopNAsks)
+{
+  FullDepth depth;
+  depth.add_order(1250, 100, false);
+  depth.add_order(1230, 200, false);
+  depth.add_order(1240, 300, false);
+  depth.add_order(1230, 400, false);
+
+  std::vector<DepthLevel> levels;
+  BOOST_CHECK_EQUAL(2, depth.top_n(false, 2, levels));
+  BOOST_CHECK(verify_full_level(levels[0], 1230, 2, 600));
+  BOOST_CHECK(verify_full_level(levels[1], 1240, 1, 300));
+  // Asking for more than exists returns what there is
+  BOOST_CHECK_EQUAL(3, depth.top_n(false, 10, levels));
+  BOOST_CHECK(verify_full_level(levels[2], 1250, 1, 100));
+}
+
+BOOST_AUTO_TEST_CASE(TestFullDepthCloseEraseAndChange)
+{
+  FullDepth depth;
+  depth.add_order(1250, 100, true);
+  depth.add_order(1250, 200, true);
+  depth.add_order(1240, 300, true);
+
+  BOOST_CHECK(!depth.close_order(1250, 100, true));
+  BOOST_CHECK(depth.close_order(1240, 300, true));
+  depth.change_qty_order(1250, -50, true);
+  // Unknown levels are ignored
+  BOOST_CHECK(!depth.close_order(1111, 10, true));
+
+  std::vector<DepthLevel> levels;
+  BOOST_CHECK_EQUAL(1, depth.top_n(true, 0, levels));
+  BOOST_CHECK(verify_full_level(levels[0], 1250, 1, 150));
+}
+
+BOOST_AUTO_TEST_CASE(TestFullDepthReplaceMovesLevel)
+{
+  FullDepth depth;
+  depth.add_order(1250, 100, false);
+  depth.add_order(1260, 100, false);
+  BOOST_CHECK(depth.replace_order(1250, 1270, 100, 80, false));
+
+  std::vector<DepthLevel> levels;
+  BOOST_CHECK_EQUAL(2, depth.top_n(false, 0, levels));
+  BOOST_CHECK(verify_full_level(levels[0], 1260, 1, 100));
+  BOOST_CHECK(verify_full_level(levels[1], 1270, 1, 80));
+}
+
+BOOST_AUTO_TEST_CASE(TestFullDepthLadderIsCumulative)
+{
+  FullDepth depth;
+  depth.add_order(1250, 100, true);
+  depth.add_order(1240, 200, true);
+  depth.add_order(1240, 50, true);
+  depth.add_order(1230, 300, true);
+
+  std::vector<LadderStep> ladder;
+  BOOST_CHECK_EQUAL(3, depth.ladder(true, 0, ladder));
+  BOOST_CHECK_EQUAL(1250, ladder[0].price);
+  BOOST_CHECK_EQUAL(100, ladder[0].cumulative_qty);
+  BOOST_CHECK_EQUAL(1240, ladder[1].price);
+  BOOST_CHECK_EQUAL(250, ladder[1].qty);
+  BOOST_CHECK_EQUAL(2, ladder[1].order_count);
+  BOOST_CHECK_EQUAL(350, ladder[1].cumulative_qty);
+  BOOST_CHECK_EQUAL(650, ladder[2].cumulative_qty);
+
+  BOOST_CHECK_EQUAL(2, depth.ladder(true, 2, ladder));
+  BOOST_CHECK_EQUAL(350, ladder[1].cumulative_qty);
+}
+
+BOOST_AUTO_TEST_CASE(TestFullDepthTracksBookBeyondFixedDepth)
+{
+  SimpleOrderBook order_book;
+  std::vector<SimpleOrder> bids;
+  bids.reserve(8);
+  for (book::Price price = 1200; price < 1208; ++price) {
+    bids.push_back(SimpleOrder(true, price, 100));
+  }
+  for (size_t i = 0; i < bids.size(); ++i) {
+    BOOST_CHECK(add_and_verify(order_book, &bids[i], false));
+  }
+  // Fixed depth holds 5 levels, full depth holds all 8
+  BOOST_CHECK_EQUAL(8, order_book.full_depth().bid_level_count());
+
+  // Sell through the best three levels and part of the fourth
+  SimpleOrder ask(false, 1204, 350);
+  BOOST_CHECK(add_and_verify(order_book, &ask, true, true));
+
+  std::vector<DepthLevel> levels;
+  BOOST_CHECK_EQUAL(5, order_book.full_depth().top_n(true, 0, levels));
+  BOOST_CHECK(verify_full_level(levels[0], 1204, 1, 50));
+  BOOST_CHECK(verify_full_level(levels[4], 1200, 1, 100));
+  BOOST_CHECK_EQUAL(0, order_book.full_depth().ask_level_count());
+
+  // Cancel an order that lives only in the excess of the fixed depth
+  BOOST_CHECK(cancel_and_verify(order_book, &bids[0], simple::os_cancelled));
+  BOOST_CHECK_EQUAL(4, order_book.full_depth().bid_level_count());
+}
+
+namespace {
+typedef book::DepthOrderBook<SimpleOrder*> FullDepthCbBook;
+
+class FullDepthCbListener : public FullDepthCbBook::TypedDepthListener
+{
+public:
+  virtual void on_depth_change(const FullDepthCbBook*,
+                               const FullDepthCbBook::DepthTracker*)
+  {
+    ++changes_;
+  }
+  size_t changes_ = 0;
+};
+}
+
+BOOST_AUTO_TEST_CASE(TestFullDepthChangeBeyondFixedDepthPublishes)
+{
+  FullDepthCbListener listener;
+  FullDepthCbBook order_book;
+  order_book.set_depth_listener(&listener);
+  std::vector<SimpleOrder> bids;
+  bids.reserve(20);
+  for (book::Price price = 1220; price > 1200; --price) {
+    bids.push_back(SimpleOrder(true, price, 100));
+  }
+  for (size_t i = 0; i < bids.size(); ++i) {
+    order_book.add(&bids[i]);
+  }
+  BOOST_CHECK_EQUAL(20, listener.changes_);
+  BOOST_CHECK(!order_book.full_depth().changed());
+
+  // Level 15 is only visible through full depth
+  listener.changes_ = 0;
+  SimpleOrder level15(true, 1206, 50);
+  order_book.add(&level15);
+  BOOST_CHECK_EQUAL(1, listener.changes_);
+  std::vector<DepthLevel> levels;
+  order_book.full_depth().top_n(true, 20, levels);
+  BOOST_CHECK(verify_full_level(levels[14], 1206, 2, 150));
+
+  order_book.cancel(&level15);
+  BOOST_CHECK_EQUAL(2, listener.changes_);
+  BOOST_CHECK(!order_book.full_depth().changed());
+}
+
+} // namespace liquibook
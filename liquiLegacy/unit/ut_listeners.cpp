@@ -7,6 +7,7 @@
 
 #include "ut_utils.h"
 #include "changed_checker.h"
+#include "depth_check.h"
 #include <book/order_book.h>
 #include <simple/simple_order.h>
 
@@ -25,10 +26,10 @@ class TradeCbListener : public TradeListener<TypedOrderBook>
 public:
   virtual void on_trade(const TypedOrderBook* order_book,
                         Quantity qty,
-                        Cost cost)
+                        Price price)
   {
     quantities_.push_back(qty);
-    costs_.push_back(cost);
+    costs_.push_back(qty * price);
   }
 
   void reset()
@@ -260,10 +261,10 @@ BOOST_AUTO_TEST_CASE(TestDepthCallbacks)
   BOOST_CHECK_EQUAL(5, listener.changes_.size());
   listener.reset();
 
-  // Add buy orders past end, should be accepted, but not affect depth
+  // Add buy orders past end, should be accepted, changing only full depth
   order_book.add(&buy5);
   order_book.add(&buy6);
-  BOOST_CHECK_EQUAL(0, listener.changes_.size());
+  BOOST_CHECK_EQUAL(2, listener.changes_.size());
   listener.reset();
 
   // Add sell orders, should be accepted and affect depth
@@ -276,9 +277,9 @@ BOOST_AUTO_TEST_CASE(TestDepthCallbacks)
   BOOST_CHECK_EQUAL(6, listener.changes_.size());
   listener.reset();
 
-  // Add sell order past end, should be accepted, but not affect depth
+  // Add sell order past end, should be accepted, changing only full depth
   order_book.add(&sell6);
-  BOOST_CHECK_EQUAL(0, listener.changes_.size());
+  BOOST_CHECK_EQUAL(1, listener.changes_.size());
   listener.reset();
 }
 
@@ -373,6 +374,60 @@ BOOST_AUTO_TEST_CASE(TestBboCallbacks)
   listener.reset();
 }
 
+BOOST_AUTO_TEST_CASE(TestHeldBookUpdates)
+{
+  SimpleOrder buy0(true, 3250, 100);
+  SimpleOrder buy1(true, 3249, 800);
+  SimpleOrder buy2(true, 3248, 300);
+  SimpleOrder sell0(false, 3248, 400);
+
+  DepthCbListener depth_listener;
+  BboCbListener bbo_listener;
+  OrderBookCbListener book_listener;
+  TypedDepthOrderBook order_book;
+  order_book.set_depth_listener(&depth_listener);
+  order_book.set_bbo_listener(&bbo_listener);
+  order_book.set_order_book_listener(&book_listener);
+
+  // Held: requests complete, notifications wait for the release
+  order_book.hold_book_updates();
+  order_book.add(&buy0);
+  order_book.add(&buy1);
+  order_book.add(&buy2);
+  order_book.cancel(&buy1);
+  BOOST_CHECK_EQUAL(2, order_book.bids().size());
+  BOOST_CHECK_EQUAL(0, depth_listener.changes_.size());
+  BOOST_CHECK_EQUAL(0, bbo_listener.changes_.size());
+  BOOST_CHECK_EQUAL(0, book_listener.changes_.size());
+  order_book.release_book_updates();
+  BOOST_CHECK_EQUAL(1, depth_listener.changes_.size());
+  BOOST_CHECK_EQUAL(1, bbo_listener.changes_.size());
+  BOOST_CHECK_EQUAL(1, book_listener.changes_.size());
+  // Final state only
+  BOOST_CHECK_EQUAL(3250, order_book.depth().bids()->price());
+  BOOST_CHECK_EQUAL(100, order_book.depth().bids()->aggregate_qty());
+  BOOST_CHECK_EQUAL(3248, (order_book.depth().bids() + 1)->price());
+  BOOST_CHECK_EQUAL(300, (order_book.depth().bids() + 1)->aggregate_qty());
+  depth_listener.reset();
+  bbo_listener.reset();
+  book_listener.reset();
+
+  // A sweep of two levels is one notification
+  order_book.add(&sell0);
+  BOOST_CHECK_EQUAL(1, depth_listener.changes_.size());
+  BOOST_CHECK_EQUAL(1, bbo_listener.changes_.size());
+  BOOST_CHECK_EQUAL(0, order_book.depth().bids()->aggregate_qty());
+  depth_listener.reset();
+  bbo_listener.reset();
+
+  // Nothing changed while held, nothing to report
+  order_book.hold_book_updates();
+  order_book.cancel(&buy1);
+  order_book.release_book_updates();
+  BOOST_CHECK_EQUAL(0, depth_listener.changes_.size());
+  BOOST_CHECK_EQUAL(0, bbo_listener.changes_.size());
+}
+
 BOOST_AUTO_TEST_CASE(TestTradeCallbacks) 
 {
   SimpleOrder order0(false, 3250, 100);
@@ -423,4 +478,89 @@ BOOST_AUTO_TEST_CASE(TestTradeCallbacks)
   BOOST_CHECK_EQUAL(0, listener.quantities_.size());
 }
 
+class StaticCbListener;
+typedef DepthOrderBook<OrderPtr, 5, StaticCbListener> StaticDepthOrderBook;
+
+// Bound at compile time: takes every role it implements, no set_*_listener
+class StaticCbListener
+      : public OrderCbListener,
+        public TradeListener<StaticDepthOrderBook>,
+        public DepthListener<StaticDepthOrderBook>,
+        public BboListener<StaticDepthOrderBook>
+{
+public:
+  virtual void on_trade(const StaticDepthOrderBook* ,
+                        Quantity qty,
+                        Price )
+  {
+    trades_.push_back(qty);
+  }
+  virtual void on_depth_change(const StaticDepthOrderBook* ,
+                               const DepthTracker* )
+  {
+    ++depth_changes_;
+  }
+  virtual void on_bbo_change(const StaticDepthOrderBook* ,
+                             const DepthTracker* )
+  {
+    ++bbo_changes_;
+  }
+
+  void reset()
+  {
+    OrderCbListener::reset();
+    trades_.clear();
+    depth_changes_ = 0;
+    bbo_changes_ = 0;
+  }
+
+  std::vector<Quantity> trades_;
+  int depth_changes_ = 0;
+  int bbo_changes_ = 0;
+};
+
+BOOST_AUTO_TEST_CASE(TestStaticListenerCallbacks)
+{
+  SimpleOrder order0(false, 3250, 100);
+  SimpleOrder order1(true,  3250, 800);
+  SimpleOrder order2(false, 3230, 0);
+  SimpleOrder order3(true,  3240, 200);
+
+  StaticCbListener listener;
+  StaticDepthOrderBook order_book;
+  order_book.set_listener(&listener);
+  // Add order, should be accepted and change depth and bbo
+  order_book.add(&order0);
+  BOOST_CHECK_EQUAL(1, listener.accepts_.size());
+  BOOST_CHECK_EQUAL(1, listener.depth_changes_);
+  BOOST_CHECK_EQUAL(1, listener.bbo_changes_);
+  listener.reset();
+  // Add matching order, should be accepted, followed by a fill and trade
+  order_book.add(&order1);
+  BOOST_CHECK_EQUAL(1, listener.accepts_.size());
+  BOOST_CHECK_EQUAL(1, listener.fills_.size());
+  BOOST_CHECK_EQUAL(1, listener.trades_.size());
+  BOOST_CHECK_EQUAL(100, listener.trades_[0]);
+  BOOST_CHECK_EQUAL(1, listener.bbo_changes_);
+  listener.reset();
+  // Add invalid order, should be rejected
+  order_book.add(&order2);
+  BOOST_CHECK_EQUAL(1, listener.rejects_.size());
+  listener.reset();
+  // Depth is maintained by the statically bound hooks
+  order_book.add(&order3);
+  order_book.replace(&order3, -50, 3245);
+  BOOST_CHECK_EQUAL(1, listener.replaces_.size());
+  DepthCheck<StaticDepthOrderBook> dc(order_book.depth());
+  BOOST_CHECK(dc.verify_bid(3250, 1, 700));
+  BOOST_CHECK(dc.verify_bid(3245, 1, 150));
+  listener.reset();
+  // Cancel, should be cancelled and leave one bid level
+  order_book.cancel(&order1);
+  BOOST_CHECK_EQUAL(1, listener.cancels_.size());
+  BOOST_CHECK_EQUAL(1, listener.bbo_changes_);
+  dc.reset();
+  BOOST_CHECK(dc.verify_bid(3245, 1, 150));
+}
+
 } // namespace liquibook
@@ -2354,6 +2354,48 @@ BOOST_AUTO_TEST_CASE(TestReplaceAskPriceChangeErase)
   BOOST_CHECK(dc.verify_ask(1256, 1, 330));
 }
 
+BOOST_AUTO_TEST_CASE(TestReplacePartiallyFilledPriceChange)
+{
+  SimpleOrderBook order_book;
+  SimpleOrder ask0(false, 1252, 300);
+  SimpleOrder bid0(true,  1250, 100);
+
+  // No match
+  BOOST_CHECK(add_and_verify(order_book, &bid0, false));
+  BOOST_CHECK(add_and_verify(order_book, &ask0, false));
+
+  SimpleOrder cross_bid(true,  1252, 200);
+  // Partial fill existing order
+  {
+    SimpleFillCheck fc1(&cross_bid, 200, 1252 * 200);
+    SimpleFillCheck fc2(&ask0,      200, 1252 * 200);
+    BOOST_CHECK(add_and_verify(order_book, &cross_bid, true, true));
+  }
+
+  // Verify depth
+  DepthCheck<SimpleOrderBook> dc(order_book.depth());
+  BOOST_CHECK(dc.verify_bid(1250, 1, 100));
+  BOOST_CHECK(dc.verify_ask(1252, 1, 100));
+
+  // Move the remainder - depth must move the open quantity, not order qty
+  BOOST_CHECK(replace_and_verify(order_book, &ask0, SIZE_UNCHANGED, 1253));
+  BOOST_CHECK_EQUAL(100U, ask0.open_qty());
+
+  // Verify depth
+  dc.reset();
+  BOOST_CHECK(dc.verify_bid(1250, 1, 100));
+  BOOST_CHECK(dc.verify_ask(1253, 1, 100));
+
+  // Replace size and price together
+  BOOST_CHECK(replace_and_verify(order_book, &ask0, 50, 1251));
+  BOOST_CHECK_EQUAL(150U, ask0.open_qty());
+
+  // Verify depth
+  dc.reset();
+  BOOST_CHECK(dc.verify_bid(1250, 1, 100));
+  BOOST_CHECK(dc.verify_ask(1251, 1, 150));
+}
+
 // A potential problem
 // When restroing a level into the depth, the orders (and thus the restored
 // level already reflect the post-fill quantity, but the fill callback has 
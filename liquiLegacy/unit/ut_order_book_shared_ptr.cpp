@@ -11,6 +11,7 @@
 #include <simple/simple_order.h>
 #include <simple/simple_order_book.h>
 #include <memory>
+#include <vector>
 
 namespace liquibook {
 
@@ -23,6 +24,7 @@ using simple::SimpleOrder;
 typedef std::shared_ptr<SimpleOrder> SimpleOrderPtr;
 class SharedPtrOrderBook : public OrderBook<SimpleOrderPtr>
 {
+protected:
   virtual void perform_callback(OrderBook<SimpleOrderPtr>::TypedCallback& cb)
   {
     switch(cb.type) {
@@ -103,4 +105,52 @@ BOOST_AUTO_TEST_CASE(TestSharedCancelBid)
   BOOST_CHECK_EQUAL(2, order_book.asks().size());
 }
 
+// Re-enters the book from a fill callback: the follow-up order is owned only
+// by a temporary, so its queued callbacks must not depend on the caller.
+class ReentrantOrderBook : public SharedPtrOrderBook
+{
+public:
+  SimpleOrderPtr cancel_on_fill_;
+  std::vector<SimpleOrderPtr> accepted_;
+
+  virtual void perform_callback(OrderBook<SimpleOrderPtr>::TypedCallback& cb)
+  {
+    SharedPtrOrderBook::perform_callback(cb);
+    if (cb.type == TypedCallback::cb_order_accept) {
+      accepted_.push_back(cb.order);
+    }
+    else if (cb.type == TypedCallback::cb_order_fill && cancel_on_fill_) {
+      SimpleOrderPtr cancel_me;
+      cancel_me.swap(cancel_on_fill_);
+      cancel(cancel_me);
+      add(SimpleOrderPtr(new SimpleOrder(true, 1249, 100)));
+    }
+  }
+};
+
+BOOST_AUTO_TEST_CASE(TestSharedRequestsFromCallback)
+{
+  ReentrantOrderBook order_book;
+  SimpleOrderPtr ask1(new SimpleOrder(false, 1252, 100));
+  SimpleOrderPtr ask0(new SimpleOrder(false, 1251, 100));
+  SimpleOrderPtr bid0(new SimpleOrder(true,  1251, 100));
+
+  BOOST_CHECK(add_and_verify(order_book, ask0, false));
+  BOOST_CHECK(add_and_verify(order_book, ask1, false));
+  order_book.cancel_on_fill_ = ask1;
+  ask1.reset();
+
+  // The fill cancels ask1 and adds a new bid; both are handled before
+  // add returns, after the last outside reference to them is gone
+  BOOST_CHECK(add_and_verify(order_book, bid0, true, true));
+  BOOST_CHECK_EQUAL(0, order_book.asks().size());
+  BOOST_REQUIRE_EQUAL(1, order_book.bids().size());
+  BOOST_CHECK_EQUAL(1249, order_book.bids().begin()->first.price());
+
+  BOOST_REQUIRE_EQUAL(4, order_book.accepted_.size());
+  const SimpleOrderPtr & follow_up = order_book.accepted_.back();
+  BOOST_CHECK_EQUAL(simple::os_accepted, follow_up->state());
+  BOOST_CHECK_EQUAL(1249, follow_up->price());
+}
+
 } // namespace
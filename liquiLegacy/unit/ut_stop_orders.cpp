@@ -28,6 +28,7 @@ namespace
   const Price prc55 = 55;
   const Price prc56 = 56;
   const Price prc57 = 57;
+  const Price prc58 = 58;
 
   const Quantity q100 = 100;
   const Quantity q1000 = 1000;
@@ -147,4 +148,130 @@ BOOST_AUTO_TEST_CASE(TestStopOrdersCancelBeforeTrigger)
   BOOST_CHECK(cancel_and_verify(book, &ask, simple::os_cancelled));
 }
 
+BOOST_AUTO_TEST_CASE(TestStopOrdersTriggerOnlyReachedStops)
+{
+  SimpleOrderBook book;
+  book.set_market_price(prc55);
+  SimpleOrder order0(sideSell, prc57, q1000);
+  BOOST_CHECK(add_and_verify(book, &order0, expectNoMatch));
+
+  // Buy stops at 58 and 56: the one that triggers first is indexed first
+  SimpleOrder order1(sideBuy, prcMkt, q100, prc58);
+  SimpleOrder order2(sideBuy, prcMkt, q100, prc56);
+  BOOST_CHECK(add_and_verify(book, &order1, expectNoMatch));
+  BOOST_CHECK(add_and_verify(book, &order2, expectNoMatch));
+  BOOST_CHECK_EQUAL(prc56, book.stopBids().begin()->first.price());
+
+  SimpleOrder order3(sideBuy, prc56, q100);
+  SimpleOrder order4(sideSell, prc56, q100);
+
+  // Scope for fill checks
+  {
+    SimpleFillCheck fc1(&order1, 0, 0);
+    SimpleFillCheck fc2(&order2, q100, q100 * prc57);
+    // Trade at 56 triggers order2 only, which trades at 57: short of 58
+    BOOST_CHECK(add_and_verify(book, &order3, expectNoMatch));
+    BOOST_CHECK(add_and_verify(book, &order4, expectMatch, expectComplete));
+  }
+  BOOST_CHECK_EQUAL(prc57, book.market_price());
+  BOOST_CHECK_EQUAL(1, book.stopBids().size());
+  BOOST_CHECK_EQUAL(simple::os_accepted, order1.state());
+  BOOST_CHECK_EQUAL(1U, book.stop_stats().triggered);
+}
+
+BOOST_AUTO_TEST_CASE(TestStopOrdersCascade)
+{
+  SimpleOrderBook book;
+  book.set_market_price(prc55);
+  SimpleOrder order0(sideSell, prc57, q1000);
+  BOOST_CHECK(add_and_verify(book, &order0, expectNoMatch));
+
+  SimpleOrder order1(sideBuy, prcMkt, q100, prc57);
+  SimpleOrder order2(sideBuy, prcMkt, q100, prc56);
+  BOOST_CHECK(add_and_verify(book, &order1, expectNoMatch));
+  BOOST_CHECK(add_and_verify(book, &order2, expectNoMatch));
+
+  SimpleOrder order3(sideBuy, prc56, q100);
+  SimpleOrder order4(sideSell, prc56, q100);
+
+  // Scope for fill checks
+  {
+    SimpleFillCheck fc1(&order1, q100, q100 * prc57);
+    SimpleFillCheck fc2(&order2, q100, q100 * prc57);
+    // Trade at 56 triggers order2, whose trade at 57 triggers order1
+    BOOST_CHECK(add_and_verify(book, &order3, expectNoMatch));
+    BOOST_CHECK(add_and_verify(book, &order4, expectMatch, expectComplete));
+  }
+  BOOST_CHECK(book.stopBids().empty());
+  BOOST_CHECK(book.pendingStops().empty());
+  BOOST_CHECK_EQUAL(2U, book.stop_stats().triggered);
+  BOOST_CHECK_EQUAL(2U, book.stop_stats().batches);
+  BOOST_CHECK_EQUAL(0U, book.stop_stats().capped);
+}
+
+BOOST_AUTO_TEST_CASE(TestStopCascadeLimit)
+{
+  SimpleOrderBook book;
+  book.set_market_price(prc55);
+  book.set_stop_cascade_limit(1);
+  SimpleOrder order0(sideSell, prc57, q1000);
+  BOOST_CHECK(add_and_verify(book, &order0, expectNoMatch));
+
+  SimpleOrder order1(sideBuy, prcMkt, q100, prc57);
+  SimpleOrder order2(sideBuy, prcMkt, q100, prc56);
+  BOOST_CHECK(add_and_verify(book, &order1, expectNoMatch));
+  BOOST_CHECK(add_and_verify(book, &order2, expectNoMatch));
+
+  SimpleOrder order3(sideBuy, prc56, q100);
+  SimpleOrder order4(sideSell, prc56, q100);
+
+  // Scope for fill checks
+  {
+    SimpleFillCheck fc1(&order1, 0, 0);
+    SimpleFillCheck fc2(&order2, q100, q100 * prc57);
+    // order1 is triggered too, but waits: one stop per command
+    BOOST_CHECK(add_and_verify(book, &order3, expectNoMatch));
+    BOOST_CHECK(add_and_verify(book, &order4, expectMatch, expectComplete));
+  }
+  BOOST_CHECK(book.stopBids().empty());
+  BOOST_CHECK_EQUAL(1, book.pendingStops().size());
+  BOOST_CHECK_EQUAL(simple::os_accepted, order1.state());
+  BOOST_CHECK_EQUAL(1U, book.stop_stats().triggered);
+  BOOST_CHECK_EQUAL(1U, book.stop_stats().capped);
+
+  // The next command submits order1 ahead of its own order
+  SimpleOrder order5(sideBuy, prc53, q100);
+  {
+    SimpleFillCheck fc1(&order1, q100, q100 * prc57);
+    BOOST_CHECK(add_and_verify(book, &order5, expectNoMatch));
+  }
+  BOOST_CHECK(book.pendingStops().empty());
+  BOOST_CHECK_EQUAL(2U, book.stop_stats().triggered);
+}
+
+BOOST_AUTO_TEST_CASE(TestStopOrdersCancelPendingStop)
+{
+  SimpleOrderBook book;
+  book.set_market_price(prc55);
+  book.set_stop_cascade_limit(1);
+  SimpleOrder order0(sideSell, prc57, q1000);
+  BOOST_CHECK(add_and_verify(book, &order0, expectNoMatch));
+
+  SimpleOrder order1(sideBuy, prcMkt, q100, prc57);
+  SimpleOrder order2(sideBuy, prcMkt, q100, prc56);
+  BOOST_CHECK(add_and_verify(book, &order1, expectNoMatch));
+  BOOST_CHECK(add_and_verify(book, &order2, expectNoMatch));
+
+  SimpleOrder order3(sideBuy, prc56, q100);
+  SimpleOrder order4(sideSell, prc56, q100);
+  BOOST_CHECK(add_and_verify(book, &order3, expectNoMatch));
+  BOOST_CHECK(add_and_verify(book, &order4, expectMatch, expectComplete));
+  BOOST_CHECK_EQUAL(1, book.pendingStops().size());
+
+  // order1 was triggered but not submitted; it can still be cancelled
+  BOOST_CHECK(cancel_and_verify(book, &order1, simple::os_cancelled));
+  BOOST_CHECK(book.pendingStops().empty());
+  BOOST_CHECK_EQUAL(q100, order0.filled_qty());
+}
+
 } // namespace
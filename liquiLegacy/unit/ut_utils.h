@@ -16,6 +16,37 @@ namespace liquibook {
 typedef simple::SimpleOrderBook<5> SimpleOrderBook;
 typedef simple::SimpleOrderBook<5>::DepthTracker SimpleDepth;
 
+// Check the per-level quantities the book keeps against its orders
+template <class TrackerMap>
+bool verify_levels(const TrackerMap& trackers, const LevelQuantities& levels)
+{
+  LevelQuantities expected;
+  for (auto pos = trackers.begin(); pos != trackers.end(); ++pos) {
+    expected.add(pos->first, pos->second.open_qty(), pos->second.all_or_none());
+  }
+  bool correct = expected.levels().size() == levels.levels().size();
+  auto actual = levels.levels().begin();
+  for (auto level = expected.levels().begin();
+       correct && level != expected.levels().end(); ++level, ++actual) {
+    correct = level->first == actual->first &&
+      level->second.regular == actual->second.regular &&
+      level->second.aon == actual->second.aon &&
+      level->second.orders == actual->second.orders &&
+      level->second.aon_orders == actual->second.aon_orders;
+  }
+  if (!correct) {
+    std::cout << "Level quantities do not match orders" << std::endl;
+  }
+  return correct;
+}
+
+template <class OrderBook>
+bool verify_levels(const OrderBook& order_book)
+{
+  return verify_levels(order_book.bids(), order_book.bidLevels()) &&
+         verify_levels(order_book.asks(), order_book.askLevels());
+}
+
 template <class OrderBook, class OrderPtr>
 bool add_and_verify(OrderBook& order_book,
                     const OrderPtr& order,
@@ -24,6 +55,9 @@ bool add_and_verify(OrderBook& order_book,
                     OrderConditions conditions = 0)
 {
   const bool matched = order_book.add(order, conditions);
+  if (!verify_levels(order_book)) {
+    return false;
+  }
   if (matched == match_expected) {
     if (complete_expected) {
       // State should be complete
@@ -47,7 +81,7 @@ bool cancel_and_verify(OrderBook& order_book,
                        simple::OrderState expected_state)
 {
   order_book.cancel(order);
-  return expected_state == order->state();
+  return verify_levels(order_book) && expected_state == order->state();
 }
 
 template <class OrderBook, class OrderPtr>
@@ -68,7 +102,7 @@ bool replace_and_verify(OrderBook& order_book,
   order_book.replace(order, size_change, new_price);
 
   // Verify
-  bool correct = true;
+  bool correct = verify_levels(order_book);
   if (expected_state != order->state()) {
     correct = false;
     std::cout << "State " << order->state() << std::endl;
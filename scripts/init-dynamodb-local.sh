@@ -32,6 +32,17 @@ aws dynamodb create-table \
   --billing-mode PAY_PER_REQUEST \
   --no-cli-pager 2>/dev/null && echo "✓ supernoba-settings created" || echo "- supernoba-settings already exists"
 
+# supernoba-orders (엔진 활성 주문 복원 — DYNAMODB_ENDPOINT=http://localhost:8808)
+# status-index GSI: DYNAMODB_STATUS_INDEX=status-index 로 활성 주문만 Query
+aws dynamodb create-table \
+  --endpoint-url $ENDPOINT \
+  --table-name supernoba-orders \
+  --attribute-definitions AttributeName=user_id,AttributeType=S AttributeName=order_id,AttributeType=S AttributeName=status,AttributeType=S \
+  --key-schema AttributeName=user_id,KeyType=HASH AttributeName=order_id,KeyType=RANGE \
+  --global-secondary-indexes "IndexName=status-index,KeySchema=[{AttributeName=status,KeyType=HASH},{AttributeName=order_id,KeyType=RANGE}],Projection={ProjectionType=ALL}" \
+  --billing-mode PAY_PER_REQUEST \
+  --no-cli-pager 2>/dev/null && echo "✓ supernoba-orders created" || echo "- supernoba-orders already exists"
+
 echo ""
 echo "Tables:"
 aws dynamodb list-tables --endpoint-url $ENDPOINT --no-cli-pager
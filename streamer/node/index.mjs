@@ -4,6 +4,7 @@
 
 import Redis from 'ioredis';
 import { ApiGatewayManagementApiClient, PostToConnectionCommand } from '@aws-sdk/client-apigatewaymanagementapi';
+import { metrics, timed, startMetricsServer } from './metrics.mjs';
 
 // 환경변수
 const VALKEY_HOST = process.env.VALKEY_HOST || 'localhost';
@@ -20,6 +21,7 @@ const CANDLE_CACHE_PORT = parseInt(process.env.CANDLE_CACHE_PORT || '6380');
 const OPERATING_CACHE_HOST = process.env.OPERATING_CACHE_HOST || VALKEY_HOST;
 const OPERATING_CACHE_PORT = parseInt(process.env.OPERATING_CACHE_PORT || '6382');
 const BACKUP_CACHE_PORT = parseInt(process.env.BACKUP_CACHE_PORT || '6381');
+const METRICS_PORT = parseInt(process.env.METRICS_PORT || '9101');  // Prometheus /metrics, 0이면 비활성
 
 const POLL_MS_AUTH = 200;  // 인증 사용자 브로드캐스트 주기
 const POLL_MS_ANON = 500;  // 익명 사용자 브로드캐스트 주기
@@ -131,7 +133,7 @@ async function classifyConnections(connectionIds) {
   // Pipeline으로 일괄 조회 (1 RTT) — ws:* keys live in operating cache
   const pipeline = operatingClient.pipeline();
   connectionIds.forEach(id => pipeline.get(`ws:${id}`));
-  const results = await pipeline.exec();
+  const results = await timed(metrics.valkeyRtt, pipeline.exec());
 
   const auth = [];
   const anon = [];
@@ -153,16 +155,19 @@ async function classifyConnections(connectionIds) {
 // === 유틸리티 ===
 async function sendToConnection(connectionId, data) {
   try {
-    await apiClient.send(new PostToConnectionCommand({
+    await timed(metrics.postLatency, apiClient.send(new PostToConnectionCommand({
       ConnectionId: connectionId,
       Data: typeof data === 'string' ? data : JSON.stringify(data),
-    }));
+    })));
+    metrics.messagesSent++;
     return true;
   } catch (error) {
     const statusCode = error.$metadata?.httpStatusCode;
     if (statusCode === 410) {
+      metrics.staleConnections++;
       await cleanupConnection(connectionId);
     } else {
+      metrics.sendFailures++;
       console.error(`[SendToConn] Error ${statusCode}: ${error.message} (conn=${connectionId})`);
     }
     return false;
@@ -205,6 +210,7 @@ async function sendToAdmin(connectionId, data) {
       ConnectionId: connectionId,
       Data: typeof data === 'string' ? data : JSON.stringify(data),
     }));
+    metrics.adminMessagesSent++;
     return { success: true };
   } catch (error) {
     const statusCode = error.$metadata?.httpStatusCode;
@@ -254,10 +260,14 @@ async function broadcastLoopAuth() {
   console.log('[Broadcast] Auth loop started (200ms)');
   while (!isShuttingDown) {
     try {
+      const cycleStart = process.hrtime.bigint();
       const symbols = await operatingClient.smembers('subscribed:symbols');
       if (symbols.length > 0) {
         await Promise.all(symbols.map(s => broadcastSymbolData(s, 'auth')));
       }
+      metrics.subscribedSymbols = symbols.length;
+      metrics.broadcastCycles.auth++;
+      metrics.cycleLatency.auth.since(cycleStart);
       await new Promise(r => setTimeout(r, POLL_MS_AUTH));
     } catch (err) {
       if (isShuttingDown) break;
@@ -273,10 +283,14 @@ async function broadcastLoopAnon() {
   console.log('[Broadcast] Anon loop started (500ms)');
   while (!isShuttingDown) {
     try {
+      const cycleStart = process.hrtime.bigint();
       const symbols = await operatingClient.smembers('subscribed:symbols');
       if (symbols.length > 0) {
         await Promise.all(symbols.map(s => broadcastSymbolData(s, 'anon')));
       }
+      metrics.subscribedSymbols = symbols.length;
+      metrics.broadcastCycles.anon++;
+      metrics.cycleLatency.anon.since(cycleStart);
       await new Promise(r => setTimeout(r, POLL_MS_ANON));
     } catch (err) {
       if (isShuttingDown) break;
@@ -303,12 +317,12 @@ async function broadcastSymbolData(symbol, tier) {
     if (targetMain.length === 0 && targetSub.length === 0) return;
 
     // 캐시별로 분리된 데이터 가져오기
-    const [depthJson, tickerJson, candleData, prevClose] = await Promise.all([
+    const [depthJson, tickerJson, candleData, prevClose] = await timed(metrics.valkeyRtt, Promise.all([
       depthClient.get(`depth:${symbol}`),
       depthClient.get(`ticker:${symbol}`),
       candleClient.hgetall(`candle:1m:${symbol}`),
       depthClient.get(`prev:${symbol}`)
-    ]);
+    ]));
 
     let tickerData = tickerJson ? JSON.parse(tickerJson) : null;
     if (tickerData && prevClose) {
@@ -523,6 +537,7 @@ async function syncAdminConnections() {
     const oldSize = adminConnections.size;
     adminConnections.clear();
     connections.forEach(conn => adminConnections.add(conn));
+    metrics.adminConnections = adminConnections.size;
     if (adminConnections.size !== oldSize) {
       console.log(`[Admin Sync] Updated: ${adminConnections.size} connections`);
     }
@@ -534,6 +549,9 @@ async function syncAdminConnections() {
 // === 시작 ===
 console.log('Starting Streaming Server...');
 
+// Prometheus /metrics
+const metricsServer = startMetricsServer(METRICS_PORT);
+
 // 어드민 연결 동기화 시작 (1초 간격)
 intervalHandles.push(setInterval(syncAdminConnections, 1000));
 syncAdminConnections();
@@ -570,6 +588,8 @@ async function gracefulShutdown(signal) {
   intervalHandles.forEach(handle => clearInterval(handle));
   console.log(`[Shutdown] Cleared ${intervalHandles.length} intervals`);
 
+  if (metricsServer) metricsServer.close();
+
   // Redis 연결 종료
   try {
     await Promise.allSettled([
@@ -0,0 +1,170 @@
+// Streamer 메트릭 — Prometheus 텍스트 노출 + HDR 방식 지연 히스토그램
+// 엔진/집계기(C++)와 같은 버킷 구조(옥타브당 8칸, 상대 오차 ≤ 12.5%)와 노출 형식을 쓴다.
+// Node는 단일 스레드라 카운터는 평범한 number로 충분하다.
+
+import http from 'node:http';
+
+const SUB_BITS = 3;
+const SUB_COUNT = 1 << SUB_BITS;
+const BUCKETS = (64 - SUB_BITS + 1) * SUB_COUNT;
+const LE_MIN_SHIFT = 10;  // 1µs
+const LE_MAX_SHIFT = 34;  // 약 17s
+const QUANTILES = [0.5, 0.9, 0.99, 0.999];
+
+function bucketOf(ns) {
+  if (ns < SUB_COUNT) return Math.max(0, Math.floor(ns));
+  let e = Math.floor(Math.log2(ns));
+  if (2 ** e > ns) e -= 1;
+  const sub = Math.floor(ns / 2 ** (e - SUB_BITS)) & (SUB_COUNT - 1);
+  return Math.min(BUCKETS - 1, ((e - SUB_BITS + 1) << SUB_BITS) + sub);
+}
+
+function bucketLower(idx) {
+  if (idx < SUB_COUNT) return idx;
+  const octave = idx >> SUB_BITS;
+  return (SUB_COUNT + (idx & (SUB_COUNT - 1))) * 2 ** (octave - 1);
+}
+
+function bucketUpper(idx) {
+  return idx + 1 >= BUCKETS ? Infinity : bucketLower(idx + 1) - 1;
+}
+
+export class LatencyHistogram {
+  constructor() {
+    this.buckets = new Float64Array(BUCKETS);
+    this.count = 0;
+    this.sumNs = 0;
+    this.maxNs = 0;
+  }
+
+  record(ns) {
+    this.buckets[bucketOf(ns)] += 1;
+    this.count += 1;
+    this.sumNs += ns;
+    if (ns > this.maxNs) this.maxNs = ns;
+  }
+
+  // hrtime.bigint() 시작값부터 지금까지를 기록
+  since(startNs) {
+    this.record(Number(process.hrtime.bigint() - startNs));
+  }
+
+  // q 분위수의 상한(ns), 최댓값으로 제한
+  percentile(q) {
+    if (this.count === 0) return 0;
+    const rank = Math.max(1, Math.ceil(Math.min(Math.max(q, 0), 1) * this.count));
+    let seen = 0;
+    for (let i = 0; i < BUCKETS; i++) {
+      seen += this.buckets[i];
+      if (seen >= rank) return Math.min(bucketUpper(i), this.maxNs);
+    }
+    return this.maxNs;
+  }
+
+  countAtOrBelow(limitNs) {
+    let n = 0;
+    for (let i = 0; i < BUCKETS && bucketUpper(i) <= limitNs; i++) n += this.buckets[i];
+    return n;
+  }
+}
+
+// 프로미스 소요 시간을 히스토그램에 기록하고 결과를 그대로 돌려준다
+export async function timed(hist, promise) {
+  const start = process.hrtime.bigint();
+  try {
+    return await promise;
+  } finally {
+    hist.since(start);
+  }
+}
+
+export const metrics = {
+  broadcastCycles: { auth: 0, anon: 0 },
+  messagesSent: 0,
+  sendFailures: 0,
+  staleConnections: 0,      // 410 Gone → 정리
+  adminMessagesSent: 0,
+  subscribedSymbols: 0,     // gauge (마지막 루프 기준)
+  adminConnections: 0,      // gauge
+
+  cycleLatency: { auth: new LatencyHistogram(), anon: new LatencyHistogram() },
+  valkeyRtt: new LatencyHistogram(),    // 브로드캐스트 경로 Valkey 조회
+  postLatency: new LatencyHistogram(),  // API Gateway PostToConnection
+};
+
+function header(out, name, help, type) {
+  out.push(`# HELP ${name} ${help}`, `# TYPE ${name} ${type}`);
+}
+
+function histogram(out, name, help, hists, label) {
+  header(out, name, help, 'histogram');
+  for (const [key, h] of Object.entries(hists)) {
+    const l = label ? `${label}="${key}",` : '';
+    for (let shift = LE_MIN_SHIFT; shift <= LE_MAX_SHIFT; shift++) {
+      const limit = 2 ** shift;
+      out.push(`${name}_bucket{${l}le="${limit / 1e9}"} ${h.countAtOrBelow(limit - 1)}`);
+    }
+    const sel = label ? `{${label}="${key}"}` : '';
+    out.push(`${name}_bucket{${l}le="+Inf"} ${h.count}`);
+    out.push(`${name}_sum${sel} ${h.sumNs / 1e9}`);
+    out.push(`${name}_count${sel} ${h.count}`);
+  }
+
+  const qname = name.replace(/_seconds$/, '_quantile_seconds');
+  header(out, qname, `${help} (HDR quantile)`, 'gauge');
+  for (const [key, h] of Object.entries(hists)) {
+    const l = label ? `${label}="${key}",` : '';
+    for (const q of QUANTILES) out.push(`${qname}{${l}quantile="${q}"} ${h.percentile(q) / 1e9}`);
+    out.push(`${qname}{${l}quantile="1"} ${h.maxNs / 1e9}`);
+  }
+}
+
+export function renderPrometheus() {
+  const m = metrics;
+  const out = [];
+  header(out, 'streamer_broadcast_cycles_total', 'Broadcast loop iterations', 'counter');
+  for (const [tier, n] of Object.entries(m.broadcastCycles)) {
+    out.push(`streamer_broadcast_cycles_total{tier="${tier}"} ${n}`);
+  }
+  header(out, 'streamer_messages_sent_total', 'PostToConnection successes', 'counter');
+  out.push(`streamer_messages_sent_total ${m.messagesSent}`);
+  header(out, 'streamer_send_failures_total', 'PostToConnection failures (non-410)', 'counter');
+  out.push(`streamer_send_failures_total ${m.sendFailures}`);
+  header(out, 'streamer_stale_connections_total', 'Connections cleaned up after 410 Gone', 'counter');
+  out.push(`streamer_stale_connections_total ${m.staleConnections}`);
+  header(out, 'streamer_admin_messages_sent_total', 'Admin PostToConnection successes', 'counter');
+  out.push(`streamer_admin_messages_sent_total ${m.adminMessagesSent}`);
+  header(out, 'streamer_subscribed_symbols', 'Symbols with subscribers', 'gauge');
+  out.push(`streamer_subscribed_symbols ${m.subscribedSymbols}`);
+  header(out, 'streamer_admin_connections', 'Admin WebSocket connections', 'gauge');
+  out.push(`streamer_admin_connections ${m.adminConnections}`);
+
+  histogram(out, 'streamer_cycle_latency_seconds', 'Broadcast loop cycle time (excluding sleep)',
+            m.cycleLatency, 'tier');
+  histogram(out, 'streamer_valkey_rtt_seconds', 'Valkey reads on the broadcast path',
+            { all: m.valkeyRtt }, null);
+  histogram(out, 'streamer_post_latency_seconds', 'API Gateway PostToConnection latency',
+            { all: m.postLatency }, null);
+  return out.join('\n') + '\n';
+}
+
+// GET /metrics, /healthz. port 0이면 시작하지 않는다.
+export function startMetricsServer(port) {
+  if (!port) return null;
+  const server = http.createServer((req, res) => {
+    const path = (req.url || '').split('?')[0];
+    if (req.method !== 'GET') {
+      res.writeHead(405, { 'Content-Type': 'text/plain' }).end('method not allowed\n');
+    } else if (path === '/metrics') {
+      res.writeHead(200, { 'Content-Type': 'text/plain; version=0.0.4; charset=utf-8' })
+        .end(renderPrometheus());
+    } else if (path === '/healthz') {
+      res.writeHead(200, { 'Content-Type': 'text/plain' }).end('ok\n');
+    } else {
+      res.writeHead(404, { 'Content-Type': 'text/plain' }).end('not found\n');
+    }
+  });
+  server.on('error', (err) => console.error(`[Metrics] Server error: ${err.message}`));
+  server.listen(port, () => console.log(`[Metrics] Listening on port ${port} (/metrics)`));
+  return server;
+}
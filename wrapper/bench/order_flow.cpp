@@ -0,0 +1,326 @@
+#include "order_flow.h"
+#include <algorithm>
+#include <fstream>
+#include <random>
+#include <unordered_map>
+
+namespace aws_wrapper {
+
+namespace {
+
+constexpr uint64_t BASE_PRICE = 10000;
+constexpr int64_t BASE_TIMESTAMP_MS = 1700000000000;
+
+// 북에 남아 있다고 보는 주문. 체결은 가격 우선으로 근사해 지우므로(시간 우선·STP는 무시)
+// 이미 체결된 주문을 취소·정정하는 레코드가 일부 생긴다 — 실제 흐름에도 있는 경합이다.
+struct LiveOrder {
+    std::string order_id;
+    std::string user_id;
+    bool is_buy;
+    uint64_t price;
+    uint64_t qty;
+};
+
+struct SymbolState {
+    std::string symbol;
+    uint64_t mid = BASE_PRICE;
+    std::vector<LiveOrder> live;
+};
+
+class FlowBuilder {
+public:
+    FlowBuilder(const FlowSpec& spec, size_t default_symbols)
+        : rng_(spec.seed), limit_(spec.orders) {
+        size_t n = spec.symbols ? spec.symbols : default_symbols;
+        for (size_t i = 0; i < n; ++i) {
+            SymbolState s;
+            s.symbol = "SYM" + std::to_string(i);
+            symbols_.push_back(std::move(s));
+        }
+        // 종목 선택은 순위 역수 가중(상위 종목에 흐름이 몰림)
+        for (size_t i = 0; i < n; ++i) weights_.push_back(1.0 / static_cast<double>(i + 1));
+        pick_symbol_ = std::discrete_distribution<size_t>(weights_.begin(), weights_.end());
+    }
+
+    bool full() const { return records_.size() >= limit_; }
+    std::vector<nlohmann::json> take() { return std::move(records_); }
+
+    size_t symbolCount() const { return symbols_.size(); }
+    SymbolState& symbol(size_t i) { return symbols_[i]; }
+    SymbolState& randomSymbol() { return symbols_[pick_symbol_(rng_)]; }
+
+    uint64_t uniform(uint64_t lo, uint64_t hi) {
+        return std::uniform_int_distribution<uint64_t>(lo, hi)(rng_);
+    }
+    bool chance(double p) { return std::bernoulli_distribution(p)(rng_); }
+
+    // 중간가 기준 depth번째 호가 (1 = 최우선)
+    static uint64_t levelPrice(const SymbolState& s, bool is_buy, uint64_t depth) {
+        return is_buy ? s.mid - depth : s.mid + depth;
+    }
+
+    void add(SymbolState& s, const std::string& user, bool is_buy, uint64_t price,
+             uint64_t qty, bool rests = true) {
+        if (full()) return;
+        std::string id = "o" + std::to_string(++seq_);
+        nlohmann::json j = base("ADD", s.symbol, id);
+        j["user_id"] = user;
+        j["side"] = is_buy ? "BUY" : "SELL";
+        j["price"] = price;
+        j["quantity"] = qty;
+        j["order_type"] = "LIMIT";
+        records_.push_back(std::move(j));
+        qty = consume(s, is_buy, price, qty);
+        if (rests && qty > 0) s.live.push_back({id, user, is_buy, price, qty});
+    }
+
+    // 시장가: price 0 + IOC (잔량은 북에 남지 않는다)
+    void market(SymbolState& s, const std::string& user, bool is_buy, uint64_t qty) {
+        if (full()) return;
+        nlohmann::json j = base("ADD", s.symbol, "o" + std::to_string(++seq_));
+        j["user_id"] = user;
+        j["side"] = is_buy ? "BUY" : "SELL";
+        j["price"] = 0;
+        j["quantity"] = qty;
+        j["order_type"] = "MARKET";
+        j["conditions"] = {{"immediate_or_cancel", true}};
+        records_.push_back(std::move(j));
+        consume(s, is_buy, 0, qty);
+    }
+
+    // live에서 임의 주문 하나를 꺼내 취소
+    void cancelRandom(SymbolState& s) {
+        if (full() || s.live.empty()) return;
+        size_t i = uniform(0, s.live.size() - 1);
+        records_.push_back(base("CANCEL", s.symbol, s.live[i].order_id));
+        s.live[i] = std::move(s.live.back());
+        s.live.pop_back();
+    }
+
+    void cancelAll(SymbolState& s) {
+        std::shuffle(s.live.begin(), s.live.end(), rng_);
+        while (!s.live.empty() && !full()) {
+            records_.push_back(base("CANCEL", s.symbol, s.live.back().order_id));
+            s.live.pop_back();
+        }
+    }
+
+    // live에서 임의 주문 하나를 depth단계로 옮긴다 (수량 ±)
+    void replaceRandom(SymbolState& s, uint64_t depth, int64_t qty_delta) {
+        if (full() || s.live.empty()) return;
+        LiveOrder& o = s.live[uniform(0, s.live.size() - 1)];
+        uint64_t new_price = levelPrice(s, o.is_buy, depth);
+        nlohmann::json j = base("REPLACE", s.symbol, o.order_id);
+        j["qty_delta"] = qty_delta;
+        j["new_price"] = new_price;
+        records_.push_back(std::move(j));
+        o.price = new_price;
+        o.qty = static_cast<uint64_t>(std::max<int64_t>(0, static_cast<int64_t>(o.qty) + qty_delta));
+    }
+
+    // 중간가 랜덤 워크 (±1틱)
+    void drift(SymbolState& s, double p) {
+        if (!chance(p)) return;
+        s.mid = chance(0.5) ? s.mid + 1 : s.mid - 1;
+    }
+
+    // 양쪽 levels단계 × per_level주문 MM 호가
+    void seedLadder(SymbolState& s, int levels, int per_level, uint64_t qty) {
+        for (int level = 1; level <= levels; ++level) {
+            for (int k = 0; k < per_level; ++k) {
+                add(s, "mm-buyer", true, levelPrice(s, true, level), qty);
+                add(s, "mm-seller", false, levelPrice(s, false, level), qty);
+            }
+        }
+    }
+
+    std::string retailUser() { return "user-" + std::to_string(uniform(1, 1000)); }
+
+private:
+    // 들어온 주문이 반대편 live 주문과 체결되는 만큼 지운다. 남은 수량을 돌려준다.
+    // limit_price 0 = 시장가.
+    static uint64_t consume(SymbolState& s, bool is_buy, uint64_t limit_price, uint64_t qty) {
+        while (qty > 0) {
+            size_t best = s.live.size();
+            for (size_t i = 0; i < s.live.size(); ++i) {
+                const LiveOrder& o = s.live[i];
+                if (o.is_buy == is_buy) continue;
+                if (limit_price != 0 && (is_buy ? o.price > limit_price : o.price < limit_price)) {
+                    continue;
+                }
+                if (best == s.live.size() ||
+                    (is_buy ? o.price < s.live[best].price : o.price > s.live[best].price)) {
+                    best = i;
+                }
+            }
+            if (best == s.live.size()) break;
+            uint64_t fill = std::min(qty, s.live[best].qty);
+            qty -= fill;
+            s.live[best].qty -= fill;
+            if (s.live[best].qty == 0) {
+                s.live[best] = std::move(s.live.back());
+                s.live.pop_back();
+            }
+        }
+        return qty;
+    }
+
+    nlohmann::json base(const char* action, const std::string& symbol,
+                        const std::string& order_id) {
+        nlohmann::json j;
+        j["action"] = action;
+        j["order_id"] = order_id;
+        j["symbol"] = symbol;
+        j["timestamp"] = BASE_TIMESTAMP_MS + static_cast<int64_t>(records_.size());
+        return j;
+    }
+
+    std::mt19937_64 rng_;
+    size_t limit_;
+    uint64_t seq_ = 0;
+    std::vector<SymbolState> symbols_;
+    std::vector<double> weights_;
+    std::discrete_distribution<size_t> pick_symbol_;
+    std::vector<nlohmann::json> records_;
+};
+
+// MM이 10단계 호가를 계속 정정·교체하고, 가끔 개인 지정가가 최우선을 친다
+void mmLadder(FlowBuilder& b) {
+    for (size_t i = 0; i < b.symbolCount(); ++i) b.seedLadder(b.symbol(i), 10, 2, 100);
+    while (!b.full()) {
+        SymbolState& s = b.randomSymbol();
+        b.drift(s, 0.1);
+        uint64_t roll = b.uniform(0, 99);
+        if (roll < 60) {
+            b.replaceRandom(s, b.uniform(1, 10), static_cast<int64_t>(b.uniform(0, 20)) - 10);
+        } else if (roll < 85) {
+            b.cancelRandom(s);
+            bool is_buy = b.chance(0.5);
+            b.add(s, is_buy ? "mm-buyer" : "mm-seller", is_buy,
+                  FlowBuilder::levelPrice(s, is_buy, b.uniform(1, 10)), 100);
+        } else {
+            bool is_buy = b.chance(0.5);
+            b.add(s, b.retailUser(), is_buy, FlowBuilder::levelPrice(s, !is_buy, 1),
+                  b.uniform(1, 50), false);
+        }
+    }
+}
+
+// 두꺼운 MM 호가에 개인 시장가가 쏟아지고, MM이 소진분을 보충한다
+void retailMarket(FlowBuilder& b) {
+    for (size_t i = 0; i < b.symbolCount(); ++i) b.seedLadder(b.symbol(i), 10, 5, 200);
+    while (!b.full()) {
+        SymbolState& s = b.randomSymbol();
+        b.drift(s, 0.02);
+        uint64_t roll = b.uniform(0, 99);
+        if (roll < 70) {
+            b.market(s, b.retailUser(), b.chance(0.5), b.uniform(1, 50));
+        } else if (roll < 90) {
+            bool is_buy = b.chance(0.5);
+            b.add(s, b.retailUser(), is_buy,
+                  FlowBuilder::levelPrice(s, is_buy, b.uniform(1, 5)), b.uniform(1, 50));
+        } else {
+            bool is_buy = b.chance(0.5);
+            b.add(s, is_buy ? "mm-buyer" : "mm-seller", is_buy,
+                  FlowBuilder::levelPrice(s, is_buy, b.uniform(1, 10)), 200);
+        }
+    }
+}
+
+// 수백 건을 깔았다가 무작위 순서로 전부 취소하는 폭주를 반복
+void cancelStorm(FlowBuilder& b) {
+    while (!b.full()) {
+        SymbolState& s = b.randomSymbol();
+        size_t burst = b.uniform(100, 400);
+        for (size_t k = 0; k < burst; ++k) {
+            bool is_buy = b.chance(0.5);
+            b.add(s, "mm-storm", is_buy,
+                  FlowBuilder::levelPrice(s, is_buy, b.uniform(1, 20)), b.uniform(1, 100));
+        }
+        b.cancelAll(s);
+    }
+}
+
+// 여러 종목에 위 패턴을 섞는다 (종목 쏠림 포함)
+void multiSymbol(FlowBuilder& b) {
+    for (size_t i = 0; i < b.symbolCount(); ++i) b.seedLadder(b.symbol(i), 5, 2, 100);
+    while (!b.full()) {
+        SymbolState& s = b.randomSymbol();
+        b.drift(s, 0.05);
+        uint64_t roll = b.uniform(0, 99);
+        bool is_buy = b.chance(0.5);
+        if (roll < 40) {
+            b.replaceRandom(s, b.uniform(1, 5), 0);
+        } else if (roll < 60) {
+            b.market(s, b.retailUser(), is_buy, b.uniform(1, 30));
+        } else if (roll < 85) {
+            b.add(s, is_buy ? "mm-buyer" : "mm-seller", is_buy,
+                  FlowBuilder::levelPrice(s, is_buy, b.uniform(1, 5)), 100);
+        } else {
+            b.cancelRandom(s);
+        }
+    }
+}
+
+}  // namespace
+
+const std::vector<std::string>& flowScenarios() {
+    static const std::vector<std::string> names = {
+        "mm_ladder", "retail_market", "cancel_storm", "multi_symbol"};
+    return names;
+}
+
+std::vector<nlohmann::json> generateOrderFlow(const FlowSpec& spec) {
+    if (spec.scenario == "mm_ladder") {
+        FlowBuilder b(spec, 1);
+        mmLadder(b);
+        return b.take();
+    }
+    if (spec.scenario == "retail_market") {
+        FlowBuilder b(spec, 1);
+        retailMarket(b);
+        return b.take();
+    }
+    if (spec.scenario == "cancel_storm") {
+        FlowBuilder b(spec, 1);
+        cancelStorm(b);
+        return b.take();
+    }
+    if (spec.scenario == "multi_symbol") {
+        FlowBuilder b(spec, 50);
+        multiSymbol(b);
+        return b.take();
+    }
+    return {};
+}
+
+bool loadOrderFlow(const std::string& path, std::vector<nlohmann::json>& out,
+                   std::string& error) {
+    std::ifstream in(path);
+    if (!in) {
+        error = "cannot open " + path;
+        return false;
+    }
+    std::string line;
+    size_t line_no = 0;
+    while (std::getline(in, line)) {
+        ++line_no;
+        if (line.empty() || line[0] == '#') continue;
+        try {
+            out.push_back(nlohmann::json::parse(line));
+        } catch (const std::exception& e) {
+            error = path + ":" + std::to_string(line_no) + ": " + e.what();
+            return false;
+        }
+    }
+    return true;
+}
+
+bool writeOrderFlow(const std::string& path, const std::vector<nlohmann::json>& records) {
+    std::ofstream out(path);
+    if (!out) return false;
+    for (const auto& j : records) out << j.dump() << '\n';
+    return static_cast<bool>(out);
+}
+
+} // namespace aws_wrapper
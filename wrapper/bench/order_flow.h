@@ -0,0 +1,39 @@
+#pragma once
+
+#include <nlohmann/json.hpp>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace aws_wrapper {
+
+/**
+ * 주문 흐름(order flow) 파일: JSON Lines, 한 줄이 Kinesis 주문 레코드 하나.
+ *
+ *   {"action":"ADD","order_id":"o1","user_id":"u1","symbol":"SAMSUNG","side":"BUY",
+ *    "price":72500,"quantity":10,"order_type":"LIMIT","timestamp":1700000000000}
+ *   {"action":"CANCEL","order_id":"o1","symbol":"SAMSUNG"}
+ *   {"action":"REPLACE","order_id":"o1","symbol":"SAMSUNG","qty_delta":-5,"new_price":72400}
+ *
+ * 컨슈머 콜백(main.cpp)이 읽는 필드와 같으므로 캡처한 레코드를 그대로 재생할 수 있다.
+ * 빈 줄과 '#'으로 시작하는 줄은 무시한다.
+ */
+struct FlowSpec {
+    std::string scenario = "mm_ladder";
+    size_t orders = 100000;   // 생성할 레코드 수 (시드 호가 포함)
+    size_t symbols = 0;       // 0이면 시나리오 기본값
+    uint64_t seed = 42;
+};
+
+// 합성 시나리오 이름: mm_ladder, retail_market, cancel_storm, multi_symbol
+const std::vector<std::string>& flowScenarios();
+
+// 시나리오를 결정적으로(seed 기준) 생성. 모르는 시나리오면 빈 벡터.
+std::vector<nlohmann::json> generateOrderFlow(const FlowSpec& spec);
+
+// 파일 읽기/쓰기. 실패 시 false와 error(줄 번호 포함).
+bool loadOrderFlow(const std::string& path, std::vector<nlohmann::json>& out,
+                   std::string& error);
+bool writeOrderFlow(const std::string& path, const std::vector<nlohmann::json>& records);
+
+} // namespace aws_wrapper
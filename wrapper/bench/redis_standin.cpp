@@ -0,0 +1,226 @@
+#include "redis_standin.h"
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+
+namespace aws_wrapper {
+
+namespace {
+
+void appendBulk(std::string& out, const std::string& s) {
+    out += '$';
+    out += std::to_string(s.size());
+    out += "\r\n";
+    out += s;
+    out += "\r\n";
+}
+
+void appendInt(std::string& out, long long v) {
+    out += ':';
+    out += std::to_string(v);
+    out += "\r\n";
+}
+
+// "\r\n"으로 끝나는 한 줄을 [pos, end)로. 덜 왔으면 false.
+bool findLine(const std::string& buf, size_t pos, size_t& end) {
+    size_t cr = buf.find("\r\n", pos);
+    if (cr == std::string::npos) return false;
+    end = cr;
+    return true;
+}
+
+}  // namespace
+
+RedisStandIn::~RedisStandIn() {
+    stop();
+}
+
+bool RedisStandIn::start() {
+    listen_fd_ = ::socket(AF_INET, SOCK_STREAM, 0);
+    if (listen_fd_ < 0) return false;
+    int one = 1;
+    ::setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = 0;  // 임의 포트
+    socklen_t len = sizeof(addr);
+    if (::bind(listen_fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 ||
+        ::listen(listen_fd_, 16) != 0 ||
+        ::getsockname(listen_fd_, reinterpret_cast<sockaddr*>(&addr), &len) != 0 ||
+        ::pipe(wake_fd_) != 0) {
+        stop();
+        return false;
+    }
+    port_ = ntohs(addr.sin_port);
+    running_.store(true, std::memory_order_release);
+    thread_ = std::thread(&RedisStandIn::run, this);
+    return true;
+}
+
+void RedisStandIn::stop() {
+    if (running_.exchange(false) && wake_fd_[1] >= 0) {
+        char c = 0;
+        (void)::write(wake_fd_[1], &c, 1);
+    }
+    if (thread_.joinable()) thread_.join();
+    for (int* fd : {&listen_fd_, &wake_fd_[0], &wake_fd_[1]}) {
+        if (*fd >= 0) ::close(*fd);
+        *fd = -1;
+    }
+}
+
+std::map<std::string, uint64_t> RedisStandIn::commandCounts() const {
+    std::lock_guard<std::mutex> lock(counts_mutex_);
+    return counts_;
+}
+
+void RedisStandIn::resetCounts() {
+    std::lock_guard<std::mutex> lock(counts_mutex_);
+    counts_.clear();
+    total_commands_.store(0, std::memory_order_relaxed);
+}
+
+void RedisStandIn::run() {
+    std::vector<Client> clients;
+    std::vector<pollfd> fds;
+    std::vector<std::string> args;
+    char buf[16384];
+
+    while (running_.load(std::memory_order_acquire)) {
+        fds.clear();
+        fds.push_back({listen_fd_, POLLIN, 0});
+        fds.push_back({wake_fd_[0], POLLIN, 0});
+        for (const auto& c : clients) {
+            fds.push_back({c.fd, static_cast<short>(POLLIN | (c.out.empty() ? 0 : POLLOUT)), 0});
+        }
+        if (::poll(fds.data(), fds.size(), -1) < 0) continue;
+
+        if (fds[0].revents & POLLIN) {
+            int fd = ::accept(listen_fd_, nullptr, nullptr);
+            if (fd >= 0) {
+                int one = 1;
+                ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+                ::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL) | O_NONBLOCK);
+                clients.push_back(Client{fd, {}, {}});
+            }
+        }
+
+        // fds[2..]는 poll 직전의 clients 순서와 같다 (새 연결은 뒤에 붙는다)
+        for (size_t i = 2; i < fds.size(); ++i) {
+            Client& c = clients[i - 2];
+            if (fds[i].revents & (POLLIN | POLLHUP | POLLERR)) {
+                ssize_t n = ::recv(c.fd, buf, sizeof(buf), 0);
+                if (n <= 0) {
+                    ::close(c.fd);
+                    c.fd = -1;
+                    continue;
+                }
+                c.in.append(buf, static_cast<size_t>(n));
+                size_t pos = 0;
+                while (parseCommand(c.in, pos, args)) execute(args, c.out);
+                c.in.erase(0, pos);
+            }
+            if (!c.out.empty()) {
+                ssize_t n = ::send(c.fd, c.out.data(), c.out.size(), MSG_NOSIGNAL);
+                if (n > 0) c.out.erase(0, static_cast<size_t>(n));
+            }
+        }
+        clients.erase(std::remove_if(clients.begin(), clients.end(),
+                                     [](const Client& c) { return c.fd < 0; }),
+                      clients.end());
+    }
+    for (auto& c : clients) ::close(c.fd);
+}
+
+bool RedisStandIn::parseCommand(std::string& buf, size_t& pos, std::vector<std::string>& args) {
+    args.clear();
+    if (pos >= buf.size()) return false;
+    size_t end;
+    if (buf[pos] != '*') {
+        // 인라인 명령 (redis-cli/telnet)
+        if (!findLine(buf, pos, end)) return false;
+        size_t p = pos;
+        while (p < end) {
+            while (p < end && buf[p] == ' ') ++p;
+            size_t q = p;
+            while (q < end && buf[q] != ' ') ++q;
+            if (q > p) args.emplace_back(buf, p, q - p);
+            p = q;
+        }
+        pos = end + 2;
+        return true;
+    }
+    size_t p = pos;
+    if (!findLine(buf, p, end)) return false;
+    long count = std::strtol(buf.c_str() + p + 1, nullptr, 10);
+    p = end + 2;
+    for (long i = 0; i < count; ++i) {
+        if (!findLine(buf, p, end) || buf[p] != '$') return false;
+        size_t n = static_cast<size_t>(std::strtol(buf.c_str() + p + 1, nullptr, 10));
+        p = end + 2;
+        if (buf.size() < p + n + 2) return false;
+        args.emplace_back(buf, p, n);
+        p += n + 2;
+    }
+    pos = p;
+    return true;
+}
+
+void RedisStandIn::execute(const std::vector<std::string>& args, std::string& out) {
+    if (args.empty()) return;
+    std::string cmd = args[0];
+    for (auto& ch : cmd) ch = static_cast<char>(std::toupper(static_cast<unsigned char>(ch)));
+    {
+        std::lock_guard<std::mutex> lock(counts_mutex_);
+        ++counts_[cmd];
+    }
+    total_commands_.fetch_add(1, std::memory_order_relaxed);
+
+    if (cmd == "PING") {
+        out += "+PONG\r\n";
+    } else if ((cmd == "SET" && args.size() >= 3) || (cmd == "SETEX" && args.size() >= 4)) {
+        strings_[args[1]] = args[cmd == "SET" ? 2 : 3];
+        out += "+OK\r\n";
+    } else if (cmd == "MSET") {
+        for (size_t i = 1; i + 1 < args.size(); i += 2) strings_[args[i]] = args[i + 1];
+        out += "+OK\r\n";
+    } else if (cmd == "GET" && args.size() >= 2) {
+        auto it = strings_.find(args[1]);
+        if (it == strings_.end()) out += "$-1\r\n";
+        else appendBulk(out, it->second);
+    } else if (cmd == "DEL" || cmd == "EXISTS") {
+        long long n = 0;
+        for (size_t i = 1; i < args.size(); ++i) {
+            if (cmd == "DEL") n += static_cast<long long>(strings_.erase(args[i]));
+            else n += static_cast<long long>(strings_.count(args[i]));
+        }
+        appendInt(out, n);
+    } else if (cmd == "ZINCRBY" && args.size() >= 3) {
+        appendBulk(out, args[2]);
+    } else if (cmd == "ZADD" || cmd == "LPUSH" || cmd == "HSET") {
+        appendInt(out, 1);
+    } else if (cmd == "SISMEMBER" || cmd == "PUBLISH" || cmd == "ZREMRANGEBYRANK") {
+        appendInt(out, 0);
+    } else if (cmd == "KEYS" || cmd == "SMEMBERS" || cmd == "LRANGE" || cmd == "ZRANGE" ||
+               cmd == "ZREVRANGE" || cmd == "HGETALL") {
+        out += "*0\r\n";
+    } else if (cmd == "HGET") {
+        out += "$-1\r\n";
+    } else if (cmd == "EVAL" || cmd == "EVALSHA") {
+        appendBulk(out, "OK");  // 엔진의 유일한 스크립트(캔들 갱신)는 "OK"를 돌려준다
+    } else {
+        out += "+OK\r\n";
+    }
+}
+
+} // namespace aws_wrapper
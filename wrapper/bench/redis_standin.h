@@ -0,0 +1,66 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace aws_wrapper {
+
+/**
+ * RedisStandIn: 벤치마크용 프로세스 내 Redis 대역
+ *
+ * 127.0.0.1 임의 포트에서 RESP2를 받는 단일 스레드 서버. 엔진 쪽 RedisClient/hiredis는
+ * 그대로 쓰므로 명령 포맷팅·소켓 왕복·응답 파싱 비용이 측정에 포함되고, 원격 Valkey의
+ * 네트워크 지연만 빠진다.
+ *
+ * 문자열 키(SET/SETEX/MSET/GET/DEL/EXISTS)만 실제로 저장한다. 나머지 명령은 RedisClient가
+ * 성공으로 보는 형태(+OK, :0, 빈 배열 등)로 답하고 명령별 횟수만 센다.
+ */
+class RedisStandIn {
+public:
+    RedisStandIn() = default;
+    ~RedisStandIn();
+
+    RedisStandIn(const RedisStandIn&) = delete;
+    RedisStandIn& operator=(const RedisStandIn&) = delete;
+
+    // 수신 소켓을 열고 서버 스레드 시작. 실패하면 false.
+    bool start();
+    void stop();
+    int port() const { return port_; }
+
+    // 명령 이름(대문자) → 처리 횟수
+    std::map<std::string, uint64_t> commandCounts() const;
+    uint64_t totalCommands() const { return total_commands_.load(std::memory_order_relaxed); }
+    void resetCounts();
+
+private:
+    struct Client {
+        int fd = -1;
+        std::string in;
+        std::string out;
+    };
+
+    void run();
+    // buf에서 완결된 명령 하나를 꺼낸다. 아직 덜 왔으면 false.
+    static bool parseCommand(std::string& buf, size_t& pos, std::vector<std::string>& args);
+    void execute(const std::vector<std::string>& args, std::string& out);
+
+    int listen_fd_ = -1;
+    int wake_fd_[2] = {-1, -1};
+    int port_ = 0;
+    std::thread thread_;
+    std::atomic<bool> running_{false};
+
+    std::unordered_map<std::string, std::string> strings_;  // 서버 스레드 전용
+    mutable std::mutex counts_mutex_;
+    std::map<std::string, uint64_t> counts_;
+    std::atomic<uint64_t> total_commands_{0};
+};
+
+} // namespace aws_wrapper
@@ -0,0 +1,415 @@
+// 주문 흐름 재생 벤치마크 — EngineCore + MarketDataHandler 전체 경로.
+//
+// 캡처했거나 합성한 주문 흐름(JSON Lines, order_flow.h)을 addOrder/cancelOrder/replaceOrder로
+// 흘려 처리량(orders/sec), 동작별 p50/p99/p99.9, 주문당 힙 할당 수를 잰다.
+// 발행은 카운팅 mock IProducer, Redis는 프로세스 내 RESP 대역(RedisStandIn)이 받는다.
+//
+//   replay_bench                                  # 합성 시나리오 4종 전부
+//   replay_bench --scenario=retail_market --orders=500000
+//   replay_bench --flow=captured.jsonl --flow=storm.jsonl
+//   replay_bench --scenario=mm_ladder --write-flow=mm.jsonl   # 생성만 하고 저장
+//   replay_bench --json=bench.json                # 회귀 추적용 결과
+//
+// 옵션: --orders=N --symbols=N --seed=N --warmup=N(기본 5%) --redis=standin|none
+//       --mbo (MBO 피드 포함). 엔진 설정(PRICE_BAND_PCT 등)은 운영과 같은 환경변수를 따른다.
+// 로그: LOG_LEVEL(기본 ERROR — 예상된 거부의 WARN을 숨긴다. 로깅 비용까지 재려면 INFO).
+// 디코드(JSON 파싱·Order::fromJson)는 측정 전에 끝내므로 결과는 엔진 구간만이다.
+#include "order_flow.h"
+#include "redis_standin.h"
+#include "config.h"
+#include "engine_core.h"
+#include "iproducer.h"
+#include "latency_trace.h"
+#include "logger.h"
+#include "market_data_handler.h"
+#include "mbo_feed.h"
+#include "metrics.h"
+#include "order.h"
+#include "ranking_manager.h"
+#include "redis_client.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <string>
+#include <vector>
+
+// === 힙 할당 계수 ===========================================================
+// 측정 스레드에서만 센다 (로거 writer·Redis 대역 스레드의 할당은 제외)
+namespace {
+thread_local bool t_count_allocs = false;
+thread_local uint64_t t_allocs = 0;
+
+void* countedAlloc(std::size_t size) {
+    if (t_count_allocs) ++t_allocs;
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+}  // namespace
+
+void* operator new(std::size_t size) { return countedAlloc(size); }
+void* operator new[](std::size_t size) { return countedAlloc(size); }
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    if (t_count_allocs) ++t_allocs;
+    return std::malloc(size ? size : 1);
+}
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    if (t_count_allocs) ++t_allocs;
+    return std::malloc(size ? size : 1);
+}
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+
+using namespace aws_wrapper;
+
+namespace {
+
+// 발행 이벤트 수만 세는 producer (KinesisProducer의 직렬화·전송 비용은 제외)
+struct CountingProducer : public IProducer {
+    uint64_t fills = 0, trades = 0, depths = 0, statuses = 0, mbo = 0;
+
+    void publishFill(const std::string&, const std::string&, const std::string&,
+                     const std::string&, const std::string&, uint64_t, uint64_t,
+                     bool, bool, bool) override { ++fills; }
+    void publishTrade(const std::string&, uint64_t, uint64_t) override { ++trades; }
+    void publishDepth(const std::string&, const nlohmann::json&) override { ++depths; }
+    void publishOrderStatus(const std::string&, const std::string&, const std::string&,
+                            const std::string&, const std::string&, uint64_t, uint64_t,
+                            bool, const std::string&) override { ++statuses; }
+    void publishMbo(const std::string&, const std::string&) override { ++mbo; }
+    void flush(int) override {}
+
+    uint64_t total() const { return fills + trades + depths + statuses + mbo; }
+};
+
+enum OpKind { OP_ADD, OP_CANCEL, OP_REPLACE, OP_KINDS };
+const char* opName(OpKind k) {
+    switch (k) {
+        case OP_ADD:     return "add";
+        case OP_CANCEL:  return "cancel";
+        case OP_REPLACE: return "replace";
+        default:         return "?";
+    }
+}
+
+struct ReplayOp {
+    OpKind kind;
+    OrderPtr order;
+    int64_t qty_delta = 0;
+    uint64_t new_price = 0;
+};
+
+struct Options {
+    std::vector<std::string> flows;
+    std::vector<std::string> scenarios;
+    FlowSpec spec;
+    long warmup = -1;  // -1이면 5%
+    bool redis = true;
+    bool mbo = false;
+    std::string write_flow;
+    std::string json_out;
+};
+
+struct OpStats {
+    LatencyHistogram latency;
+    uint64_t count = 0;
+    uint64_t allocs = 0;
+    uint64_t rejected = 0;  // 엔진이 false를 돌려준 수 (중복·밴드·미존재 취소 등)
+};
+
+struct RunResult {
+    std::string name;
+    size_t records = 0;
+    size_t measured = 0;
+    double seconds = 0;
+    uint64_t allocs = 0;
+    uint64_t events = 0;
+    uint64_t redis_commands = 0;
+    uint64_t trades = 0;
+    OpStats ops[OP_KINDS];
+};
+
+bool startsWith(const char* arg, const char* prefix, const char*& value) {
+    size_t n = std::strlen(prefix);
+    if (std::strncmp(arg, prefix, n) != 0) return false;
+    value = arg + n;
+    return true;
+}
+
+void usage() {
+    std::cerr << "usage: replay_bench [--flow=FILE]... [--scenario=NAME|all]... [--orders=N]\n"
+                 "                    [--symbols=N] [--seed=N] [--warmup=N] [--redis=standin|none]\n"
+                 "                    [--mbo] [--write-flow=FILE] [--json=FILE]\n"
+                 "scenarios:";
+    for (const auto& s : flowScenarios()) std::cerr << " " << s;
+    std::cerr << "\n";
+}
+
+bool parseArgs(int argc, char** argv, Options& opt) {
+    for (int i = 1; i < argc; ++i) {
+        const char* v = nullptr;
+        const char* a = argv[i];
+        if (startsWith(a, "--flow=", v)) opt.flows.push_back(v);
+        else if (startsWith(a, "--scenario=", v)) opt.scenarios.push_back(v);
+        else if (startsWith(a, "--orders=", v)) opt.spec.orders = std::strtoull(v, nullptr, 10);
+        else if (startsWith(a, "--symbols=", v)) opt.spec.symbols = std::strtoull(v, nullptr, 10);
+        else if (startsWith(a, "--seed=", v)) opt.spec.seed = std::strtoull(v, nullptr, 10);
+        else if (startsWith(a, "--warmup=", v)) opt.warmup = std::strtol(v, nullptr, 10);
+        else if (startsWith(a, "--redis=", v)) opt.redis = std::strcmp(v, "none") != 0;
+        else if (std::strcmp(a, "--mbo") == 0) opt.mbo = true;
+        else if (startsWith(a, "--write-flow=", v)) opt.write_flow = v;
+        else if (startsWith(a, "--json=", v)) opt.json_out = v;
+        else {
+            std::cerr << "unknown option: " << a << "\n";
+            return false;
+        }
+    }
+    if (opt.flows.empty() && opt.scenarios.empty()) opt.scenarios.push_back("all");
+    std::vector<std::string> expanded;
+    for (const auto& s : opt.scenarios) {
+        if (s == "all") {
+            for (const auto& name : flowScenarios()) expanded.push_back(name);
+            continue;
+        }
+        bool known = false;
+        for (const auto& name : flowScenarios()) known = known || name == s;
+        if (!known) {
+            std::cerr << "unknown scenario: " << s << "\n";
+            return false;
+        }
+        expanded.push_back(s);
+    }
+    opt.scenarios = expanded;
+    return true;
+}
+
+// 레코드를 미리 Order로 디코드 (컨슈머 콜백과 같은 필드 해석)
+std::vector<ReplayOp> decode(const std::vector<nlohmann::json>& records, EngineClock& clock) {
+    std::vector<ReplayOp> ops;
+    ops.reserve(records.size());
+    for (const auto& j : records) {
+        ReplayOp op;
+        std::string action = j.value("action", "ADD");
+        op.kind = action == "CANCEL" ? OP_CANCEL : action == "REPLACE" ? OP_REPLACE : OP_ADD;
+        op.order = Order::fromJson(j, &clock);
+        op.qty_delta = j.value("qty_delta", 0);
+        op.new_price = j.value("new_price", 0);
+        ops.push_back(std::move(op));
+    }
+    return ops;
+}
+
+bool execute(EngineCore& engine, const ReplayOp& op) {
+    switch (op.kind) {
+        case OP_ADD:
+            return engine.addOrder(op.order);
+        case OP_CANCEL:
+            return engine.cancelOrder(op.order->symbol(), op.order->order_id());
+        case OP_REPLACE:
+            return engine.replaceOrder(op.order->symbol(), op.order->order_id(),
+                                       op.qty_delta, op.new_price);
+        default:
+            return false;
+    }
+}
+
+void run(const std::string& name, const std::vector<nlohmann::json>& records,
+         const Options& opt, RunResult& result) {
+    result.name = name;
+    result.records = records.size();
+
+    // 운영 main.cpp와 같은 배선: depth/candle/operating/ranking 각자 연결
+    RedisStandIn standin;
+    std::unique_ptr<RedisClient> depth_redis, candle_redis, operating_redis, ranking_redis;
+    if (opt.redis) {
+        if (standin.start()) {
+            depth_redis = std::make_unique<RedisClient>("127.0.0.1", standin.port());
+            candle_redis = std::make_unique<RedisClient>("127.0.0.1", standin.port());
+            operating_redis = std::make_unique<RedisClient>("127.0.0.1", standin.port());
+            ranking_redis = std::make_unique<RedisClient>("127.0.0.1", standin.port());
+            for (auto* c : {depth_redis.get(), candle_redis.get(), operating_redis.get(),
+                            ranking_redis.get()}) {
+                c->connect();
+            }
+        }
+        if (!depth_redis || !depth_redis->isConnected()) {
+            LOGGER_WARN("Redis stand-in unavailable - running without Redis");
+        }
+    }
+    auto connected = [](const std::unique_ptr<RedisClient>& c) {
+        return c && c->isConnected() ? c.get() : nullptr;
+    };
+
+    CountingProducer producer;
+    RankingManager ranking(connected(ranking_redis), nullptr);
+    MarketDataHandler handler(&producer, connected(depth_redis), connected(candle_redis),
+                              connected(ranking_redis) ? &ranking : nullptr);
+    EngineCore engine(&handler, connected(operating_redis));
+    std::unique_ptr<MboFeed> mbo_feed;
+    if (opt.mbo) {
+        MboFeed::Config mbo_config;
+        mbo_feed = std::make_unique<MboFeed>(&producer, mbo_config, &engine.clock());
+        handler.setMboFeed(mbo_feed.get());
+        mbo_feed->start();
+    }
+
+    std::vector<ReplayOp> ops = decode(records, engine.clock());
+    size_t warmup = opt.warmup >= 0 ? static_cast<size_t>(opt.warmup) : ops.size() / 20;
+    warmup = std::min(warmup, ops.size());
+    for (size_t i = 0; i < warmup; ++i) execute(engine, ops[i]);
+
+    uint64_t events_before = producer.total();
+    uint64_t trades_before = engine.getTotalTradesExecuted();
+    standin.resetCounts();
+
+    auto wall_start = std::chrono::steady_clock::now();
+    for (size_t i = warmup; i < ops.size(); ++i) {
+        const ReplayOp& op = ops[i];
+        OpStats& stats = result.ops[op.kind];
+        t_allocs = 0;
+        t_count_allocs = true;
+        uint64_t t0 = TraceClock::now();
+        bool ok = execute(engine, op);
+        uint64_t t1 = TraceClock::now();
+        t_count_allocs = false;
+        stats.latency.record(TraceClock::toNanos(t1 - t0));
+        stats.allocs += t_allocs;
+        ++stats.count;
+        if (!ok) ++stats.rejected;
+    }
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                                   wall_start).count();
+
+    if (mbo_feed) mbo_feed->stop();
+    result.measured = ops.size() - warmup;
+    for (const auto& s : result.ops) result.allocs += s.allocs;
+    result.events = producer.total() - events_before;
+    result.trades = engine.getTotalTradesExecuted() - trades_before;
+    result.redis_commands = standin.totalCommands();
+}
+
+double perOrder(uint64_t v, size_t n) {
+    return n ? static_cast<double>(v) / static_cast<double>(n) : 0.0;
+}
+
+void printResult(const RunResult& r) {
+    std::printf("\n== %s: %zu records (%zu measured) ==\n", r.name.c_str(), r.records, r.measured);
+    std::printf("  throughput   %.0f orders/sec\n",
+                r.seconds > 0 ? static_cast<double>(r.measured) / r.seconds : 0.0);
+    std::printf("  per order    %.2f allocs, %.2f events, %.2f redis cmds  (trades %llu)\n",
+                perOrder(r.allocs, r.measured), perOrder(r.events, r.measured),
+                perOrder(r.redis_commands, r.measured),
+                static_cast<unsigned long long>(r.trades));
+    std::printf("  %-8s %10s %9s %9s %9s %9s %10s %9s\n", "op", "count", "p50 us", "p99 us",
+                "p99.9 us", "max us", "allocs/op", "rejected");
+    for (int k = 0; k < OP_KINDS; ++k) {
+        const OpStats& s = r.ops[k];
+        if (s.count == 0) continue;
+        std::printf("  %-8s %10llu %9.2f %9.2f %9.2f %9.2f %10.2f %9llu\n",
+                    opName(static_cast<OpKind>(k)), static_cast<unsigned long long>(s.count),
+                    s.latency.percentile(0.50) / 1e3, s.latency.percentile(0.99) / 1e3,
+                    s.latency.percentile(0.999) / 1e3, s.latency.maxNs() / 1e3,
+                    perOrder(s.allocs, s.count), static_cast<unsigned long long>(s.rejected));
+    }
+}
+
+nlohmann::json toJson(const RunResult& r) {
+    nlohmann::json j;
+    j["name"] = r.name;
+    j["records"] = r.records;
+    j["measured"] = r.measured;
+    j["seconds"] = r.seconds;
+    j["orders_per_sec"] = r.seconds > 0 ? static_cast<double>(r.measured) / r.seconds : 0.0;
+    j["allocs_per_order"] = perOrder(r.allocs, r.measured);
+    j["events_per_order"] = perOrder(r.events, r.measured);
+    j["redis_commands_per_order"] = perOrder(r.redis_commands, r.measured);
+    j["trades"] = r.trades;
+    for (int k = 0; k < OP_KINDS; ++k) {
+        const OpStats& s = r.ops[k];
+        if (s.count == 0) continue;
+        j["ops"][opName(static_cast<OpKind>(k))] = {
+            {"count", s.count},
+            {"p50_ns", s.latency.percentile(0.50)},
+            {"p99_ns", s.latency.percentile(0.99)},
+            {"p999_ns", s.latency.percentile(0.999)},
+            {"max_ns", s.latency.maxNs()},
+            {"allocs_per_op", perOrder(s.allocs, s.count)},
+            {"rejected", s.rejected},
+        };
+    }
+    return j;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    Options opt;
+    if (!parseArgs(argc, argv, opt)) {
+        usage();
+        return 2;
+    }
+
+    std::string log_level = Config::get(Config::LOG_LEVEL, "ERROR");
+    if (log_level == "DEBUG") Logger::setLevel(LogLevel::DEBUG);
+    else if (log_level == "INFO") Logger::setLevel(LogLevel::INFO);
+    else if (log_level == "WARN") Logger::setLevel(LogLevel::WARN);
+    else Logger::setLevel(LogLevel::ERROR);
+
+    std::vector<std::pair<std::string, std::vector<nlohmann::json>>> flows;
+    for (const auto& path : opt.flows) {
+        std::vector<nlohmann::json> records;
+        std::string error;
+        if (!loadOrderFlow(path, records, error)) {
+            std::cerr << error << "\n";
+            return 1;
+        }
+        flows.emplace_back(path, std::move(records));
+    }
+    for (const auto& scenario : opt.scenarios) {
+        FlowSpec spec = opt.spec;
+        spec.scenario = scenario;
+        flows.emplace_back(scenario, generateOrderFlow(spec));
+    }
+
+    if (!opt.write_flow.empty()) {
+        if (flows.size() != 1) {
+            std::cerr << "--write-flow needs exactly one flow or scenario\n";
+            return 2;
+        }
+        if (!writeOrderFlow(opt.write_flow, flows.front().second)) {
+            std::cerr << "cannot write " << opt.write_flow << "\n";
+            return 1;
+        }
+        std::cout << "wrote " << flows.front().second.size() << " records to "
+                  << opt.write_flow << "\n";
+        return 0;
+    }
+
+    nlohmann::json report = nlohmann::json::array();
+    bool ok = true;
+    for (const auto& [name, records] : flows) {
+        RunResult result;
+        run(name, records, opt, result);
+        Logger::flush();
+        printResult(result);
+        report.push_back(toJson(result));
+        ok = ok && result.measured > 0;
+    }
+
+    if (!opt.json_out.empty()) {
+        std::ofstream out(opt.json_out);
+        out << report.dump(2) << "\n";
+        if (!out) {
+            std::cerr << "cannot write " << opt.json_out << "\n";
+            return 1;
+        }
+    }
+    return ok ? 0 : 1;
+}
@@ -3,6 +3,7 @@
 #include <string>
 #include <unordered_map>
 #include <mutex>
+#include <condition_variable>
 #include <chrono>
 #include <thread>
 #include <atomic>
@@ -22,6 +23,9 @@ class RedisClient;
  *   - 주기적 체크포인트 플러시 (100 레코드 또는 5초)
  *   - In-memory 버퍼 + dirty flag
  *   - Graceful shutdown 시 최종 플러시
+ *   - dirty 샤드 전부를 MSET 한 번(단일 왕복)으로 저장 — 샤드 수와 무관하게 플러시당 1 RTT
+ *   - 백그라운드 모드에서 consumer 스레드는 버퍼만 갱신하고, 임계 도달 시 플러시 스레드를
+ *     깨울 뿐 Redis I/O를 하지 않는다 (그 사이 갱신은 다음 MSET에 합쳐짐)
  */
 class CheckpointManager {
 public:
@@ -47,16 +51,26 @@ public:
     // 모든 체크포인트 삭제 (재시작 시 LATEST부터 시작하도록)
     void clearAllCheckpoints();
 
-    // 즉시 저장 (flush + persist)
+    // 즉시 저장 (flush + persist). 다른 dirty 샤드도 같은 MSET에 실린다.
     void checkpointImmediate(const std::string& shard_id, const std::string& sequence_number);
 
+    // 여러 샤드를 버퍼에 넣고 MSET 한 번으로 저장 (앵커 시딩 / 종료 시 최종 저장)
+    void checkpointBatch(const std::unordered_map<std::string, std::string>& sequences);
+
     // 백그라운드 플러시 스레드 (선택)
     void startBackgroundFlush();
     void stopBackgroundFlush();
 
     // 메트릭
     uint64_t getCheckpointCount() const { return checkpoint_count_.load(); }
-    uint64_t getFlushCount() const { return flush_count_.load(); }
+    uint64_t getFlushCount() const { return flush_count_.load(); }          // 저장된 샤드 수
+    uint64_t getFlushBatchCount() const { return flush_batches_.load(); }   // MSET 호출 수
+    uint64_t getLastFlushMicros() const { return last_flush_us_.load(); }
+    uint64_t getMaxFlushMicros() const { return max_flush_us_.load(); }
+    uint64_t getAvgFlushMicros() const {
+        uint64_t n = flush_batches_.load();
+        return n ? total_flush_us_.load() / n : 0;
+    }
     size_t getPendingCount() const;
 
 private:
@@ -68,27 +82,40 @@ private:
         std::string sequence_number;
         std::chrono::steady_clock::time_point last_updated;
         int records_since_flush = 0;
+        uint64_t version = 0;   // 갱신마다 증가 — 플러시 중 들어온 갱신은 dirty로 남긴다
         bool dirty = false;
     };
 
     mutable std::mutex buffer_mutex_;
     std::unordered_map<std::string, ShardCheckpoint> checkpoint_buffer_;
 
+    // Redis 쓰기 직렬화 (플러시 스레드 / 종료 플러시 / 시딩). buffer_mutex_보다 먼저 잡는다.
+    std::mutex flush_mutex_;
+
     // 백그라운드 플러시 스레드
     std::thread flush_thread_;
     std::atomic<bool> running_{false};
+    std::condition_variable flush_cv_;
+    bool flush_requested_ = false;   // buffer_mutex_ 보호
     void flushLoop();
 
     // 메트릭
     std::atomic<uint64_t> checkpoint_count_{0};
     std::atomic<uint64_t> flush_count_{0};
+    std::atomic<uint64_t> flush_batches_{0};
+    std::atomic<uint64_t> last_flush_us_{0};
+    std::atomic<uint64_t> max_flush_us_{0};
+    std::atomic<uint64_t> total_flush_us_{0};
 
     // Redis 키 헬퍼
     std::string makeCheckpointKey(const std::string& shard_id) const;
     std::string makeTimestampKey(const std::string& shard_id) const;
 
-    // 단일 샤드 플러시
-    void flushShard(const std::string& shard_id, ShardCheckpoint& cp);
+    // 버퍼 갱신 (buffer_mutex_ 보유 상태)
+    ShardCheckpoint& updateLocked(const std::string& shard_id, const std::string& sequence_number);
+
+    // dirty 샤드 전부를 MSET 한 번으로 저장. 반환: 저장된 샤드 수
+    int flushDirty();
 };
 
 } // namespace aws_wrapper
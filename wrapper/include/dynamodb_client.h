@@ -1,6 +1,7 @@
 #pragma once
 
 #include "order.h"
+#include <functional>
 #include <string>
 #include <vector>
 #include <memory>
@@ -39,6 +40,29 @@ public:
      */
     std::vector<OrderPtr> loadActiveOrders(const std::string& table_name = "supernoba-orders");
 
+    struct ActiveOrderLoadOptions {
+        // 병렬 Scan 세그먼트(=스레드) 수. 1이면 기존 순차 Scan.
+        int segments = 1;
+        // 비어있지 않으면 status를 파티션 키로 하는 GSI를 Query (활성 주문만 읽음).
+        // 이 경우 segments는 무시되고 status별로 하나씩 병렬 Query한다.
+        std::string status_index;
+        // 스캔 스레드와 복원(sink) 사이 대기열 상한
+        size_t handoff_capacity = 4096;
+    };
+
+    /**
+     * 활성 주문을 스트리밍으로 전달 (loadActiveOrders와 같은 필터/파싱)
+     *
+     * 세그먼트/GSI 워커 스레드가 페이지 단위로 파싱해 넘기고, sink는 호출 스레드에서
+     * 순서대로 호출된다 — 스캔이 끝나기 전에 복원이 시작되고, sink는 락이 필요 없다.
+     * 종목 간/종목 내 전달 순서는 보장하지 않는다 (기존 Scan과 동일).
+     *
+     * @return sink에 전달한 주문 수
+     */
+    size_t streamActiveOrders(const std::string& table_name,
+                              const ActiveOrderLoadOptions& options,
+                              const std::function<void(const OrderPtr&)>& sink);
+
     /**
      * 특정 심볼의 활성 주문 로드 (ACCEPTED + PARTIAL_FILL)
      *
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace aws_wrapper {
+
+/**
+ * EngineClock: 엔진이 읽는 "현재 시각"의 단일 출처
+ *
+ * 매칭 경로(dedup TTL, VI halt, 체결/호가 타임스탬프, 거래일 경계)는
+ * system_clock/steady_clock을 직접 부르지 않고 이 인터페이스를 통한다.
+ *   - RealClock      : 운영 기본값 (벽시계/단조시계 그대로)
+ *   - SimulatedClock : 테스트용. set/advance로만 움직인다 (120초 halt를 즉시 검증)
+ *   - InputClock     : 입력(aggressor 주문) 타임스탬프로만 움직인다 → 저널 재생이 비트 단위로 재현
+ *
+ * 스레드 안전: 구현은 모두 원자 변수만 사용. 주입된 시계는 엔진보다 오래 살아야 한다.
+ */
+class EngineClock {
+public:
+    virtual ~EngineClock() = default;
+
+    // 벽시계 (epoch 기준 타임스탬프, 거래일 계산)
+    virtual std::chrono::system_clock::time_point wallNow() const = 0;
+    // 단조시계 (TTL/halt 구간 측정)
+    virtual std::chrono::steady_clock::time_point monotonicNow() const = 0;
+
+    // 입력 주문의 타임스탬프(ms) 관찰. 입력 기반 시계만 반응한다.
+    virtual void observeInput(int64_t timestamp_ms) { (void)timestamp_ms; }
+
+    int64_t nowMs() const {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(
+            wallNow().time_since_epoch()).count();
+    }
+
+    // 프로세스 공용 RealClock (주입하지 않은 구성요소의 기본값)
+    static EngineClock& real();
+};
+
+class RealClock : public EngineClock {
+public:
+    std::chrono::system_clock::time_point wallNow() const override {
+        return std::chrono::system_clock::now();
+    }
+    std::chrono::steady_clock::time_point monotonicNow() const override {
+        return std::chrono::steady_clock::now();
+    }
+};
+
+inline EngineClock& EngineClock::real() {
+    static RealClock clock;
+    return clock;
+}
+
+// 테스트용 수동 시계: 벽시계와 단조시계가 같은 값(epoch ms)에서 함께 움직인다.
+class SimulatedClock : public EngineClock {
+public:
+    explicit SimulatedClock(int64_t start_ms = 0) : now_ms_(start_ms) {}
+
+    std::chrono::system_clock::time_point wallNow() const override {
+        return std::chrono::system_clock::time_point(std::chrono::milliseconds(now_ms_.load()));
+    }
+    std::chrono::steady_clock::time_point monotonicNow() const override {
+        return std::chrono::steady_clock::time_point(std::chrono::milliseconds(now_ms_.load()));
+    }
+
+    void set(int64_t now_ms) { now_ms_.store(now_ms); }
+    void advance(std::chrono::milliseconds delta) { now_ms_.fetch_add(delta.count()); }
+
+private:
+    std::atomic<int64_t> now_ms_;
+};
+
+// 입력 기반 시계: 지금까지 본 주문 타임스탬프의 최댓값이 현재 시각.
+// 같은 입력 저널을 재생하면 모든 시각 의존 판정·출력이 동일하다.
+// 역행하는 타임스탬프는 무시(단조 유지). ms로 볼 수 없는 값(음수, 9999년 이후 —
+// µs/ns 단위가 섞여 들어온 경우)도 무시한다: 한 번 받으면 시계가 되돌아오지 못한다.
+class InputClock : public EngineClock {
+public:
+    // 9999-12-31T23:59:59.999Z (epoch ms). 현재 시각의 µs/ns 값은 모두 이보다 크다.
+    static constexpr int64_t MAX_PLAUSIBLE_MS = 253402300799999LL;
+
+    explicit InputClock(int64_t start_ms = 0) : now_ms_(start_ms) {}
+
+    std::chrono::system_clock::time_point wallNow() const override {
+        return std::chrono::system_clock::time_point(std::chrono::milliseconds(now_ms_.load()));
+    }
+    std::chrono::steady_clock::time_point monotonicNow() const override {
+        return std::chrono::steady_clock::time_point(std::chrono::milliseconds(now_ms_.load()));
+    }
+
+    void observeInput(int64_t timestamp_ms) override {
+        if (timestamp_ms < 0 || timestamp_ms > MAX_PLAUSIBLE_MS) {
+            return;
+        }
+        int64_t cur = now_ms_.load();
+        while (timestamp_ms > cur && !now_ms_.compare_exchange_weak(cur, timestamp_ms)) {
+        }
+    }
+
+private:
+    std::atomic<int64_t> now_ms_;
+};
+
+} // namespace aws_wrapper
@@ -3,12 +3,15 @@
 #include <book/depth_order_book.h>
 #include "order.h"
 #include "market_data_handler.h"
+#include "pre_trade_risk.h"
+#include "engine_clock.h"
 #include <chrono>
 #include <map>
 #include <mutex>
 #include <shared_mutex>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 namespace aws_wrapper {
@@ -20,13 +23,41 @@ struct CancelAllResult {
     std::vector<std::string> failed_order_ids;
 };
 
+// 집계 호가 조회 결과. 각 단계는 가격/잔량/주문수/누적잔량(최우선부터)을 담는다.
+struct DepthView {
+    std::vector<liquibook::book::LadderStep> bids;
+    std::vector<liquibook::book::LadderStep> asks;
+};
+
+// 엔진 내부 카운터 스냅샷 (메트릭 노출용). 값은 한 시점에 일관되게 읽힌다.
+struct EngineCounters {
+    uint64_t orders_processed = 0;
+    uint64_t trades_executed = 0;
+    uint64_t duplicates_rejected = 0;
+    uint64_t self_trades_prevented = 0;
+    uint64_t price_band_rejects = 0;
+    uint64_t vi_halt_rejects = 0;
+    uint64_t silent_restore_matches = 0;
+    uint64_t stops_triggered = 0;
+    uint64_t stop_cascades_capped = 0;
+    uint64_t auctions_uncrossed = 0;
+    uint64_t auction_volume = 0;
+    uint64_t batch_auctions = 0;
+    uint64_t market_orders_collared = 0;
+    uint64_t risk_rejects = 0;
+    size_t symbols = 0;
+    size_t resting_orders = 0;
+};
+
 class EngineCore {
 public:
-    // Depth levels: 10 bid + 10 ask
-    using OrderBook = liquibook::book::DepthOrderBook<OrderPtr, 10>;
+    // Depth levels: 10 bid + 10 ask (리스너는 MarketDataHandler로 정적 바인딩)
+    using OrderBook = aws_wrapper::OrderBook;
     using OrderBookPtr = std::shared_ptr<OrderBook>;
 
-    explicit EngineCore(MarketDataHandler* handler, RedisClient* redis = nullptr);
+    // clock: 시각 출처(nullptr이면 RealClock). handler와 그 RankingManager에도 전파된다.
+    explicit EngineCore(MarketDataHandler* handler, RedisClient* redis = nullptr,
+                        EngineClock* clock = nullptr);
 
     // === 주문 API ===
     bool addOrder(OrderPtr order);
@@ -37,15 +68,34 @@ public:
 
     // 콜백 내에서 호출용 (락 이미 보유된 상태)
     void removeFilledOrderUnsafe(const std::string& symbol, const std::string& order_id);
+    // 주문 전 리스크 노출 — 리스너 콜백(락 보유)이 접수·체결·취소·정정을 반영한다
+    PreTradeRisk& risk() { return risk_; }
     
     // === 스냅샷 API (gRPC용) ===
     std::string snapshotOrderBook(const std::string& symbol);
     bool restoreOrderBook(const std::string& symbol, const std::string& data);
     bool removeOrderBook(const std::string& symbol);
+
+    // === 복원용 일괄 등재 ===
+    // 교차하지 않는 resting LIMIT 주문 묶음을 매칭 없이 한 번에 북에 올린다.
+    // 정렬은 내부에서 한다(측면별 가격 우선, 같은 가격은 입력 순서 유지).
+    // 배치가 자기 자신 또는 기존 북과 교차하면 아무것도 등재하지 않고 false —
+    // 호출자는 addOrder로 개별 재시도한다. 주문별 ACCEPTED 이벤트는 내지 않는다.
+    bool bulkLoadOrders(const std::string& symbol, std::vector<OrderPtr> orders);
+    // 일괄 등재 가능 여부: 가격 있는 LIMIT, 스톱 아님, IOC 아님, 잔량 > 0
+    static bool isBulkLoadable(const Order& order);
+    // DB 복원 묶음을 접수 시각(timestamp, ms) 순으로 안정 정렬 — 스캔 순서는 임의이므로
+    // bulkLoadOrders/addOrder 전에 불러 같은 가격 대기열을 접수 순서대로 세운다.
+    static void sortByArrival(std::vector<OrderPtr>& orders);
     
     // === 주문 조회 API ===
     bool hasOrder(const std::string& symbol, const std::string& order_id) const;
 
+    // === 호가 조회 API ===
+    // 상위 levels단계(0이면 전체) 집계 호가. 북에 증분 유지되는 FullDepth를 읽으므로
+    // 주문 단위 순회 없이 O(levels). 종목이 없으면 false.
+    bool getDepth(const std::string& symbol, size_t levels, DepthView& out) const;
+
     // VI 기준가 조회(진단·테스트용). 미설정이면 0.
     uint64_t viReferencePrice(const std::string& symbol) const;
 
@@ -57,16 +107,34 @@ public:
     // 변동률이 VI 임계를 초과하는지(순수 판정). |cur-ref|/ref >= pct.
     static bool exceedsViThreshold(uint64_t ref_price, uint64_t cur_price, double pct);
 
+    // === 단일가 경매 (VI halt 재개 / 신규 상장 개시) ===
+    // 경매 중인 종목은 주문을 매칭 없이 모았다가, 경매가 끝난 뒤 첫 명령 앞에서 한 번의
+    // 단일가(체결량 최대 → 불균형 최소 → 기준가 근접)로 일괄 체결한다.
+    // 주문이 끊긴 종목도 제때 끝나도록 메인 루프가 주기적으로 호출한다.
+    void runDueAuctions();
+    bool inAuction(const std::string& symbol) const;
+    // 배치 경매 종목: 연속 매매 대신 주문을 batchAuctionInterval()마다 모아 단일가로 체결하고,
+    // 그 구간의 체결·depth를 한 번에 낸다. runDueAuctions를 이 주기로 불러야 한다.
+    // 배치 경매 종목이 없으면 0.
+    std::chrono::milliseconds batchAuctionInterval() const;
+
     // === 메트릭 API ===
     size_t getSymbolCount() const;
     std::vector<std::string> getAllSymbols() const;
     uint64_t getTotalOrdersProcessed() const { return total_orders_processed_; }
     uint64_t getTotalTradesExecuted() const { return total_trades_executed_; }
+    // 락(shared) 아래에서 전 카운터를 한 번에 복사 — 스크레이프 스레드에서 호출
+    EngineCounters getCounters() const;
+
+    EngineClock& clock() const { return *clock_; }
 
 private:
     OrderBookPtr getOrCreateBook(const std::string& symbol);
     OrderPtr findOrder(const std::string& symbol, const std::string& order_id);
     void cleanupProcessedOrders();
+    // 락 보유 상태에서 호출. orders를 정렬해 book에 bulk_load하고 맵/dedup/MBO에 반영.
+    bool bulkLoadUnsafe(const std::string& symbol, OrderBook& book,
+                        std::vector<OrderPtr>& orders);
 
     // Self-Trade Prevention (STP): cancel-oldest 정책.
     // aggressor의 limit price까지 반대편 북에서 동일 user_id의 resting 주문을 취소.
@@ -80,11 +148,33 @@ private:
     // 직전 체결가가 없거나(첫 거래 전) 밴드 비활성(pct<=0)이면 위반 아님.
     bool violatesPriceBand(const OrderPtr& order) const;
 
+    // 시장가 collar: MARKET 주문을 반대편 최우선호가 ±market_collar_pct_의 지정가로 바꾼다.
+    // 최우선호가는 북이 유지하는 Depth 최상위 레벨에서 O(1)로 읽는다. 범위 안에서만 체결되고
+    // 잔량은 IOC 취소 대신 그 가격에 지정가로 남는다. 지불 상한(max_price)이 최우선 매도보다
+    // 낮은 매수는 교차하지 않으므로 그대로 IOC 취소된다. 락 보유 상태에서 호출. 바꿨으면 true.
+    bool applyMarketCollarUnsafe(OrderBook& book, const OrderPtr& order);
+
+    // 락 보유 상태에서 호출. 개시 경매 시간이 남아 있으면 true(지났으면 정리).
+    bool openingAuctionOpenUnsafe(const std::string& symbol);
+    // 락 보유 상태에서 호출. 모인 주문을 단일가로 체결한다. reopen이면(halt·개시 경매 종료)
+    // VI 기준가를 그 가격으로 갱신하고, 아니면(배치 경매) 그 가격을 VI로 판정한다.
+    liquibook::book::AuctionResult uncrossAuctionUnsafe(const std::string& symbol,
+                                                       OrderBook& book, bool reopen = true);
+    // 락 보유 상태에서 호출. 배치 경매 구간 시작: 경매 상태 + 구간 끝까지 depth 발행 보류.
+    void startBatchUnsafe(const std::string& symbol, OrderBook& book);
+    // 락 보유 상태에서 호출. 구간이 끝났으면 체결하고 보류한 depth를 발행, 다음 구간 시작.
+    void clearBatchUnsafe(const std::string& symbol, OrderBook& book);
+    // 경매 tiebreak 기준가: VI 동결 기준가(충격 이전 가격), 없으면 직전 체결가
+    uint64_t auctionReference(const std::string& symbol) const;
+    // 체결가를 VI 기준가와 비교해 임계 초과면 halt, 아니면 기준가 갱신
+    void checkVolatility(const std::string& symbol, uint64_t price);
+
     std::map<std::string, OrderBookPtr> books_;
     std::map<std::string, std::map<std::string, OrderPtr>> order_maps_;
     mutable std::shared_mutex rw_mutex_;  // shared_mutex for read-write locking
     MarketDataHandler* handler_;
     RedisClient* operating_redis_ = nullptr;
+    EngineClock* clock_;
 
     // Dedup Layer 1: recently processed order IDs (TTL-based eviction)
     std::unordered_map<std::string, std::chrono::steady_clock::time_point> processed_orders_;
@@ -97,17 +187,48 @@ private:
     uint64_t price_band_rejects_ = 0;
     uint64_t vi_halt_rejects_ = 0;
     // 복원 중 교차(무음 체결 위험) 발생 횟수 — 정상 스냅샷이면 항상 0이어야 한다.
+    // 일괄 등재 배치가 교차로 거부된 경우와, 개별 add로 복원한 주문이 체결된 경우를 센다.
     uint64_t silent_restore_matches_ = 0;
+    // 발동되어 북에 제출된 스톱 수와, 명령당 한도에 걸려 다음 명령으로 넘어간 연쇄 횟수
+    uint64_t stops_triggered_ = 0;
+    uint64_t stop_cascades_capped_ = 0;
+    // 끝난 단일가 경매 수와 그 체결 수량 합
+    uint64_t auctions_uncrossed_ = 0;
+    uint64_t auction_volume_ = 0;
+    uint64_t batch_auctions_ = 0;
 
     // 가격 밴드 폭(직전 체결가 대비 ±비율). 0이면 비활성. PRICE_BAND_PCT env로 설정.
     double price_band_pct_ = 0.0;
 
+    // 시장가 collar 폭(반대편 최우선호가 대비 ±비율). 0이면 비활성. MARKET_COLLAR_PCT env로 설정.
+    double market_collar_pct_ = 0.0;
+    uint64_t market_orders_collared_ = 0;
+
+    // 주문 전 리스크 단계 (RISK_* env). 한도 초과로 거부한 주문·정정 수.
+    PreTradeRisk risk_;
+    uint64_t risk_rejects_ = 0;
+
+    // 명령 하나가 연쇄로 제출하는 스톱 수 상한. 0이면 무제한. STOP_CASCADE_LIMIT env로 설정.
+    size_t stop_cascade_limit_ = 0;
+
     // VI 서킷브레이커 설정/상태
     double vi_dynamic_pct_ = 0.0;      // 동적 VI 임계(직전 체결가 대비). 0이면 비활성.
     int vi_halt_seconds_ = 120;        // halt 지속(초)
     std::unordered_map<std::string, uint64_t> vi_last_price_;   // 심볼별 직전 체결가(VI 기준)
     std::unordered_map<std::string, std::chrono::steady_clock::time_point> halt_until_;
     mutable std::mutex vi_mutex_;      // vi_last_price_/halt_until_ 보호(콜백 스레드/주문 스레드)
+
+    // 단일가 경매 설정/상태 (rw_mutex_ 보호)
+    bool vi_auction_ = false;          // halt 중 주문을 거부 대신 경매로 모음. VI_AUCTION env.
+    int opening_auction_seconds_ = 0;  // 신규 종목 개시 경매 길이(초). 0이면 없음.
+    std::unordered_map<std::string, std::chrono::steady_clock::time_point> opening_until_;
+    bool uncrossing_ = false;          // 경매 체결 중에는 VI 판정을 건너뛴다
+    // 배치 경매 종목과 구간 길이 (BATCH_AUCTION_SYMBOLS / BATCH_AUCTION_INTERVAL_MS env)
+    std::unordered_set<std::string> batch_symbols_;
+    std::chrono::milliseconds batch_interval_{100};
+    std::unordered_map<std::string, std::chrono::steady_clock::time_point> batch_due_;
+    // halt를 거친 배치 경매 종목 — 다음 체결은 재개 단일가로 취급
+    std::unordered_set<std::string> halted_batches_;
 };
 
 } // namespace aws_wrapper
@@ -4,6 +4,7 @@
 #include "snapshot.grpc.pb.h"
 #include "engine_core.h"
 #include "redis_client.h"
+#include "mbo_feed.h"
 #include <thread>
 #include <atomic>
 #include <memory>
@@ -12,7 +13,7 @@ namespace aws_wrapper {
 
 class GrpcServiceImpl final : public SnapshotService::Service {
 public:
-    GrpcServiceImpl(EngineCore* engine, RedisClient* redis);
+    GrpcServiceImpl(EngineCore* engine, RedisClient* redis, MboFeed* mbo_feed = nullptr);
     
     grpc::Status CreateSnapshot(grpc::ServerContext* context,
                                  const SnapshotRequest* request,
@@ -38,6 +39,18 @@ public:
                               const CancelOrderRequest* request,
                               CancelOrderResponse* response) override;
 
+    grpc::Status GetDepth(grpc::ServerContext* context,
+                           const DepthRequest* request,
+                           DepthResponse* response) override;
+
+    grpc::Status RecoverMbo(grpc::ServerContext* context,
+                             const MboRecoverRequest* request,
+                             MboRecoverResponse* response) override;
+
+    grpc::Status DumpTraces(grpc::ServerContext* context,
+                             const TraceDumpRequest* request,
+                             TraceDumpResponse* response) override;
+
 private:
     // 관리 채널 인증: 메타데이터 x-engine-token이 공유 시크릿과 일치하는지 확인.
     // ENGINE_GRPC_TOKEN 미설정 시 경고 후 허용(하위호환), 설정 시 강제.
@@ -46,13 +59,14 @@ private:
 
     EngineCore* engine_;
     RedisClient* redis_;
+    MboFeed* mbo_feed_;
     std::string auth_token_;
     std::chrono::steady_clock::time_point start_time_;
 };
 
 class GrpcService {
 public:
-    GrpcService(EngineCore* engine, RedisClient* redis);
+    GrpcService(EngineCore* engine, RedisClient* redis, MboFeed* mbo_feed = nullptr);
     ~GrpcService();
     
     void start(int port);
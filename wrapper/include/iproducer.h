@@ -42,6 +42,14 @@ public:
                                     bool is_buy = true,
                                     const std::string& order_type = "") = 0;
     
+    // 주문 단위(MBO) 바이너리 배치 발행 (MboFeed 배치 스레드에서 호출).
+    // 기본은 무시 — MBO 스트림을 지원하는 producer만 재정의한다.
+    virtual void publishMbo(const std::string& symbol,
+                            const std::string& payload) {
+        (void)symbol;
+        (void)payload;
+    }
+    
     virtual void flush(int timeout_ms = 1000) = 0;
 };
 
@@ -0,0 +1,146 @@
+#pragma once
+
+#include <charconv>
+#include <cstdint>
+#include <ctime>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <book/depth_level.h>
+
+namespace aws_wrapper {
+
+/**
+ * JsonWriter: 재사용 버퍼에 직접 쓰는 스트리밍 JSON 작성기
+ *
+ * nlohmann::json 트리를 만들고 dump()하면 이벤트당 수십 번 할당이 일어난다.
+ * 핫패스(체결/주문상태/호가/티커)는 이 작성기로 스레드별 버퍼에 바로 쓴다.
+ *
+ * 출력은 nlohmann::json::dump()와 바이트 단위로 같아야 한다:
+ *   - 공백 없음, 객체 키는 호출자가 사전순으로 써야 한다 (nlohmann은 std::map 정렬)
+ *   - 문자열 이스케이프: \" \\ \b \f \n \r \t, 그 외 0x20 미만은 \u00xx (소문자 hex)
+ *   - UTF-8은 그대로 통과 (잘못된 UTF-8도 검증하지 않고 통과 — dump()는 예외)
+ * test/json_writer_test.cpp가 nlohmann 출력과 골든 비교한다.
+ */
+class JsonWriter {
+public:
+    // out을 비우고 이어 쓴다 (capacity는 유지되므로 재사용 시 할당 없음)
+    explicit JsonWriter(std::string& out) : out_(out) { out_.clear(); }
+
+    void beginObject() { separate(); out_.push_back('{'); open(); }
+    void endObject() { out_.push_back('}'); close(); }
+    void beginArray() { separate(); out_.push_back('['); open(); }
+    void endArray() { out_.push_back(']'); close(); }
+
+    // 키는 이스케이프가 필요 없는 리터럴만 받는다: "k": 조각을 통째로 복사
+    template <size_t N>
+    void key(const char (&k)[N]) {
+        separate();
+        out_.push_back('"');
+        out_.append(k, N - 1);
+        out_.append("\":", 2);
+        after_key_ = true;
+    }
+
+    void value(std::string_view s) {
+        separate();
+        out_.push_back('"');
+        appendEscaped(s);
+        out_.push_back('"');
+    }
+    // a + sep + b 를 하나의 문자열 값으로 (임시 std::string 없이)
+    void valueJoined(std::string_view a, std::string_view sep, std::string_view b) {
+        separate();
+        out_.push_back('"');
+        appendEscaped(a);
+        appendEscaped(sep);
+        appendEscaped(b);
+        out_.push_back('"');
+    }
+    void value(const char* s) { value(std::string_view(s)); }
+    void value(bool b) {
+        separate();
+        if (b) out_.append("true", 4); else out_.append("false", 5);
+    }
+    void value(uint64_t v) { separate(); appendInt(v); }
+    void value(int64_t v) { separate(); appendInt(v); }
+
+    // UTC 초 단위 ISO 8601 ("2024-01-02T03:04:05Z").
+    // 같은 초 안의 호출은 스레드별 캐시를 재사용한다 (gmtime/strftime 생략).
+    static std::string_view isoSecondUtc(std::time_t t);
+
+private:
+    template <typename Int>
+    void appendInt(Int v) {
+        char buf[24];
+        auto res = std::to_chars(buf, buf + sizeof(buf), v);
+        out_.append(buf, static_cast<size_t>(res.ptr - buf));
+    }
+
+    void appendEscaped(std::string_view s);
+
+    // 같은 컨테이너 안 두 번째 원소부터 ',' (키 바로 뒤 값은 제외)
+    void separate() {
+        if (after_key_) {
+            after_key_ = false;
+        } else if (depth_ > 0 && (has_item_ & bit())) {
+            out_.push_back(',');
+        }
+        if (depth_ > 0) has_item_ |= bit();
+    }
+    void open() { ++depth_; has_item_ &= ~bit(); }
+    void close() { --depth_; }
+    uint64_t bit() const { return uint64_t(1) << (depth_ - 1); }
+
+    std::string& out_;
+    uint64_t has_item_ = 0;   // 중첩 단계별 "원소 있음" 비트 (최대 64단계)
+    int depth_ = 0;
+    bool after_key_ = false;
+};
+
+// === 이벤트 페이로드 (기존 nlohmann 포맷과 동일한 바이트) ===
+
+// Kinesis fills 스트림 FILL 이벤트
+void writeFillJson(std::string& out,
+                   const std::string& symbol,
+                   const std::string& order_id,
+                   const std::string& matched_order_id,
+                   const std::string& buyer_id,
+                   const std::string& seller_id,
+                   uint64_t qty,
+                   uint64_t price,
+                   bool buyer_fully_filled,
+                   bool seller_fully_filled,
+                   bool buyer_is_maker,
+                   int64_t timestamp_ms);
+
+// Kinesis order-status 스트림 ORDER_STATUS 이벤트
+void writeOrderStatusJson(std::string& out,
+                          const std::string& symbol,
+                          const std::string& order_id,
+                          const std::string& user_id,
+                          const std::string& status,
+                          const std::string& reason,
+                          uint64_t price,
+                          uint64_t quantity,
+                          bool is_buy,
+                          const std::string& order_type,
+                          int64_t timestamp_ms);
+
+// Valkey depth:{symbol} 캐시 {"a":[[p,q],...],"b":[...],"e":"d","p":..,"s":..,"t":..}
+void writeDepthJson(std::string& out,
+                    const std::string& symbol,
+                    const std::vector<liquibook::book::DepthLevel>& bids,
+                    const std::vector<liquibook::book::DepthLevel>& asks,
+                    uint64_t last_price,
+                    int64_t timestamp_ms);
+
+// Valkey ticker:{symbol} 캐시
+void writeTickerJson(std::string& out, const std::string& symbol,
+                     uint64_t price, int64_t timestamp_ms);
+
+// Valkey ohlc:{symbol} 캐시
+void writeOhlcJson(std::string& out, uint64_t open, uint64_t high, uint64_t low,
+                   uint64_t close, uint64_t volume, int64_t epoch_sec);
+
+} // namespace aws_wrapper
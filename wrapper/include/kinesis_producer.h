@@ -5,6 +5,7 @@
 #include <memory>
 #include <nlohmann/json.hpp>
 #include "iproducer.h"
+#include "engine_clock.h"
 
 namespace aws_wrapper {
 
@@ -45,6 +46,10 @@ public:
                             bool is_buy = true,
                             const std::string& order_type = "") override;
     
+    // MBO 바이너리 배치 발행 (partition key = 종목 → 종목 내 순서 보장)
+    void publishMbo(const std::string& symbol,
+                    const std::string& payload) override;
+    
     void flush(int timeout_ms = 1000) override;
 
     // WAL 재생: 발행 실패로 로컬 WAL에 남은 이벤트를 재발행한다.
@@ -53,10 +58,16 @@ public:
     // 반환: 재발행 시도한 레코드 수.
     int replayWAL();
 
+    // 이벤트 timestamp 출처 (기본 RealClock). WAL 기록 시각은 항상 실제 시간.
+    void setClock(EngineClock* clock) { clock_ = clock ? clock : &EngineClock::real(); }
+
 private:
+    // use_wal=false: 실패 시 WAL에 남기지 않는다 (바이너리 페이로드는 줄 단위 WAL에
+    // 담을 수 없고, MBO는 소비자가 seq 공백을 보고 recover로 복구한다).
     void produce(const std::string& stream_name,
                  const std::string& partition_key,
-                 const std::string& data);
+                 const std::string& data,
+                 bool use_wal = true);
 
     void saveToWAL(const std::string& stream_name,
                    const std::string& partition_key,
@@ -67,6 +78,8 @@ private:
     std::string trades_stream_;
     std::string depth_stream_;
     std::string status_stream_;
+    std::string mbo_stream_;
+    EngineClock* clock_ = &EngineClock::real();
 };
 
 } // namespace aws_wrapper
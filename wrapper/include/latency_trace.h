@@ -0,0 +1,213 @@
+#pragma once
+
+#include "metrics.h"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+namespace aws_wrapper {
+
+/**
+ * TraceClock: 주문 단위 타임스탬프용 저비용 시계
+ *
+ * x86에서는 rdtsc(약 20 사이클, 시스템 콜·vDSO 없음)를 쓰고, 틱→ns 환산 계수는
+ * 시작 시 steady_clock과 한 번 대조해 정한다. constant/invariant TSC(최근 x86, EC2 Nitro)
+ * 를 전제로 하며 구간 차이만 쓰므로 코어 간 미세 오프셋은 무시할 수준이다.
+ * 그 외 아키텍처는 steady_clock ns를 그대로 틱으로 쓴다.
+ */
+class TraceClock {
+public:
+    static uint64_t now() {
+#if defined(__x86_64__) || defined(__i386__)
+        return __rdtsc();
+#else
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+    }
+
+    // 틱 → ns (첫 호출 시 보정, 이후 곱셈 하나)
+    static uint64_t toNanos(uint64_t ticks) {
+        return static_cast<uint64_t>(static_cast<double>(ticks) * nanosPerTick());
+    }
+
+    // 약 10ms 보정. 핫패스에서 첫 호출이 멈추지 않도록 시작 시 명시적으로 부른다.
+    static double nanosPerTick();
+};
+
+// 주문 한 건이 지나는 단계 (순서대로)
+enum class TraceStage : uint8_t {
+    FETCHED = 0,      // GetRecords 응답 수신 (배치 단위)
+    DECODED,          // JSON 파싱 + Order 생성 완료
+    LOCKED,           // EngineCore 배타 락 획득
+    MATCHED,          // 매칭 종료 = 첫 콜백 진입 (liquibook은 매칭을 끝낸 뒤 콜백을 몰아 호출)
+    CALLBACKS_DONE,   // 주문 API의 book 호출 반환 (콜백 전부 완료)
+    PUBLISHED,        // 마지막 Kinesis PutRecord 성공 응답
+    DEPTH_WRITTEN,    // 마지막 Redis depth 캐시 기록
+    COUNT
+};
+
+const char* traceStageName(TraceStage stage);
+
+// 콜백 안에서 일어나는 동기 I/O (단계 사이 시간을 원인별로 쪼개는 데 쓴다)
+enum class TraceIo : uint8_t { KINESIS = 0, REDIS, COUNT };
+
+// 샘플링된 전체 트레이스. 각 단계는 FETCHED 기준 ns 오프셋, 기록되지 않은 단계는 -1.
+struct OrderTrace {
+    static constexpr size_t STAGES = static_cast<size_t>(TraceStage::COUNT);
+    static constexpr size_t IO_KINDS = static_cast<size_t>(TraceIo::COUNT);
+
+    std::string symbol;
+    std::string order_id;
+    int64_t wall_time_ms = 0;                 // 트레이스 종료 시각 (epoch ms)
+    std::array<int64_t, STAGES> stage_ns{};
+    std::array<uint64_t, IO_KINDS> io_ns{};   // 주문 처리 중 누적 I/O 시간
+    std::array<uint32_t, IO_KINDS> io_calls{};
+    uint64_t total_ns = 0;                    // FETCHED → 마지막 단계
+};
+
+/**
+ * LatencyTracer: Kinesis 레코드 수신부터 체결 발행까지 단계별 지연 추적
+ *
+ * 컨슈머 스레드의 thread_local 트레이스에 단계 도착 시각(TSC 틱)을 찍고, 주문 처리가
+ * 끝나면 구간별 히스토그램(모든 주문)에 누적한다. 전체 트레이스는 N건마다 하나,
+ * 그리고 임계 지연을 넘은 주문은 항상 고정 크기 링에 남긴다(gRPC DumpTraces로 조회).
+ *
+ * 구간:
+ *   fetch_to_decode  FETCHED→DECODED (같은 배치 앞 레코드 처리 대기 포함)
+ *   lock_wait        DECODED→LOCKED
+ *   match            LOCKED→MATCHED
+ *   callbacks        MATCHED→CALLBACKS_DONE (Kinesis/Redis 동기 I/O 포함)
+ *   kinesis, redis   콜백 중 해당 I/O 누적 시간
+ *   callbacks_cpu    callbacks − kinesis − redis
+ *   end_to_end       FETCHED→마지막 단계
+ * 주문마다 lock_wait/match/kinesis/redis/callbacks_cpu 중 가장 큰 구간을 dominant
+ * 카운터에 올려, p99를 무엇이 지배하는지 바로 읽을 수 있게 한다.
+ *
+ * 트레이스가 활성화되지 않은 스레드(gRPC, 스냅샷 등)에서 stamp/IO 기록은 no-op이다.
+ */
+class LatencyTracer {
+public:
+    enum Span : uint8_t {
+        SPAN_FETCH_TO_DECODE = 0,
+        SPAN_LOCK_WAIT,
+        SPAN_MATCH,
+        SPAN_CALLBACKS,
+        SPAN_KINESIS,
+        SPAN_REDIS,
+        SPAN_CALLBACKS_CPU,
+        SPAN_END_TO_END,
+        SPAN_COUNT
+    };
+
+    // dominant 후보
+    enum Component : uint8_t {
+        COMP_LOCK_WAIT = 0,
+        COMP_MATCH,
+        COMP_KINESIS,
+        COMP_REDIS,
+        COMP_CALLBACKS_CPU,
+        COMP_COUNT
+    };
+
+    static LatencyTracer& instance() {
+        static LatencyTracer inst;
+        return inst;
+    }
+
+    // sample_every=0이면 주기 샘플링 끔, slow_threshold_ns=0이면 지연 기준 샘플링 끔.
+    // ring_capacity 변경 시 기존 샘플은 버린다.
+    void configure(uint32_t sample_every, uint64_t slow_threshold_ns, size_t ring_capacity);
+
+    // GetRecords 응답 직후 (컨슈머 스레드). 다음 begin()들의 FETCHED 시각이 된다.
+    static void markFetched();
+
+    // 레코드 처리 시작/종료 (컨슈머 콜백). finish 없이 다음 begin이 오면 이전 것은 버린다.
+    void begin();
+    void finish(const std::string& symbol, const std::string& order_id);
+    static void abandon();
+
+    // 단계 도착. MATCHED는 첫 기록만, 나머지는 마지막 기록이 남는다.
+    static void stamp(TraceStage stage);
+
+    // 활성 트레이스가 있으면 I/O 구간 시간을 누적
+    static bool active();
+    static void addIo(TraceIo kind, uint64_t ticks);
+
+    // 최신 순 최대 max건
+    std::vector<OrderTrace> recent(size_t max) const;
+
+    const LatencyHistogram& span(Span s) const { return spans_[s]; }
+    uint64_t dominantCount(Component c) const {
+        return dominant_[c].load(std::memory_order_relaxed);
+    }
+    uint64_t tracedCount() const { return traced_.load(std::memory_order_relaxed); }
+    uint64_t sampledCount() const { return sampled_.load(std::memory_order_relaxed); }
+
+    static const char* spanName(Span s);
+    static const char* componentName(Component c);
+
+    // Metrics 컬렉터용 Prometheus 출력
+    void writePrometheus(std::string& out) const;
+
+private:
+    LatencyTracer();
+
+    std::atomic<uint32_t> sample_every_{100};
+    std::atomic<uint64_t> slow_threshold_ns_{0};
+
+    std::array<LatencyHistogram, SPAN_COUNT> spans_;
+    std::array<std::atomic<uint64_t>, COMP_COUNT> dominant_{};
+    std::atomic<uint64_t> traced_{0};
+    std::atomic<uint64_t> sampled_{0};
+
+    mutable std::mutex ring_mutex_;
+    std::vector<OrderTrace> ring_;
+    size_t ring_next_ = 0;
+    size_t ring_size_ = 0;
+};
+
+// 컨슈머 콜백용 RAII: 생성 시 begin, finish 없이 스코프를 벗어나면(예외 등) 폐기
+class ScopedTrace {
+public:
+    ScopedTrace() { LatencyTracer::instance().begin(); }
+    ~ScopedTrace() {
+        if (!finished_) LatencyTracer::abandon();
+    }
+    void finish(const std::string& symbol, const std::string& order_id) {
+        LatencyTracer::instance().finish(symbol, order_id);
+        finished_ = true;
+    }
+    ScopedTrace(const ScopedTrace&) = delete;
+    ScopedTrace& operator=(const ScopedTrace&) = delete;
+
+private:
+    bool finished_ = false;
+};
+
+// I/O 호출 구간을 활성 트레이스에 누적 (트레이스 밖이면 시계도 읽지 않는다)
+class TraceIoScope {
+public:
+    explicit TraceIoScope(TraceIo kind)
+        : kind_(kind), start_(LatencyTracer::active() ? TraceClock::now() : 0) {}
+    ~TraceIoScope() {
+        if (start_ != 0) LatencyTracer::addIo(kind_, TraceClock::now() - start_);
+    }
+    TraceIoScope(const TraceIoScope&) = delete;
+    TraceIoScope& operator=(const TraceIoScope&) = delete;
+
+private:
+    TraceIo kind_;
+    uint64_t start_;
+};
+
+} // namespace aws_wrapper
@@ -1,13 +1,34 @@
 #pragma once
 
-#include <iostream>
-#include <string>
+#include "spsc_ring.h"
+#include <atomic>
 #include <chrono>
-#include <iomanip>
+#include <cstdint>
+#include <cstring>
+#include <memory>
 #include <sstream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+// 빌드 시 최소 로그 레벨 (0=DEBUG, 1=INFO, 2=WARN, 3=ERROR).
+// 이보다 낮은 레벨 호출은 if constexpr로 본문이 통째로 사라진다. 예: -DLOGGER_MIN_LEVEL=1
+#ifndef LOGGER_MIN_LEVEL
+#define LOGGER_MIN_LEVEL 0
+#endif
 
 namespace aws_wrapper {
 
+// std::string(할당자 무관)·string_view처럼 연속 문자 버퍼를 가진 타입.
+// 암시적 변환 연산자만 있는 타입(예: nlohmann::json)은 operator<< 경로로 보낸다.
+template<typename T, typename = void>
+struct IsStringLike : std::false_type {};
+template<typename T>
+struct IsStringLike<T, std::void_t<decltype(std::declval<const T&>().data()),
+                                   decltype(std::declval<const T&>().size())>>
+    : std::is_convertible<const T&, std::string_view> {};
+
 enum class LogLevel {
     DEBUG = 0,
     INFO = 1,
@@ -15,64 +36,217 @@ enum class LogLevel {
     ERROR = 3
 };
 
+/**
+ * LogRecord: 로그 한 줄의 바이너리 표현 (링 슬롯 하나)
+ *
+ * msg는 문자열 리터럴이면 주소만 싣는다(포맷 id). 인자는 [태그 1B][값]으로 inline_args에
+ * 직렬화하고, 문자열은 길이(2B) + 바이트로 복사한다. inline_args를 넘치면 생산자 쪽에서
+ * 인자 전체를 텍스트로 만들어 overflow에 싣는다(드문 느린 경로).
+ */
+struct LogRecord {
+    static constexpr size_t INLINE_BYTES = 192;
+
+    enum Tag : uint8_t { TAG_I64 = 1, TAG_U64, TAG_F64, TAG_CHAR, TAG_STR };
+
+    int64_t time_ns = 0;               // system_clock epoch ns
+    const char* msg_literal = nullptr; // 리터럴이면 주소, 아니면 nullptr (msg_text 사용)
+    LogLevel level = LogLevel::INFO;
+    bool preformatted = false;         // true면 인자가 overflow 텍스트
+    uint16_t used = 0;
+    char inline_args[INLINE_BYTES];
+    std::string msg_text;
+    std::string overflow;
+};
+
+/**
+ * Logger: 비동기 로거
+ *
+ * 호출 스레드는 자기 전용 SPSC 링(첫 로그 시 생성·등록)에 LogRecord를 넣고 곧바로
+ * 돌아간다. 포맷팅(타임스탬프 포함)과 stdout 쓰기는 백그라운드 스레드가 모아서 하고,
+ * 배치마다 한 번 flush한다. 핫패스 비용은 시계 읽기 + 인자 memcpy 수준이다.
+ *
+ * - 링이 가득 차면 드롭하지 않고 빈 칸이 날 때까지 양보하며 기다린다 (getRingFullWaits).
+ * - 스레드 간 줄 순서는 보장하지 않는다 (스레드 안에서는 보장).
+ * - 프로세스 종료(atexit) 시 남은 레코드를 비운 뒤 동기 모드로 전환한다.
+ *   비정상 종료(abort/SIGSEGV) 시 마지막 수 ms 로그는 유실될 수 있다.
+ * - setAsync(false)면 호출 스레드에서 즉시 쓴다 (테스트·디버깅용).
+ */
 class Logger {
 public:
-    static void setLevel(LogLevel level) { level_ = level; }
-    static LogLevel getLevel() { return level_; }
+    static void setLevel(LogLevel level) { level_.store(level, std::memory_order_relaxed); }
+    static LogLevel getLevel() { return level_.load(std::memory_order_relaxed); }
 
+    // 런타임 레벨 + 빌드 시 최소 레벨 검사
+    template<LogLevel L>
+    static bool enabled() {
+        if constexpr (static_cast<int>(L) < LOGGER_MIN_LEVEL) {
+            return false;
+        } else {
+            return L >= getLevel();
+        }
+    }
+
+    static void setAsync(bool async);
+    // 지금까지 들어온 레코드를 모두 쓰고 돌아온다
+    static void flush();
+    static uint64_t getRingFullWaits();
+
+    template<size_t N, typename... Args>
+    static void debug(const char (&msg)[N], Args&&... args) {
+        log<LogLevel::DEBUG>(msg, nullptr, std::forward<Args>(args)...);
+    }
     template<typename... Args>
     static void debug(const std::string& msg, Args&&... args) {
-        log(LogLevel::DEBUG, "DEBUG", msg, std::forward<Args>(args)...);
+        log<LogLevel::DEBUG>(nullptr, &msg, std::forward<Args>(args)...);
     }
 
+    template<size_t N, typename... Args>
+    static void info(const char (&msg)[N], Args&&... args) {
+        log<LogLevel::INFO>(msg, nullptr, std::forward<Args>(args)...);
+    }
     template<typename... Args>
     static void info(const std::string& msg, Args&&... args) {
-        log(LogLevel::INFO, "INFO", msg, std::forward<Args>(args)...);
+        log<LogLevel::INFO>(nullptr, &msg, std::forward<Args>(args)...);
     }
 
+    template<size_t N, typename... Args>
+    static void warn(const char (&msg)[N], Args&&... args) {
+        log<LogLevel::WARN>(msg, nullptr, std::forward<Args>(args)...);
+    }
     template<typename... Args>
     static void warn(const std::string& msg, Args&&... args) {
-        log(LogLevel::WARN, "WARN", msg, std::forward<Args>(args)...);
+        log<LogLevel::WARN>(nullptr, &msg, std::forward<Args>(args)...);
     }
 
+    template<size_t N, typename... Args>
+    static void error(const char (&msg)[N], Args&&... args) {
+        log<LogLevel::ERROR>(msg, nullptr, std::forward<Args>(args)...);
+    }
     template<typename... Args>
     static void error(const std::string& msg, Args&&... args) {
-        log(LogLevel::ERROR, "ERROR", msg, std::forward<Args>(args)...);
+        log<LogLevel::ERROR>(nullptr, &msg, std::forward<Args>(args)...);
     }
 
+    // 백그라운드 스레드 포맷터 (테스트에서 출력 형식 검증용으로도 쓴다)
+    static void format(const LogRecord& record, std::string& out);
+
 private:
-    static inline LogLevel level_ = LogLevel::INFO;
-
-    static std::string timestamp() {
-        auto now = std::chrono::system_clock::now();
-        auto time = std::chrono::system_clock::to_time_t(now);
-        auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
-            now.time_since_epoch()) % 1000;
-
-        // Fixed: Thread-safe localtime (localtime_r for Linux, localtime_s for Windows)
-        std::tm tm_buf;
-#if defined(_WIN32) || defined(_WIN64)
-        localtime_s(&tm_buf, &time);
-#else
-        localtime_r(&time, &tm_buf);
-#endif
+    static inline std::atomic<LogLevel> level_{LogLevel::INFO};
 
-        std::stringstream ss;
-        ss << std::put_time(&tm_buf, "%Y-%m-%d %H:%M:%S");
-        ss << '.' << std::setfill('0') << std::setw(3) << ms.count();
-        return ss.str();
+    template<LogLevel L, typename... Args>
+    static void log(const char* literal, const std::string* text, Args&&... args) {
+        if constexpr (static_cast<int>(L) < LOGGER_MIN_LEVEL) {
+            return;
+        } else {
+            if (L < getLevel()) return;
+            LogRecord& record = acquire();
+            record.time_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::system_clock::now().time_since_epoch()).count();
+            record.level = L;
+            record.msg_literal = literal;
+            if (text) record.msg_text = *text;
+            bool fits = (encode(record, args) && ...);
+            if (!fits) {
+                record.preformatted = true;
+                std::ostringstream oss;
+                ((oss << " " << args), ...);
+                record.overflow = oss.str();
+            }
+            commit();
+        }
     }
 
-    template<typename... Args>
-    static void log(LogLevel level, const char* levelStr, 
-                    const std::string& msg, Args&&... args) {
-        if (level < level_) return;
-        
-        std::cout << "[" << timestamp() << "] [" << levelStr << "] " 
-                  << msg;
-        ((std::cout << " " << args), ...);
-        std::cout << std::endl;
+    // 호출 스레드 링의 스크래치 레코드를 비워서 돌려준다 / 링에 넣는다
+    static LogRecord& acquire();
+    static void commit();
+
+    static bool put(LogRecord& r, LogRecord::Tag tag, const void* data, size_t len) {
+        if (r.used + 1 + len > LogRecord::INLINE_BYTES) return false;
+        r.inline_args[r.used++] = static_cast<char>(tag);
+        std::memcpy(r.inline_args + r.used, data, len);
+        r.used = static_cast<uint16_t>(r.used + len);
+        return true;
+    }
+
+    static bool putStr(LogRecord& r, const char* s, size_t len) {
+        if (len > 0xFFFF || r.used + 3 + len > LogRecord::INLINE_BYTES) return false;
+        uint16_t n = static_cast<uint16_t>(len);
+        r.inline_args[r.used++] = static_cast<char>(LogRecord::TAG_STR);
+        std::memcpy(r.inline_args + r.used, &n, 2);
+        std::memcpy(r.inline_args + r.used + 2, s, len);
+        r.used = static_cast<uint16_t>(r.used + 2 + len);
+        return true;
+    }
+
+    template<typename T>
+    static bool encode(LogRecord& r, const T& v) {
+        using D = std::decay_t<T>;
+        if constexpr (std::is_same_v<D, bool>) {
+            int64_t x = v ? 1 : 0;  // ostream 기본 출력과 같게 1/0
+            return put(r, LogRecord::TAG_I64, &x, sizeof(x));
+        } else if constexpr (std::is_same_v<D, char> || std::is_same_v<D, signed char> ||
+                             std::is_same_v<D, unsigned char>) {
+            return put(r, LogRecord::TAG_CHAR, &v, 1);
+        } else if constexpr (std::is_integral_v<D> && std::is_signed_v<D>) {
+            int64_t x = v;
+            return put(r, LogRecord::TAG_I64, &x, sizeof(x));
+        } else if constexpr (std::is_integral_v<D>) {
+            uint64_t x = v;
+            return put(r, LogRecord::TAG_U64, &x, sizeof(x));
+        } else if constexpr (std::is_floating_point_v<D>) {
+            double x = static_cast<double>(v);
+            return put(r, LogRecord::TAG_F64, &x, sizeof(x));
+        } else if constexpr (std::is_enum_v<D>) {
+            int64_t x = static_cast<int64_t>(v);
+            return put(r, LogRecord::TAG_I64, &x, sizeof(x));
+        } else if constexpr (std::is_array_v<T>) {
+            // 문자 배열(주로 리터럴): 종단 NUL 전까지
+            return putStr(r, v, std::char_traits<char>::length(v));
+        } else if constexpr (std::is_same_v<D, const char*> || std::is_same_v<D, char*>) {
+            if (!v) return putStr(r, "(null)", 6);
+            return putStr(r, v, std::strlen(v));
+        } else if constexpr (IsStringLike<D>::value) {
+            std::string_view sv = v;
+            return putStr(r, sv.data(), sv.size());
+        } else {
+            // 그 밖의 타입은 operator<<로 문자열화 (느린 경로)
+            std::ostringstream oss;
+            oss << v;
+            const std::string s = oss.str();
+            return putStr(r, s.data(), s.size());
+        }
     }
 };
 
 } // namespace aws_wrapper
+
+// === 로그 매크로 ===
+// 레벨이 꺼져 있으면 인자를 평가하지 않는다 (substr·to_string·dump 등의 할당이 생기지 않음).
+// LOGGER_MIN_LEVEL 미만 레벨은 if (false)로 남겨 타입 검사만 받고 코드는 생성되지 않는다.
+// 이름이 LOG_*가 아닌 것은 <syslog.h>의 LOG_INFO/LOG_DEBUG와의 충돌을 피하기 위함.
+#define LOGGER_LOG_AT_(LEVEL, FN, ...)                                                  \
+    do {                                                                                \
+        if (::aws_wrapper::Logger::enabled<::aws_wrapper::LogLevel::LEVEL>())           \
+            ::aws_wrapper::Logger::FN(__VA_ARGS__);                                     \
+    } while (0)
+#define LOGGER_ELIDED_(FN, ...)                                                         \
+    do {                                                                                \
+        if (false) ::aws_wrapper::Logger::FN(__VA_ARGS__);                              \
+    } while (0)
+
+#if LOGGER_MIN_LEVEL > 0
+#define LOGGER_DEBUG(...) LOGGER_ELIDED_(debug, __VA_ARGS__)
+#else
+#define LOGGER_DEBUG(...) LOGGER_LOG_AT_(DEBUG, debug, __VA_ARGS__)
+#endif
+#if LOGGER_MIN_LEVEL > 1
+#define LOGGER_INFO(...) LOGGER_ELIDED_(info, __VA_ARGS__)
+#else
+#define LOGGER_INFO(...) LOGGER_LOG_AT_(INFO, info, __VA_ARGS__)
+#endif
+#if LOGGER_MIN_LEVEL > 2
+#define LOGGER_WARN(...) LOGGER_ELIDED_(warn, __VA_ARGS__)
+#else
+#define LOGGER_WARN(...) LOGGER_LOG_AT_(WARN, warn, __VA_ARGS__)
+#endif
+#define LOGGER_ERROR(...) LOGGER_LOG_AT_(ERROR, error, __VA_ARGS__)
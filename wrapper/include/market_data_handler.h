@@ -3,23 +3,26 @@
 #include <cstdint>
 #include <string>
 #include <unordered_map>
+#include <vector>
 #include <ctime>
 #include <book/order_listener.h>
-#include <book/trade_listener.h>
 #include <book/depth_listener.h>
-#include <book/bbo_listener.h>
 #include <book/depth_order_book.h>
 #include "order.h"
 #include "iproducer.h"
+#include "engine_clock.h"
 
 namespace aws_wrapper {
 
 class RedisClient;          // forward declaration
 class EngineCore;           // forward declaration
 class RankingManager;       // forward declaration
+class MboFeed;              // forward declaration
+class MarketDataHandler;
 
 // Depth levels: 10 bid + 10 ask
-using OrderBook = liquibook::book::DepthOrderBook<OrderPtr, 10>;
+// 리스너 타입을 템플릿 인자로 고정해 콜백이 가상 호출 없이 매칭 루프에서 직접 불린다.
+using OrderBook = liquibook::book::DepthOrderBook<OrderPtr, 10, MarketDataHandler>;
 using BookDepth = liquibook::book::Depth<10>;
 
 // 일일 시장 데이터 (OHLC)
@@ -34,14 +37,15 @@ struct DayData {
 
 class MarketDataHandler
     : public liquibook::book::OrderListener<OrderPtr>
-    , public liquibook::book::TradeListener<OrderBook>
     , public liquibook::book::DepthListener<OrderBook>
-    , public liquibook::book::BboListener<OrderBook>
 {
 public:
     // depth/ticker 캐시 TTL(초). 엔진이 죽으면 만료되어 스트리머가 스테일 시장데이터를
     // 계속 브로드캐스트하지 못하게 한다. 정상 운영 중에는 갱신 주기가 훨씬 짧아 무해.
     static constexpr int MARKET_DATA_TTL_SECONDS = 60;
+    // depth 이벤트에 싣는 호가 단계 수(기본). DEPTH_PUBLISH_LEVELS env로 조정.
+    // 고정 Depth<10>이 아니라 FullDepth에서 읽으므로 10단계를 넘어서도 유효하다.
+    static constexpr int DEFAULT_DEPTH_PUBLISH_LEVELS = 20;
 
     explicit MarketDataHandler(IProducer* producer,
                                RedisClient* depth_redis = nullptr,
@@ -50,31 +54,29 @@ public:
     
     // === OrderListener ===
     void on_accept(const OrderPtr& order) override;
+    void on_accept_stop(const OrderPtr& order) override;
+    void on_trigger_stop(const OrderPtr& order) override;
     void on_reject(const OrderPtr& order, const char* reason) override;
     void on_fill(const OrderPtr& order,
                  const OrderPtr& matched_order,
                  liquibook::book::Quantity fill_qty,
                  liquibook::book::Price fill_price) override;
     void on_cancel(const OrderPtr& order) override;
+    void on_cancel_stop(const OrderPtr& order) override;
     void on_cancel_reject(const OrderPtr& order, const char* reason) override;
     void on_replace(const OrderPtr& order,
                     const int64_t& size_delta,
                     liquibook::book::Price new_price) override;
     void on_replace_reject(const OrderPtr& order, const char* reason) override;
     
-    // === TradeListener ===
-    void on_trade(const OrderBook* book,
-                  liquibook::book::Quantity qty,
-                  liquibook::book::Price price) override;
+    // TradeListener는 구현하지 않는다. 체결 처리(DayData·캔들·랭킹·fills 발행)는 모두 on_fill에서.
     
     // === DepthListener ===
+    // BboListener는 구현하지 않는다. BBO 변화는 depth 변화의 부분집합이라 같은 book update에서
+    // on_depth_change가 이미 발행한다(둘 다 받으면 depth가 두 번 발행된다).
     void on_depth_change(const OrderBook* book,
                          const BookDepth* depth) override;
     
-    // === BboListener ===
-    void on_bbo_change(const OrderBook* book,
-                       const BookDepth* depth) override;
-    
     // === Day Data ===
     DayData& getDayData(const std::string& symbol);
     void checkDayReset(const std::string& symbol);
@@ -86,13 +88,32 @@ public:
     // EngineCore 설정 (완전 체결된 주문 제거용)
     void setEngineCore(EngineCore* engine) { engine_ = engine; }
 
+    // 시각 출처 설정 (EngineCore가 생성 시 전파). RankingManager에도 전달한다.
+    void setClock(EngineClock* clock);
+    EngineClock& clock() const { return *clock_; }
+
+    // 주문 단위(MBO) 피드 설정 (nullptr이면 비활성)
+    void setMboFeed(MboFeed* feed) { mbo_feed_ = feed; }
+    MboFeed* mboFeed() const { return mbo_feed_; }
+
 private:
+    // 접수·취소 공통 처리. on_book=false면 호가창에 오른 적 없는 스톱(MBO 이벤트 없음).
+    void handleAccept(const OrderPtr& order, bool on_book);
+    void handleCancel(const OrderPtr& order, bool on_book);
+
     IProducer* producer_;
     RedisClient* depth_redis_;
     RedisClient* candle_redis_;
     RankingManager* ranking_manager_;
     EngineCore* engine_ = nullptr;
+    MboFeed* mbo_feed_ = nullptr;
+    EngineClock* clock_ = &EngineClock::real();
     std::unordered_map<std::string, DayData> symbol_day_data_;
+    size_t depth_publish_levels_ = DEFAULT_DEPTH_PUBLISH_LEVELS;
+    // on_depth_change/on_fill에서 재사용하는 버퍼(이벤트마다 할당하지 않도록)
+    std::vector<liquibook::book::DepthLevel> depth_bid_scratch_;
+    std::vector<liquibook::book::DepthLevel> depth_ask_scratch_;
+    std::string json_buf_;
     
     void updateTickerCache(const std::string& symbol, uint64_t price);
 };
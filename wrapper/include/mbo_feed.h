@@ -0,0 +1,186 @@
+#pragma once
+
+#include "spsc_ring.h"
+#include "engine_clock.h"
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace aws_wrapper {
+
+class IProducer;
+class Order;
+
+// 종목별 생산자 상태. MboFeed가 소유하고 주소는 고정이며, 주문이 첫 이벤트 때 포인터를
+// 붙여 두므로(Order::mboStream) 이후 이벤트는 종목 문자열로 찾지 않는다.
+struct MboStream {
+    std::string symbol;
+    uint64_t next_seq = 0;   // 매칭 스레드 전용
+};
+
+/**
+ * MboFeed: 주문 단위(L3, market-by-order) 이벤트 스트림
+ *
+ * 매칭 스레드(OrderListener 콜백)는 고정 크기 슬롯을 SPSC 링에 쓰기만 한다.
+ * 인코딩·배치·발행·재생 이력 관리는 전부 백그라운드 스레드에서 수행.
+ *
+ * 바이너리 포맷 (리틀엔디언, 종목 단위 배치):
+ *   header : u8 'M' | u8 version(1) | u8 kind('L' 실시간, 'S' 스냅샷)
+ *            | u8 sym_len | symbol | u64 last_seq | u32 count
+ *   record : u8 type('A','X','R','E') | u8 side(1=BUY,0=SELL)
+ *            | u64 seq | u64 ts_ns | u64 price | u64 qty | u8 id_len | order_id
+ *   - A(add): qty=주문수량, X(cancel): qty=취소 시점 잔량,
+ *     R(replace): price/qty=변경 후 가격·잔량, E(execute): price/qty=체결가·체결량
+ *   - seq는 종목별 1부터 연속. 수신자는 공백을 보면 recover()로 재생/스냅샷을 받는다.
+ *
+ * 매칭 스레드는 링 쓰기 외에 아무것도 하지 않는다: 링이 가득 차면 기다리지 않고 그 이벤트를
+ * 버린다(getDroppedEvents). seq는 그대로 소비되므로 수신자에게는 공백으로 보이고, 버려진
+ * 이벤트는 재생도 스냅샷도 할 수 없어 공백 이전으로의 recover()는 실패한다 — 그때는 엔진
+ * 스냅샷(CreateSnapshot)으로 다시 맞춘다. 슬롯에 들어가지 않는 긴 주문 ID의 이벤트는 잘라
+ * 싣지 않고 seq 없이 버린다(getOversizeDrops).
+ *
+ * 스레드 모델: on*()는 엔진 락(EngineCore rw_mutex_) 보유 상태의 콜백에서만 호출되므로
+ * 생산자는 항상 하나다. recover()는 아무 스레드에서나 호출 가능.
+ */
+class MboFeed {
+public:
+    enum EventType : uint8_t {
+        ADD = 'A',
+        CANCEL = 'X',
+        REPLACE = 'R',
+        EXECUTE = 'E'
+    };
+
+    struct Config {
+        size_t ring_capacity = 65536;        // 링 슬롯 수 (2의 거듭제곱으로 올림)
+        int flush_interval_ms = 5;           // 배치 발행 주기
+        size_t history_per_symbol = 100000;  // 재생용으로 보관하는 최근 이벤트 수
+    };
+
+    // 디코딩된 레코드 (소비자·테스트용)
+    struct Record {
+        EventType type;
+        bool is_buy;
+        uint64_t seq;
+        uint64_t ts_ns;
+        uint64_t price;
+        uint64_t qty;
+        std::string order_id;
+    };
+
+    // 디코딩된 배치
+    struct Batch {
+        bool is_snapshot = false;
+        std::string symbol;
+        uint64_t last_seq = 0;
+        std::vector<Record> records;
+    };
+
+    // clock: 이벤트 ts_ns 출처 (nullptr이면 RealClock)
+    MboFeed(IProducer* sink, const Config& config, EngineClock* clock = nullptr);
+    ~MboFeed();
+
+    // 백그라운드 배치 스레드
+    void start();
+    void stop();
+
+    // === 매칭 스레드 전용 (링 쓰기만) ===
+    // 주문에 종목 스트림이 아직 없으면 한 번 찾아 붙인다 (주문당 1회)
+    void onAdd(Order& order);
+    void onCancel(Order& order);
+    void onReplace(Order& order, uint64_t new_qty, uint64_t new_price);
+    void onExecute(Order& order, uint64_t fill_qty, uint64_t fill_price);
+
+    // 늦게 붙은 소비자 복구: from_seq 이후 이벤트를 재생 배치로 돌려주고,
+    // 이력이 이미 밀려났으면 현재 주문 상태 스냅샷(kind='S')을 돌려준다.
+    // 종목을 모르거나 from_seq 이후에 버려진 이벤트가 있으면(공백) false.
+    bool recover(const std::string& symbol, uint64_t from_seq, std::string& out);
+
+    // 링에 쌓인 이벤트를 즉시 처리·발행 (종료 시/스레드 미사용 테스트용)
+    void drain();
+
+    static bool decode(const std::string& data, Batch& out);
+
+    // 메트릭
+    uint64_t getEventCount() const { return event_count_.load(); }
+    uint64_t getBatchCount() const { return batch_count_.load(); }
+    uint64_t getDroppedEvents() const { return dropped_events_.load(); }
+    uint64_t getOversizeDrops() const { return oversize_drops_.load(); }
+
+    static constexpr size_t MAX_SYMBOL_LEN = 255;   // 헤더 sym_len(u8)
+    static constexpr size_t MAX_ORDER_ID_LEN = 63;  // 링 슬롯 폭
+
+private:
+    // 링 슬롯: 할당 없이 복사되는 고정 크기 POD
+    struct Slot {
+        const MboStream* stream;
+        uint64_t seq;
+        uint64_t ts_ns;
+        uint64_t price;
+        uint64_t qty;
+        uint8_t type;
+        uint8_t is_buy;
+        uint8_t order_id_len;
+        char order_id[MAX_ORDER_ID_LEN + 1];
+    };
+
+    // 스냅샷 재구성용 주문 상태
+    struct LiveOrder {
+        uint64_t price;
+        uint64_t qty;
+        uint64_t seq;   // 시간 우선순위(가격 변경 시 갱신)
+        bool is_buy;
+    };
+
+    struct SymbolState {
+        std::deque<std::string> history;  // 인코딩된 레코드
+        uint64_t first_seq = 0;           // history.front()의 seq
+        uint64_t last_seq = 0;
+        uint64_t gap_seq = 0;             // 버려진 것으로 확인된 마지막 seq (0이면 공백 없음)
+        std::unordered_map<std::string, LiveOrder> live;
+        std::string pending;              // 이번 배치에 실을 레코드
+        uint32_t pending_count = 0;
+    };
+
+    MboStream* stream(Order& order);
+    void push(EventType type, Order& order, uint64_t price, uint64_t qty);
+    void run();
+    size_t consume();   // 링 → 상태/배치, 처리한 이벤트 수
+    void publishPending();
+    void apply(SymbolState& state, const Slot& slot, const std::string& order_id);
+
+    static void appendHeader(std::string& out, char kind, const std::string& symbol,
+                             uint64_t last_seq, uint32_t count);
+    static void appendRecord(std::string& out, uint8_t type, bool is_buy, uint64_t seq,
+                             uint64_t ts_ns, uint64_t price, uint64_t qty,
+                             const char* order_id, size_t order_id_len);
+
+    IProducer* sink_;
+    Config config_;
+    EngineClock* clock_;
+    SpscRing<Slot> ring_;
+
+    // 생산자 측 상태 (매칭 스레드 전용). deque라 스트림 주소가 바뀌지 않는다.
+    std::deque<MboStream> streams_;
+    std::unordered_map<std::string, MboStream*> stream_index_;
+
+    // 소비자 측 상태
+    std::mutex state_mutex_;   // states_ 보호 (recover()와 배치 스레드)
+    std::unordered_map<std::string, SymbolState> states_;
+    std::mutex consume_mutex_; // drain()/배치 스레드가 동시에 소비하지 않도록
+
+    std::thread thread_;
+    std::atomic<bool> running_{false};
+
+    std::atomic<uint64_t> event_count_{0};
+    std::atomic<uint64_t> batch_count_{0};
+    std::atomic<uint64_t> dropped_events_{0};
+    std::atomic<uint64_t> oversize_drops_{0};
+};
+
+} // namespace aws_wrapper
@@ -1,11 +1,118 @@
 #pragma once
 
-#include <string>
+#include <array>
 #include <atomic>
+#include <chrono>
+#include <cstddef>
 #include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
 
 namespace aws_wrapper {
 
+/**
+ * StripedCounter: 스레드별 스트라이프 카운터
+ *
+ * 각 스레드는 처음 증가할 때 스트라이프 하나를 배정받아 거기에만 relaxed add 한다.
+ * 스트라이프는 캐시 라인 단위로 떨어져 있어 매칭·컨슈머·gRPC 스레드가 같은 카운터를
+ * 올려도 라인 핑퐁이 없다. 읽기(스크레이프)는 전 스트라이프 합산 — 드물게 일어나므로 싸다.
+ */
+class StripedCounter {
+public:
+    void add(uint64_t n = 1) {
+        cells_[slot()].value.fetch_add(n, std::memory_order_relaxed);
+    }
+
+    uint64_t load() const {
+        uint64_t sum = 0;
+        for (const auto& c : cells_) sum += c.value.load(std::memory_order_relaxed);
+        return sum;
+    }
+
+private:
+    static constexpr size_t STRIPES = 16;
+
+    struct alignas(64) Cell {
+        std::atomic<uint64_t> value{0};
+    };
+
+    static size_t slot() {
+        static std::atomic<size_t> next{0};
+        thread_local size_t idx = next.fetch_add(1, std::memory_order_relaxed) % STRIPES;
+        return idx;
+    }
+
+    std::array<Cell, STRIPES> cells_{};
+};
+
+/**
+ * LatencyHistogram: HDR 방식 로그-선형 지연 히스토그램 (나노초)
+ *
+ * 2의 거듭제곱 구간(옥타브)마다 2^SUB_BITS개의 균등 칸 → 상대 오차 ≤ 1/2^SUB_BITS(12.5%).
+ * 0ns ~ 2^64ns 전 범위를 496칸 고정 배열로 덮으므로 할당·락이 없고,
+ * record()는 relaxed fetch_add 두세 번이다. 분위수는 칸 상한으로 보고한다(보수적).
+ */
+class LatencyHistogram {
+public:
+    static constexpr int SUB_BITS = 3;
+    static constexpr size_t SUB_COUNT = size_t(1) << SUB_BITS;
+    static constexpr size_t BUCKETS = (64 - SUB_BITS + 1) * SUB_COUNT;
+
+    void record(uint64_t ns) {
+        buckets_[bucketOf(ns)].fetch_add(1, std::memory_order_relaxed);
+        count_.fetch_add(1, std::memory_order_relaxed);
+        sum_ns_.fetch_add(ns, std::memory_order_relaxed);
+        uint64_t prev = max_ns_.load(std::memory_order_relaxed);
+        while (ns > prev &&
+               !max_ns_.compare_exchange_weak(prev, ns, std::memory_order_relaxed)) {
+        }
+    }
+
+    uint64_t count() const { return count_.load(std::memory_order_relaxed); }
+    uint64_t sumNs() const { return sum_ns_.load(std::memory_order_relaxed); }
+    uint64_t maxNs() const { return max_ns_.load(std::memory_order_relaxed); }
+
+    // q(0~1) 분위수의 상한(ns). 기록이 없으면 0.
+    uint64_t percentile(double q) const;
+    // limit_ns 이하 칸에 든 표본 수 (limit_ns가 칸 경계(2의 거듭제곱-1)면 정확)
+    uint64_t countAtOrBelow(uint64_t limit_ns) const;
+
+    static size_t bucketOf(uint64_t ns) {
+        if (ns < SUB_COUNT) return static_cast<size_t>(ns);
+        int e = 63 - __builtin_clzll(ns);
+        return (static_cast<size_t>(e - SUB_BITS + 1) << SUB_BITS) +
+               static_cast<size_t>((ns >> (e - SUB_BITS)) & (SUB_COUNT - 1));
+    }
+    static uint64_t bucketLower(size_t idx);
+    static uint64_t bucketUpper(size_t idx);  // 포함 상한
+
+private:
+    std::array<std::atomic<uint64_t>, BUCKETS> buckets_{};
+    std::atomic<uint64_t> count_{0};
+    std::atomic<uint64_t> sum_ns_{0};
+    std::atomic<uint64_t> max_ns_{0};
+};
+
+// 스코프 구간을 히스토그램에 기록 (steady_clock)
+class ScopedLatency {
+public:
+    explicit ScopedLatency(LatencyHistogram& hist)
+        : hist_(hist), start_(std::chrono::steady_clock::now()) {}
+    ~ScopedLatency() {
+        hist_.record(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start_).count()));
+    }
+    ScopedLatency(const ScopedLatency&) = delete;
+    ScopedLatency& operator=(const ScopedLatency&) = delete;
+
+private:
+    LatencyHistogram& hist_;
+    std::chrono::steady_clock::time_point start_;
+};
+
 class Metrics {
 public:
     static Metrics& instance() {
@@ -14,24 +121,63 @@ public:
     }
 
     // 카운터
-    void incrementOrdersReceived() { ++orders_received_; }
-    void incrementOrdersAccepted() { ++orders_accepted_; }
-    void incrementOrdersRejected() { ++orders_rejected_; }
-    void incrementFillsPublished() { ++fills_published_; }
+    void incrementOrdersReceived() { orders_received_.add(); }
+    void incrementOrdersAccepted() { orders_accepted_.add(); }
+    void incrementOrdersRejected() { orders_rejected_.add(); }
+    void incrementTradesExecuted() { trades_executed_.add(); }
+    void incrementFillsPublished() { fills_published_.add(); }
+    void incrementDepthPublished() { depth_published_.add(); }
 
     // Getters
-    uint64_t getOrdersReceived() const { return orders_received_; }
-    uint64_t getOrdersAccepted() const { return orders_accepted_; }
-    uint64_t getTradesExecuted() const { return trades_executed_; }
+    uint64_t getOrdersReceived() const { return orders_received_.load(); }
+    uint64_t getOrdersAccepted() const { return orders_accepted_.load(); }
+    uint64_t getOrdersRejected() const { return orders_rejected_.load(); }
+    uint64_t getTradesExecuted() const { return trades_executed_.load(); }
+    uint64_t getFillsPublished() const { return fills_published_.load(); }
+    uint64_t getDepthPublished() const { return depth_published_.load(); }
+
+    // 지연 히스토그램
+    LatencyHistogram& decodeLatency() { return decode_; }     // 주문 레코드 JSON 파싱 + Order 생성
+    LatencyHistogram& matchLatency() { return match_; }       // EngineCore 주문 API (락 대기 포함)
+    LatencyHistogram& publishLatency() { return publish_; }   // Kinesis PutRecord (재시도 포함)
+    LatencyHistogram& redisRtt() { return redis_rtt_; }       // hiredis 명령 왕복
+
+    // === Prometheus 텍스트 노출 (version 0.0.4) ===
+    // 컬렉터: 스크레이프 시점에 다른 컴포넌트(EngineCore 등)의 값을 덧붙인다.
+    using Collector = std::function<void(std::string& out)>;
+    void addCollector(Collector collector);
+    std::string renderPrometheus() const;
+
+    static void writeCounter(std::string& out, const std::string& name,
+                             const std::string& help, uint64_t value);
+    static void writeGauge(std::string& out, const std::string& name,
+                           const std::string& help, double value);
+    // histogram(_bucket/_sum/_count, 초 단위) + 분위수 gauge(name_quantile_seconds)
+    static void writeHistogram(std::string& out, const std::string& name,
+                               const std::string& help, const LatencyHistogram& hist);
+    // 라벨 하나로 구분되는 히스토그램 묶음 (예: stage="lock_wait"). label이 비면 writeHistogram과 같다.
+    static void writeHistogramFamily(
+        std::string& out, const std::string& name, const std::string& help,
+        const std::string& label,
+        const std::vector<std::pair<std::string, const LatencyHistogram*>>& series);
 
 private:
     Metrics() = default;
 
-    std::atomic<uint64_t> orders_received_{0};
-    std::atomic<uint64_t> orders_accepted_{0};
-    std::atomic<uint64_t> orders_rejected_{0};
-    std::atomic<uint64_t> trades_executed_{0};
-    std::atomic<uint64_t> fills_published_{0};
+    StripedCounter orders_received_;
+    StripedCounter orders_accepted_;
+    StripedCounter orders_rejected_;
+    StripedCounter trades_executed_;
+    StripedCounter fills_published_;
+    StripedCounter depth_published_;
+
+    LatencyHistogram decode_;
+    LatencyHistogram match_;
+    LatencyHistogram publish_;
+    LatencyHistogram redis_rtt_;
+
+    mutable std::mutex collectors_mutex_;
+    std::vector<Collector> collectors_;
 };
 
 } // namespace aws_wrapper
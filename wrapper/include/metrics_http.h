@@ -0,0 +1,47 @@
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <string>
+#include <thread>
+
+namespace aws_wrapper {
+
+/**
+ * MetricsHttpServer: Prometheus 스크레이프용 최소 HTTP/1.0 서버
+ *
+ * 스레드 하나가 POSIX 소켓으로 accept → 요청 한 줄 파싱 → 응답 → close 한다.
+ *   GET /metrics  → 200, text/plain; version=0.0.4 (renderer 결과)
+ *   GET /healthz  → 200 "ok"
+ *   그 외         → 404
+ * 스크레이프는 수 초 간격이므로 동시성·keep-alive는 필요 없다. 매칭 경로와는
+ * 렌더러가 읽는 원자 카운터/히스토그램 외에 공유하는 것이 없다.
+ */
+class MetricsHttpServer {
+public:
+    using Renderer = std::function<std::string()>;
+
+    // port 0이면 임의 포트에 바인드(테스트용, port()로 확인)
+    MetricsHttpServer(int port, Renderer renderer);
+    ~MetricsHttpServer();
+
+    // 바인드·리슨 실패 시 false (엔진은 메트릭 없이 계속 동작)
+    bool start();
+    void stop();
+
+    int port() const { return port_; }
+    uint64_t getRequestCount() const { return requests_.load(); }
+
+private:
+    void run();
+    void handle(int client_fd);
+
+    int port_;
+    Renderer renderer_;
+    int listen_fd_ = -1;
+    std::thread thread_;
+    std::atomic<bool> running_{false};
+    std::atomic<uint64_t> requests_{0};
+};
+
+} // namespace aws_wrapper
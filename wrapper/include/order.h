@@ -6,18 +6,38 @@
 #include <memory>
 #include <cstdint>
 #include <nlohmann/json.hpp>
+#include "engine_clock.h"
 
 namespace aws_wrapper {
 
+struct MboStream;
+
+// 주문 전 리스크 단계(PreTradeRisk)가 이 주문에 잡아 둔 노출 칸과 반영된 잔량
+struct RiskTag {
+    static constexpr uint32_t NONE = UINT32_MAX;
+    uint32_t table = NONE;               // 종목 번호
+    uint32_t user = 0;                   // 인터닝한 유저 번호
+    liquibook::book::Price price = 0;    // 명목가 (가격 없는 주문은 접수 시 기준가)
+    liquibook::book::Quantity open = 0;  // 노출에 반영된 잔량
+    bool counted = false;                // 접수되어 노출에 들어가 있음
+};
+
 class Order : public liquibook::book::Order {
 public:
     Order() = default;
     
     // Kafka JSON에서 파싱하여 생성
-    static std::shared_ptr<Order> fromJson(const nlohmann::json& j);
+    // timestamp가 없으면 clock(nullptr이면 RealClock)의 현재 시각으로 채운다
+    static std::shared_ptr<Order> fromJson(const nlohmann::json& j,
+                                           const EngineClock* clock = nullptr);
     
     // JSON으로 직렬화 (스냅샷용)
     nlohmann::json toJson() const;
+
+    // 주문 테이블의 created_at(ISO-8601 UTC, 예: "2026-10-19T03:04:05.678Z" 또는
+    // epoch ms 숫자 문자열)을 epoch ms로 변환. fromJson의 timestamp와 같은 단위.
+    // 해석할 수 없으면 -1.
+    static int64_t parseTimestampMs(const std::string& text);
     
     // === Liquibook Order 인터페이스 구현 ===
     bool is_buy() const override { return is_buy_; }
@@ -69,6 +89,14 @@ public:
     const std::string& order_type() const { return order_type_; }
     void setOrderType(const std::string& t) { order_type_ = t; }
 
+    // 리스크 노출 (스냅샷에는 싣지 않는다 — 복원 시 PreTradeRisk::track이 다시 잡는다)
+    RiskTag& riskTag() { return risk_tag_; }
+    const RiskTag& riskTag() const { return risk_tag_; }
+
+    // 이 주문의 종목 MBO 스트림 (MboFeed가 첫 이벤트 때 붙인다 — 이후 종목 조회 없음)
+    MboStream* mboStream() const { return mbo_stream_; }
+    void setMboStream(MboStream* stream) { mbo_stream_ = stream; }
+
 private:
     std::string order_id_;
     std::string user_id_;
@@ -82,6 +110,8 @@ private:
     liquibook::book::OrderConditions conditions_ = 0;
     int64_t timestamp_ = 0;
     std::string order_type_ = "LIMIT";
+    RiskTag risk_tag_;
+    MboStream* mbo_stream_ = nullptr;
 };
 
 using OrderPtr = std::shared_ptr<Order>;
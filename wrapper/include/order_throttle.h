@@ -0,0 +1,119 @@
+#pragma once
+
+#include "engine_clock.h"
+#include "order.h"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace aws_wrapper {
+
+class IProducer;
+
+/**
+ * TokenBucketTable: 키(문자열 해시)별 토큰 버킷을 담는 개방 주소법 해시 테이블
+ *
+ * 슬롯은 {해시, 토큰, 마지막 보충 시각} 24바이트뿐이고 선형 탐사로 찾는다. 키 문자열은
+ * 보관하지 않는다(64비트 해시 충돌은 두 키가 버킷을 나눠 쓰는 정도의 영향). 적재율이
+ * 절반을 넘으면 두 배로 늘린다. 토큰은 음수까지 빌릴 수 있어 "지연" 정책은 미래 토큰을
+ * 예약하고 그만큼 기다린다.
+ */
+class TokenBucketTable {
+public:
+    // rate: 초당 보충 토큰(0이면 무제한), burst: 버킷 크기
+    TokenBucketTable(double rate, double burst);
+
+    bool enabled() const { return rate_ > 0.0; }
+    // 보충 후 토큰 1개를 쓸 수 있을 때까지 남은 시간(ns). 0이면 지금 가능.
+    int64_t waitNs(uint64_t key, std::chrono::steady_clock::time_point now);
+    // 토큰 1개 사용 (waitNs 직후 호출 — 음수면 미래 토큰을 빌린다)
+    void take(uint64_t key);
+    size_t size() const { return used_; }
+
+private:
+    struct Slot {
+        uint64_t key = 0;        // 0 = 빈 슬롯 (해시 0은 1로 바꿔 저장)
+        double tokens = 0.0;
+        int64_t last_ns = 0;
+    };
+    Slot& slot(uint64_t key);
+    void grow();
+
+    double rate_;
+    double burst_;
+    std::vector<Slot> slots_;
+    size_t used_ = 0;
+    Slot* last_ = nullptr;       // 직전 waitNs의 슬롯 (take가 다시 찾지 않도록)
+};
+
+/**
+ * OrderThrottle: 컨슈머 콜백과 EngineCore 사이의 유입 제한 단계
+ *
+ * 클라이언트 하나(또는 MM 루프)가 supernoba-orders를 폭주시켜도 전역 락 아래의 매칭이
+ * 다른 유저를 위해 돌 수 있도록, 유저별·종목별 토큰 버킷을 모두 통과한 ADD/REPLACE만
+ * 엔진에 넘긴다. CANCEL은 노출을 줄이므로 제한하지 않는다.
+ *
+ * 정책 (THROTTLE_POLICY):
+ *   - reject : 토큰이 없으면 거부. REJECTED 상태 이벤트는 모았다가 일괄 발행한다.
+ *              REPLACE는 원 주문이 호가창에 살아 있으므로 REPLACE_REJECTED로 발행한다.
+ *   - delay  : THROTTLE_MAX_DELAY_MS 안에 토큰이 생기면 예약하고 그만큼 기다린다(컨슈머
+ *              스레드가 자므로 스트림 소비 자체가 늦춰진다). 더 기다려야 하면 거부.
+ *
+ * 설정: THROTTLE_USER_RATE / THROTTLE_USER_BURST, THROTTLE_SYMBOL_RATE /
+ * THROTTLE_SYMBOL_BURST (초당 주문 수, 0이면 그 축은 비활성), THROTTLE_REJECT_BATCH.
+ *
+ * 스레드 모델: admit()은 컨슈머 스레드에서만, flushRejected()와 카운터는 아무 스레드에서나.
+ */
+class OrderThrottle {
+public:
+    enum class Policy { REJECT, DELAY };
+
+    struct Verdict {
+        bool admitted = true;
+        std::chrono::nanoseconds delay{0};   // 지연 정책: 엔진에 넘기기 전 기다릴 시간
+    };
+
+    OrderThrottle(IProducer* producer, const EngineClock* clock = nullptr);
+
+    bool enabled() const { return users_.enabled() || symbols_.enabled(); }
+    Policy policy() const { return policy_; }
+
+    // 주문 하나를 들여보낼지 판정. 거부면 REJECTED(정정이면 REPLACE_REJECTED) 이벤트를
+    // 대기열에 넣는다(배치가 차면 발행).
+    Verdict admit(const OrderPtr& order, bool is_replace = false);
+    // 대기 중인 거부 이벤트를 발행. 발행한 건수 반환.
+    size_t flushRejected();
+
+    uint64_t throttledOrders() const { return throttled_orders_.load(std::memory_order_relaxed); }
+    uint64_t throttledQty() const { return throttled_qty_.load(std::memory_order_relaxed); }
+    uint64_t delayedOrders() const { return delayed_orders_.load(std::memory_order_relaxed); }
+    uint64_t delayNs() const { return delay_ns_.load(std::memory_order_relaxed); }
+
+private:
+    IProducer* producer_;
+    const EngineClock* clock_;
+    Policy policy_ = Policy::REJECT;
+    std::chrono::nanoseconds max_delay_{0};
+    size_t reject_batch_ = 64;
+
+    TokenBucketTable users_;
+    TokenBucketTable symbols_;
+
+    struct Pending {
+        OrderPtr order;
+        bool replace;                    // true면 REPLACE_REJECTED (원 주문은 그대로 유효)
+    };
+
+    std::mutex pending_mutex_;
+    std::vector<Pending> pending_;       // 발행 대기 거부 이벤트
+
+    std::atomic<uint64_t> throttled_orders_{0};
+    std::atomic<uint64_t> throttled_qty_{0};
+    std::atomic<uint64_t> delayed_orders_{0};
+    std::atomic<uint64_t> delay_ns_{0};
+};
+
+} // namespace aws_wrapper
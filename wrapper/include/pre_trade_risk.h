@@ -0,0 +1,93 @@
+#pragma once
+
+#include <book/types.h>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace aws_wrapper {
+
+class Order;
+
+// 유저별 주문 전 한도. 0이면 그 항목은 무제한.
+struct RiskLimits {
+    uint32_t max_open_orders = 0;     // 미체결 주문 수
+    uint64_t max_open_notional = 0;   // 미체결 명목금액 합 (가격 × 잔량)
+    uint64_t max_order_qty = 0;       // 주문 1건 수량
+    bool any() const { return max_open_orders || max_open_notional || max_order_qty; }
+};
+
+/**
+ * PreTradeRisk: 엔진 내부 주문 전 리스크 단계
+ *
+ * 잔고 잠금은 order-router Lambda가 하지만 MM·관리자 직접 경로는 게이트웨이를 거치지 않는다.
+ * book->add 직전에 유저별 미체결 주문 수·미체결 명목금액·주문 수량 한도를 검사한다.
+ *
+ * 상태는 종목별 평면 배열 하나(인덱스 = 인터닝한 유저 번호)이고, 접수·체결·취소·정정
+ * 콜백에서 증감만 한다. 주문이 잡아 둔 노출은 Order::riskTag()에 남아 있어 콜백은 문자열
+ * 조회 없이 배열 한 칸만 고친다. 검사 비용은 인터닝(해시 1회) + 비교 세 번.
+ *
+ * 한도: RISK_MAX_OPEN_ORDERS / RISK_MAX_OPEN_NOTIONAL / RISK_MAX_ORDER_QTY 가 기본,
+ * RISK_SYMBOL_LIMITS="SYM:주문수:명목금액:수량,..." 가 종목별로 덮어쓴다.
+ * 전부 0/미설정이면 비활성 — 검사도 집계도 하지 않는다.
+ *
+ * 스레드 모델: EngineCore rw_mutex_ 보유 상태(주문 경로와 리스너 콜백)에서만 호출.
+ */
+class PreTradeRisk {
+public:
+    PreTradeRisk();
+
+    bool enabled() const { return enabled_; }
+    const RiskLimits& limits(const std::string& symbol) const;
+
+    // 통과면 nullptr, 아니면 거부 사유. 통과한 주문에는 노출 칸과 명목가를 잡아 두고
+    // onAccept에서 반영한다. reference: 시장가·가격 없는 주문의 명목가(반대편 최우선호가).
+    // 시장가 매수의 price는 지불 상한이라 reference가 그보다 높을 때만 상한을 쓴다.
+    const char* check(Order& order, liquibook::book::Price reference);
+    // 검사 뒤 가격이 정해진 주문(시장가 collar)의 명목가를 실제 잔류 가격으로 다시 잡는다
+    void reprice(Order& order);
+    // 정정 검사: 수량 증가분과 바뀐 가격을 반영한 노출이 한도를 넘으면 거부 사유
+    const char* checkReplace(const Order& order, int64_t size_delta,
+                             liquibook::book::Price new_price) const;
+
+    // 리스너 콜백에서 호출
+    void onAccept(Order& order);
+    void onFill(Order& order, liquibook::book::Quantity qty);
+    void onClose(Order& order);       // 취소·거부: 남은 노출 전부 해제
+    void onReplace(Order& order, int64_t size_delta, liquibook::book::Price new_price);
+
+    // 리스너 없이 북에 들어간 주문(복원·일괄 등재)을 노출에 넣는다
+    void track(Order& order, liquibook::book::Price reference);
+    // 북 교체·삭제 시 그 종목의 노출을 비운다
+    void reset(const std::string& symbol);
+
+    // 테스트·진단용: 유저의 종목 내 미체결 주문 수 / 명목금액
+    uint32_t openOrders(const std::string& symbol, const std::string& user_id) const;
+    uint64_t openNotional(const std::string& symbol, const std::string& user_id) const;
+
+private:
+    struct Exposure {
+        uint32_t open_orders = 0;
+        uint64_t open_notional = 0;
+    };
+    struct Table {
+        RiskLimits limits;
+        std::vector<Exposure> users;   // 유저 번호로 인덱스
+    };
+
+    uint32_t internUser(const std::string& user_id);
+    uint32_t internSymbol(const std::string& symbol);
+    Exposure& exposure(uint32_t table, uint32_t user);
+    const Exposure* find(const std::string& symbol, const std::string& user_id) const;
+    void release(Order& order, liquibook::book::Quantity qty);
+
+    bool enabled_ = false;
+    RiskLimits defaults_;
+    std::unordered_map<std::string, RiskLimits> symbol_limits_;
+    std::unordered_map<std::string, uint32_t> user_ids_;
+    std::unordered_map<std::string, uint32_t> symbol_ids_;
+    std::vector<Table> tables_;        // 종목 번호로 인덱스
+};
+
+} // namespace aws_wrapper
@@ -7,6 +7,7 @@
 #include <unordered_map>
 #include <mutex>
 #include <cstdint>
+#include "engine_clock.h"
 
 namespace aws_wrapper {
 
@@ -58,6 +59,11 @@ public:
     void setTotalShares(const std::string& symbol, uint64_t total_shares);
     uint64_t getTotalShares(const std::string& symbol) const;
 
+    /**
+     * 시각 출처 설정 (거래일 경계·스냅샷 시각). 스냅샷 주기 자체는 실제 시간으로 돈다.
+     */
+    void setClock(EngineClock* clock) { clock_ = clock ? clock : &EngineClock::real(); }
+
     /**
      * 스냅샷 스레드 시작 (10초 주기)
      */
@@ -83,6 +89,7 @@ private:
 
     // 스냅샷 스레드
     std::atomic<bool> running_{false};
+    EngineClock* clock_ = &EngineClock::real();
     std::thread snapshot_thread_;
 
     // 일일 거래량 리셋 추적 (KST 기준 YYYYMMDD)
@@ -35,6 +35,8 @@ public:
     bool del(const std::string& key);
     bool exists(const std::string& key);
     std::vector<std::string> keys(const std::string& pattern);
+    // 여러 키를 한 번의 MSET으로 (단일 왕복, 원자적)
+    bool mset(const std::vector<std::pair<std::string, std::string>>& kvs);
 
     // 리스트 연산 (체결 내역용)
     bool lpush(const std::string& key, const std::string& value);
@@ -109,6 +111,10 @@ private:
     int calculateBackoffDelay();
     void markDisconnected();
     bool ensureConnection();  // Helper to check/reconnect before operations
+
+    // context_로 명령 전송 + 왕복 시간 기록 (Metrics redis_rtt)
+    redisReply* command(const char* format, ...);
+    redisReply* commandArgv(int argc, const char** argv, const size_t* argvlen);
 };
 
 } // namespace aws_wrapper
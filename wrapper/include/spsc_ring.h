@@ -0,0 +1,69 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+namespace aws_wrapper {
+
+// 단일 생산자/단일 소비자 고정 크기 링 버퍼.
+// 생산자(매칭 스레드)는 tryPush만, 소비자(백그라운드 스레드)는 tryPop만 호출한다.
+// 용량은 2의 거듭제곱으로 올림. head/tail을 다른 캐시 라인에 두어 false sharing 방지.
+template <typename T>
+class SpscRing {
+public:
+    explicit SpscRing(size_t capacity)
+        : mask_(roundUp(capacity) - 1),
+          slots_(new T[mask_ + 1]) {}
+
+    SpscRing(const SpscRing&) = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+
+    // 가득 차면 false (호출자가 대기/드롭 정책 결정)
+    bool tryPush(const T& item) {
+        const size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail - head_cache_ > mask_) {
+            head_cache_ = head_.load(std::memory_order_acquire);
+            if (tail - head_cache_ > mask_) return false;
+        }
+        slots_[tail & mask_] = item;
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // 비어 있으면 false
+    bool tryPop(T& out) {
+        const size_t head = head_.load(std::memory_order_relaxed);
+        if (head == tail_cache_) {
+            tail_cache_ = tail_.load(std::memory_order_acquire);
+            if (head == tail_cache_) return false;
+        }
+        out = slots_[head & mask_];
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    size_t capacity() const { return mask_ + 1; }
+
+    // 근사치(다른 스레드가 동시에 움직일 수 있음)
+    size_t sizeApprox() const {
+        return tail_.load(std::memory_order_acquire) - head_.load(std::memory_order_acquire);
+    }
+
+private:
+    static size_t roundUp(size_t n) {
+        size_t cap = 2;
+        while (cap < n) cap <<= 1;
+        return cap;
+    }
+
+    const size_t mask_;
+    std::unique_ptr<T[]> slots_;
+
+    alignas(64) std::atomic<size_t> head_{0};   // 소비자 소유
+    size_t tail_cache_ = 0;                      // 소비자가 본 tail
+    alignas(64) std::atomic<size_t> tail_{0};   // 생산자 소유
+    size_t head_cache_ = 0;                      // 생산자가 본 head
+};
+
+} // namespace aws_wrapper
@@ -2,6 +2,7 @@
 #include "redis_client.h"
 #include "logger.h"
 #include <chrono>
+#include <vector>
 
 namespace aws_wrapper {
 
@@ -23,46 +24,61 @@ std::string CheckpointManager::makeTimestampKey(const std::string& shard_id) con
     return "kinesis:checkpoint:" + config_.stream_name + ":" + shard_id + ":ts";
 }
 
-void CheckpointManager::checkpoint(const std::string& shard_id, const std::string& sequence_number) {
-    std::lock_guard<std::mutex> lock(buffer_mutex_);
-
+CheckpointManager::ShardCheckpoint& CheckpointManager::updateLocked(
+        const std::string& shard_id, const std::string& sequence_number) {
     auto& cp = checkpoint_buffer_[shard_id];
     cp.sequence_number = sequence_number;
     cp.last_updated = std::chrono::steady_clock::now();
     cp.records_since_flush++;
+    cp.version++;
     cp.dirty = true;
-
     ++checkpoint_count_;
+    return cp;
+}
 
-    // Fix 3: 백그라운드 플러시 활성 시 inline flush 스킵 (consumer 스레드 블로킹 방지)
-    if (config_.enable_background_flush && running_.load()) {
-        return;
-    }
-
-    // 즉시 플러시 조건 확인
+void CheckpointManager::checkpoint(const std::string& shard_id, const std::string& sequence_number) {
     bool should_flush = false;
+    {
+        std::lock_guard<std::mutex> lock(buffer_mutex_);
+        auto& cp = updateLocked(shard_id, sequence_number);
+
+        // 레코드 수 기반
+        should_flush = cp.records_since_flush >= config_.flush_interval_records;
 
-    // 레코드 수 기반
-    if (cp.records_since_flush >= config_.flush_interval_records) {
-        should_flush = true;
+        // Fix 3: 백그라운드 플러시 활성 시 inline flush 스킵 (consumer 스레드 블로킹 방지).
+        // 임계 도달이면 플러시 스레드만 깨운다 — 그 사이 다른 샤드 갱신도 같은 MSET에 합쳐진다.
+        if (config_.enable_background_flush && running_.load()) {
+            if (should_flush && !flush_requested_) {
+                flush_requested_ = true;
+                flush_cv_.notify_one();
+            }
+            return;
+        }
     }
 
     if (should_flush) {
-        flushShard(shard_id, cp);
+        flushDirty();
     }
 }
 
 void CheckpointManager::checkpointImmediate(const std::string& shard_id, const std::string& sequence_number) {
-    std::lock_guard<std::mutex> lock(buffer_mutex_);
-
-    auto& cp = checkpoint_buffer_[shard_id];
-    cp.sequence_number = sequence_number;
-    cp.last_updated = std::chrono::steady_clock::now();
-    cp.dirty = true;
-
-    ++checkpoint_count_;
+    {
+        std::lock_guard<std::mutex> lock(buffer_mutex_);
+        updateLocked(shard_id, sequence_number);
+    }
+    flushDirty();
+}
 
-    flushShard(shard_id, cp);
+void CheckpointManager::checkpointBatch(const std::unordered_map<std::string, std::string>& sequences) {
+    {
+        std::lock_guard<std::mutex> lock(buffer_mutex_);
+        for (const auto& [shard_id, seq] : sequences) {
+            if (!seq.empty()) {
+                updateLocked(shard_id, seq);
+            }
+        }
+    }
+    flushDirty();
 }
 
 std::string CheckpointManager::getLastCheckpoint(const std::string& shard_id) {
@@ -109,57 +125,79 @@ void CheckpointManager::clearAllCheckpoints() {
 }
 
 void CheckpointManager::flush() {
-    std::lock_guard<std::mutex> lock(buffer_mutex_);
-
     if (!redis_ || !redis_->isConnected()) {
         Logger::warn("CheckpointManager: Redis not connected, cannot flush");
         return;
     }
 
-    int flushed = 0;
-    for (auto& [shard_id, cp] : checkpoint_buffer_) {
-        if (cp.dirty) {
-            flushShard(shard_id, cp);
-            ++flushed;
-        }
-    }
-
+    int flushed = flushDirty();
     if (flushed > 0) {
         Logger::info("CheckpointManager flushed", flushed, "shards");
     }
 }
 
-void CheckpointManager::flushShard(const std::string& shard_id, ShardCheckpoint& cp) {
-    if (!cp.dirty || cp.sequence_number.empty()) {
-        return;
-    }
+int CheckpointManager::flushDirty() {
+    std::lock_guard<std::mutex> flush_lock(flush_mutex_);
 
     if (!redis_ || !redis_->isConnected()) {
-        Logger::warn("CheckpointManager: Redis not connected, skip flush for", shard_id);
-        return;
+        Logger::warn("CheckpointManager: Redis not connected, skip flush");
+        return 0;
     }
 
-    std::string key = makeCheckpointKey(shard_id);
-    std::string ts_key = makeTimestampKey(shard_id);
-
-    // 시퀀스 번호 저장
-    bool success = redis_->set(key, cp.sequence_number);
+    // 1. dirty 샤드 수집 (버퍼 락은 짧게 — consumer의 checkpoint()를 막지 않음)
+    struct Pending {
+        std::string shard_id;
+        uint64_t version;
+    };
+    std::vector<Pending> pending;
+    std::vector<std::pair<std::string, std::string>> kvs;
+    const std::string ts = std::to_string(std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count());
+    {
+        std::lock_guard<std::mutex> lock(buffer_mutex_);
+        for (const auto& [shard_id, cp] : checkpoint_buffer_) {
+            if (!cp.dirty || cp.sequence_number.empty()) continue;
+            pending.push_back({shard_id, cp.version});
+            kvs.emplace_back(makeCheckpointKey(shard_id), cp.sequence_number);
+            kvs.emplace_back(makeTimestampKey(shard_id), ts);
+        }
+    }
+    if (pending.empty()) {
+        return 0;
+    }
 
-    if (success) {
-        // 타임스탬프 저장
-        auto now = std::chrono::system_clock::now();
-        auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
-            now.time_since_epoch()).count();
-        redis_->set(ts_key, std::to_string(ms));
+    // 2. 시퀀스 번호 + 타임스탬프를 MSET 한 번으로 (락 밖)
+    auto start = std::chrono::steady_clock::now();
+    bool success = redis_->mset(kvs);
+    uint64_t us = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start).count());
+
+    flush_batches_.fetch_add(1);
+    last_flush_us_.store(us);
+    total_flush_us_.fetch_add(us);
+    uint64_t prev_max = max_flush_us_.load();
+    while (us > prev_max && !max_flush_us_.compare_exchange_weak(prev_max, us)) {
+    }
 
-        cp.dirty = false;
-        cp.records_since_flush = 0;
-        ++flush_count_;
+    if (!success) {
+        Logger::error("Failed to save checkpoints,", pending.size(), "shards");
+        return 0;
+    }
 
-        Logger::debug("Checkpoint saved:", shard_id, "seq:", cp.sequence_number.substr(0, 30) + "...");
-    } else {
-        Logger::error("Failed to save checkpoint for", shard_id);
+    // 3. 저장한 버전 그대로인 샤드만 clean (플러시 중 갱신된 샤드는 다음 플러시로)
+    {
+        std::lock_guard<std::mutex> lock(buffer_mutex_);
+        for (const auto& p : pending) {
+            auto it = checkpoint_buffer_.find(p.shard_id);
+            if (it == checkpoint_buffer_.end() || it->second.version != p.version) continue;
+            it->second.dirty = false;
+            it->second.records_since_flush = 0;
+        }
     }
+    flush_count_.fetch_add(pending.size());
+
+    Logger::debug("Checkpoints saved:", pending.size(), "shards in", us, "us");
+    return static_cast<int>(pending.size());
 }
 
 size_t CheckpointManager::getPendingCount() const {
@@ -189,7 +227,11 @@ void CheckpointManager::stopBackgroundFlush() {
         return;
     }
 
-    running_ = false;
+    {
+        std::lock_guard<std::mutex> lock(buffer_mutex_);
+        running_ = false;
+    }
+    flush_cv_.notify_one();
     if (flush_thread_.joinable()) {
         flush_thread_.join();
     }
@@ -197,34 +239,24 @@ void CheckpointManager::stopBackgroundFlush() {
 }
 
 void CheckpointManager::flushLoop() {
+    const auto interval = std::chrono::seconds(config_.flush_interval_seconds);
     while (running_.load()) {
-        // 설정된 간격만큼 대기
-        for (int i = 0; i < config_.flush_interval_seconds * 10 && running_.load(); ++i) {
-            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        // 설정된 간격만큼, 또는 레코드 수 임계 도달(checkpoint()가 깨움)까지 대기
+        {
+            std::unique_lock<std::mutex> lock(buffer_mutex_);
+            flush_cv_.wait_for(lock, interval, [this] {
+                return flush_requested_ || !running_.load();
+            });
+            flush_requested_ = false;
         }
 
         if (!running_.load()) {
             break;
         }
 
-        // 시간 기반 + 레코드 수 기반 플러시
-        {
-            std::lock_guard<std::mutex> lock(buffer_mutex_);
-            auto now = std::chrono::steady_clock::now();
-
-            for (auto& [shard_id, cp] : checkpoint_buffer_) {
-                if (cp.dirty) {
-                    auto elapsed = std::chrono::duration_cast<std::chrono::seconds>(
-                        now - cp.last_updated).count();
-
-                    // 시간 초과 또는 레코드 수 초과 시 플러시
-                    if (elapsed >= config_.flush_interval_seconds ||
-                        cp.records_since_flush >= config_.flush_interval_records) {
-                        flushShard(shard_id, cp);
-                    }
-                }
-            }
-        }
+        // 깨어난 시점의 dirty 샤드 전부를 한 번에 (시간/레코드 수 임계를 넘지 않은 샤드도
+        // 같은 왕복에 실리므로 추가 비용 없음)
+        flushDirty();
     }
 }
 
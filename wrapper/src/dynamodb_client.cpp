@@ -1,4 +1,5 @@
 #include "dynamodb_client.h"
+#include "config.h"
 #include "logger.h"
 
 #include <aws/core/Aws.h>
@@ -7,6 +8,14 @@
 #include <aws/dynamodb/model/QueryRequest.h>
 #include <aws/dynamodb/model/AttributeValue.h>
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
 namespace aws_wrapper {
 
 struct DynamoDBClient::Impl {
@@ -30,6 +39,14 @@ bool DynamoDBClient::initialize() {
         config.region = region_;
         config.connectTimeoutMs = 5000;
         config.requestTimeoutMs = 10000;
+        // 병렬 세그먼트 스레드가 연결을 기다리지 않도록
+        config.maxConnections = 32;
+        // DynamoDB Local 등 엔드포인트 지정 (scripts/init-dynamodb-local.sh)
+        const std::string endpoint = Config::get("DYNAMODB_ENDPOINT", "");
+        if (!endpoint.empty()) {
+            config.endpointOverride = endpoint;
+            Logger::info("DynamoDB endpoint override:", endpoint);
+        }
 
         impl_->client = std::make_unique<Aws::DynamoDB::DynamoDBClient>(config);
         initialized_ = true;
@@ -41,182 +58,312 @@ bool DynamoDBClient::initialize() {
     }
 }
 
-std::vector<OrderPtr> DynamoDBClient::loadActiveOrders(const std::string& table_name) {
-    std::vector<OrderPtr> orders;
+namespace {
 
-    if (!initialized_) {
-        Logger::error("DynamoDB client not initialized");
-        return orders;
-    }
+using Item = Aws::Map<Aws::String, Aws::DynamoDB::Model::AttributeValue>;
 
-    try {
-        Aws::DynamoDB::Model::ScanRequest request;
-        request.SetTableName(table_name);
+struct LoadStats {
+    std::atomic<int> scanned{0};
+    std::atomic<int> accepted{0};
+    std::atomic<int> partial{0};
+};
 
-        // status IN ('ACCEPTED', 'PARTIAL_FILL') + cancel_processed/PENDING_CANCEL 가드
-        // 고스트 주문 방지: cancel_processed=true 또는 PENDING_CANCEL 상태인 주문 제외
-        request.SetFilterExpression(
-            "(#s = :accepted OR #s = :partial_fill) AND "
-            "(attribute_not_exists(cancel_processed) OR cancel_processed = :false)"
-        );
-        request.AddExpressionAttributeNames("#s", "status");
+bool isMarketMakerUser(const std::string& user_id) {
+    return user_id.find("mm-") == 0 ||
+           user_id.find("mm_") == 0 ||
+           user_id == "mm-bid" ||
+           user_id == "mm-ask" ||
+           user_id == "mm-kinesis-direct-buy" ||
+           user_id == "mm-kinesis-direct-sell";
+}
 
-        Aws::DynamoDB::Model::AttributeValue acceptedVal;
-        acceptedVal.SetS("ACCEPTED");
-        request.AddExpressionAttributeValues(":accepted", acceptedVal);
+// created_at(ISO-8601 문자열 또는 epoch ms 숫자)을 ms timestamp로 — 복원 시 같은 가격
+// 대기열을 이 순서로 세운다. 없거나 해석할 수 없으면 지금 시각(대기열 맨 뒤).
+int64_t createdAtMs(const Item& item, const std::string& order_id) {
+    auto it = item.find("created_at");
+    if (it != item.end()) {
+        const auto& attr = it->second;
+        const std::string text = attr.GetS().empty() ? attr.GetN().c_str() : attr.GetS().c_str();
+        const int64_t ms = Order::parseTimestampMs(text);
+        if (ms >= 0) {
+            return ms;
+        }
+        Logger::warn("Unparsable created_at, using load time:", order_id, text);
+    }
+    return EngineClock::real().nowMs();
+}
 
-        Aws::DynamoDB::Model::AttributeValue partialFillVal;
-        partialFillVal.SetS("PARTIAL_FILL");
-        request.AddExpressionAttributeValues(":partial_fill", partialFillVal);
+// 활성 주문 한 건 파싱. MM 주문/복원 불가 주문이면 nullptr.
+OrderPtr parseActiveOrder(const Item& item, LoadStats& stats) {
+    // MM(마켓메이커) 주문 제외
+    auto user_it = item.find("user_id");
+    if (user_it != item.end() && isMarketMakerUser(user_it->second.GetS())) {
+        return nullptr;  // MM 주문 스킵
+    }
 
-        Aws::DynamoDB::Model::AttributeValue falseVal;
-        falseVal.SetBool(false);
-        request.AddExpressionAttributeValues(":false", falseVal);
+    auto order = std::make_shared<Order>();
 
-        // 필요한 속성만 가져오기 (프로젝션)
-        request.SetProjectionExpression(
-            "order_id, user_id, symbol, side, price, quantity, filled_qty, #s, created_at"
-        );
+    auto it = item.find("order_id");
+    if (it != item.end()) order->setOrderId(it->second.GetS());
 
-        std::string last_key;
-        int total_scanned = 0;
-        int total_accepted = 0;
-        int total_partial = 0;
+    it = item.find("user_id");
+    if (it != item.end()) order->setUserId(it->second.GetS());
 
-        do {
-            auto outcome = impl_->client->Scan(request);
+    it = item.find("symbol");
+    if (it != item.end()) order->setSymbol(it->second.GetS());
 
-            if (!outcome.IsSuccess()) {
-                Logger::error("DynamoDB scan failed:",
-                             outcome.GetError().GetMessage());
-                break;
-            }
+    // side (BUY/SELL)
+    it = item.find("side");
+    if (it != item.end()) order->setIsBuy(it->second.GetS() == "BUY");
 
-            const auto& result = outcome.GetResult();
-            total_scanned += result.GetScannedCount();
+    it = item.find("price");
+    if (it != item.end()) {
+        order->setPrice(static_cast<uint64_t>(std::stoull(it->second.GetN())));
+    }
 
-            for (const auto& item : result.GetItems()) {
-                // MM(마켓메이커) 주문 제외
-                auto user_it = item.find("user_id");
-                if (user_it != item.end()) {
-                    const std::string& user_id = user_it->second.GetS();
-                    if (user_id.find("mm-") == 0 ||
-                        user_id.find("mm_") == 0 ||
-                        user_id == "mm-bid" ||
-                        user_id == "mm-ask" ||
-                        user_id == "mm-kinesis-direct-buy" ||
-                        user_id == "mm-kinesis-direct-sell") {
-                        continue;  // MM 주문 스킵
-                    }
-                }
+    // quantity 및 filled_qty 파싱
+    uint64_t quantity = 0;
+    uint64_t filled_qty = 0;
 
-                auto order = std::make_shared<Order>();
+    it = item.find("quantity");
+    if (it != item.end()) {
+        quantity = static_cast<uint64_t>(std::stoull(it->second.GetN()));
+    }
 
-                // order_id
-                auto it = item.find("order_id");
-                if (it != item.end()) {
-                    order->setOrderId(it->second.GetS());
-                }
+    it = item.find("filled_qty");
+    if (it != item.end()) {
+        filled_qty = static_cast<uint64_t>(std::stoull(it->second.GetN()));
+    }
 
-                // user_id
-                it = item.find("user_id");
-                if (it != item.end()) {
-                    order->setUserId(it->second.GetS());
-                }
+    // status 확인 - PARTIAL_FILL이면 잔여 수량으로 복원
+    std::string status;
+    it = item.find("status");
+    if (it != item.end()) {
+        status = it->second.GetS();
+    }
 
-                // symbol
-                it = item.find("symbol");
-                if (it != item.end()) {
-                    order->setSymbol(it->second.GetS());
-                }
+    if (status == "PARTIAL_FILL") {
+        uint64_t remaining = quantity - filled_qty;
+        if (remaining == 0) {
+            Logger::warn("PARTIAL_FILL order has 0 remaining qty, skipping:",
+                        order->order_id());
+            return nullptr;
+        }
+        // Safety: skip orders with suspiciously large remaining qty.
+        // Caused by legacy bug (hardcoded qty=999999999 in fill_processor).
+        if (remaining > 100000000) {
+            Logger::warn("Suspiciously large remaining qty, skipping:",
+                        order->order_id(), "remaining:", remaining,
+                        "quantity:", quantity, "filled:", filled_qty);
+            return nullptr;
+        }
+        order->setOrderQty(remaining);
+        ++stats.partial;
+        Logger::info("PARTIAL_FILL order loaded:", order->order_id(),
+                    "original_qty:", quantity, "filled:", filled_qty,
+                    "remaining:", remaining);
+    } else {
+        order->setOrderQty(quantity);
+        ++stats.accepted;
+    }
 
-                // side (BUY/SELL)
-                it = item.find("side");
-                if (it != item.end()) {
-                    order->setIsBuy(it->second.GetS() == "BUY");
-                }
+    order->setTimestamp(createdAtMs(item, order->order_id()));
 
-                // price
-                it = item.find("price");
-                if (it != item.end()) {
-                    order->setPrice(static_cast<uint64_t>(std::stoull(it->second.GetN())));
-                }
+    return order;
+}
 
-                // quantity 및 filled_qty 파싱
-                uint64_t quantity = 0;
-                uint64_t filled_qty = 0;
+// 스캔/쿼리 스레드 → 호출 스레드로 주문을 넘기는 큐 (생산자 여럿, 소비자 하나).
+// 상한을 두어 복원(소비)이 느리면 스캔이 기다린다 — 메모리가 테이블 크기에 비례하지 않게.
+class OrderHandoff {
+public:
+    explicit OrderHandoff(size_t capacity) : capacity_(capacity) {}
+
+    void push(OrderPtr order) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        not_full_.wait(lock, [&] { return queue_.size() < capacity_; });
+        queue_.push_back(std::move(order));
+        not_empty_.notify_one();
+    }
 
-                it = item.find("quantity");
-                if (it != item.end()) {
-                    quantity = static_cast<uint64_t>(std::stoull(it->second.GetN()));
-                }
+    void producerDone() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ++done_;
+        not_empty_.notify_one();
+    }
 
-                it = item.find("filled_qty");
-                if (it != item.end()) {
-                    filled_qty = static_cast<uint64_t>(std::stoull(it->second.GetN()));
-                }
+    // 비었고 생산자가 모두 끝났으면 false
+    bool pop(OrderPtr& out, int producers) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        not_empty_.wait(lock, [&] { return !queue_.empty() || done_ == producers; });
+        if (queue_.empty()) return false;
+        out = std::move(queue_.front());
+        queue_.pop_front();
+        not_full_.notify_one();
+        return true;
+    }
 
-                // status 확인 - PARTIAL_FILL이면 잔여 수량으로 복원
-                std::string status;
-                it = item.find("status");
-                if (it != item.end()) {
-                    status = it->second.GetS();
-                }
+private:
+    const size_t capacity_;
+    std::mutex mutex_;
+    std::condition_variable not_empty_;
+    std::condition_variable not_full_;
+    std::deque<OrderPtr> queue_;
+    int done_ = 0;
+};
 
-                if (status == "PARTIAL_FILL") {
-                    uint64_t remaining = quantity - filled_qty;
-                    if (remaining == 0) {
-                        Logger::warn("PARTIAL_FILL order has 0 remaining qty, skipping:",
-                                    order->order_id());
-                        continue;
-                    }
-                    // Safety: skip orders with suspiciously large remaining qty.
-                    // Caused by legacy bug (hardcoded qty=999999999 in fill_processor).
-                    if (remaining > 100000000) {
-                        Logger::warn("Suspiciously large remaining qty, skipping:",
-                                    order->order_id(), "remaining:", remaining,
-                                    "quantity:", quantity, "filled:", filled_qty);
-                        continue;
-                    }
-                    order->setOrderQty(remaining);
-                    ++total_partial;
-                    Logger::info("PARTIAL_FILL order loaded:", order->order_id(),
-                                "original_qty:", quantity, "filled:", filled_qty,
-                                "remaining:", remaining);
-                } else {
-                    order->setOrderQty(quantity);
-                    ++total_accepted;
-                }
+// 활성 주문 필터: cancel_processed/PENDING_CANCEL 가드 (고스트 주문 방지)
+constexpr const char* NOT_CANCEL_PROCESSED =
+    "(attribute_not_exists(cancel_processed) OR cancel_processed = :false)";
+constexpr const char* ACTIVE_ORDER_PROJECTION =
+    "order_id, user_id, symbol, side, price, quantity, filled_qty, #s, created_at";
 
-                // created_at을 timestamp로 변환 (선택적)
-                it = item.find("created_at");
-                if (it != item.end()) {
-                    auto now = std::chrono::system_clock::now();
-                    auto epoch = std::chrono::duration_cast<std::chrono::nanoseconds>(
-                        now.time_since_epoch()).count();
-                    order->setTimestamp(epoch);
-                }
+Aws::DynamoDB::Model::AttributeValue stringValue(const std::string& v) {
+    Aws::DynamoDB::Model::AttributeValue value;
+    value.SetS(v);
+    return value;
+}
 
-                orders.push_back(order);
-            }
+Aws::DynamoDB::Model::AttributeValue boolValue(bool v) {
+    Aws::DynamoDB::Model::AttributeValue value;
+    value.SetBool(v);
+    return value;
+}
 
-            // 페이지네이션 처리
-            if (result.GetLastEvaluatedKey().empty()) {
-                break;
-            }
-            request.SetExclusiveStartKey(result.GetLastEvaluatedKey());
+} // namespace
 
-        } while (true);
+std::vector<OrderPtr> DynamoDBClient::loadActiveOrders(const std::string& table_name) {
+    std::vector<OrderPtr> orders;
+    streamActiveOrders(table_name, ActiveOrderLoadOptions{},
+                       [&orders](const OrderPtr& order) { orders.push_back(order); });
+    return orders;
+}
 
-        Logger::info("DynamoDB scan complete: scanned=", total_scanned,
-                    ", accepted=", total_accepted, ", partial_fill=", total_partial,
-                    " active orders loaded (MM excluded)");
+size_t DynamoDBClient::streamActiveOrders(const std::string& table_name,
+                                          const ActiveOrderLoadOptions& options,
+                                          const std::function<void(const OrderPtr&)>& sink) {
+    if (!initialized_) {
+        Logger::error("DynamoDB client not initialized");
+        return 0;
+    }
 
-    } catch (const std::exception& e) {
-        Logger::error("DynamoDB loadActiveOrders failed:", e.what());
+    LoadStats stats;
+    OrderHandoff handoff(options.handoff_capacity > 0 ? options.handoff_capacity : 1);
+    std::vector<std::thread> workers;
+    auto* client = impl_->client.get();
+    auto start = std::chrono::steady_clock::now();
+
+    // 페이지 단위로 파싱해 넘긴다 (페이지 전체를 모으지 않음)
+    auto drainItems = [&](const Aws::Vector<Item>& items) {
+        for (const auto& item : items) {
+            try {
+                if (auto order = parseActiveOrder(item, stats)) {
+                    handoff.push(std::move(order));
+                }
+            } catch (const std::exception& e) {
+                Logger::error("DynamoDB active order parse failed:", e.what());
+            }
+        }
+    };
+
+    if (!options.status_index.empty()) {
+        // GSI Query 모드: status 파티션(ACCEPTED, PARTIAL_FILL)만 읽는다 → 비용 ∝ 활성 주문 수
+        for (const char* status : {"ACCEPTED", "PARTIAL_FILL"}) {
+            workers.emplace_back([&, status] {
+                try {
+                    Aws::DynamoDB::Model::QueryRequest request;
+                    request.SetTableName(table_name);
+                    request.SetIndexName(options.status_index);
+                    request.SetKeyConditionExpression("#s = :status");
+                    request.SetFilterExpression(NOT_CANCEL_PROCESSED);
+                    request.AddExpressionAttributeNames("#s", "status");
+                    request.AddExpressionAttributeValues(":status", stringValue(status));
+                    request.AddExpressionAttributeValues(":false", boolValue(false));
+                    request.SetProjectionExpression(ACTIVE_ORDER_PROJECTION);
+
+                    while (true) {
+                        auto outcome = client->Query(request);
+                        if (!outcome.IsSuccess()) {
+                            Logger::error("DynamoDB status query failed:", status,
+                                          outcome.GetError().GetMessage());
+                            break;
+                        }
+                        const auto& result = outcome.GetResult();
+                        stats.scanned += result.GetScannedCount();
+                        drainItems(result.GetItems());
+                        if (result.GetLastEvaluatedKey().empty()) break;
+                        request.SetExclusiveStartKey(result.GetLastEvaluatedKey());
+                    }
+                } catch (const std::exception& e) {
+                    Logger::error("DynamoDB status query failed:", status, e.what());
+                }
+                handoff.producerDone();
+            });
+        }
+    } else {
+        // 병렬 세그먼트 Scan: 세그먼트마다 스레드 하나가 독립적으로 페이지를 넘긴다
+        const int segments = std::max(1, options.segments);
+        for (int segment = 0; segment < segments; ++segment) {
+            workers.emplace_back([&, segment, segments] {
+                try {
+                    Aws::DynamoDB::Model::ScanRequest request;
+                    request.SetTableName(table_name);
+                    if (segments > 1) {
+                        request.SetSegment(segment);
+                        request.SetTotalSegments(segments);
+                    }
+                    // status IN ('ACCEPTED', 'PARTIAL_FILL') + cancel_processed 가드
+                    request.SetFilterExpression(
+                        std::string("(#s = :accepted OR #s = :partial_fill) AND ") +
+                        NOT_CANCEL_PROCESSED);
+                    request.AddExpressionAttributeNames("#s", "status");
+                    request.AddExpressionAttributeValues(":accepted", stringValue("ACCEPTED"));
+                    request.AddExpressionAttributeValues(":partial_fill", stringValue("PARTIAL_FILL"));
+                    request.AddExpressionAttributeValues(":false", boolValue(false));
+                    // 필요한 속성만 가져오기 (프로젝션)
+                    request.SetProjectionExpression(ACTIVE_ORDER_PROJECTION);
+
+                    while (true) {
+                        auto outcome = client->Scan(request);
+                        if (!outcome.IsSuccess()) {
+                            Logger::error("DynamoDB scan failed (segment", segment, "):",
+                                          outcome.GetError().GetMessage());
+                            break;
+                        }
+                        const auto& result = outcome.GetResult();
+                        stats.scanned += result.GetScannedCount();
+                        drainItems(result.GetItems());
+                        // 페이지네이션 처리
+                        if (result.GetLastEvaluatedKey().empty()) break;
+                        request.SetExclusiveStartKey(result.GetLastEvaluatedKey());
+                    }
+                } catch (const std::exception& e) {
+                    Logger::error("DynamoDB scan failed (segment", segment, "):", e.what());
+                }
+                handoff.producerDone();
+            });
+        }
     }
 
-    return orders;
+    // 호출 스레드에서 소비: 복원(엔진 addOrder)이 스캔과 겹쳐 진행된다
+    const int producers = static_cast<int>(workers.size());
+    size_t delivered = 0;
+    OrderPtr order;
+    while (handoff.pop(order, producers)) {
+        sink(order);
+        ++delivered;
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    auto elapsed_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start).count();
+    Logger::info("DynamoDB active order load complete (",
+                 options.status_index.empty() ? "scan" : "gsi query",
+                 "workers:", producers, "): scanned=", stats.scanned.load(),
+                 ", accepted=", stats.accepted.load(), ", partial_fill=", stats.partial.load(),
+                 " active orders loaded (MM excluded) in", elapsed_ms, "ms");
+    return delivered;
 }
 
 std::vector<OrderPtr> DynamoDBClient::loadActiveOrdersBySymbol(
@@ -337,9 +484,7 @@ std::vector<OrderPtr> DynamoDBClient::loadActiveOrdersBySymbol(
                     order->setOrderQty(quantity);
                 }
 
-                auto now = std::chrono::system_clock::now();
-                order->setTimestamp(std::chrono::duration_cast<std::chrono::nanoseconds>(
-                    now.time_since_epoch()).count());
+                order->setTimestamp(createdAtMs(item, order->order_id()));
 
                 orders.push_back(order);
             }
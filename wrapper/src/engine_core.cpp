@@ -1,19 +1,25 @@
 #include "engine_core.h"
+#include "mbo_feed.h"
+#include "latency_trace.h"
 #include "redis_client.h"
 #include "logger.h"
 #include "config.h"
+#include <algorithm>
 #include <mutex>
 #include <cstdlib>
 #include <cmath>
 #include <nlohmann/json.hpp>
+#include <sstream>
 
 namespace aws_wrapper {
 
-EngineCore::EngineCore(MarketDataHandler* handler, RedisClient* redis)
-    : handler_(handler), operating_redis_(redis) {
+EngineCore::EngineCore(MarketDataHandler* handler, RedisClient* redis, EngineClock* clock)
+    : handler_(handler), operating_redis_(redis),
+      clock_(clock ? clock : &EngineClock::real()) {
     // MarketDataHandler에 EngineCore 참조 설정 (완전 체결된 주문 제거용)
     if (handler_) {
         handler_->setEngineCore(this);
+        handler_->setClock(clock_);
     }
     // 가격 밴드 폭 (예: 0.5 = ±50%). 0/미설정이면 비활성.
     try {
@@ -22,7 +28,16 @@ EngineCore::EngineCore(MarketDataHandler* handler, RedisClient* redis)
         price_band_pct_ = 0.0;
     }
     if (price_band_pct_ > 0.0) {
-        Logger::info("Price band enabled: ±", price_band_pct_ * 100.0, "% of last trade");
+        LOGGER_INFO("Price band enabled: ±", price_band_pct_ * 100.0, "% of last trade");
+    }
+    // 시장가 collar 폭 (예: 0.05 = 반대편 최우선호가 ±5%). 0/미설정이면 비활성.
+    try {
+        market_collar_pct_ = std::stod(Config::get("MARKET_COLLAR_PCT", "0"));
+    } catch (...) {
+        market_collar_pct_ = 0.0;
+    }
+    if (market_collar_pct_ > 0.0) {
+        LOGGER_INFO("Market order collar enabled: ±", market_collar_pct_ * 100.0, "% of best quote");
     }
     // VI 서킷브레이커 설정
     try {
@@ -31,11 +46,34 @@ EngineCore::EngineCore(MarketDataHandler* handler, RedisClient* redis)
         vi_dynamic_pct_ = 0.0;
     }
     vi_halt_seconds_ = std::stoi(Config::get("VI_HALT_SECONDS", "120"));
+    // 스톱 연쇄 상한: 넘는 스톱은 발동 순서대로 대기했다가 그 종목의 다음 명령 앞에 제출된다
+    stop_cascade_limit_ = static_cast<size_t>(std::max(0, Config::getInt("STOP_CASCADE_LIMIT", 0)));
+    if (stop_cascade_limit_ > 0) {
+        LOGGER_INFO("Stop cascade limit:", stop_cascade_limit_, "stops per command");
+    }
     if (vi_dynamic_pct_ > 0.0) {
-        Logger::info("VI circuit breaker enabled: ±", vi_dynamic_pct_ * 100.0,
+        LOGGER_INFO("VI circuit breaker enabled: ±", vi_dynamic_pct_ * 100.0,
                      "% dynamic, halt", vi_halt_seconds_, "s");
     }
-    Logger::info("EngineCore initialized");
+    // 단일가 경매: halt 중 주문을 모아 재개 시 단일가 체결 / 신규 종목 개시 경매
+    vi_auction_ = Config::getBool("VI_AUCTION", false);
+    opening_auction_seconds_ = std::max(0, Config::getInt("OPENING_AUCTION_SECONDS", 0));
+    if (vi_auction_ || opening_auction_seconds_ > 0) {
+        LOGGER_INFO("Call auction enabled: VI halt", vi_auction_ ? "on" : "off",
+                     ", opening", opening_auction_seconds_, "s");
+    }
+    // 배치 경매 종목 (쉼표 구분): 연속 매매 대신 구간마다 단일가 체결
+    std::istringstream batch_list(Config::get("BATCH_AUCTION_SYMBOLS", ""));
+    for (std::string symbol; std::getline(batch_list, symbol, ',');) {
+        if (!symbol.empty()) batch_symbols_.insert(symbol);
+    }
+    batch_interval_ = std::chrono::milliseconds(
+        std::max(1, Config::getInt("BATCH_AUCTION_INTERVAL_MS", 100)));
+    if (!batch_symbols_.empty()) {
+        LOGGER_INFO("Batch auction:", batch_symbols_.size(), "symbols, every",
+                     batch_interval_.count(), "ms");
+    }
+    LOGGER_INFO("EngineCore initialized");
 }
 
 bool EngineCore::exceedsViThreshold(uint64_t ref_price, uint64_t cur_price, double pct) {
@@ -47,6 +85,14 @@ bool EngineCore::exceedsViThreshold(uint64_t ref_price, uint64_t cur_price, doub
 }
 
 void EngineCore::onTradeForVI(const std::string& symbol, uint64_t fill_price) {
+    // 체결 콜백은 주문 API의 배타 락 안에서 불리므로 rw_mutex_ 보호 카운터를 올려도 안전
+    ++total_trades_executed_;
+    // 경매 체결은 건별로 판정하지 않는다 — 끝난 뒤 단일가 하나로 처리한다
+    if (uncrossing_) return;
+    checkVolatility(symbol, fill_price);
+}
+
+void EngineCore::checkVolatility(const std::string& symbol, uint64_t fill_price) {
     if (vi_dynamic_pct_ <= 0.0 || fill_price == 0) return;
 
     bool newly_halted = false;
@@ -55,7 +101,7 @@ void EngineCore::onTradeForVI(const std::string& symbol, uint64_t fill_price) {
         auto it = vi_last_price_.find(symbol);
         if (it != vi_last_price_.end() &&
             exceedsViThreshold(it->second, fill_price, vi_dynamic_pct_)) {
-            halt_until_[symbol] = std::chrono::steady_clock::now() +
+            halt_until_[symbol] = clock_->monotonicNow() +
                                   std::chrono::seconds(vi_halt_seconds_);
             newly_halted = true;
             // 기준가 동결: halt를 유발한 그 체결가로 기준가를 갱신하면, 해제 후 그 가격이
@@ -67,7 +113,7 @@ void EngineCore::onTradeForVI(const std::string& symbol, uint64_t fill_price) {
     }
 
     if (newly_halted) {
-        Logger::warn("VI HALT:", symbol, "price:", fill_price,
+        LOGGER_WARN("VI HALT:", symbol, "price:", fill_price,
                      "(급변 ±", vi_dynamic_pct_ * 100.0, "% 초과) —", vi_halt_seconds_, "s 정지");
         // 상태 전파: MM·스트리머·프론트가 구독. MM은 halt 시 호가를 걷어야 함(재개 단일가 왜곡 방지).
         // TTL을 halt 길이로 걸어, 거래가 끊겨 아무도 addOrder를 호출하지 않아도(자동 해제가
@@ -91,7 +137,7 @@ bool EngineCore::isHalted(const std::string& symbol) {
     std::lock_guard<std::mutex> lock(vi_mutex_);
     auto it = halt_until_.find(symbol);
     if (it == halt_until_.end()) return false;
-    if (std::chrono::steady_clock::now() >= it->second) {
+    if (clock_->monotonicNow() >= it->second) {
         // 자동 해제
         halt_until_.erase(it);
         if (operating_redis_ && operating_redis_->isConnected()) {
@@ -104,6 +150,98 @@ bool EngineCore::isHalted(const std::string& symbol) {
     return true;
 }
 
+bool EngineCore::openingAuctionOpenUnsafe(const std::string& symbol) {
+    auto it = opening_until_.find(symbol);
+    if (it == opening_until_.end()) return false;
+    if (clock_->monotonicNow() < it->second) return true;
+    opening_until_.erase(it);
+    return false;
+}
+
+uint64_t EngineCore::auctionReference(const std::string& symbol) const {
+    const uint64_t reference = viReferencePrice(symbol);
+    if (reference == 0 && handler_) return handler_->getLastPrice(symbol);
+    return reference;
+}
+
+liquibook::book::AuctionResult EngineCore::uncrossAuctionUnsafe(const std::string& symbol,
+                                                                OrderBook& book, bool reopen) {
+    const uint64_t reference = auctionReference(symbol);
+    const auto stops_before = book.stop_stats();
+    uncrossing_ = true;
+    const auto result = book.uncross(reference);
+    book.perform_callbacks();
+    uncrossing_ = false;
+    stops_triggered_ += book.stop_stats().triggered - stops_before.triggered;
+    stop_cascades_capped_ += book.stop_stats().capped - stops_before.capped;
+    ++auctions_uncrossed_;
+    auction_volume_ += result.volume;
+
+    if (result.volume > 0 && reopen) {
+        std::lock_guard<std::mutex> lock(vi_mutex_);
+        vi_last_price_[symbol] = result.price;
+    } else if (result.volume > 0) {
+        checkVolatility(symbol, result.price);
+    }
+    LOGGER_INFO("AUCTION UNCROSS:", symbol, "price:", result.price,
+                 "volume:", result.volume, "imbalance:", result.imbalance,
+                 "reference:", reference);
+    return result;
+}
+
+void EngineCore::startBatchUnsafe(const std::string& symbol, OrderBook& book) {
+    book.start_auction();
+    book.hold_book_updates();
+    batch_due_[symbol] = clock_->monotonicNow() + batch_interval_;
+}
+
+void EngineCore::clearBatchUnsafe(const std::string& symbol, OrderBook& book) {
+    const auto now = clock_->monotonicNow();
+    auto& due = batch_due_[symbol];
+    if (now < due) return;
+    due = now + batch_interval_;
+
+    // 교차가 없으면 경매를 그대로 이어 간다 (빈 체결로 카운터·로그를 흔들지 않는다)
+    const auto cross = liquibook::book::auction_equilibrium(
+        book.bidLevels(), book.askLevels(), auctionReference(symbol));
+    if (cross.volume > 0) {
+        uncrossAuctionUnsafe(symbol, book, halted_batches_.erase(symbol) > 0);
+        ++batch_auctions_;
+        book.start_auction();
+    }
+    // 구간 동안 보류한 depth를 한 번 발행(변화가 없었으면 발행 없음)하고 다음 구간을 묶는다
+    book.release_book_updates();
+    book.hold_book_updates();
+}
+
+std::chrono::milliseconds EngineCore::batchAuctionInterval() const {
+    return batch_symbols_.empty() ? std::chrono::milliseconds(0) : batch_interval_;
+}
+
+void EngineCore::runDueAuctions() {
+    std::unique_lock<std::shared_mutex> lock(rw_mutex_);
+    for (auto& [symbol, book] : books_) {
+        if (!book->in_auction()) continue;
+        const bool batch = batch_symbols_.count(symbol) > 0;
+        if (isHalted(symbol)) {
+            if (batch) halted_batches_.insert(symbol);
+            continue;
+        }
+        if (openingAuctionOpenUnsafe(symbol)) continue;
+        if (batch) {
+            clearBatchUnsafe(symbol, *book);
+        } else {
+            uncrossAuctionUnsafe(symbol, *book);
+        }
+    }
+}
+
+bool EngineCore::inAuction(const std::string& symbol) const {
+    std::shared_lock<std::shared_mutex> lock(rw_mutex_);
+    auto it = books_.find(symbol);
+    return it != books_.end() && it->second->in_auction();
+}
+
 bool EngineCore::violatesPriceBand(const OrderPtr& order) const {
     if (price_band_pct_ <= 0.0) return false;              // 비활성
     const liquibook::book::Price px = order->price();
@@ -121,6 +259,44 @@ bool EngineCore::violatesPriceBand(const OrderPtr& order) const {
     return (static_cast<double>(px) < lo) || (static_cast<double>(px) > hi);
 }
 
+bool EngineCore::applyMarketCollarUnsafe(OrderBook& book, const OrderPtr& order) {
+    if (market_collar_pct_ <= 0.0) return false;            // 비활성
+    if (order->order_type() != "MARKET") return false;
+    // 스톱 시장가는 발동 시점의 호가가 기준이어야 하므로 그대로 둔다
+    if (order->stop_price() != 0) return false;
+    // 경매 중 시장가는 단일가 산정에 시장가로 참여한다(교차한 호가는 기준이 못 된다)
+    if (book.in_auction()) return false;
+
+    // Depth는 지정가만 집계한다 — 최상위 레벨이 곧 반대편 최우선호가
+    const liquibook::book::DepthLevel* best =
+        order->is_buy() ? book.depth().asks() : book.depth().bids();
+    if (best->order_count() == 0) return false;             // 반대편이 비면 IOC로 그냥 취소
+
+    const double bbo = static_cast<double>(best->price());
+    liquibook::book::Price limit;
+    if (order->is_buy()) {
+        limit = static_cast<liquibook::book::Price>(std::ceil(bbo * (1.0 + market_collar_pct_)));
+        // MARKET BUY의 price는 라우터가 잔고로 정한 지불 상한 — collar가 넘으면 안 된다.
+        // 상한이 최우선 매도에도 못 미치면 잔류할 지정가가 아니므로 IOC 그대로 취소시킨다.
+        if (order->price() != 0) {
+            if (order->price() < best->price()) return false;
+            limit = std::min(limit, order->price());
+        }
+    } else {
+        limit = static_cast<liquibook::book::Price>(std::floor(bbo * (1.0 - market_collar_pct_)));
+        limit = std::max<liquibook::book::Price>(limit, 1);
+    }
+    // 이후로는 collar 가격의 지정가다 — 상태 이벤트·스냅샷·가격 밴드·리스크 명목가 모두
+    // 지정가로 다뤄야 잔량이 시장가로 재-collar되거나 밴드를 우회하지 않는다
+    order->setPrice(limit);
+    order->setOrderType("LIMIT");
+    order->setConditions(order->conditions() & ~liquibook::book::oc_immediate_or_cancel);
+    ++market_orders_collared_;
+    LOGGER_DEBUG("Market order collared:", order->order_id(), "best:", best->price(),
+                 "limit:", limit);
+    return true;
+}
+
 bool EngineCore::isMarketMaker(const std::string& user_id) {
     // MM 계정은 mm-buyer/mm-seller 등 두 ID로 의도적 자전체결을 하므로 STP 면제.
     // restoreOrderBook의 MM 판별과 동일 기준(단일 진실원천 유지 목적).
@@ -165,7 +341,7 @@ int EngineCore::applySelfTradePrevention(const std::string& symbol,
         book_it->second->perform_callbacks();
         map_it->second.erase(resting->order_id());
         ++self_trades_prevented_;
-        Logger::warn("STP: cancelled resting order", resting->order_id(),
+        LOGGER_WARN("STP: cancelled resting order", resting->order_id(),
                      "(user", uid, "symbol", symbol,
                      ") to prevent self-trade with", aggressor->order_id());
     }
@@ -193,23 +369,32 @@ EngineCore::OrderBookPtr EngineCore::getOrCreateBook(const std::string& symbol)
     if (operating_redis_ && operating_redis_->isConnected()) {
         if (operating_redis_->sismember("deleted:symbols", symbol) ||
             operating_redis_->sismember("blocked:symbols", symbol)) {
-            Logger::warn("Blocked symbol, refusing to create OrderBook:", symbol);
+            LOGGER_WARN("Blocked symbol, refusing to create OrderBook:", symbol);
             return nullptr;
         }
     }
 
     auto book = std::make_shared<OrderBook>();
     book->set_symbol(symbol);
+    book->set_stop_cascade_limit(stop_cascade_limit_);
+
+    // 신규 상장 개시 경매: 첫 OPENING_AUCTION_SECONDS 동안 주문을 모아 단일가로 시작
+    if (opening_auction_seconds_ > 0) {
+        book->start_auction();
+        opening_until_[symbol] = clock_->monotonicNow() +
+                                 std::chrono::seconds(opening_auction_seconds_);
+    }
+    if (batch_symbols_.count(symbol)) {
+        startBatchUnsafe(symbol, *book);
+    }
     
-    // 리스너 등록 (TradeListener는 타입 불일치로 on_fill에서 처리)
-    book->set_order_listener(handler_);
-    book->set_depth_listener(handler_);
-    book->set_bbo_listener(handler_);
+    // 리스너 등록 (order/depth 역할 모두 handler_, 체결 처리는 on_fill에서)
+    book->set_listener(handler_);
     
     books_[symbol] = book;
     order_maps_[symbol] = {};
     
-    Logger::info("Created OrderBook for symbol:", symbol);
+    LOGGER_INFO("Created OrderBook for symbol:", symbol);
     return book;
 }
 
@@ -219,13 +404,17 @@ bool EngineCore::addOrder(OrderPtr order) {
 
     {
         std::unique_lock<std::shared_mutex> lock(rw_mutex_);
+        LatencyTracer::stamp(TraceStage::LOCKED);
+
+        // 입력 기반 시계는 aggressor 타임스탬프로 전진 (이후 모든 시각 판정의 기준)
+        clock_->observeInput(order->timestamp());
 
         // Dedup Layer 1: reject recently processed orders (Kinesis at-least-once defense)
         auto dedup_it = processed_orders_.find(order_id);
         if (dedup_it != processed_orders_.end()) {
             auto age_s = std::chrono::duration_cast<std::chrono::seconds>(
-                std::chrono::steady_clock::now() - dedup_it->second).count();
-            Logger::warn("DUPLICATE order rejected:", order_id, symbol,
+                clock_->monotonicNow() - dedup_it->second).count();
+            LOGGER_WARN("DUPLICATE order rejected:", order_id, symbol,
                          "(processed", age_s, "s ago)");
             ++duplicates_rejected_;
             return false;
@@ -240,7 +429,7 @@ bool EngineCore::addOrder(OrderPtr order) {
             auto sym_it = order_maps_.find(symbol);
             if (sym_it != order_maps_.end() &&
                 sym_it->second.find(order_id) != sym_it->second.end()) {
-                Logger::warn("DUPLICATE order rejected (already resting in book):",
+                LOGGER_WARN("DUPLICATE order rejected (already resting in book):",
                              order_id, symbol);
                 ++duplicates_rejected_;
                 return false;
@@ -255,18 +444,20 @@ bool EngineCore::addOrder(OrderPtr order) {
             if (handler_) {
                 handler_->on_reject(order, "Symbol is blocked or deleted");
             }
-            Logger::warn("Order rejected (blocked/deleted symbol):", order_id, symbol);
+            LOGGER_WARN("Order rejected (blocked/deleted symbol):", order_id, symbol);
             return false;
         }
 
         // VI 서킷브레이커: halt 중인 종목의 신규 주문 거부 (무결성 원칙: halt 검사가 밴드보다 우선).
-        if (isHalted(symbol)) {
+        // VI_AUCTION이면 거부 대신 아래에서 단일가 경매로 모은다.
+        const bool halted = isHalted(symbol);
+        if (halted && !vi_auction_) {
             ++vi_halt_rejects_;
             lock.unlock();
             if (handler_) {
                 handler_->on_reject(order, "Symbol halted (volatility interruption)");
             }
-            Logger::warn("Order rejected (VI halt):", order_id, symbol);
+            LOGGER_WARN("Order rejected (VI halt):", order_id, symbol);
             return false;
         }
 
@@ -277,12 +468,55 @@ bool EngineCore::addOrder(OrderPtr order) {
             if (handler_) {
                 handler_->on_reject(order, "Price outside allowed band");
             }
-            Logger::warn("Order rejected (price band):", order_id, symbol,
+            LOGGER_WARN("Order rejected (price band):", order_id, symbol,
                          "price:", order->price(),
                          "last:", handler_ ? handler_->getLastPrice(symbol) : 0);
             return false;
         }
 
+        // 주문 전 리스크: 유저별 미체결 주문 수·명목금액·주문 수량 한도. 게이트웨이를 거치지
+        // 않는 MM·관리자 직접 경로도 여기서 걸린다. 시장가·가격 없는 주문은 반대편 최우선호가
+        // (비었으면 직전 체결가)로 명목을 잡고, collar로 가격이 정해지면 아래에서 다시 잡는다.
+        liquibook::book::Price risk_ref = 0;
+        if (risk_.enabled() && (order->price() == 0 || order->order_type() == "MARKET")) {
+            const liquibook::book::DepthLevel* best =
+                order->is_buy() ? book->depth().asks() : book->depth().bids();
+            if (best->order_count() != 0) {
+                risk_ref = best->price();
+            } else if (handler_) {
+                risk_ref = handler_->getLastPrice(symbol);
+            }
+        }
+        if (const char* reason = risk_.check(*order, risk_ref)) {
+            ++risk_rejects_;
+            lock.unlock();
+            if (handler_) {
+                handler_->on_reject(order, reason);
+            }
+            LOGGER_WARN("Order rejected (pre-trade risk):", order_id, symbol,
+                         "user:", order->user_id(), "reason:", reason);
+            return false;
+        }
+
+        // 인바운드 명령 하나(STP 취소 + add와 그 체결 전부)의 depth 변화는 끝에서 한 번만 발행.
+        // 주문/체결 콜백은 각 요청 안에서 그대로 수행된다.
+        book->hold_book_updates();
+
+        // 단일가 경매: halt 또는 개시 경매 중이면 매칭 없이 접수만 한다. 경매가 끝난 뒤
+        // 첫 명령은 모인 주문을 먼저 단일가로 체결한다(depth 발행은 이 명령과 합쳐 1회).
+        // 배치 경매 종목은 runDueAuctions의 구간 체결만 경매를 끝낸다.
+        if (halted || openingAuctionOpenUnsafe(symbol)) {
+            book->start_auction();
+        } else if (book->in_auction() && !batch_symbols_.count(symbol)) {
+            uncrossAuctionUnsafe(symbol, *book);
+        }
+
+        // 시장가 collar: 한 명령이 쓸어가는 가격 범위(=체결·콜백·발행 수)를 제한한다.
+        // STP보다 먼저 적용해 STP도 collar 가격까지만 자기 주문을 취소한다.
+        if (applyMarketCollarUnsafe(*book, order)) {
+            risk_.reprice(*order);
+        }
+
         // Self-Trade Prevention (cancel-oldest): 동일 유저의 반대편 resting 주문을
         // aggressor 추가 전에 취소해 자전체결을 원천 차단. MM 계정은 면제.
         applySelfTradePrevention(symbol, order);
@@ -297,13 +531,20 @@ bool EngineCore::addOrder(OrderPtr order) {
         // 버그라 무효다. 전달하지 않으면 IOC가 통째로 무시되어, 미체결 시장가 주문이
         // 취소되지 않고 북에 잔류한다 — MARKET SELL은 price=0으로 남아 이후 들어오는
         // 매수를 전부 쓸어간다.
+        const auto stops_before = book->stop_stats();
         book->add(order, order->conditions());
         book->perform_callbacks();
+        book->release_book_updates();
+        stops_triggered_ += book->stop_stats().triggered - stops_before.triggered;
+        stop_cascades_capped_ += book->stop_stats().capped - stops_before.capped;
+        // MATCHED는 첫 콜백에서 이미 찍힌다 (콜백 없는 경로를 위한 보정)
+        LatencyTracer::stamp(TraceStage::MATCHED);
+        LatencyTracer::stamp(TraceStage::CALLBACKS_DONE);
 
         ++total_orders_processed_;
 
         // Record processed order for dedup
-        processed_orders_[order_id] = std::chrono::steady_clock::now();
+        processed_orders_[order_id] = clock_->monotonicNow();
 
         // Periodic TTL cleanup (every 1000 orders)
         if (total_orders_processed_ % 1000 == 0) {
@@ -311,7 +552,7 @@ bool EngineCore::addOrder(OrderPtr order) {
         }
     }
 
-    Logger::debug("Order added:", order_id, symbol);
+    LOGGER_DEBUG("Order added:", order_id, symbol);
     return true;
 }
 
@@ -319,11 +560,12 @@ bool EngineCore::cancelOrder(const std::string& symbol,
                               const std::string& order_id) {
     {
         std::unique_lock<std::shared_mutex> lock(rw_mutex_);
+        LatencyTracer::stamp(TraceStage::LOCKED);
 
         auto order = findOrder(symbol, order_id);
         if (!order) {
             lock.unlock();
-            Logger::warn("Cancel failed - order not found:", order_id);
+            LOGGER_WARN("Cancel failed - order not found:", order_id);
             return false;
         }
 
@@ -332,12 +574,14 @@ bool EngineCore::cancelOrder(const std::string& symbol,
 
         it->second->cancel(order);
         it->second->perform_callbacks();
+        LatencyTracer::stamp(TraceStage::MATCHED);
+        LatencyTracer::stamp(TraceStage::CALLBACKS_DONE);
 
         // 주문 맵에서 제거
         order_maps_[symbol].erase(order_id);
     }
 
-    Logger::info("Order cancelled:", order_id);
+    LOGGER_INFO("Order cancelled:", order_id);
     return true;
 }
 
@@ -347,22 +591,36 @@ bool EngineCore::replaceOrder(const std::string& symbol,
                                liquibook::book::Price new_price) {
     {
         std::unique_lock<std::shared_mutex> lock(rw_mutex_);
+        LatencyTracer::stamp(TraceStage::LOCKED);
 
         auto order = findOrder(symbol, order_id);
         if (!order) {
             lock.unlock();
-            Logger::warn("Replace failed - order not found:", order_id);
+            LOGGER_WARN("Replace failed - order not found:", order_id);
             return false;
         }
 
         auto it = books_.find(symbol);
         if (it == books_.end()) return false;
 
+        // 정정으로 늘어나는 노출도 주문 전 리스크 한도 안이어야 한다
+        if (const char* reason = risk_.checkReplace(*order, qty_delta, new_price)) {
+            ++risk_rejects_;
+            lock.unlock();
+            if (handler_) {
+                handler_->on_replace_reject(order, reason);
+            }
+            LOGGER_WARN("Replace rejected (pre-trade risk):", order_id, "reason:", reason);
+            return false;
+        }
+
         it->second->replace(order, qty_delta, new_price);
         it->second->perform_callbacks();
+        LatencyTracer::stamp(TraceStage::MATCHED);
+        LatencyTracer::stamp(TraceStage::CALLBACKS_DONE);
     }
 
-    Logger::info("Order replaced:", order_id, "delta:", qty_delta, "price:", new_price);
+    LOGGER_INFO("Order replaced:", order_id, "delta:", qty_delta, "price:", new_price);
     return true;
 }
 
@@ -373,7 +631,7 @@ CancelAllResult EngineCore::cancelAllOrders(const std::string& symbol) {
 
     auto book_it = books_.find(symbol);
     if (book_it == books_.end()) {
-        Logger::warn("cancelAllOrders: no orderbook for", symbol);
+        LOGGER_WARN("cancelAllOrders: no orderbook for", symbol);
         return result;
     }
 
@@ -390,7 +648,8 @@ CancelAllResult EngineCore::cancelAllOrders(const std::string& symbol) {
         }
     }
 
-    // 각 주문에 대해 cancel + perform_callbacks 호출
+    // 각 주문에 대해 cancel + perform_callbacks 호출. depth는 전부 취소한 뒤 한 번만 발행.
+    book_it->second->hold_book_updates();
     for (const auto& [id, order] : orders_to_cancel) {
         try {
             book_it->second->cancel(order);
@@ -400,12 +659,13 @@ CancelAllResult EngineCore::cancelAllOrders(const std::string& symbol) {
             map_it->second.erase(id);
             result.cancelled_count++;
         } catch (const std::exception& e) {
-            Logger::error("cancelAllOrders failed for", id, ":", e.what());
+            LOGGER_ERROR("cancelAllOrders failed for", id, ":", e.what());
             result.failed_order_ids.push_back(id);
         }
     }
+    book_it->second->release_book_updates();
 
-    Logger::info("cancelAllOrders:", symbol,
+    LOGGER_INFO("cancelAllOrders:", symbol,
                  "cancelled:", result.cancelled_count,
                  "failed:", result.failed_order_ids.size());
     return result;
@@ -421,7 +681,7 @@ void EngineCore::removeFilledOrderUnsafe(const std::string& symbol,
     if (ord_it == sym_it->second.end()) return;
 
     sym_it->second.erase(ord_it);
-    Logger::info("Filled order removed from map:", order_id, "symbol:", symbol);
+    LOGGER_INFO("Filled order removed from map:", order_id, "symbol:", symbol);
 }
 
 std::string EngineCore::snapshotOrderBook(const std::string& symbol) {
@@ -431,26 +691,41 @@ std::string EngineCore::snapshotOrderBook(const std::string& symbol) {
     {
         std::shared_lock<std::shared_mutex> lock(rw_mutex_);
 
-        auto it = order_maps_.find(symbol);
-        if (it == order_maps_.end()) {
+        auto it = books_.find(symbol);
+        if (it == books_.end()) {
             return "";
         }
+        const OrderBook& book = *it->second;
 
         snapshot["symbol"] = symbol;
-        snapshot["timestamp"] = std::chrono::duration_cast<std::chrono::milliseconds>(
-            std::chrono::system_clock::now().time_since_epoch()).count();
+        snapshot["timestamp"] = clock_->nowMs();
 
+        // 주문은 북의 우선순위 순서(가격 → 단계 내 대기열)로 싣고 queue_seq를 매긴다.
+        // 복원은 queue_seq 순서로 대기열을 다시 쌓으므로 같은 가격의 FIFO가 보존된다.
+        // (order_maps_ 순회는 order_id 사전순이라 시간 우선순위를 잃는다)
         nlohmann::json orders = nlohmann::json::array();
-        for (const auto& [id, order] : it->second) {
-            if (order->open_qty() > 0) {
-                orders.push_back(order->toJson());
-            }
-        }
+        uint64_t queue_seq = 0;
+        auto append = [&](const OrderBook::Tracker& tracker) {
+            const OrderPtr& order = tracker.ptr();
+            if (order->open_qty() == 0) return;
+            nlohmann::json j = order->toJson();
+            j["queue_seq"] = ++queue_seq;
+            orders.push_back(std::move(j));
+        };
+        for (const auto& [price, tracker] : book.bids()) append(tracker);
+        for (const auto& [price, tracker] : book.asks()) append(tracker);
+        // 미발동 스톱도 발동 시 순서가 있으므로 같은 방식으로
+        for (const auto& [price, tracker] : book.stopBids()) append(tracker);
+        for (const auto& [price, tracker] : book.stopAsks()) append(tracker);
+        // 연쇄 상한에 걸려 발동만 되고 아직 제출되지 않은 스톱 (발동 순서)
+        for (const auto& tracker : book.pendingStops()) append(tracker);
         snapshot["orders"] = orders;
+        // 경매 중인 북은 교차해 있을 수 있다 — 복원 시 경매 상태로 올려 재개 때 단일가 체결
+        snapshot["auction"] = book.in_auction();
         order_count = orders.size();
     }
 
-    Logger::info("Snapshot created for:", symbol, "orders:", order_count);
+    LOGGER_INFO("Snapshot created for:", symbol, "orders:", order_count);
     return snapshot.dump();
 }
 
@@ -465,13 +740,29 @@ bool EngineCore::restoreOrderBook(const std::string& symbol,
         {
             std::unique_lock<std::shared_mutex> lock(rw_mutex_);
 
+            // MBO: 교체되는 북의 주문은 취소로 흘려 소비자 상태를 비운다
+            MboFeed* mbo = handler_ ? handler_->mboFeed() : nullptr;
+            auto old_book = books_.find(symbol);
+            if (mbo && old_book != books_.end()) {
+                for (const auto& [price, tracker] : old_book->second->bids()) mbo->onCancel(*tracker.ptr());
+                for (const auto& [price, tracker] : old_book->second->asks()) mbo->onCancel(*tracker.ptr());
+            }
+
             // 기존 오더북 제거
             books_.erase(symbol);
             order_maps_.erase(symbol);
+            risk_.reset(symbol);
 
             // 새 오더북 생성 (리스너 없이)
             auto book = std::make_shared<OrderBook>();
             book->set_symbol(symbol);
+            book->set_stop_cascade_limit(stop_cascade_limit_);
+            if (snapshot.value("auction", false)) {
+                book->start_auction();
+            }
+            if (batch_symbols_.count(symbol)) {
+                startBatchUnsafe(symbol, *book);
+            }
             books_[symbol] = book;
             order_maps_[symbol] = {};
 
@@ -479,6 +770,13 @@ bool EngineCore::restoreOrderBook(const std::string& symbol,
             total = orders.size();
             size_t count = 0;
             size_t restored = 0;
+            // 스냅샷 대기열 순서(queue_seq). 구 스냅샷(queue_seq 없음)은 접수 시각으로 대신한다.
+            struct Queued {
+                uint64_t seq;
+                OrderPtr order;
+            };
+            std::vector<Queued> queued;
+            queued.reserve(total);
 
             // 프로그레스 바 표시
             std::cout << "\r  Restoring " << symbol << ": [";
@@ -486,7 +784,7 @@ bool EngineCore::restoreOrderBook(const std::string& symbol,
 
             // 주문 복원 (리스너 없이 조용히)
             for (const auto& j : orders) {
-                auto order = Order::fromJson(j);
+                auto order = Order::fromJson(j, clock_);
 
                 // MM(마켓메이커) 주문은 복원하지 않음 — 고아 주문 누적 방지
                 const std::string& uid = order->user_id();
@@ -513,19 +811,7 @@ bool EngineCore::restoreOrderBook(const std::string& symbol,
                     order->setFilledQty(0);
                 }
 
-                order_maps_[symbol][order->order_id()] = order;
-                // 복원은 리스너를 붙이기 전에 수행되므로, 여기서 교차가 일어나면 on_fill이
-                // 호출되지 않아 Kinesis 체결 이벤트 없이 잔량만 소멸한다(무음 체결 = 미정산).
-                // 정상 스냅샷은 uncrossed여야 하므로 matched=true는 데이터 이상 신호다.
-                if (book->add(order)) {
-                    ++silent_restore_matches_;
-                    Logger::error("복원 중 교차 발생(무음 체결 위험):", symbol,
-                                  order->order_id(), "price:", order->price(),
-                                  "— 스냅샷이 uncrossed가 아님");
-                }
-                // 복원된 주문을 dedup에 시딩 — 앵커 리플레이가 같은 ADD를 재전달해도
-                // 북에 이중 등록되지 않는다(addOrder의 Layer 2와 이중 방어).
-                processed_orders_[order->order_id()] = std::chrono::steady_clock::now();
+                queued.push_back({j.value("queue_seq", uint64_t(0)), order});
                 ++restored;
 
                 // 프로그레스 업데이트
@@ -546,6 +832,47 @@ bool EngineCore::restoreOrderBook(const std::string& symbol,
                 }
             }
 
+            std::stable_sort(queued.begin(), queued.end(),
+                             [](const Queued& a, const Queued& b) {
+                if (a.seq != b.seq) return a.seq < b.seq;
+                return a.order->timestamp() < b.order->timestamp();
+            });
+
+            // 교차 없는 resting LIMIT 주문은 매칭을 우회해 한 번에 등재한다.
+            // 스톱/시장가 등은 기존처럼 개별 add (역시 대기열 순서로).
+            std::vector<OrderPtr> batch;
+            std::vector<OrderPtr> deferred;
+            batch.reserve(queued.size());
+            for (auto& q : queued) {
+                if (isBulkLoadable(*q.order)) {
+                    batch.push_back(std::move(q.order));
+                } else {
+                    deferred.push_back(std::move(q.order));
+                }
+            }
+
+            // 가격 단계·호가 집계를 한 번의 선형 패스로 구성. 정상 스냅샷은 uncrossed여야
+            // 하므로 교차 배치는 조용히 체결시키지 않고 복원 자체를 실패시킨다.
+            if (!bulkLoadUnsafe(symbol, *book, batch)) {
+                books_.erase(symbol);
+                order_maps_.erase(symbol);
+                return false;
+            }
+
+            for (const auto& order : deferred) {
+                order_maps_[symbol][order->order_id()] = order;
+                risk_.track(*order, 0);
+                // 복원은 리스너를 붙이기 전에 수행되므로, 여기서 교차가 일어나면 on_fill이
+                // 호출되지 않아 Kinesis 체결 이벤트 없이 잔량만 소멸한다(무음 체결 = 미정산).
+                if (book->add(order)) {
+                    ++silent_restore_matches_;
+                    LOGGER_ERROR("복원 중 교차 발생(무음 체결 위험):", symbol,
+                                  order->order_id(), "price:", order->price(),
+                                  "— 스냅샷이 uncrossed가 아님");
+                }
+                processed_orders_[order->order_id()] = clock_->monotonicNow();
+            }
+
             std::cout << "\r  Restoring " << symbol << ": [";
             for (int i = 0; i < 50; ++i) std::cout << "█";
             std::cout << "] " << restored << "/" << total
@@ -553,28 +880,93 @@ bool EngineCore::restoreOrderBook(const std::string& symbol,
                       << " ✓" << std::endl;
 
             // 리스너 등록 (복원 완료 후)
-            book->set_order_listener(handler_);
-            book->set_depth_listener(handler_);
-            book->set_bbo_listener(handler_);
+            book->set_listener(handler_);
         }
 
-        Logger::info("OrderBook restored:", symbol, "orders:", total - mm_skipped,
+        LOGGER_INFO("OrderBook restored:", symbol, "orders:", total - mm_skipped,
                      "mm_skipped:", mm_skipped);
         return true;
     } catch (const std::exception& e) {
-        Logger::error("Failed to restore orderbook:", e.what());
+        LOGGER_ERROR("Failed to restore orderbook:", e.what());
         return false;
     }
 }
 
+bool EngineCore::isBulkLoadable(const Order& order) {
+    return order.order_qty() > 0 && order.is_limit() &&
+           order.stop_price() == 0 && !order.immediate_or_cancel();
+}
+
+void EngineCore::sortByArrival(std::vector<OrderPtr>& orders) {
+    std::stable_sort(orders.begin(), orders.end(), [](const OrderPtr& a, const OrderPtr& b) {
+        return a->timestamp() < b->timestamp();
+    });
+}
+
+bool EngineCore::bulkLoadOrders(const std::string& symbol, std::vector<OrderPtr> orders) {
+    std::unique_lock<std::shared_mutex> lock(rw_mutex_);
+    auto book = getOrCreateBook(symbol);
+    if (!book) {
+        LOGGER_WARN("bulkLoadOrders: blocked symbol, skipped:", symbol);
+        return false;
+    }
+    if (!bulkLoadUnsafe(symbol, *book, orders)) {
+        return false;
+    }
+    total_orders_processed_ += orders.size();
+    LOGGER_INFO("OrderBook bulk loaded:", symbol, "orders:", orders.size());
+    return true;
+}
+
+bool EngineCore::bulkLoadUnsafe(const std::string& symbol, OrderBook& book,
+                                std::vector<OrderPtr>& orders) {
+    // 매수는 높은 가격부터, 매도는 낮은 가격부터. 같은 가격은 입력 순서가 시간 우선순위.
+    std::stable_sort(orders.begin(), orders.end(),
+                     [](const OrderPtr& a, const OrderPtr& b) {
+        if (a->is_buy() != b->is_buy()) return a->is_buy();
+        return a->is_buy() ? a->price() > b->price() : a->price() < b->price();
+    });
+
+    if (const char* reason = book.bulk_load(orders)) {
+        ++silent_restore_matches_;
+        LOGGER_ERROR("일괄 등재 거부:", symbol, "orders:", orders.size(), "—", reason);
+        return false;
+    }
+
+    auto& order_map = order_maps_[symbol];
+    const auto now = clock_->monotonicNow();
+    MboFeed* mbo = handler_ ? handler_->mboFeed() : nullptr;
+    for (const auto& order : orders) {
+        order_map[order->order_id()] = order;
+        // 리스너 없이 등재되었으므로 리스크 노출에 직접 넣는다
+        risk_.track(*order, 0);
+        // 복원된 주문을 dedup에 시딩 — 앵커 리플레이가 같은 ADD를 재전달해도
+        // 북에 이중 등록되지 않는다(addOrder의 Layer 2와 이중 방어).
+        processed_orders_[order->order_id()] = now;
+        // MBO: 리스너 콜백 없이 들어갔으므로 북 우선순위 순서로 ADD를 흘린다
+        if (mbo) mbo->onAdd(*order);
+    }
+    return true;
+}
+
 bool EngineCore::removeOrderBook(const std::string& symbol) {
     {
         std::unique_lock<std::shared_mutex> lock(rw_mutex_);
+        MboFeed* mbo = handler_ ? handler_->mboFeed() : nullptr;
+        auto it = books_.find(symbol);
+        if (mbo && it != books_.end()) {
+            for (const auto& [price, tracker] : it->second->bids()) mbo->onCancel(*tracker.ptr());
+            for (const auto& [price, tracker] : it->second->asks()) mbo->onCancel(*tracker.ptr());
+        }
         books_.erase(symbol);
         order_maps_.erase(symbol);
+        risk_.reset(symbol);
+        opening_until_.erase(symbol);
+        batch_due_.erase(symbol);
+        halted_batches_.erase(symbol);
     }
 
-    Logger::info("OrderBook removed:", symbol);
+    LOGGER_INFO("OrderBook removed:", symbol);
     return true;
 }
 
@@ -588,11 +980,48 @@ bool EngineCore::hasOrder(const std::string& symbol,
     return sym_it->second.find(order_id) != sym_it->second.end();
 }
 
+bool EngineCore::getDepth(const std::string& symbol, size_t levels,
+                          DepthView& out) const {
+    std::shared_lock<std::shared_mutex> lock(rw_mutex_);
+
+    auto it = books_.find(symbol);
+    if (it == books_.end()) return false;
+
+    const auto& full = it->second->full_depth();
+    full.ladder(true, levels, out.bids);
+    full.ladder(false, levels, out.asks);
+    return true;
+}
+
 size_t EngineCore::getSymbolCount() const {
     std::shared_lock<std::shared_mutex> lock(rw_mutex_);
     return books_.size();
 }
 
+EngineCounters EngineCore::getCounters() const {
+    std::shared_lock<std::shared_mutex> lock(rw_mutex_);
+    EngineCounters c;
+    c.orders_processed = total_orders_processed_;
+    c.trades_executed = total_trades_executed_;
+    c.duplicates_rejected = duplicates_rejected_;
+    c.self_trades_prevented = self_trades_prevented_;
+    c.price_band_rejects = price_band_rejects_;
+    c.vi_halt_rejects = vi_halt_rejects_;
+    c.silent_restore_matches = silent_restore_matches_;
+    c.stops_triggered = stops_triggered_;
+    c.stop_cascades_capped = stop_cascades_capped_;
+    c.auctions_uncrossed = auctions_uncrossed_;
+    c.auction_volume = auction_volume_;
+    c.batch_auctions = batch_auctions_;
+    c.market_orders_collared = market_orders_collared_;
+    c.risk_rejects = risk_rejects_;
+    c.symbols = books_.size();
+    for (const auto& [symbol, orders] : order_maps_) {
+        c.resting_orders += orders.size();
+    }
+    return c;
+}
+
 std::vector<std::string> EngineCore::getAllSymbols() const {
     std::shared_lock<std::shared_mutex> lock(rw_mutex_);
     std::vector<std::string> symbols;
@@ -605,7 +1034,7 @@ std::vector<std::string> EngineCore::getAllSymbols() const {
 
 void EngineCore::cleanupProcessedOrders() {
     // Called within locked section — evict entries older than DEDUP_TTL_SECONDS
-    auto now = std::chrono::steady_clock::now();
+    auto now = clock_->monotonicNow();
     size_t evicted = 0;
     for (auto it = processed_orders_.begin(); it != processed_orders_.end(); ) {
         auto age_s = std::chrono::duration_cast<std::chrono::seconds>(
@@ -618,7 +1047,7 @@ void EngineCore::cleanupProcessedOrders() {
         }
     }
     if (evicted > 0) {
-        Logger::info("Dedup cleanup: evicted", evicted, "entries,",
+        LOGGER_INFO("Dedup cleanup: evicted", evicted, "entries,",
                      processed_orders_.size(), "remaining");
     }
 }
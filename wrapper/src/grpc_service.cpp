@@ -1,14 +1,16 @@
 #include "grpc_service.h"
 #include "logger.h"
 #include "config.h"
+#include "latency_trace.h"
 #include <grpcpp/grpcpp.h>
 #include <cstdlib>
 
 namespace aws_wrapper {
 
-GrpcServiceImpl::GrpcServiceImpl(EngineCore* engine, RedisClient* redis)
+GrpcServiceImpl::GrpcServiceImpl(EngineCore* engine, RedisClient* redis, MboFeed* mbo_feed)
     : engine_(engine)
     , redis_(redis)
+    , mbo_feed_(mbo_feed)
     , auth_token_(Config::get("ENGINE_GRPC_TOKEN", ""))
     , start_time_(std::chrono::steady_clock::now()) {
     if (auth_token_.empty()) {
@@ -192,9 +194,122 @@ grpc::Status GrpcServiceImpl::CancelOrder(
     return grpc::Status::OK;
 }
 
+grpc::Status GrpcServiceImpl::GetDepth(
+    grpc::ServerContext* context,
+    const DepthRequest* request,
+    DepthResponse* response) {
+
+    // 공개 시세 조회(읽기 전용) — HealthCheck와 같이 인증 없이 허용한다.
+    const std::string& symbol = request->symbol();
+    if (symbol.empty()) {
+        response->set_success(false);
+        response->set_error("symbol is required");
+        return grpc::Status::OK;
+    }
+
+    size_t levels = request->levels() > 0 ? static_cast<size_t>(request->levels()) : 0;
+    DepthView view;
+    if (!engine_->getDepth(symbol, levels, view)) {
+        response->set_success(false);
+        response->set_error("Symbol not found");
+        return grpc::Status::OK;
+    }
+
+    auto fill = [](const liquibook::book::LadderStep& step, PriceLevel* level) {
+        level->set_price(static_cast<int64_t>(step.price));
+        level->set_quantity(static_cast<int64_t>(step.qty));
+        level->set_order_count(static_cast<int32_t>(step.order_count));
+        level->set_cumulative_quantity(static_cast<int64_t>(step.cumulative_qty));
+    };
+    for (const auto& step : view.bids) fill(step, response->add_bids());
+    for (const auto& step : view.asks) fill(step, response->add_asks());
+    response->set_success(true);
+    return grpc::Status::OK;
+}
+
+grpc::Status GrpcServiceImpl::RecoverMbo(
+    grpc::ServerContext* context,
+    const MboRecoverRequest* request,
+    MboRecoverResponse* response) {
+
+    // 주문 단위 데이터(주문 ID 포함)이므로 관리 채널 인증을 요구한다.
+    if (!authorize(context, "RecoverMbo"))
+        return grpc::Status(grpc::StatusCode::UNAUTHENTICATED, "invalid or missing x-engine-token");
+
+    if (!mbo_feed_) {
+        response->set_success(false);
+        response->set_error("MBO feed disabled");
+        return grpc::Status::OK;
+    }
+
+    std::string data;
+    if (!mbo_feed_->recover(request->symbol(), request->from_seq(), data)) {
+        response->set_success(false);
+        response->set_error("Symbol not found or MBO events dropped (resync via CreateSnapshot)");
+        return grpc::Status::OK;
+    }
+
+    response->set_success(true);
+    response->set_data(data);
+    return grpc::Status::OK;
+}
+
+grpc::Status GrpcServiceImpl::DumpTraces(
+    grpc::ServerContext* context,
+    const TraceDumpRequest* request,
+    TraceDumpResponse* response) {
+
+    // 주문 ID가 실리므로 관리 채널 인증을 요구한다.
+    if (!authorize(context, "DumpTraces"))
+        return grpc::Status(grpc::StatusCode::UNAUTHENTICATED, "invalid or missing x-engine-token");
+
+    const auto& tracer = LatencyTracer::instance();
+    size_t max = request->max_traces() > 0 ? request->max_traces() : 100;
+    for (const auto& t : tracer.recent(max)) {
+        auto* rec = response->add_traces();
+        rec->set_symbol(t.symbol);
+        rec->set_order_id(t.order_id);
+        rec->set_wall_time_ms(t.wall_time_ms);
+        auto stage = [&t](TraceStage s) { return t.stage_ns[static_cast<size_t>(s)]; };
+        rec->set_decoded_ns(stage(TraceStage::DECODED));
+        rec->set_locked_ns(stage(TraceStage::LOCKED));
+        rec->set_matched_ns(stage(TraceStage::MATCHED));
+        rec->set_callbacks_done_ns(stage(TraceStage::CALLBACKS_DONE));
+        rec->set_published_ns(stage(TraceStage::PUBLISHED));
+        rec->set_depth_written_ns(stage(TraceStage::DEPTH_WRITTEN));
+        rec->set_kinesis_ns(t.io_ns[static_cast<size_t>(TraceIo::KINESIS)]);
+        rec->set_kinesis_calls(t.io_calls[static_cast<size_t>(TraceIo::KINESIS)]);
+        rec->set_redis_ns(t.io_ns[static_cast<size_t>(TraceIo::REDIS)]);
+        rec->set_redis_calls(t.io_calls[static_cast<size_t>(TraceIo::REDIS)]);
+        rec->set_total_ns(t.total_ns);
+    }
+
+    for (size_t s = 0; s < LatencyTracer::SPAN_COUNT; ++s) {
+        auto span = static_cast<LatencyTracer::Span>(s);
+        const auto& hist = tracer.span(span);
+        auto* stage = response->add_stages();
+        stage->set_stage(LatencyTracer::spanName(span));
+        stage->set_count(hist.count());
+        stage->set_p50_ns(hist.percentile(0.5));
+        stage->set_p99_ns(hist.percentile(0.99));
+        stage->set_p999_ns(hist.percentile(0.999));
+        stage->set_max_ns(hist.maxNs());
+    }
+
+    auto dominant = LatencyTracer::COMP_LOCK_WAIT;
+    for (size_t c = 1; c < LatencyTracer::COMP_COUNT; ++c) {
+        auto comp = static_cast<LatencyTracer::Component>(c);
+        if (tracer.dominantCount(comp) > tracer.dominantCount(dominant)) dominant = comp;
+    }
+    response->set_traced_total(tracer.tracedCount());
+    response->set_dominant_component(tracer.tracedCount() > 0
+        ? LatencyTracer::componentName(dominant) : "");
+    return grpc::Status::OK;
+}
+
 // GrpcService implementation
-GrpcService::GrpcService(EngineCore* engine, RedisClient* redis)
-    : service_(std::make_unique<GrpcServiceImpl>(engine, redis)) {
+GrpcService::GrpcService(EngineCore* engine, RedisClient* redis, MboFeed* mbo_feed)
+    : service_(std::make_unique<GrpcServiceImpl>(engine, redis, mbo_feed)) {
 }
 
 GrpcService::~GrpcService() {
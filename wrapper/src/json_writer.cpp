@@ -0,0 +1,200 @@
+#include "json_writer.h"
+
+namespace aws_wrapper {
+
+namespace {
+
+constexpr char HEX[] = "0123456789abcdef";
+
+inline bool needsEscape(unsigned char c) {
+    return c < 0x20 || c == '"' || c == '\\';
+}
+
+} // namespace
+
+void JsonWriter::appendEscaped(std::string_view s) {
+    size_t run_start = 0;
+    for (size_t i = 0; i < s.size(); ++i) {
+        unsigned char c = static_cast<unsigned char>(s[i]);
+        if (!needsEscape(c)) continue;
+        // 이스케이프 없는 구간은 한 번에 복사
+        out_.append(s.data() + run_start, i - run_start);
+        run_start = i + 1;
+        switch (c) {
+        case '"':  out_.append("\\\"", 2); break;
+        case '\\': out_.append("\\\\", 2); break;
+        case '\b': out_.append("\\b", 2); break;
+        case '\f': out_.append("\\f", 2); break;
+        case '\n': out_.append("\\n", 2); break;
+        case '\r': out_.append("\\r", 2); break;
+        case '\t': out_.append("\\t", 2); break;
+        default: {
+            char esc[6] = {'\\', 'u', '0', '0', HEX[c >> 4], HEX[c & 0x0f]};
+            out_.append(esc, 6);
+            break;
+        }
+        }
+    }
+    out_.append(s.data() + run_start, s.size() - run_start);
+}
+
+std::string_view JsonWriter::isoSecondUtc(std::time_t t) {
+    thread_local std::time_t cached_sec = -1;
+    thread_local char cached[24];
+    thread_local size_t cached_len = 0;
+
+    if (t != cached_sec) {
+        std::tm tm_now{};
+#ifdef _WIN32
+        gmtime_s(&tm_now, &t);
+#else
+        gmtime_r(&t, &tm_now);
+#endif
+        cached_len = std::strftime(cached, sizeof(cached), "%Y-%m-%dT%H:%M:%SZ", &tm_now);
+        cached_sec = t;
+    }
+    return std::string_view(cached, cached_len);
+}
+
+// 키는 nlohmann dump()와 같게 사전순으로 쓴다.
+
+void writeFillJson(std::string& out,
+                   const std::string& symbol,
+                   const std::string& order_id,
+                   const std::string& matched_order_id,
+                   const std::string& buyer_id,
+                   const std::string& seller_id,
+                   uint64_t qty,
+                   uint64_t price,
+                   bool buyer_fully_filled,
+                   bool seller_fully_filled,
+                   bool buyer_is_maker,
+                   int64_t timestamp_ms) {
+    JsonWriter w(out);
+    w.beginObject();
+
+    w.key("buyer");
+    w.beginObject();
+    w.key("fully_filled"); w.value(buyer_fully_filled);
+    w.key("is_maker");     w.value(buyer_is_maker);
+    w.key("order_id");     w.value(order_id);
+    w.key("user_id");      w.value(buyer_id);
+    w.endObject();
+
+    w.key("event");       w.value("FILL");
+    w.key("executed_at");
+    w.value(JsonWriter::isoSecondUtc(static_cast<std::time_t>(timestamp_ms / 1000)));
+    w.key("price");       w.value(price);
+    w.key("quantity");    w.value(qty);
+
+    w.key("seller");
+    w.beginObject();
+    w.key("fully_filled"); w.value(seller_fully_filled);
+    w.key("is_maker");     w.value(!buyer_is_maker);
+    w.key("order_id");     w.value(matched_order_id);
+    w.key("user_id");      w.value(seller_id);
+    w.endObject();
+
+    w.key("symbol");      w.value(symbol);
+    w.key("timestamp");   w.value(timestamp_ms);
+
+    w.key("trade_id");    w.valueJoined(order_id, "_", matched_order_id);
+    w.endObject();
+}
+
+void writeOrderStatusJson(std::string& out,
+                          const std::string& symbol,
+                          const std::string& order_id,
+                          const std::string& user_id,
+                          const std::string& status,
+                          const std::string& reason,
+                          uint64_t price,
+                          uint64_t quantity,
+                          bool is_buy,
+                          const std::string& order_type,
+                          int64_t timestamp_ms) {
+    // 주문 정보(price/quantity/side/type)는 quantity > 0일 때만, reason은 있을 때만
+    const bool has_order_info = quantity > 0;
+
+    JsonWriter w(out);
+    w.beginObject();
+    w.key("event");     w.value("ORDER_STATUS");
+    w.key("order_id");  w.value(order_id);
+    if (has_order_info) {
+        w.key("price");     w.value(price);
+        w.key("quantity");  w.value(quantity);
+    }
+    if (!reason.empty()) {
+        w.key("reason");    w.value(reason);
+    }
+    if (has_order_info) {
+        w.key("side");      w.value(is_buy ? "BUY" : "SELL");
+    }
+    w.key("status");    w.value(status);
+    w.key("symbol");    w.value(symbol);
+    w.key("timestamp"); w.value(timestamp_ms);
+    if (has_order_info) {
+        w.key("type");      w.value(order_type.empty() ? std::string_view("LIMIT")
+                                                       : std::string_view(order_type));
+    }
+    w.key("user_id");   w.value(user_id);
+    w.endObject();
+}
+
+namespace {
+
+void writeLevels(JsonWriter& w, const std::vector<liquibook::book::DepthLevel>& levels) {
+    w.beginArray();
+    for (const auto& level : levels) {
+        w.beginArray();
+        w.value(static_cast<uint64_t>(level.price()));
+        w.value(static_cast<uint64_t>(level.aggregate_qty()));
+        w.endArray();
+    }
+    w.endArray();
+}
+
+} // namespace
+
+void writeDepthJson(std::string& out,
+                    const std::string& symbol,
+                    const std::vector<liquibook::book::DepthLevel>& bids,
+                    const std::vector<liquibook::book::DepthLevel>& asks,
+                    uint64_t last_price,
+                    int64_t timestamp_ms) {
+    JsonWriter w(out);
+    w.beginObject();
+    w.key("a"); writeLevels(w, asks);
+    w.key("b"); writeLevels(w, bids);
+    w.key("e"); w.value("d");
+    w.key("p"); w.value(last_price);
+    w.key("s"); w.value(symbol);
+    w.key("t"); w.value(timestamp_ms);
+    w.endObject();
+}
+
+void writeTickerJson(std::string& out, const std::string& symbol,
+                     uint64_t price, int64_t timestamp_ms) {
+    JsonWriter w(out);
+    w.beginObject();
+    w.key("e"); w.value("t");
+    w.key("p"); w.value(price);
+    w.key("s"); w.value(symbol);
+    w.key("t"); w.value(timestamp_ms);
+    w.endObject();
+}
+
+void writeOhlcJson(std::string& out, uint64_t open, uint64_t high, uint64_t low,
+                   uint64_t close, uint64_t volume, int64_t epoch_sec) {
+    JsonWriter w(out);
+    w.beginObject();
+    w.key("c"); w.value(close);
+    w.key("h"); w.value(high);
+    w.key("l"); w.value(low);
+    w.key("o"); w.value(open);
+    w.key("t"); w.value(epoch_sec);
+    w.key("v"); w.value(volume);
+    w.endObject();
+}
+
+} // namespace aws_wrapper
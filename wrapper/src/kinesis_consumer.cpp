@@ -2,6 +2,7 @@
 #include "checkpoint_manager.h"
 #include "logger.h"
 #include "config.h"
+#include "latency_trace.h"
 #include <aws/core/Aws.h>
 #include <aws/kinesis/model/GetShardIteratorRequest.h>
 #include <aws/kinesis/model/GetRecordsRequest.h>
@@ -24,7 +25,7 @@ KinesisConsumer::KinesisConsumer(const std::string& stream_name,
 
     client_ = std::make_unique<Aws::Kinesis::KinesisClient>(config);
 
-    Logger::info("KinesisConsumer created, stream:", stream_name_, "region:", region_,
+    LOGGER_INFO("KinesisConsumer created, stream:", stream_name_, "region:", region_,
                  "connectTimeout:", config.connectTimeoutMs, "requestTimeout:", config.requestTimeoutMs,
                  "tcpKeepAlive:", config.enableTcpKeepAlive ? "ON" : "OFF");
 }
@@ -47,12 +48,12 @@ std::string KinesisConsumer::getShardIterator(const std::string& shard_id) {
 
     auto outcome = client_->GetShardIterator(request);
     if (!outcome.IsSuccess()) {
-        Logger::error("Failed to get shard iterator for", shard_id, ":",
+        LOGGER_ERROR("Failed to get shard iterator for", shard_id, ":",
                       outcome.GetError().GetMessage());
         return "";
     }
 
-    Logger::info("Got LATEST shard iterator for:", shard_id);
+    LOGGER_INFO("Got LATEST shard iterator for:", shard_id);
     return outcome.GetResult().GetShardIterator();
 }
 
@@ -68,21 +69,21 @@ std::string KinesisConsumer::getShardIteratorWithCheckpoint(const std::string& s
         // 체크포인트 복구: AFTER_SEQUENCE_NUMBER
         request.SetShardIteratorType(Aws::Kinesis::Model::ShardIteratorType::AFTER_SEQUENCE_NUMBER);
         request.SetStartingSequenceNumber(last_seq);
-        Logger::info("Resuming shard", shard_id, "from checkpoint:", last_seq.substr(0, 30) + "...");
+        LOGGER_INFO("Resuming shard", shard_id, "from checkpoint:", last_seq.substr(0, 30) + "...");
     } else {
         // 체크포인트 없음: LATEST (첫 시작)
         request.SetShardIteratorType(Aws::Kinesis::Model::ShardIteratorType::LATEST);
-        Logger::info("Starting shard", shard_id, "from LATEST (no checkpoint)");
+        LOGGER_INFO("Starting shard", shard_id, "from LATEST (no checkpoint)");
     }
 
     auto outcome = client_->GetShardIterator(request);
     if (!outcome.IsSuccess()) {
-        Logger::error("Failed to get shard iterator for", shard_id, ":",
+        LOGGER_ERROR("Failed to get shard iterator for", shard_id, ":",
                       outcome.GetError().GetMessage());
 
         // 체크포인트 기반 복구 실패 시 LATEST로 폴백
         if (!last_seq.empty()) {
-            Logger::warn("Checkpoint recovery failed, falling back to LATEST for", shard_id);
+            LOGGER_WARN("Checkpoint recovery failed, falling back to LATEST for", shard_id);
             request.SetShardIteratorType(Aws::Kinesis::Model::ShardIteratorType::LATEST);
             request.SetStartingSequenceNumber("");
 
@@ -113,7 +114,7 @@ void KinesisConsumer::start() {
 
         auto desc_outcome = client_->DescribeStream(desc_request);
         if (!desc_outcome.IsSuccess()) {
-            Logger::error("Failed to describe stream:", desc_outcome.GetError().GetMessage());
+            LOGGER_ERROR("Failed to describe stream:", desc_outcome.GetError().GetMessage());
             return;
         }
 
@@ -126,26 +127,26 @@ void KinesisConsumer::start() {
 
         if (desc.GetHasMoreShards() && !shards.empty()) {
             exclusive_start_shard_id = shards.back().GetShardId();
-            Logger::info("DescribeStream has more shards, continuing from:", exclusive_start_shard_id);
+            LOGGER_INFO("DescribeStream has more shards, continuing from:", exclusive_start_shard_id);
         } else {
             break;
         }
     } while (true);
 
     if (all_shards.empty()) {
-        Logger::error("No shards found in stream:", stream_name_);
+        LOGGER_ERROR("No shards found in stream:", stream_name_);
         return;
     }
 
-    Logger::info("Found", all_shards.size(), "shard(s) in stream:", stream_name_);
-    Logger::info("Checkpoint enabled:", checkpoint_enabled_ ? "YES" : "NO");
+    LOGGER_INFO("Found", all_shards.size(), "shard(s) in stream:", stream_name_);
+    LOGGER_INFO("Checkpoint enabled:", checkpoint_enabled_ ? "YES" : "NO");
 
     for (const auto& shard : all_shards) {
         std::string shard_id = shard.GetShardId();
 
         // 닫힌 shard는 건너뛰기 (ending sequence number가 있으면 닫힘)
         if (!shard.GetSequenceNumberRange().GetEndingSequenceNumber().empty()) {
-            Logger::info("Skipping closed shard:", shard_id);
+            LOGGER_INFO("Skipping closed shard:", shard_id);
             continue;
         }
 
@@ -153,30 +154,30 @@ void KinesisConsumer::start() {
         if (!it.empty()) {
             shard_iterators_[shard_id] = it;
             shard_iterator_created_[shard_id] = std::chrono::steady_clock::now();
-            Logger::info("Shard iterator acquired:", shard_id);
+            LOGGER_INFO("Shard iterator acquired:", shard_id);
         } else {
-            Logger::error("Failed to get iterator for shard:", shard_id);
+            LOGGER_ERROR("Failed to get iterator for shard:", shard_id);
         }
     }
 
     if (shard_iterators_.empty()) {
-        Logger::error("Failed to get any shard iterators");
+        LOGGER_ERROR("Failed to get any shard iterators");
         return;
     }
 
-    Logger::info("Active shard iterators:", shard_iterators_.size());
+    LOGGER_INFO("Active shard iterators:", shard_iterators_.size());
 
     running_ = true;
     draining_ = false;
     worker_ = std::thread(&KinesisConsumer::consumeLoop, this);
 
-    Logger::info("KinesisConsumer started, stream:", stream_name_);
+    LOGGER_INFO("KinesisConsumer started, stream:", stream_name_);
 }
 
 void KinesisConsumer::stop() {
     if (!running_) return;
 
-    Logger::info("KinesisConsumer stopping - initiating graceful shutdown");
+    LOGGER_INFO("KinesisConsumer stopping - initiating graceful shutdown");
 
     // 1. 새 레코드 수신 중단 (worker는 다음 루프에서 running_=false를 보고 빠져나온다)
     draining_ = true;
@@ -196,7 +197,7 @@ void KinesisConsumer::stop() {
     if (worker_.joinable()) {
         auto future = std::async(std::launch::async, [this]() { worker_.join(); });
         if (future.wait_for(std::chrono::seconds(join_wait_s)) == std::future_status::timeout) {
-            Logger::error("KinesisConsumer worker did not exit within", join_wait_s,
+            LOGGER_ERROR("KinesisConsumer worker did not exit within", join_wait_s,
                           "s - detaching (client_ 유지: reset 시 UAF 위험)");
             worker_.detach();
             detached_ = true;
@@ -214,19 +215,15 @@ void KinesisConsumer::stop() {
 
     // 4. 마지막 체크포인트 저장 — join 이후에만 last_sequence_numbers_ 접근(경쟁 방지).
     if (joined && checkpoint_enabled_ && checkpoint_manager_) {
-        Logger::info("Flushing final checkpoints...");
-        for (const auto& [shard_id, seq] : last_sequence_numbers_) {
-            if (!seq.empty()) {
-                checkpoint_manager_->checkpointImmediate(shard_id, seq);
-            }
-        }
-        checkpoint_manager_->flush();
-        Logger::info("Final checkpoints saved");
+        LOGGER_INFO("Flushing final checkpoints...");
+        // 전 샤드를 MSET 한 번으로 (샤드별 왕복 없음)
+        checkpoint_manager_->checkpointBatch(last_sequence_numbers_);
+        LOGGER_INFO("Final checkpoints saved");
     } else if (!joined) {
-        Logger::warn("Skipping checkpoint flush — worker detached (상태 불확실)");
+        LOGGER_WARN("Skipping checkpoint flush — worker detached (상태 불확실)");
     }
 
-    Logger::info("KinesisConsumer stopped, records processed:", records_processed_.load());
+    LOGGER_INFO("KinesisConsumer stopped, records processed:", records_processed_.load());
 }
 
 std::map<std::string, std::string> KinesisConsumer::getShardPositions() const {
@@ -236,7 +233,7 @@ std::map<std::string, std::string> KinesisConsumer::getShardPositions() const {
 }
 
 void KinesisConsumer::restart() {
-    Logger::warn("KinesisConsumer restarting...");
+    LOGGER_WARN("KinesisConsumer restarting...");
     stop();
     std::this_thread::sleep_for(std::chrono::seconds(1));
 
@@ -246,7 +243,7 @@ void KinesisConsumer::restart() {
     //  ③ running_=true 복원으로 구 worker 루프가 부활 → 같은 스트림 이중 소비(주문 이중 처리)
     // 상태를 안전하게 되돌릴 방법이 없으므로 프로세스를 종료해 systemd 재시작에 위임한다.
     if (detached_) {
-        Logger::error("이전 worker가 detach된 상태 — 안전한 재시작 불가. "
+        LOGGER_ERROR("이전 worker가 detach된 상태 — 안전한 재시작 불가. "
                       "프로세스를 종료해 systemd 재시작에 위임합니다.");
         std::_Exit(EXIT_FAILURE);
     }
@@ -264,12 +261,12 @@ void KinesisConsumer::restart() {
     last_sequence_numbers_.clear();
 
     start();
-    Logger::info("KinesisConsumer restarted successfully");
+    LOGGER_INFO("KinesisConsumer restarted successfully");
 }
 
 void KinesisConsumer::drainQueue() {
     // Graceful shutdown 시 잔여 메시지 처리
-    Logger::info("Draining queue (timeout:", drain_timeout_seconds_, "s)...");
+    LOGGER_INFO("Draining queue (timeout:", drain_timeout_seconds_, "s)...");
 
     auto start = std::chrono::steady_clock::now();
     int drained = 0;
@@ -279,7 +276,7 @@ void KinesisConsumer::drainQueue() {
             std::chrono::steady_clock::now() - start).count();
 
         if (elapsed >= drain_timeout_seconds_) {
-            Logger::warn("Drain timeout reached, stopping");
+            LOGGER_WARN("Drain timeout reached, stopping");
             break;
         }
 
@@ -296,6 +293,7 @@ void KinesisConsumer::drainQueue() {
             if (!outcome.IsSuccess()) {
                 continue;
             }
+            LatencyTracer::markFetched();
 
             const auto& result = outcome.GetResult();
             iterator = result.GetNextShardIterator();
@@ -312,7 +310,7 @@ void KinesisConsumer::drainQueue() {
                     try {
                         callback_(record.GetPartitionKey(), value);
                     } catch (const std::exception& e) {
-                        Logger::error("Drain callback error:", e.what());
+                        LOGGER_ERROR("Drain callback error:", e.what());
                     }
                 }
 
@@ -329,7 +327,7 @@ void KinesisConsumer::drainQueue() {
         }
     }
 
-    Logger::info("Drained", drained, "records");
+    LOGGER_INFO("Drained", drained, "records");
 }
 
 int KinesisConsumer::countActiveIterators() const {
@@ -353,7 +351,7 @@ void KinesisConsumer::consumeLoop() {
         auto now_steady = std::chrono::steady_clock::now();
         if (std::chrono::duration_cast<std::chrono::seconds>(now_steady - last_heartbeat).count()
             >= HEARTBEAT_INTERVAL_SECONDS) {
-            Logger::info("KinesisConsumer heartbeat: polling", shard_iterators_.size(),
+            LOGGER_INFO("KinesisConsumer heartbeat: polling", shard_iterators_.size(),
                          "shards, active iterators:", countActiveIterators(),
                          "records:", records_processed_.load(),
                          "poll_count:", poll_count);
@@ -369,15 +367,15 @@ void KinesisConsumer::consumeLoop() {
             if (created_it != shard_iterator_created_.end()) {
                 auto elapsed = std::chrono::duration_cast<std::chrono::seconds>(now - created_it->second).count();
                 if (elapsed >= ITERATOR_REFRESH_SECONDS) {
-                    Logger::info("Proactive iterator refresh for", shard_id, "after", elapsed, "seconds");
+                    LOGGER_INFO("Proactive iterator refresh for", shard_id, "after", elapsed, "seconds");
                     std::string new_iterator = getShardIterator(shard_id);
                     if (!new_iterator.empty()) {
                         iterator = new_iterator;
                         shard_iterator_created_[shard_id] = now;
-                        Logger::info("Iterator proactively refreshed for", shard_id);
+                        LOGGER_INFO("Iterator proactively refreshed for", shard_id);
                     } else {
                         // Fix 5: 실패 시 30초 후 재시도 (즉시 재시도 방지)
-                        Logger::warn("Failed to proactively refresh iterator for", shard_id, "- will retry in 30s");
+                        LOGGER_WARN("Failed to proactively refresh iterator for", shard_id, "- will retry in 30s");
                         shard_iterator_created_[shard_id] = now - std::chrono::seconds(ITERATOR_REFRESH_SECONDS - 30);
                     }
                 }
@@ -385,14 +383,14 @@ void KinesisConsumer::consumeLoop() {
 
             if (iterator.empty()) {
                 // 빈 iterator 즉시 갱신 시도 (지연 없음)
-                Logger::warn("Shard iterator empty for:", shard_id, "- immediate refresh");
+                LOGGER_WARN("Shard iterator empty for:", shard_id, "- immediate refresh");
                 std::string new_iterator = getShardIterator(shard_id);
                 if (!new_iterator.empty()) {
                     iterator = new_iterator;
                     shard_iterator_created_[shard_id] = std::chrono::steady_clock::now();
-                    Logger::info("Iterator recovered for", shard_id);
+                    LOGGER_INFO("Iterator recovered for", shard_id);
                 } else {
-                    Logger::error("Failed to refresh iterator for", shard_id);
+                    LOGGER_ERROR("Failed to refresh iterator for", shard_id);
                     std::this_thread::sleep_for(std::chrono::milliseconds(500));
                 }
                 continue;
@@ -416,7 +414,7 @@ void KinesisConsumer::consumeLoop() {
                 std::string error_msg = error.GetMessage();
 
                 // 모든 에러 케이스에서 상세 로깅 및 iterator 갱신 시도
-                Logger::warn("GetRecords failed for", shard_id,
+                LOGGER_WARN("GetRecords failed for", shard_id,
                              "type:", error_type, "msg:", error_msg);
 
                 // 모든 실패 케이스에서 Iterator 갱신 시도
@@ -424,9 +422,9 @@ void KinesisConsumer::consumeLoop() {
                 if (!new_iterator.empty()) {
                     iterator = new_iterator;
                     shard_iterator_created_[shard_id] = std::chrono::steady_clock::now();
-                    Logger::info("Iterator refreshed after error for", shard_id);
+                    LOGGER_INFO("Iterator refreshed after error for", shard_id);
                 } else {
-                    Logger::error("Failed to refresh iterator for", shard_id);
+                    LOGGER_ERROR("Failed to refresh iterator for", shard_id);
                 }
 
                 // 에러 발생 시 잠시 대기하되 running_ 체크
@@ -435,25 +433,26 @@ void KinesisConsumer::consumeLoop() {
                 }
                 continue;
             }
+            LatencyTracer::markFetched();  // 이 배치 레코드들의 FETCHED 시각
 
             const auto& result = outcome.GetResult();
             std::string next_iterator = result.GetNextShardIterator();
 
             if (next_iterator.empty()) {
                 // next_iterator가 빈 문자열이면 즉시 새 iterator 획득
-                Logger::warn("NextIterator empty for:", shard_id, "- refreshing immediately");
+                LOGGER_WARN("NextIterator empty for:", shard_id, "- refreshing immediately");
                 std::string fresh_iterator = getShardIterator(shard_id);
                 if (!fresh_iterator.empty()) {
                     iterator = fresh_iterator;
                     shard_iterator_created_[shard_id] = std::chrono::steady_clock::now();
-                    Logger::info("Iterator refreshed after empty next for", shard_id);
+                    LOGGER_INFO("Iterator refreshed after empty next for", shard_id);
                 } else {
-                    Logger::error("Failed to get fresh iterator for", shard_id);
+                    LOGGER_ERROR("Failed to get fresh iterator for", shard_id);
                     iterator = "";  // 다음 루프에서 즉시 복구 시도
                 }
             } else {
                 if (poll_count % 100 == 0 && shard_id == shard_iterators_.begin()->first) {
-                    Logger::debug("Shard polling active, records:", result.GetRecords().size());
+                    LOGGER_DEBUG("Shard polling active, records:", result.GetRecords().size());
                 }
                 iterator = next_iterator;
             }
@@ -466,7 +465,7 @@ void KinesisConsumer::consumeLoop() {
                 std::string partition_key = record.GetPartitionKey();
                 std::string sequence_number = record.GetSequenceNumber();
 
-                Logger::debug(">>> Received Kinesis record, shard:", shard_id,
+                LOGGER_DEBUG(">>> Received Kinesis record, shard:", shard_id,
                               "key:", partition_key, "len:", data.GetLength());
 
                 if (callback_) {
@@ -485,7 +484,7 @@ void KinesisConsumer::consumeLoop() {
                             checkpoint_manager_->checkpoint(shard_id, sequence_number);
                         }
                     } catch (const std::exception& e) {
-                        Logger::error("Callback error:", e.what());
+                        LOGGER_ERROR("Callback error:", e.what());
                     }
                 }
             }
@@ -1,6 +1,9 @@
 #include "kinesis_producer.h"
 #include "config.h"
+#include "json_writer.h"
 #include "logger.h"
+#include "metrics.h"
+#include "latency_trace.h"
 #include <aws/core/Aws.h>
 #include <aws/kinesis/model/PutRecordRequest.h>
 #include <chrono>
@@ -37,8 +40,9 @@ KinesisProducer::KinesisProducer(const std::string& region) {
     trades_stream_ = Config::get("KINESIS_TRADES_STREAM", "supernoba-trades");
     depth_stream_ = Config::get("KINESIS_DEPTH_STREAM", "supernoba-depth");
     status_stream_ = Config::get("KINESIS_STATUS_STREAM", "supernoba-order-status");
+    mbo_stream_ = Config::get("KINESIS_MBO_STREAM", "supernoba-mbo");
     
-    Logger::info("KinesisProducer created, region:", region);
+    LOGGER_INFO("KinesisProducer created, region:", region);
 }
 
 KinesisProducer::~KinesisProducer() {
@@ -47,7 +51,8 @@ KinesisProducer::~KinesisProducer() {
 
 void KinesisProducer::produce(const std::string& stream_name,
                                const std::string& partition_key,
-                               const std::string& data) {
+                               const std::string& data,
+                               bool use_wal) {
     constexpr int MAX_RETRIES = 3;
     constexpr int RETRY_DELAY_MS = 100;  // 100, 200, 400ms
 
@@ -61,19 +66,22 @@ void KinesisProducer::produce(const std::string& stream_name,
 
     bool success = false;
     std::string last_error;
+    // 주문 처리 중 발행이면 해당 주문 트레이스의 Kinesis I/O로 누적
+    const uint64_t trace_start = LatencyTracer::active() ? TraceClock::now() : 0;
 
     for (int attempt = 0; attempt < MAX_RETRIES; ++attempt) {
         auto outcome = client_->PutRecord(request);
 
         if (outcome.IsSuccess()) {
             success = true;
+            LatencyTracer::stamp(TraceStage::PUBLISHED);
             auto end = std::chrono::steady_clock::now();
             auto elapsed_ms = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
 
             if (elapsed_ms > 1000) {
-                Logger::warn("[SLOW] PutRecord to", stream_name, "took", elapsed_ms, "ms");
+                LOGGER_WARN("[SLOW] PutRecord to", stream_name, "took", elapsed_ms, "ms");
             }
-            Logger::debug("Published to", stream_name, "shard:",
+            LOGGER_DEBUG("Published to", stream_name, "shard:",
                           outcome.GetResult().GetShardId(), "in", elapsed_ms, "ms");
             break;
         }
@@ -81,19 +89,30 @@ void KinesisProducer::produce(const std::string& stream_name,
         last_error = outcome.GetError().GetMessage();
         if (attempt < MAX_RETRIES - 1) {
             int delay = RETRY_DELAY_MS * (1 << attempt);  // exponential backoff
-            Logger::warn("Kinesis retry", attempt + 1, "for", stream_name, "in", delay, "ms");
+            LOGGER_WARN("Kinesis retry", attempt + 1, "for", stream_name, "in", delay, "ms");
             std::this_thread::sleep_for(std::chrono::milliseconds(delay));
         }
     }
 
+    if (trace_start != 0) {
+        LatencyTracer::addIo(TraceIo::KINESIS, TraceClock::now() - trace_start);
+    }
+
+    // 발행 지연: 재시도·백오프 포함, WAL 기록 제외
+    Metrics::instance().publishLatency().record(static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start).count()));
+
     if (!success) {
         auto end = std::chrono::steady_clock::now();
         auto elapsed_ms = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
-        Logger::error("Failed to put record to", stream_name, "after", MAX_RETRIES,
+        LOGGER_ERROR("Failed to put record to", stream_name, "after", MAX_RETRIES,
                       "retries in", elapsed_ms, "ms:", last_error);
 
         // WAL: Save failed event to local file for manual recovery
-        saveToWAL(stream_name, partition_key, data);
+        if (use_wal) {
+            saveToWAL(stream_name, partition_key, data);
+        }
     }
 }
 
@@ -110,12 +129,12 @@ void KinesisProducer::saveToWAL(const std::string& stream_name,
             // WAL format: timestamp|stream|partition_key|data
             wal_file << ts << "|" << stream_name << "|" << partition_key << "|" << data << "\n";
             wal_file.flush();
-            Logger::warn("[WAL] Saved failed event to", WAL_PATH);
+            LOGGER_WARN("[WAL] Saved failed event to", WAL_PATH);
         } else {
-            Logger::error("[WAL] Cannot open", WAL_PATH);
+            LOGGER_ERROR("[WAL] Cannot open", WAL_PATH);
         }
     } catch (const std::exception& e) {
-        Logger::error("[WAL] Failed to save:", e.what());
+        LOGGER_ERROR("[WAL] Failed to save:", e.what());
     }
 }
 
@@ -131,13 +150,13 @@ int KinesisProducer::replayWAL() {
     }
 
     if (std::rename(WAL_PATH, replaying.c_str()) != 0) {
-        Logger::warn("[WAL] rename failed, skipping replay");
+        LOGGER_WARN("[WAL] rename failed, skipping replay");
         return 0;
     }
 
     std::ifstream in(replaying);
     if (!in.is_open()) {
-        Logger::error("[WAL] cannot open", replaying, "for replay");
+        LOGGER_ERROR("[WAL] cannot open", replaying, "for replay");
         return 0;
     }
 
@@ -151,7 +170,7 @@ int KinesisProducer::replayWAL() {
         auto p2 = (p1 == std::string::npos) ? std::string::npos : line.find('|', p1 + 1);
         auto p3 = (p2 == std::string::npos) ? std::string::npos : line.find('|', p2 + 1);
         if (p1 == std::string::npos || p2 == std::string::npos || p3 == std::string::npos) {
-            Logger::warn("[WAL] malformed line skipped");
+            LOGGER_WARN("[WAL] malformed line skipped");
             continue;
         }
         std::string stream = line.substr(p1 + 1, p2 - p1 - 1);
@@ -166,7 +185,7 @@ int KinesisProducer::replayWAL() {
 
     std::remove(replaying.c_str());
     if (replayed > 0) {
-        Logger::info("[WAL] replayed", replayed, "record(s) from WAL");
+        LOGGER_INFO("[WAL] replayed", replayed, "record(s) from WAL");
     }
     return replayed;
 }
@@ -181,49 +200,13 @@ void KinesisProducer::publishFill(const std::string& symbol,
                                    bool buyer_fully_filled,
                                    bool seller_fully_filled,
                                    bool buyer_is_maker) {
-    nlohmann::json j;
-    j["event"] = "FILL";
-    j["symbol"] = symbol;
-    j["trade_id"] = order_id + "_" + matched_order_id;
-
-    // buyer 객체 명시적으로 생성
-    nlohmann::json buyer_obj;
-    buyer_obj["order_id"] = order_id;
-    buyer_obj["user_id"] = buyer_id;
-    buyer_obj["fully_filled"] = buyer_fully_filled;
-    buyer_obj["is_maker"] = buyer_is_maker;
-    j["buyer"] = buyer_obj;
-
-    // seller 객체 명시적으로 생성
-    nlohmann::json seller_obj;
-    seller_obj["order_id"] = matched_order_id;
-    seller_obj["user_id"] = seller_id;
-    seller_obj["fully_filled"] = seller_fully_filled;
-    seller_obj["is_maker"] = !buyer_is_maker;  // opposite of buyer
-    j["seller"] = seller_obj;
+    // 스레드별 재사용 버퍼에 직접 직렬화 (nlohmann 트리/할당 없음, 바이트는 동일)
+    thread_local std::string buf;
+    writeFillJson(buf, symbol, order_id, matched_order_id, buyer_id, seller_id, qty, price,
+                  buyer_fully_filled, seller_fully_filled, buyer_is_maker, clock_->nowMs());
 
-    j["quantity"] = qty;
-    j["price"] = price;
-
-    // timestamp in milliseconds
-    auto now = std::chrono::system_clock::now();
-    j["timestamp"] = std::chrono::duration_cast<std::chrono::milliseconds>(
-        now.time_since_epoch()).count();
-
-    // executed_at in ISO 8601 format for history storage (thread-safe)
-    auto time_t_now = std::chrono::system_clock::to_time_t(now);
-    std::tm tm_now{};
-#ifdef _WIN32
-    gmtime_s(&tm_now, &time_t_now);
-#else
-    gmtime_r(&time_t_now, &tm_now);
-#endif
-    char iso_buf[30];
-    std::strftime(iso_buf, sizeof(iso_buf), "%Y-%m-%dT%H:%M:%SZ", &tm_now);
-    j["executed_at"] = iso_buf;
-
-    produce(fills_stream_, symbol, j.dump());
-    Logger::debug("Published fill:", order_id, "buyer_filled:", buyer_fully_filled, "seller_filled:", seller_fully_filled);
+    produce(fills_stream_, symbol, buf);
+    LOGGER_DEBUG("Published fill:", order_id, "buyer_filled:", buyer_fully_filled, "seller_filled:", seller_fully_filled);
 }
 
 void KinesisProducer::publishTrade(const std::string& symbol,
@@ -234,22 +217,20 @@ void KinesisProducer::publishTrade(const std::string& symbol,
     j["symbol"] = symbol;
     j["quantity"] = qty;
     j["price"] = price;
-    j["timestamp"] = std::chrono::duration_cast<std::chrono::milliseconds>(
-        std::chrono::system_clock::now().time_since_epoch()).count();
+    j["timestamp"] = clock_->nowMs();
     
     produce(trades_stream_, symbol, j.dump());
-    Logger::debug("Published trade:", symbol, qty, "@", price);
+    LOGGER_DEBUG("Published trade:", symbol, qty, "@", price);
 }
 
 void KinesisProducer::publishDepth(const std::string& symbol,
                                     const nlohmann::json& depth) {
     nlohmann::json j = depth;
     j["symbol"] = symbol;
-    j["timestamp"] = std::chrono::duration_cast<std::chrono::milliseconds>(
-        std::chrono::system_clock::now().time_since_epoch()).count();
+    j["timestamp"] = clock_->nowMs();
     
     produce(depth_stream_, symbol, j.dump());
-    Logger::debug("Published depth:", symbol);
+    LOGGER_DEBUG("Published depth:", symbol);
 }
 
 void KinesisProducer::publishOrderStatus(const std::string& symbol,
@@ -261,27 +242,18 @@ void KinesisProducer::publishOrderStatus(const std::string& symbol,
                                           uint64_t quantity,
                                           bool is_buy,
                                           const std::string& order_type) {
-    nlohmann::json j;
-    j["event"] = "ORDER_STATUS";
-    j["symbol"] = symbol;
-    j["order_id"] = order_id;
-    j["user_id"] = user_id;
-    j["status"] = status;
-    if (!reason.empty()) {
-        j["reason"] = reason;
-    }
-    // 모든 상태에서 주문 정보 포함 (프론트엔드 알림에 필요)
-    if (quantity > 0) {
-        j["price"] = price;
-        j["quantity"] = quantity;
-        j["side"] = is_buy ? "BUY" : "SELL";
-        j["type"] = order_type.empty() ? "LIMIT" : order_type;
-    }
-    j["timestamp"] = std::chrono::duration_cast<std::chrono::milliseconds>(
-        std::chrono::system_clock::now().time_since_epoch()).count();
+    thread_local std::string buf;
+    writeOrderStatusJson(buf, symbol, order_id, user_id, status, reason, price, quantity,
+                         is_buy, order_type, clock_->nowMs());
+
+    produce(status_stream_, symbol, buf);
+    LOGGER_DEBUG("Published ORDER_STATUS:", order_id, status, "user:", user_id);
+}
 
-    produce(status_stream_, symbol, j.dump());
-    Logger::debug("Published ORDER_STATUS:", order_id, status, "user:", user_id);
+void KinesisProducer::publishMbo(const std::string& symbol,
+                                 const std::string& payload) {
+    produce(mbo_stream_, symbol, payload, false);
+    LOGGER_DEBUG("Published MBO batch:", symbol, payload.size(), "bytes");
 }
 
 void KinesisProducer::flush(int timeout_ms) {
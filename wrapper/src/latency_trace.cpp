@@ -0,0 +1,247 @@
+#include "latency_trace.h"
+#include <algorithm>
+#include <thread>
+
+namespace aws_wrapper {
+
+namespace {
+
+constexpr size_t STAGES = OrderTrace::STAGES;
+constexpr size_t IO_KINDS = OrderTrace::IO_KINDS;
+constexpr size_t DEFAULT_RING_CAPACITY = 256;
+
+// 컨슈머 스레드의 진행 중 트레이스. 틱 0 = 미기록 (TSC/steady_clock은 0이 되지 않는다).
+struct ActiveTrace {
+    bool active = false;
+    std::array<uint64_t, STAGES> ticks{};
+    std::array<uint64_t, IO_KINDS> io_ticks{};
+    std::array<uint32_t, IO_KINDS> io_calls{};
+};
+
+thread_local ActiveTrace t_trace;
+thread_local uint64_t t_fetched_ticks = 0;
+
+size_t idx(TraceStage s) { return static_cast<size_t>(s); }
+
+}  // namespace
+
+// === TraceClock ===
+
+double TraceClock::nanosPerTick() {
+    static const double ratio = [] {
+#if defined(__x86_64__) || defined(__i386__)
+        auto wall_start = std::chrono::steady_clock::now();
+        uint64_t tick_start = __rdtsc();
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        uint64_t tick_end = __rdtsc();
+        auto wall_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - wall_start).count();
+        if (tick_end <= tick_start || wall_ns <= 0) return 1.0;
+        return static_cast<double>(wall_ns) / static_cast<double>(tick_end - tick_start);
+#else
+        return 1.0;
+#endif
+    }();
+    return ratio;
+}
+
+const char* traceStageName(TraceStage stage) {
+    switch (stage) {
+        case TraceStage::FETCHED:        return "fetched";
+        case TraceStage::DECODED:        return "decoded";
+        case TraceStage::LOCKED:         return "locked";
+        case TraceStage::MATCHED:        return "matched";
+        case TraceStage::CALLBACKS_DONE: return "callbacks_done";
+        case TraceStage::PUBLISHED:      return "published";
+        case TraceStage::DEPTH_WRITTEN:  return "depth_written";
+        default:                         return "unknown";
+    }
+}
+
+// === LatencyTracer ===
+
+LatencyTracer::LatencyTracer() {
+    ring_.resize(DEFAULT_RING_CAPACITY);
+}
+
+const char* LatencyTracer::spanName(Span s) {
+    switch (s) {
+        case SPAN_FETCH_TO_DECODE: return "fetch_to_decode";
+        case SPAN_LOCK_WAIT:       return "lock_wait";
+        case SPAN_MATCH:           return "match";
+        case SPAN_CALLBACKS:       return "callbacks";
+        case SPAN_KINESIS:         return "kinesis";
+        case SPAN_REDIS:           return "redis";
+        case SPAN_CALLBACKS_CPU:   return "callbacks_cpu";
+        case SPAN_END_TO_END:      return "end_to_end";
+        default:                   return "unknown";
+    }
+}
+
+const char* LatencyTracer::componentName(Component c) {
+    switch (c) {
+        case COMP_LOCK_WAIT:     return "lock_wait";
+        case COMP_MATCH:         return "match";
+        case COMP_KINESIS:       return "kinesis";
+        case COMP_REDIS:         return "redis";
+        case COMP_CALLBACKS_CPU: return "callbacks_cpu";
+        default:                 return "unknown";
+    }
+}
+
+void LatencyTracer::configure(uint32_t sample_every, uint64_t slow_threshold_ns,
+                              size_t ring_capacity) {
+    sample_every_.store(sample_every, std::memory_order_relaxed);
+    slow_threshold_ns_.store(slow_threshold_ns, std::memory_order_relaxed);
+    if (ring_capacity == 0) ring_capacity = 1;
+
+    std::lock_guard<std::mutex> lock(ring_mutex_);
+    if (ring_capacity != ring_.size()) {
+        ring_.assign(ring_capacity, OrderTrace{});
+        ring_next_ = 0;
+        ring_size_ = 0;
+    }
+}
+
+void LatencyTracer::markFetched() {
+    t_fetched_ticks = TraceClock::now();
+}
+
+void LatencyTracer::begin() {
+    t_trace = ActiveTrace{};
+    t_trace.active = true;
+    t_trace.ticks[idx(TraceStage::FETCHED)] =
+        t_fetched_ticks != 0 ? t_fetched_ticks : TraceClock::now();
+}
+
+void LatencyTracer::abandon() {
+    t_trace.active = false;
+}
+
+bool LatencyTracer::active() {
+    return t_trace.active;
+}
+
+void LatencyTracer::stamp(TraceStage stage) {
+    if (!t_trace.active) return;
+    uint64_t& slot = t_trace.ticks[idx(stage)];
+    if (stage == TraceStage::MATCHED && slot != 0) return;
+    slot = TraceClock::now();
+}
+
+void LatencyTracer::addIo(TraceIo kind, uint64_t ticks) {
+    if (!t_trace.active) return;
+    t_trace.io_ticks[static_cast<size_t>(kind)] += ticks;
+    ++t_trace.io_calls[static_cast<size_t>(kind)];
+}
+
+void LatencyTracer::finish(const std::string& symbol, const std::string& order_id) {
+    if (!t_trace.active) return;
+    t_trace.active = false;
+    const auto& ticks = t_trace.ticks;
+
+    const uint64_t origin = ticks[idx(TraceStage::FETCHED)];
+    uint64_t last = origin;
+    for (uint64_t t : ticks) last = std::max(last, t);
+
+    // 두 단계가 모두 찍혔을 때만 구간을 기록 (거부·디코드 실패 경로는 일부 단계가 없다)
+    auto between = [&ticks](TraceStage from, TraceStage to, uint64_t& out_ns) {
+        uint64_t a = ticks[idx(from)], b = ticks[idx(to)];
+        if (a == 0 || b == 0 || b < a) return false;
+        out_ns = TraceClock::toNanos(b - a);
+        return true;
+    };
+
+    uint64_t fetch_to_decode = 0, lock_wait = 0, match = 0, callbacks = 0;
+    if (between(TraceStage::FETCHED, TraceStage::DECODED, fetch_to_decode)) {
+        spans_[SPAN_FETCH_TO_DECODE].record(fetch_to_decode);
+    }
+    if (between(TraceStage::DECODED, TraceStage::LOCKED, lock_wait)) {
+        spans_[SPAN_LOCK_WAIT].record(lock_wait);
+    }
+    if (between(TraceStage::LOCKED, TraceStage::MATCHED, match)) {
+        spans_[SPAN_MATCH].record(match);
+    }
+
+    const uint64_t kinesis = TraceClock::toNanos(t_trace.io_ticks[static_cast<size_t>(TraceIo::KINESIS)]);
+    const uint64_t redis = TraceClock::toNanos(t_trace.io_ticks[static_cast<size_t>(TraceIo::REDIS)]);
+    uint64_t callbacks_cpu = 0;
+    if (between(TraceStage::MATCHED, TraceStage::CALLBACKS_DONE, callbacks)) {
+        callbacks_cpu = callbacks > kinesis + redis ? callbacks - kinesis - redis : 0;
+        spans_[SPAN_CALLBACKS].record(callbacks);
+        spans_[SPAN_KINESIS].record(kinesis);
+        spans_[SPAN_REDIS].record(redis);
+        spans_[SPAN_CALLBACKS_CPU].record(callbacks_cpu);
+    }
+
+    const uint64_t total_ns = TraceClock::toNanos(last - origin);
+    spans_[SPAN_END_TO_END].record(total_ns);
+
+    // 이 주문에서 가장 오래 걸린 구성 요소
+    const uint64_t parts[COMP_COUNT] = {lock_wait, match, kinesis, redis, callbacks_cpu};
+    size_t dominant = static_cast<size_t>(
+        std::max_element(parts, parts + COMP_COUNT) - parts);
+    dominant_[dominant].fetch_add(1, std::memory_order_relaxed);
+
+    uint64_t n = traced_.fetch_add(1, std::memory_order_relaxed);
+    uint32_t every = sample_every_.load(std::memory_order_relaxed);
+    uint64_t slow = slow_threshold_ns_.load(std::memory_order_relaxed);
+    if (!((every != 0 && n % every == 0) || (slow != 0 && total_ns >= slow))) return;
+
+    OrderTrace trace;
+    trace.symbol = symbol;
+    trace.order_id = order_id;
+    trace.wall_time_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    for (size_t i = 0; i < STAGES; ++i) {
+        trace.stage_ns[i] = (ticks[i] == 0 || ticks[i] < origin)
+            ? -1 : static_cast<int64_t>(TraceClock::toNanos(ticks[i] - origin));
+    }
+    for (size_t k = 0; k < IO_KINDS; ++k) {
+        trace.io_ns[k] = TraceClock::toNanos(t_trace.io_ticks[k]);
+        trace.io_calls[k] = t_trace.io_calls[k];
+    }
+    trace.total_ns = total_ns;
+
+    sampled_.fetch_add(1, std::memory_order_relaxed);
+    std::lock_guard<std::mutex> lock(ring_mutex_);
+    ring_[ring_next_] = std::move(trace);
+    ring_next_ = (ring_next_ + 1) % ring_.size();
+    if (ring_size_ < ring_.size()) ++ring_size_;
+}
+
+std::vector<OrderTrace> LatencyTracer::recent(size_t max) const {
+    std::lock_guard<std::mutex> lock(ring_mutex_);
+    size_t n = std::min(max, ring_size_);
+    std::vector<OrderTrace> out;
+    out.reserve(n);
+    for (size_t i = 0; i < n; ++i) {
+        out.push_back(ring_[(ring_next_ + ring_.size() - 1 - i) % ring_.size()]);
+    }
+    return out;
+}
+
+void LatencyTracer::writePrometheus(std::string& out) const {
+    Metrics::writeCounter(out, "engine_trace_orders_total", "Orders traced end to end",
+                          tracedCount());
+    Metrics::writeCounter(out, "engine_trace_sampled_total",
+                          "Full traces kept in the dump ring", sampledCount());
+
+    std::vector<std::pair<std::string, const LatencyHistogram*>> series;
+    for (size_t s = 0; s < SPAN_COUNT; ++s) {
+        series.emplace_back(spanName(static_cast<Span>(s)), &spans_[s]);
+    }
+    Metrics::writeHistogramFamily(out, "engine_stage_latency_seconds",
+                                  "Per-stage order latency (record fetch to depth write)",
+                                  "stage", series);
+
+    out += "# HELP engine_trace_dominant_total Orders whose largest latency component was this\n";
+    out += "# TYPE engine_trace_dominant_total counter\n";
+    for (size_t c = 0; c < COMP_COUNT; ++c) {
+        out += std::string("engine_trace_dominant_total{component=\"") +
+               componentName(static_cast<Component>(c)) + "\"} " +
+               std::to_string(dominantCount(static_cast<Component>(c))) + "\n";
+    }
+}
+
+} // namespace aws_wrapper
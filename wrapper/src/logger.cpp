@@ -1,6 +1,311 @@
 #include "logger.h"
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <mutex>
+#include <thread>
+#include <vector>
 
-// Logger는 헤더 전용 - 빈 구현
 namespace aws_wrapper {
-    // Logger 클래스는 헤더 전용이므로 여기에 추가 구현 없음
+
+namespace {
+
+constexpr size_t RING_SLOTS = 1024;          // 스레드당 (약 256KB)
+constexpr int IDLE_SLEEP_US = 1000;          // 쓸 것이 없을 때 writer 대기
+constexpr size_t MAX_BATCH_BYTES = 1 << 20;  // 한 번에 쓰는 최대 크기
+
+struct ThreadRing {
+    SpscRing<LogRecord> ring{RING_SLOTS};
+    std::atomic<bool> alive{true};
+    std::atomic<uint64_t> pushed{0};   // 생산자 소유
+    std::atomic<uint64_t> written{0};  // writer 소유
+};
+
+struct Backend {
+    std::mutex mutex;  // rings 등록, writer 시작/정지, 동기 쓰기
+    std::vector<std::shared_ptr<ThreadRing>> rings;
+    std::thread writer;
+    std::atomic<bool> running{false};
+    std::atomic<bool> async{true};
+    std::atomic<uint64_t> ring_full_waits{0};
+    bool atexit_registered = false;
+};
+
+// 의도적 누수: 정적 소멸자·atexit 이후의 로그도 안전하게 (동기 경로로) 처리
+Backend& backend() {
+    static Backend* b = new Backend();
+    return *b;
+}
+
+// 스레드 종료 시 링을 "죽음"으로 표시 — writer가 다 비운 뒤 등록 해제
+struct ThreadState {
+    LogRecord scratch;
+    std::shared_ptr<ThreadRing> ring;
+    ~ThreadState() {
+        if (ring) ring->alive.store(false, std::memory_order_release);
+    }
+};
+
+thread_local ThreadState t_state;
+
+const char* levelName(LogLevel level) {
+    switch (level) {
+        case LogLevel::DEBUG: return "DEBUG";
+        case LogLevel::INFO:  return "INFO";
+        case LogLevel::WARN:  return "WARN";
+        case LogLevel::ERROR: return "ERROR";
+    }
+    return "?";
+}
+
+void writeOut(const std::string& data) {
+    std::fwrite(data.data(), 1, data.size(), stdout);
+    std::fflush(stdout);
+}
+
+// 링을 한 바퀴 비워 out에 포맷. 꺼낸 수를 돌려준다.
+size_t drainRing(ThreadRing& ring, std::string& out, LogRecord& tmp) {
+    size_t n = 0;
+    while (out.size() < MAX_BATCH_BYTES && ring.ring.tryPop(tmp)) {
+        Logger::format(tmp, out);
+        ++n;
+    }
+    return n;
+}
+
+void writerLoop() {
+    auto& b = backend();
+    std::string batch;
+    LogRecord tmp;
+    std::vector<std::shared_ptr<ThreadRing>> rings;
+    std::vector<size_t> popped;
+
+    while (b.running.load(std::memory_order_acquire)) {
+        {
+            std::lock_guard<std::mutex> lock(b.mutex);
+            rings = b.rings;
+        }
+        batch.clear();
+        popped.assign(rings.size(), 0);
+        for (size_t i = 0; i < rings.size(); ++i) {
+            popped[i] = drainRing(*rings[i], batch, tmp);
+        }
+        if (!batch.empty()) writeOut(batch);
+        bool any = false;
+        for (size_t i = 0; i < rings.size(); ++i) {
+            if (popped[i] == 0) continue;
+            any = true;
+            rings[i]->written.fetch_add(popped[i], std::memory_order_release);
+        }
+
+        // 종료된 스레드의 빈 링 정리
+        {
+            std::lock_guard<std::mutex> lock(b.mutex);
+            for (auto it = b.rings.begin(); it != b.rings.end();) {
+                if (!(*it)->alive.load(std::memory_order_acquire) &&
+                    (*it)->ring.sizeApprox() == 0) {
+                    it = b.rings.erase(it);
+                } else {
+                    ++it;
+                }
+            }
+        }
+
+        if (!any) std::this_thread::sleep_for(std::chrono::microseconds(IDLE_SLEEP_US));
+    }
+}
+
+// writer를 멈추고 남은 레코드를 호출 스레드에서 비운다 (mutex 보유 상태에서 호출)
+void stopWriterLocked(Backend& b) {
+    if (b.running.exchange(false) && b.writer.joinable()) {
+        b.mutex.unlock();
+        b.writer.join();
+        b.mutex.lock();
+    }
+    std::string out;
+    LogRecord tmp;
+    for (auto& ring : b.rings) {
+        size_t n;
+        while ((n = drainRing(*ring, out, tmp)) > 0) {
+            writeOut(out);
+            out.clear();
+            ring->written.fetch_add(n, std::memory_order_release);
+        }
+    }
+}
+
+void shutdownAtExit() {
+    auto& b = backend();
+    std::lock_guard<std::mutex> lock(b.mutex);
+    b.async.store(false, std::memory_order_release);
+    stopWriterLocked(b);
 }
+
+void ensureWriterLocked(Backend& b) {
+    if (b.running.load(std::memory_order_acquire)) return;
+    if (!b.atexit_registered) {
+        std::atexit(shutdownAtExit);
+        b.atexit_registered = true;
+    }
+    b.running.store(true, std::memory_order_release);
+    b.writer = std::thread(writerLoop);
+}
+
+}  // namespace
+
+LogRecord& Logger::acquire() {
+    LogRecord& r = t_state.scratch;
+    r.used = 0;
+    r.preformatted = false;
+    r.msg_literal = nullptr;
+    if (!r.msg_text.empty()) r.msg_text.clear();
+    if (!r.overflow.empty()) r.overflow.clear();
+    return r;
+}
+
+void Logger::commit() {
+    auto& b = backend();
+    LogRecord& r = t_state.scratch;
+
+    if (!b.async.load(std::memory_order_acquire)) {
+        std::string out;
+        format(r, out);
+        std::lock_guard<std::mutex> lock(b.mutex);
+        writeOut(out);
+        return;
+    }
+
+    if (!t_state.ring) {
+        auto ring = std::make_shared<ThreadRing>();
+        std::lock_guard<std::mutex> lock(b.mutex);
+        b.rings.push_back(ring);
+        ensureWriterLocked(b);
+        t_state.ring = std::move(ring);
+    } else if (!b.running.load(std::memory_order_acquire)) {
+        std::lock_guard<std::mutex> lock(b.mutex);
+        if (b.async.load(std::memory_order_acquire)) ensureWriterLocked(b);
+    }
+
+    // 가득 차면 드롭하지 않고 writer가 비울 때까지 양보
+    if (!t_state.ring->ring.tryPush(r)) {
+        b.ring_full_waits.fetch_add(1, std::memory_order_relaxed);
+        while (!t_state.ring->ring.tryPush(r)) {
+            if (!b.running.load(std::memory_order_acquire)) {
+                // writer 정지(종료 중) — 동기로 쓴다
+                std::string out;
+                format(r, out);
+                std::lock_guard<std::mutex> lock(b.mutex);
+                writeOut(out);
+                return;
+            }
+            std::this_thread::yield();
+        }
+    }
+    t_state.ring->pushed.fetch_add(1, std::memory_order_release);
+}
+
+void Logger::setAsync(bool async) {
+    auto& b = backend();
+    std::lock_guard<std::mutex> lock(b.mutex);
+    b.async.store(async, std::memory_order_release);
+    if (!async) stopWriterLocked(b);
+}
+
+void Logger::flush() {
+    auto& b = backend();
+    std::vector<std::pair<std::shared_ptr<ThreadRing>, uint64_t>> targets;
+    {
+        std::lock_guard<std::mutex> lock(b.mutex);
+        for (auto& ring : b.rings) {
+            targets.emplace_back(ring, ring->pushed.load(std::memory_order_acquire));
+        }
+    }
+    for (auto& [ring, target] : targets) {
+        while (ring->written.load(std::memory_order_acquire) < target &&
+               b.running.load(std::memory_order_acquire)) {
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+    }
+}
+
+uint64_t Logger::getRingFullWaits() {
+    return backend().ring_full_waits.load(std::memory_order_relaxed);
+}
+
+void Logger::format(const LogRecord& r, std::string& out) {
+    // 초 단위 타임스탬프 접두부 캐시 — localtime_r/strftime은 초가 바뀔 때만
+    thread_local int64_t cached_sec = -1;
+    thread_local char cached_prefix[32];
+    int64_t sec = r.time_ns / 1000000000;
+    if (sec != cached_sec) {
+        std::time_t t = static_cast<std::time_t>(sec);
+        std::tm tm_buf;
+        localtime_r(&t, &tm_buf);
+        std::strftime(cached_prefix, sizeof(cached_prefix), "%Y-%m-%d %H:%M:%S", &tm_buf);
+        cached_sec = sec;
+    }
+    char ms[8];
+    std::snprintf(ms, sizeof(ms), ".%03d", static_cast<int>((r.time_ns / 1000000) % 1000));
+
+    out += '[';
+    out += cached_prefix;
+    out += ms;
+    out += "] [";
+    out += levelName(r.level);
+    out += "] ";
+    if (r.msg_literal) out += r.msg_literal;
+    else out += r.msg_text;
+
+    if (r.preformatted) {
+        out += r.overflow;
+    } else {
+        char num[32];
+        size_t pos = 0;
+        while (pos < r.used) {
+            auto tag = static_cast<LogRecord::Tag>(r.inline_args[pos++]);
+            out += ' ';
+            switch (tag) {
+                case LogRecord::TAG_I64: {
+                    int64_t v;
+                    std::memcpy(&v, r.inline_args + pos, sizeof(v));
+                    pos += sizeof(v);
+                    std::snprintf(num, sizeof(num), "%lld", static_cast<long long>(v));
+                    out += num;
+                    break;
+                }
+                case LogRecord::TAG_U64: {
+                    uint64_t v;
+                    std::memcpy(&v, r.inline_args + pos, sizeof(v));
+                    pos += sizeof(v);
+                    std::snprintf(num, sizeof(num), "%llu", static_cast<unsigned long long>(v));
+                    out += num;
+                    break;
+                }
+                case LogRecord::TAG_F64: {
+                    double v;
+                    std::memcpy(&v, r.inline_args + pos, sizeof(v));
+                    pos += sizeof(v);
+                    std::snprintf(num, sizeof(num), "%g", v);  // ostream 기본(유효숫자 6)과 동일
+                    out += num;
+                    break;
+                }
+                case LogRecord::TAG_CHAR:
+                    out += r.inline_args[pos++];
+                    break;
+                case LogRecord::TAG_STR: {
+                    uint16_t n;
+                    std::memcpy(&n, r.inline_args + pos, 2);
+                    out.append(r.inline_args + pos + 2, n);
+                    pos += 2 + n;
+                    break;
+                }
+                default:
+                    pos = r.used;  // 손상된 레코드 — 나머지 무시
+                    break;
+            }
+        }
+    }
+    out += '\n';
+}
+
+} // namespace aws_wrapper
@@ -6,13 +6,19 @@
 #include "grpc_service.h"
 #include "redis_client.h"
 #include "metrics.h"
+#include "metrics_http.h"
+#include "latency_trace.h"
 #include "kinesis_consumer.h"
 #include "kinesis_producer.h"
 #include "dynamodb_client.h"
 #include "checkpoint_manager.h"
+#include "mbo_feed.h"
+#include "order_throttle.h"
 
+#include <algorithm>
 #include <iostream>
 #include <csignal>
+#include <map>
 #include <set>
 #include <nlohmann/json.hpp>
 #include <aws/core/Aws.h>
@@ -52,6 +58,8 @@ int main(int argc, char* argv[]) {
     if (log_level == "DEBUG") Logger::setLevel(LogLevel::DEBUG);
     else if (log_level == "WARN") Logger::setLevel(LogLevel::WARN);
     else if (log_level == "ERROR") Logger::setLevel(LogLevel::ERROR);
+    // 비동기 로거(기본): 포맷·stdout 쓰기를 백그라운드 스레드로. false면 호출 스레드에서 즉시 기록.
+    if (!Config::getBool("LOG_ASYNC", true)) Logger::setAsync(false);
     
     // 환경변수에서 설정 로드
     const auto stream_name = Config::get("KINESIS_ORDERS_STREAM", "supernoba-orders");
@@ -147,7 +155,27 @@ int main(int argc, char* argv[]) {
             depth_connected ? &depth_redis : nullptr,
             candle_connected ? &candle_redis : nullptr,
             ranking_enabled ? &ranking_manager : nullptr);
-        EngineCore engine(&handler, operating_connected ? &operating_redis : nullptr);
+        // 시각 출처: real(기본) | input(입력 주문 타임스탬프로만 전진 — 저널 재생 결정성)
+        std::unique_ptr<EngineClock> engine_clock;
+        if (Config::get("ENGINE_CLOCK", "real") == "input") {
+            engine_clock = std::make_unique<InputClock>();
+            Logger::info("Engine clock: input-derived (aggressor timestamp)");
+        }
+        EngineCore engine(&handler, operating_connected ? &operating_redis : nullptr,
+                          engine_clock.get());
+        producer.setClock(&engine.clock());
+
+        // 주문 단위(MBO) 피드 — 감시/MM용 add/cancel/replace/execute 스트림 (선택)
+        std::unique_ptr<MboFeed> mbo_feed;
+        if (Config::getBool("MBO_FEED_ENABLED", false)) {
+            MboFeed::Config mbo_config;
+            mbo_config.ring_capacity = Config::getInt("MBO_RING_SIZE", 65536);
+            mbo_config.flush_interval_ms = Config::getInt("MBO_FLUSH_MS", 5);
+            mbo_config.history_per_symbol = Config::getInt("MBO_HISTORY", 100000);
+            mbo_feed = std::make_unique<MboFeed>(&producer, mbo_config, &engine.clock());
+            handler.setMboFeed(mbo_feed.get());
+            mbo_feed->start();
+        }
         
         // === 시작 시 Redis에서 스냅샷 복원 ===
         // 먼저 deleted:symbols 로드 (상장폐지된 종목 필터링용)
@@ -215,26 +243,56 @@ int main(int argc, char* argv[]) {
                     Logger::info("Loaded totalShares for", total_shares_map.size(), "symbols into RankingManager");
                 }
 
-                auto active_orders = dynamodb.loadActiveOrders(orders_table);
+                // 병렬 세그먼트 Scan(기본) 또는 status GSI Query로 활성 주문을 스트리밍 복원.
+                // 주문은 스캔 도중 이 스레드로 넘어와 종목별로 모이고, 스캔이 끝나면 일괄 등재한다.
+                DynamoDBClient::ActiveOrderLoadOptions load_options;
+                load_options.segments = Config::getInt("DYNAMODB_SCAN_SEGMENTS", 4);
+                load_options.status_index = Config::get("DYNAMODB_STATUS_INDEX", "");
 
                 int added_count = 0;
                 int skipped_count = 0;
                 int skipped_deleted = 0;
+                // resting LIMIT 주문은 종목별로 모아 매칭 없이 일괄 등재, 나머지는 addOrder
+                std::map<std::string, std::vector<OrderPtr>> bulk_orders;
+                std::vector<OrderPtr> deferred_orders;
 
-                for (const auto& order : active_orders) {
+                dynamodb.streamActiveOrders(orders_table, load_options,
+                                            [&](const OrderPtr& order) {
                     // 삭제된 종목의 주문은 스킵
                     if (deleted_symbols.count(order->symbol()) > 0) {
                         ++skipped_deleted;
-                        continue;
+                        return;
                     }
 
                     // 이미 오더북에 있는 주문은 스킵 (스냅샷에서 복원된 경우)
                     if (engine.hasOrder(order->symbol(), order->order_id())) {
                         ++skipped_count;
+                        return;
+                    }
+
+                    if (EngineCore::isBulkLoadable(*order)) {
+                        bulk_orders[order->symbol()].push_back(order);
+                    } else {
+                        deferred_orders.push_back(order);
+                    }
+                });
+
+                for (auto& [symbol, orders] : bulk_orders) {
+                    // 스캔 순서는 임의 — 같은 가격의 대기열은 접수 시각(created_at) 순으로 세운다
+                    EngineCore::sortByArrival(orders);
+                    const size_t n = orders.size();
+                    if (engine.bulkLoadOrders(symbol, orders)) {
+                        added_count += static_cast<int>(n);
                         continue;
                     }
+                    // 교차 배치(또는 스냅샷 북과 교차) — 개별 addOrder로 매칭 경로를 태운다
+                    Logger::warn("DynamoDB bulk load rejected, falling back to addOrder:", symbol);
+                    deferred_orders.insert(deferred_orders.end(), orders.begin(), orders.end());
+                }
 
-                    // 오더북에 주문 추가
+                // 개별 경로도 접수 순서대로 — 교차 배치는 원래 체결 순서에 가깝게 다시 매칭된다
+                EngineCore::sortByArrival(deferred_orders);
+                for (const auto& order : deferred_orders) {
                     engine.addOrder(order);
                     ++added_count;
 
@@ -285,12 +343,13 @@ int main(int argc, char* argv[]) {
                 if (!anchor_json.empty()) {
                     try {
                         auto anchor = nlohmann::json::parse(anchor_json);
-                        int seeded = 0;
+                        std::unordered_map<std::string, std::string> seeds;
                         for (auto it = anchor.begin(); it != anchor.end(); ++it) {
-                            checkpoint_manager->checkpointImmediate(
-                                it.key(), it.value().get<std::string>());
-                            ++seeded;
+                            seeds[it.key()] = it.value().get<std::string>();
                         }
+                        // consumer 시작 전 메인 스레드에서 MSET 한 번으로 시딩
+                        checkpoint_manager->checkpointBatch(seeds);
+                        const size_t seeded = seeds.size();
                         Logger::info("RECOVERY=replay: seeded", seeded,
                                      "shard checkpoints from snapshot anchor");
                     } catch (const std::exception& e) {
@@ -323,15 +382,45 @@ int main(int argc, char* argv[]) {
         }
         consumer.setDrainTimeoutSeconds(drain_timeout_seconds);
 
-        consumer.setCallback([&engine](const std::string& key,
-                                        const std::string& value) {
+        // 주문 단위 지연 추적: 전 주문을 단계별 히스토그램에, 일부는 전체 트레이스로 링에 보관
+        LatencyTracer::instance().configure(
+            static_cast<uint32_t>(Config::getInt("TRACE_SAMPLE_EVERY", 100)),
+            static_cast<uint64_t>(Config::getInt("TRACE_SLOW_US", 5000)) * 1000,
+            static_cast<size_t>(Config::getInt("TRACE_RING_SIZE", 1024)));
+        Logger::info("Latency trace clock:", TraceClock::nanosPerTick(), "ns/tick");
+
+        // 유입 제한: 유저·종목별 토큰 버킷 (THROTTLE_* env). 엔진 락을 잡기 전에 걸러낸다.
+        OrderThrottle throttle(&producer, &engine.clock());
+
+        consumer.setCallback([&engine, &throttle](const std::string& key,
+                                                  const std::string& value) {
             Metrics::instance().incrementOrdersReceived();
+            ScopedTrace trace;
             
             try {
+                auto& metrics = Metrics::instance();
+                auto decode_start = std::chrono::steady_clock::now();
                 auto j = nlohmann::json::parse(value);
-                auto order = Order::fromJson(j);
-                
+                auto order = Order::fromJson(j, &engine.clock());
+                LatencyTracer::stamp(TraceStage::DECODED);
+                auto match_start = std::chrono::steady_clock::now();
+                metrics.decodeLatency().record(static_cast<uint64_t>(
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(
+                        match_start - decode_start).count()));
                 std::string action = j.value("action", "ADD");
+
+                // 유입 제한 (CANCEL은 노출을 줄이므로 제외). 거부분의 REJECTED는 모아서 발행하고,
+                // 지연 정책이면 예약한 토큰 시각까지 이 컨슈머 스레드가 기다린다.
+                if (action != "CANCEL" && throttle.enabled()) {
+                    auto verdict = throttle.admit(order, action == "REPLACE");
+                    if (!verdict.admitted) {
+                        trace.finish(order->symbol(), order->order_id());
+                        return;
+                    }
+                    if (verdict.delay.count() > 0) std::this_thread::sleep_for(verdict.delay);
+                }
+
+                ScopedLatency match_timer(metrics.matchLatency());
                 
                 if (action == "ADD") {
                     engine.addOrder(order);
@@ -343,6 +432,7 @@ int main(int argc, char* argv[]) {
                     engine.replaceOrder(order->symbol(), order->order_id(), 
                                         qty_delta, new_price);
                 }
+                trace.finish(order->symbol(), order->order_id());
             } catch (const std::exception& e) {
                 Logger::error("Failed to process order:", e.what());
                 Metrics::instance().incrementOrdersRejected();
@@ -350,9 +440,94 @@ int main(int argc, char* argv[]) {
         });
         
         // gRPC 서비스 시작
-        GrpcService grpc_service(&engine, backup_connected ? &backup_redis : nullptr);
+        GrpcService grpc_service(&engine, backup_connected ? &backup_redis : nullptr,
+                                 mbo_feed.get());
         grpc_service.start(grpc_port);
         
+        // 메트릭 엔드포인트 (Prometheus /metrics). METRICS_PORT=0이면 비활성.
+        const int metrics_port = Config::getInt("METRICS_PORT", 9100);
+        Metrics::instance().addCollector([&](std::string& out) {
+            auto c = engine.getCounters();
+            Metrics::writeCounter(out, "engine_book_orders_processed_total",
+                                  "Orders that reached the book", c.orders_processed);
+            Metrics::writeCounter(out, "engine_book_trades_total",
+                                  "Trades reported by the book", c.trades_executed);
+            Metrics::writeCounter(out, "engine_duplicates_rejected_total",
+                                  "Orders rejected by dedup", c.duplicates_rejected);
+            Metrics::writeCounter(out, "engine_self_trades_prevented_total",
+                                  "Resting orders cancelled by self-trade prevention",
+                                  c.self_trades_prevented);
+            Metrics::writeCounter(out, "engine_price_band_rejects_total",
+                                  "Orders rejected by the price band", c.price_band_rejects);
+            Metrics::writeCounter(out, "engine_vi_halt_rejects_total",
+                                  "Orders rejected during a VI halt", c.vi_halt_rejects);
+            Metrics::writeCounter(out, "engine_silent_restore_matches_total",
+                                  "Crossed orders seen while restoring (should stay 0)",
+                                  c.silent_restore_matches);
+            Metrics::writeCounter(out, "engine_stops_triggered_total",
+                                  "Stop orders submitted after their stop price was reached",
+                                  c.stops_triggered);
+            Metrics::writeCounter(out, "engine_stop_cascades_capped_total",
+                                  "Stop cascades cut short by STOP_CASCADE_LIMIT",
+                                  c.stop_cascades_capped);
+            Metrics::writeCounter(out, "engine_auctions_uncrossed_total",
+                                  "Call auctions ended with a single-price uncross",
+                                  c.auctions_uncrossed);
+            Metrics::writeCounter(out, "engine_auction_volume_total",
+                                  "Quantity executed by call auctions", c.auction_volume);
+            Metrics::writeCounter(out, "engine_batch_auctions_total",
+                                  "Batch auction intervals that cleared at a single price",
+                                  c.batch_auctions);
+            Metrics::writeCounter(out, "engine_market_orders_collared_total",
+                                  "Market orders converted to limits at the collar",
+                                  c.market_orders_collared);
+            Metrics::writeCounter(out, "engine_risk_rejects_total",
+                                  "Orders and replaces rejected by pre-trade risk limits",
+                                  c.risk_rejects);
+            Metrics::writeCounter(out, "engine_throttled_orders_total",
+                                  "Orders rejected by the ingest throttle",
+                                  throttle.throttledOrders());
+            Metrics::writeCounter(out, "engine_throttled_qty_total",
+                                  "Order quantity rejected by the ingest throttle",
+                                  throttle.throttledQty());
+            Metrics::writeCounter(out, "engine_throttle_delayed_total",
+                                  "Orders held back by the ingest throttle (delay policy)",
+                                  throttle.delayedOrders());
+            Metrics::writeCounter(out, "engine_throttle_delay_ns_total",
+                                  "Total time orders were held back by the ingest throttle",
+                                  throttle.delayNs());
+            Metrics::writeGauge(out, "engine_symbols", "Order books in memory",
+                                static_cast<double>(c.symbols));
+            Metrics::writeGauge(out, "engine_resting_orders", "Orders tracked by the engine",
+                                static_cast<double>(c.resting_orders));
+            Metrics::writeCounter(out, "engine_records_consumed_total",
+                                  "Kinesis records processed", consumer.getRecordsProcessed());
+            if (checkpoint_manager) {
+                Metrics::writeCounter(out, "engine_checkpoint_flush_batches_total",
+                                      "Checkpoint MSET calls",
+                                      checkpoint_manager->getFlushBatchCount());
+                Metrics::writeGauge(out, "engine_checkpoint_flush_max_seconds",
+                                    "Slowest checkpoint flush",
+                                    checkpoint_manager->getMaxFlushMicros() / 1e6);
+            }
+            if (mbo_feed) {
+                Metrics::writeCounter(out, "engine_mbo_events_total", "MBO events encoded",
+                                      mbo_feed->getEventCount());
+                Metrics::writeCounter(out, "engine_mbo_dropped_events_total",
+                                      "MBO events dropped because the ring was full",
+                                      mbo_feed->getDroppedEvents());
+                Metrics::writeCounter(out, "engine_mbo_oversize_drops_total",
+                                      "MBO events dropped for an over-long symbol or order id",
+                                      mbo_feed->getOversizeDrops());
+            }
+            LatencyTracer::instance().writePrometheus(out);
+        });
+        MetricsHttpServer metrics_server(metrics_port,
+                                         [] { return Metrics::instance().renderPrometheus(); });
+        if (metrics_port > 0) {
+            metrics_server.start();
+        }
+
         // Consumer 시작
         consumer.start();
         
@@ -364,11 +539,24 @@ int main(int argc, char* argv[]) {
         auto last_snapshot = std::chrono::steady_clock::now();
         auto last_metrics = std::chrono::steady_clock::now();
 
+        // 배치 경매 종목이 있으면 루프를 그 구간 주기로 돌린다 (나머지 작업은 경과 시간으로 판정)
+        const auto batch_interval = engine.batchAuctionInterval();
+        const std::chrono::milliseconds loop_tick =
+            batch_interval.count() > 0 ? std::min<std::chrono::milliseconds>(
+                                             batch_interval, std::chrono::seconds(1))
+                                       : std::chrono::seconds(1);
+
         while (g_running) {
-            std::this_thread::sleep_for(std::chrono::seconds(1));
+            std::this_thread::sleep_for(loop_tick);
 
             auto now = std::chrono::steady_clock::now();
 
+            // 시간이 다 된 단일가 경매·배치 경매 체결 (주문이 끊긴 종목도 제때 재개되도록)
+            engine.runDueAuctions();
+
+            // 유입 제한으로 거부된 주문의 REJECTED 일괄 발행 (배치가 덜 찬 나머지)
+            throttle.flushRejected();
+
             // Fix 1: Watchdog — consumer 스레드가 60초 이상 진행하지 않으면 재시작
             if (consumer.isRunning()) {
                 auto last_progress = consumer.getLastProgressEpochMs();
@@ -420,7 +608,19 @@ int main(int argc, char* argv[]) {
                 Logger::info("=== Metrics ===");
                 Logger::info("Orders received:", m.getOrdersReceived());
                 Logger::info("Orders accepted:", m.getOrdersAccepted());
+                Logger::info("Orders rejected:", m.getOrdersRejected());
                 Logger::info("Trades executed:", m.getTradesExecuted());
+                Logger::info("Match p50/p99/p999 us:",
+                             m.matchLatency().percentile(0.5) / 1000,
+                             m.matchLatency().percentile(0.99) / 1000,
+                             m.matchLatency().percentile(0.999) / 1000);
+                const auto& tr = LatencyTracer::instance();
+                Logger::info("Stage p99 us lock/match/kinesis/redis/e2e:",
+                             tr.span(LatencyTracer::SPAN_LOCK_WAIT).percentile(0.99) / 1000,
+                             tr.span(LatencyTracer::SPAN_MATCH).percentile(0.99) / 1000,
+                             tr.span(LatencyTracer::SPAN_KINESIS).percentile(0.99) / 1000,
+                             tr.span(LatencyTracer::SPAN_REDIS).percentile(0.99) / 1000,
+                             tr.span(LatencyTracer::SPAN_END_TO_END).percentile(0.99) / 1000);
                 Logger::info("===============");
                 last_metrics = now;
             }
@@ -435,10 +635,20 @@ int main(int argc, char* argv[]) {
             ranking_manager.stopSnapshotThread();
         }
 
+        // 1-1. 메트릭 엔드포인트 종료 (컬렉터가 참조하는 객체보다 먼저)
+        metrics_server.stop();
+
         // 2. Kinesis Consumer 종료 (Graceful: drain + checkpoint)
         Logger::info("Stopping KinesisConsumer (drain timeout:", drain_timeout_seconds, "s)...");
         consumer.stop();
         Logger::info("KinesisConsumer stopped, records processed:", consumer.getRecordsProcessed());
+        throttle.flushRejected();
+
+        // 2-1. MBO 피드 종료 (남은 이벤트 발행)
+        if (mbo_feed) {
+            Logger::info("Stopping MboFeed...");
+            mbo_feed->stop();
+        }
 
         // 3. 최종 스냅샷 저장
         if (backup_connected) {
@@ -464,7 +674,10 @@ int main(int argc, char* argv[]) {
         // 6. Checkpoint 메트릭 로깅
         if (checkpoint_manager) {
             Logger::info("Checkpoint stats - saved:", checkpoint_manager->getCheckpointCount(),
-                        "flushed:", checkpoint_manager->getFlushCount());
+                        "flushed:", checkpoint_manager->getFlushCount(),
+                        "batches:", checkpoint_manager->getFlushBatchCount(),
+                        "avg_us:", checkpoint_manager->getAvgFlushMicros(),
+                        "max_us:", checkpoint_manager->getMaxFlushMicros());
         }
 
         Logger::info("=== Shutdown Complete ===");
@@ -3,8 +3,12 @@
 #include "redis_client.h"
 #include "ranking_manager.h"
 #include "iproducer.h"
+#include "mbo_feed.h"
 #include "logger.h"
+#include "config.h"
 #include "metrics.h"
+#include "latency_trace.h"
+#include "json_writer.h"
 #include <book/depth_level.h>
 #include <nlohmann/json.hpp>
 #include <cmath>
@@ -18,14 +22,41 @@ MarketDataHandler::MarketDataHandler(IProducer* producer, RedisClient* depth_red
                                      RankingManager* ranking_manager)
     : producer_(producer), depth_redis_(depth_redis), candle_redis_(candle_redis),
       ranking_manager_(ranking_manager) {
-    Logger::info("MarketDataHandler initialized, Depth Redis:", depth_redis_ ? "connected" : "none",
+    int levels = Config::getInt("DEPTH_PUBLISH_LEVELS", DEFAULT_DEPTH_PUBLISH_LEVELS);
+    depth_publish_levels_ = levels > 0 ? static_cast<size_t>(levels) : DEFAULT_DEPTH_PUBLISH_LEVELS;
+    LOGGER_INFO("MarketDataHandler initialized, Depth Redis:", depth_redis_ ? "connected" : "none",
                  "Candle Redis:", candle_redis_ ? "connected" : "none",
                  "RankingManager:", ranking_manager_ ? "enabled" : "disabled");
 }
 
+void MarketDataHandler::setClock(EngineClock* clock) {
+    clock_ = clock ? clock : &EngineClock::real();
+    if (ranking_manager_) {
+        ranking_manager_->setClock(clock_);
+    }
+}
+
 void MarketDataHandler::on_accept(const OrderPtr& order) {
-    Logger::info("Order ACCEPTED:", order->order_id(), order->symbol());
+    handleAccept(order, true);
+}
+
+void MarketDataHandler::on_accept_stop(const OrderPtr& order) {
+    // 발동 전 스톱은 호가창에 없다 — MBO ADD는 발동 시(on_trigger_stop) 낸다
+    handleAccept(order, false);
+}
+
+void MarketDataHandler::on_trigger_stop(const OrderPtr& order) {
+    // liquibook은 발동 콜백을 그 주문의 체결 콜백보다 먼저 부른다 (ADD → EXECUTE 순서 유지)
+    LOGGER_INFO("Stop TRIGGERED:", order->order_id(), order->symbol());
+    if (mbo_feed_) mbo_feed_->onAdd(*order);
+}
+
+void MarketDataHandler::handleAccept(const OrderPtr& order, bool on_book) {
+    LatencyTracer::stamp(TraceStage::MATCHED);  // 콜백은 매칭이 끝난 뒤 몰아서 호출된다
+    LOGGER_INFO("Order ACCEPTED:", order->order_id(), order->symbol());
     Metrics::instance().incrementOrdersAccepted();
+    if (mbo_feed_ && on_book) mbo_feed_->onAdd(*order);
+    if (engine_) engine_->risk().onAccept(*order);
     
     // NOTE: 직접 WebSocket 알림 제거됨 (2026-02-08)
     // 모든 ORDER_STATUS 알림은 Kinesis → stock-processor 단일 경로로 통합
@@ -36,12 +67,12 @@ void MarketDataHandler::on_accept(const OrderPtr& order) {
         producer_->publishOrderStatus(order->symbol(), order->order_id(),
                                       order->user_id(), "ACCEPTED", "",
                                       order->price(), order->order_qty(), order->is_buy(), otype);
-        Logger::info("Published ACCEPTED event to Kinesis:", order->order_id());
+        LOGGER_INFO("Published ACCEPTED event to Kinesis:", order->order_id());
     }
 }
 
 void MarketDataHandler::on_reject(const OrderPtr& order, const char* reason) {
-    Logger::warn("Order REJECTED:", order->order_id(), "reason:", reason);
+    LOGGER_WARN("Order REJECTED:", order->order_id(), "reason:", reason);
     Metrics::instance().incrementOrdersRejected();
     
     // Kinesis로 REJECTED 이벤트 발행 (order-status 스트림)
@@ -50,12 +81,13 @@ void MarketDataHandler::on_reject(const OrderPtr& order, const char* reason) {
         producer_->publishOrderStatus(order->symbol(), order->order_id(),
                                       order->user_id(), "REJECTED", reason ? reason : "",
                                       order->price(), order->order_qty(), order->is_buy(), otype);
-        Logger::info("Published REJECTED event to Kinesis:", order->order_id());
+        LOGGER_INFO("Published REJECTED event to Kinesis:", order->order_id());
     }
 
     // Reject된 주문을 order_maps_에서 제거 (메모리 누수 방지)
     // 콜백 컨텍스트에서는 락이 이미 보유된 상태이므로 Unsafe 버전 사용
     if (engine_) {
+        engine_->risk().onClose(*order);
         engine_->removeFilledOrderUnsafe(order->symbol(), order->order_id());
     }
 }
@@ -65,14 +97,25 @@ void MarketDataHandler::on_fill(const OrderPtr& order,
                                  liquibook::book::Quantity fill_qty,
                                  liquibook::book::Price fill_price) {
     std::string symbol = order->symbol();
-    Logger::info("FILL:", order->order_id(), "matched:", matched_order->order_id(),
+    LOGGER_INFO("FILL:", order->order_id(), "matched:", matched_order->order_id(),
                  "qty:", fill_qty, "price:", fill_price, "symbol:", symbol);
     
     // 양쪽 주문의 filled_qty 업데이트
     liquibook::book::Cost fill_cost = fill_qty * fill_price;
     order->fill(fill_qty, fill_cost, 0);
     matched_order->fill(fill_qty, fill_cost, 0);
+    if (engine_) {
+        engine_->risk().onFill(*order, fill_qty);
+        engine_->risk().onFill(*matched_order, fill_qty);
+    }
+
+    // MBO: resting 주문 먼저, 그다음 aggressor
+    if (mbo_feed_) {
+        mbo_feed_->onExecute(*matched_order, fill_qty, fill_price);
+        mbo_feed_->onExecute(*order, fill_qty, fill_price);
+    }
     
+    Metrics::instance().incrementTradesExecuted();
     Metrics::instance().incrementFillsPublished();
     
     // === DayData 업데이트 (on_trade 대체) ===
@@ -84,7 +127,7 @@ void MarketDataHandler::on_fill(const OrderPtr& order,
         day.open_price = fill_price;
         day.high_price = fill_price;
         day.low_price = fill_price;
-        Logger::info("First trade of day for", symbol, "open:", fill_price);
+        LOGGER_INFO("First trade of day for", symbol, "open:", fill_price);
     }
     
     // 고가/저가 업데이트
@@ -100,24 +143,17 @@ void MarketDataHandler::on_fill(const OrderPtr& order,
         engine_->onTradeForVI(symbol, fill_price);
     }
 
-    Logger::debug("DayData updated:", symbol, "price:", fill_price, "vol:", day.volume);
+    LOGGER_DEBUG("DayData updated:", symbol, "price:", fill_price, "vol:", day.volume);
     
     // === OHLC 캐시 저장 (당일만) ===
-    auto now = std::chrono::system_clock::now();
-    auto epoch_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
-        now.time_since_epoch()).count();
+    auto epoch_ms = clock_->nowMs();
     auto epoch_sec = epoch_ms / 1000;
     
     if (depth_redis_ && depth_redis_->isConnected()) {
-        nlohmann::json ohlc;
-        ohlc["o"] = day.open_price;
-        ohlc["h"] = day.high_price;
-        ohlc["l"] = day.low_price;
-        ohlc["c"] = day.last_price;
-        ohlc["v"] = day.volume;
-        ohlc["t"] = epoch_sec;  // Unix timestamp (초)
-        depth_redis_->set("ohlc:" + symbol, ohlc.dump());
-        Logger::debug("OHLC saved:", symbol);
+        writeOhlcJson(json_buf_, day.open_price, day.high_price, day.low_price,
+                      day.last_price, day.volume, epoch_sec);  // t: Unix timestamp (초)
+        depth_redis_->set("ohlc:" + symbol, json_buf_);
+        LOGGER_DEBUG("OHLC saved:", symbol);
     }
 
     // === 1분봉 캔들 업데이트 (Lua Script) ===
@@ -164,7 +200,7 @@ void MarketDataHandler::on_fill(const OrderPtr& order,
         bool buyer_is_maker = !order->is_buy();
         producer_->publishFill(symbol, bo, so, buyer_id, seller_id, fill_qty, fill_price,
                                buyer_fully_filled, seller_fully_filled, buyer_is_maker);
-        Logger::info("PUBLISHED_FILL:", symbol, fill_price, "x", fill_qty, 
+        LOGGER_INFO("PUBLISHED_FILL:", symbol, fill_price, "x", fill_qty, 
                      "buyer_filled:", buyer_fully_filled, "seller_filled:", seller_fully_filled);
         
         // 전량 체결된 주문은 ORDER_STATUS (FILLED)를 order-status 스트림으로 발행
@@ -174,7 +210,7 @@ void MarketDataHandler::on_fill(const OrderPtr& order,
             producer_->publishOrderStatus(symbol, bo, buyer_id, "FILLED", "",
                                           buyer_order->price(), buyer_order->order_qty(),
                                           true, buyer_type);
-            Logger::info("Published FILLED status for buyer:", bo);
+            LOGGER_INFO("Published FILLED status for buyer:", bo);
         }
 
         if (seller_fully_filled) {
@@ -183,7 +219,7 @@ void MarketDataHandler::on_fill(const OrderPtr& order,
             producer_->publishOrderStatus(symbol, so, seller_id, "FILLED", "",
                                           seller_order->price(), seller_order->order_qty(),
                                           false, seller_type);
-            Logger::info("Published FILLED status for seller:", so);
+            LOGGER_INFO("Published FILLED status for seller:", so);
         }
     }
 
@@ -204,7 +240,18 @@ void MarketDataHandler::on_fill(const OrderPtr& order,
 
 
 void MarketDataHandler::on_cancel(const OrderPtr& order) {
-    Logger::info("Order CANCELLED:", order->order_id());
+    handleCancel(order, true);
+}
+
+void MarketDataHandler::on_cancel_stop(const OrderPtr& order) {
+    // 발동 전(또는 발동 후 제출 대기 중) 스톱: MBO에 ADD가 나간 적이 없으므로 CANCEL도 없다
+    handleCancel(order, false);
+}
+
+void MarketDataHandler::handleCancel(const OrderPtr& order, bool on_book) {
+    LatencyTracer::stamp(TraceStage::MATCHED);
+    LOGGER_INFO("Order CANCELLED:", order->order_id());
+    if (mbo_feed_ && on_book) mbo_feed_->onCancel(*order);
 
     // Kinesis로 CANCEL 이벤트 발행 (DynamoDB 업데이트를 위해)
     if (producer_) {
@@ -212,7 +259,7 @@ void MarketDataHandler::on_cancel(const OrderPtr& order) {
         producer_->publishOrderStatus(order->symbol(), order->order_id(),
                                       order->user_id(), "CANCELLED", "",
                                       order->price(), order->order_qty(), order->is_buy(), otype);
-        Logger::info("Published CANCEL event to Kinesis:", order->order_id());
+        LOGGER_INFO("Published CANCEL event to Kinesis:", order->order_id());
     }
 
     // 주문 맵에서 제거. 이 경로가 없으면 IOC 잔량 취소(모든 MARKET 주문이 IOC다)로
@@ -220,12 +267,13 @@ void MarketDataHandler::on_cancel(const OrderPtr& order) {
     // 재시작 시 일반 지정가처럼 복원된다. MARKET SELL 유령은 price=0이라 liquibook에서
     // 시장가로 해석되어 복원된 매수호가 전 구간을 쓸어버린다(리스너 부재로 무음 체결).
     if (engine_) {
+        engine_->risk().onClose(*order);
         engine_->removeFilledOrderUnsafe(order->symbol(), order->order_id());
     }
 }
 
 void MarketDataHandler::on_cancel_reject(const OrderPtr& order, const char* reason) {
-    Logger::warn("Cancel REJECTED:", order->order_id(), "reason:", reason);
+    LOGGER_WARN("Cancel REJECTED:", order->order_id(), "reason:", reason);
     
     // Kinesis로 CANCEL_REJECTED 이벤트 발행
     if (producer_) {
@@ -233,15 +281,34 @@ void MarketDataHandler::on_cancel_reject(const OrderPtr& order, const char* reas
         producer_->publishOrderStatus(order->symbol(), order->order_id(),
                                       order->user_id(), "CANCEL_REJECTED", reason ? reason : "",
                                       order->price(), order->order_qty(), order->is_buy(), otype);
-        Logger::info("Published CANCEL_REJECTED event to Kinesis:", order->order_id());
+        LOGGER_INFO("Published CANCEL_REJECTED event to Kinesis:", order->order_id());
     }
 }
 
 void MarketDataHandler::on_replace(const OrderPtr& order,
                                     const int64_t& size_delta,
                                     liquibook::book::Price new_price) {
-    Logger::info("Order REPLACED:", order->order_id(), 
+    LatencyTracer::stamp(TraceStage::MATCHED);
+    LOGGER_INFO("Order REPLACED:", order->order_id(), 
                  "delta:", size_delta, "new_price:", new_price);
+
+    if (mbo_feed_) {
+        int64_t new_open = static_cast<int64_t>(order->open_qty()) + size_delta;
+        mbo_feed_->onReplace(*order, new_open > 0 ? static_cast<uint64_t>(new_open) : 0,
+                             new_price != liquibook::book::PRICE_UNCHANGED ? new_price
+                                                                           : order->price());
+    }
+
+    if (engine_) engine_->risk().onReplace(*order, size_delta, new_price);
+
+    // liquibook은 트래커만 옮기고 주문 객체는 건드리지 않는다. 주문에도 반영해야
+    // 이후 체결가·depth 갱신·스냅샷이 정정 후 가격/수량을 본다.
+    // (DepthOrderBook::on_replace는 이 콜백 직전에 옛 값으로 호출되었다)
+    order->setOrderQty(static_cast<liquibook::book::Quantity>(
+        static_cast<int64_t>(order->order_qty()) + size_delta));
+    if (new_price != liquibook::book::PRICE_UNCHANGED) {
+        order->setPrice(new_price);
+    }
     
     // Kinesis로 REPLACED 이벤트 발행
     if (producer_) {
@@ -249,12 +316,12 @@ void MarketDataHandler::on_replace(const OrderPtr& order,
         producer_->publishOrderStatus(order->symbol(), order->order_id(),
                                       order->user_id(), "REPLACED", "",
                                       order->price(), order->order_qty(), order->is_buy(), otype);
-        Logger::info("Published REPLACED event to Kinesis:", order->order_id());
+        LOGGER_INFO("Published REPLACED event to Kinesis:", order->order_id());
     }
 }
 
 void MarketDataHandler::on_replace_reject(const OrderPtr& order, const char* reason) {
-    Logger::warn("Replace REJECTED:", order->order_id(), "reason:", reason);
+    LOGGER_WARN("Replace REJECTED:", order->order_id(), "reason:", reason);
     
     // Kinesis로 REPLACE_REJECTED 이벤트 발행
     if (producer_) {
@@ -262,63 +329,19 @@ void MarketDataHandler::on_replace_reject(const OrderPtr& order, const char* rea
         producer_->publishOrderStatus(order->symbol(), order->order_id(),
                                       order->user_id(), "REPLACE_REJECTED", reason ? reason : "",
                                       order->price(), order->order_qty(), order->is_buy(), otype);
-        Logger::info("Published REPLACE_REJECTED event to Kinesis:", order->order_id());
+        LOGGER_INFO("Published REPLACE_REJECTED event to Kinesis:", order->order_id());
     }
 }
 
-void MarketDataHandler::on_trade(const OrderBook* book,
-                                  liquibook::book::Quantity qty,
-                                  liquibook::book::Price price) {
-    // NOTE: on_trade는 더 이상 사용하지 않음 (중복 제거)
-    // 모든 체결 처리는 on_fill에서 수행:
-    //   - DayData (OHLC) 업데이트
-    //   - 1분봉 캔들 업데이트
-    //   - 랭킹 업데이트
-    //   - Kinesis fills 발행
-    // supernoba-trades 스트림을 소비하는 프로세서가 없으므로 publishTrade()도 제거
-    (void)book;
-    (void)qty;
-    (void)price;
-}
-
 void MarketDataHandler::on_depth_change(const OrderBook* book,
-                                         const BookDepth* depth) {
+                                         const BookDepth* /*depth*/) {
     std::string symbol = book->symbol();
-    Logger::debug("on_depth_change called for:", symbol);
-    
-    // 컴팩트 포맷: {"e":"d","s":"SYM","t":123,"b":[[p,q],...],"a":[[p,q],...]}
-    nlohmann::json depth_json;
-    depth_json["e"] = "d";  // event = depth
-    depth_json["s"] = symbol;
-    
-    // Bids (최대 20개)
-    nlohmann::json bids_arr = nlohmann::json::array();
-    const liquibook::book::DepthLevel* bid = depth->bids();
-    const liquibook::book::DepthLevel* bid_end = depth->last_bid_level() + 1;
-    int count = 0;
-    for (; bid != bid_end && count < 20; ++bid) {
-        if (bid->order_count() > 0) {
-            bids_arr.push_back({bid->price(), bid->aggregate_qty()});
-            count++;
-        }
-    }
-    depth_json["b"] = bids_arr;
-    
-    // Asks (최대 20개)
-    nlohmann::json asks_arr = nlohmann::json::array();
-    const liquibook::book::DepthLevel* ask = depth->asks();
-    const liquibook::book::DepthLevel* ask_end = depth->last_ask_level() + 1;
-    count = 0;
-    for (; ask != ask_end && count < 20; ++ask) {
-        if (ask->order_count() > 0) {
-            asks_arr.push_back({ask->price(), ask->aggregate_qty()});
-            count++;
-        }
-    }
-    depth_json["a"] = asks_arr;
+    LOGGER_DEBUG("on_depth_change called for:", symbol);
     
-    depth_json["t"] = std::chrono::duration_cast<std::chrono::milliseconds>(
-        std::chrono::system_clock::now().time_since_epoch()).count();
+    // 고정 Depth<10>은 10단계까지만 보이므로, 전체 호가(FullDepth)에서 상위 N단계를 읽는다.
+    const liquibook::book::FullDepth& full = book->full_depth();
+    full.top_n(true, depth_publish_levels_, depth_bid_scratch_);
+    full.top_n(false, depth_publish_levels_, depth_ask_scratch_);
 
     // 현재가만 추가 (변동률 c, yc, pc는 클라이언트에서 계산)
     DayData& day = getDayData(symbol);
@@ -334,34 +357,37 @@ void MarketDataHandler::on_depth_change(const OrderBook* book,
                 day.high_price = ohlc.value("h", (uint64_t)0);
                 day.low_price = ohlc.value("l", (uint64_t)0);
                 day.volume = ohlc.value("v", (uint64_t)0);
-                Logger::info("DayData restored from OHLC cache:", symbol,
+                LOGGER_INFO("DayData restored from OHLC cache:", symbol,
                              "price:", day.last_price);
             } catch (const std::exception& e) {
-                Logger::warn("Failed to parse OHLC cache for:", symbol, e.what());
+                LOGGER_WARN("Failed to parse OHLC cache for:", symbol, e.what());
             }
         }
     }
 
-    depth_json["p"] = day.last_price;
-    
+    // 컴팩트 포맷: {"a":[[p,q],...],"b":[[p,q],...],"e":"d","p":현재가,"s":"SYM","t":123}
+    writeDepthJson(json_buf_, symbol, depth_bid_scratch_, depth_ask_scratch_, day.last_price,
+                   clock_->nowMs());
+    Metrics::instance().incrementDepthPublished();
+
     // Valkey에 depth 캐시 저장 (Streaming Server가 읽어감)
-    Logger::debug("Depth cache check - depth_redis_:", depth_redis_ ? "exists" : "null",
+    LOGGER_DEBUG("Depth cache check - depth_redis_:", depth_redis_ ? "exists" : "null",
                   "connected:", (depth_redis_ && depth_redis_->isConnected()) ? "yes" : "no");
     if (depth_redis_ && depth_redis_->isConnected()) {
         std::string key = "depth:" + symbol;
-        std::string json_str = depth_json.dump();
-        Logger::debug("DEPTH_SAVE:", key, "=", json_str.substr(0, 200));  // 앞 200자만
+        LOGGER_DEBUG("DEPTH_SAVE:", key, "=", json_buf_.substr(0, 200));  // 앞 200자만
         // TTL 부여: 엔진이 죽으면 이 키가 만료되어 스트리머가 스테일 호가를 계속
         // 브로드캐스트하지 못하게 한다. TTL이 없으면 사용자에겐 "거래가 잠잠한 정상
         // 시장"으로 보이고, 그 상태로 넣은 주문은 체결되지 않은 채 쌓인다.
-        bool saved = depth_redis_->setEx(key, json_str, MARKET_DATA_TTL_SECONDS);
+        bool saved = depth_redis_->setEx(key, json_buf_, MARKET_DATA_TTL_SECONDS);
         if (saved) {
-            Logger::debug("Depth saved OK:", key);
+            LatencyTracer::stamp(TraceStage::DEPTH_WRITTEN);
+            LOGGER_DEBUG("Depth saved OK:", key);
         } else {
-            Logger::warn("Failed to save depth to Valkey:", key);
+            LOGGER_WARN("Failed to save depth to Valkey:", key);
         }
     } else {
-        Logger::warn("Depth cache not connected, skipping save for:", symbol);
+        LOGGER_WARN("Depth cache not connected, skipping save for:", symbol);
     }
     
     // Ticker 캐시도 갱신 (Sub 구독자에게 항시 현재 가격 제공)
@@ -371,13 +397,6 @@ void MarketDataHandler::on_depth_change(const OrderBook* book,
     }
 }
 
-void MarketDataHandler::on_bbo_change(const OrderBook* book,
-                                       const BookDepth* depth) {
-    // BBO 변경 시 depth 업데이트도 발행
-    Logger::debug("BBO change for:", book->symbol());
-    on_depth_change(book, depth);
-}
-
 // === Day Data 관리 ===
 
 DayData& MarketDataHandler::getDayData(const std::string& symbol) {
@@ -391,9 +410,9 @@ uint64_t MarketDataHandler::getLastPrice(const std::string& symbol) const {
 }
 
 int MarketDataHandler::getCurrentTradingDay() const {
-    auto now = std::chrono::system_clock::now();
-    std::time_t t = std::chrono::system_clock::to_time_t(now);
-    std::tm tm = *std::localtime(&t);
+    std::time_t t = std::chrono::system_clock::to_time_t(clock_->wallNow());
+    std::tm tm{};
+    localtime_r(&t, &tm);
     return (tm.tm_year + 1900) * 10000 + (tm.tm_mon + 1) * 100 + tm.tm_mday;
 }
 
@@ -405,7 +424,7 @@ void MarketDataHandler::checkDayReset(const std::string& symbol) {
         // 일일 데이터 리셋 (prev_close는 Aggregator가 관리)
         day = DayData{};
         day.trading_day = today;
-        Logger::info("Day reset for", symbol, "new trading day:", today);
+        LOGGER_INFO("Day reset for", symbol, "new trading day:", today);
     }
 }
 
@@ -413,16 +432,11 @@ void MarketDataHandler::updateTickerCache(const std::string& symbol, uint64_t pr
     if (!depth_redis_ || !depth_redis_->isConnected()) return;
 
     // Ticker JSON (Sub 데이터용) - 현재가만 전송, 변동률은 클라이언트 계산
-    nlohmann::json ticker;
-    ticker["e"] = "t";  // event = ticker
-    ticker["s"] = symbol;
-    ticker["t"] = std::chrono::duration_cast<std::chrono::milliseconds>(
-        std::chrono::system_clock::now().time_since_epoch()).count();
-    ticker["p"] = price;
+    writeTickerJson(json_buf_, symbol, price, clock_->nowMs());
 
     // depth와 동일하게 TTL 부여(엔진 사망 시 스테일 현재가 방송 차단).
-    depth_redis_->setEx("ticker:" + symbol, ticker.dump(), MARKET_DATA_TTL_SECONDS);
-    Logger::debug("Ticker saved:", symbol, "price:", price);
+    depth_redis_->setEx("ticker:" + symbol, json_buf_, MARKET_DATA_TTL_SECONDS);
+    LOGGER_DEBUG("Ticker saved:", symbol, "price:", price);
 }
 
 } // namespace aws_wrapper
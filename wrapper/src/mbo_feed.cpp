@@ -0,0 +1,366 @@
+#include "mbo_feed.h"
+#include "iproducer.h"
+#include "order.h"
+#include "logger.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+namespace aws_wrapper {
+
+namespace {
+
+void putU8(std::string& out, uint8_t v) {
+    out.push_back(static_cast<char>(v));
+}
+
+void putU32(std::string& out, uint32_t v) {
+    for (int i = 0; i < 4; ++i) out.push_back(static_cast<char>((v >> (8 * i)) & 0xff));
+}
+
+void putU64(std::string& out, uint64_t v) {
+    for (int i = 0; i < 8; ++i) out.push_back(static_cast<char>((v >> (8 * i)) & 0xff));
+}
+
+bool getU8(const std::string& in, size_t& pos, uint8_t& v) {
+    if (pos + 1 > in.size()) return false;
+    v = static_cast<uint8_t>(in[pos++]);
+    return true;
+}
+
+bool getU32(const std::string& in, size_t& pos, uint32_t& v) {
+    if (pos + 4 > in.size()) return false;
+    v = 0;
+    for (int i = 0; i < 4; ++i) v |= uint32_t(static_cast<uint8_t>(in[pos + i])) << (8 * i);
+    pos += 4;
+    return true;
+}
+
+bool getU64(const std::string& in, size_t& pos, uint64_t& v) {
+    if (pos + 8 > in.size()) return false;
+    v = 0;
+    for (int i = 0; i < 8; ++i) v |= uint64_t(static_cast<uint8_t>(in[pos + i])) << (8 * i);
+    pos += 8;
+    return true;
+}
+
+constexpr uint8_t MBO_MAGIC = 'M';
+constexpr uint8_t MBO_VERSION = 1;
+constexpr char KIND_LIVE = 'L';
+constexpr char KIND_SNAPSHOT = 'S';
+
+}  // namespace
+
+MboFeed::MboFeed(IProducer* sink, const Config& config, EngineClock* clock)
+    : sink_(sink), config_(config), clock_(clock ? clock : &EngineClock::real()),
+      ring_(config.ring_capacity) {
+    LOGGER_INFO("MboFeed created, ring:", ring_.capacity(),
+                 "flush_ms:", config_.flush_interval_ms,
+                 "history:", config_.history_per_symbol);
+}
+
+MboFeed::~MboFeed() {
+    stop();
+}
+
+void MboFeed::start() {
+    if (running_.load()) return;
+    running_ = true;
+    thread_ = std::thread(&MboFeed::run, this);
+    LOGGER_INFO("MboFeed batch thread started");
+}
+
+void MboFeed::stop() {
+    if (!running_.load()) return;
+    running_ = false;
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+    drain();  // 종료 직전까지 쌓인 이벤트 발행
+    LOGGER_INFO("MboFeed stopped, events:", event_count_.load(),
+                 "batches:", batch_count_.load());
+}
+
+void MboFeed::run() {
+    while (running_.load()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(config_.flush_interval_ms));
+        drain();
+    }
+}
+
+// === 생산자 (매칭 스레드) ===
+
+void MboFeed::onAdd(Order& order) {
+    push(ADD, order, order.price(), order.order_qty());
+}
+
+void MboFeed::onCancel(Order& order) {
+    push(CANCEL, order, order.price(), order.open_qty());
+}
+
+void MboFeed::onReplace(Order& order, uint64_t new_qty, uint64_t new_price) {
+    push(REPLACE, order, new_price, new_qty);
+}
+
+void MboFeed::onExecute(Order& order, uint64_t fill_qty, uint64_t fill_price) {
+    push(EXECUTE, order, fill_price, fill_qty);
+}
+
+MboStream* MboFeed::stream(Order& order) {
+    if (MboStream* cached = order.mboStream()) return cached;
+    if (order.symbol().size() > MAX_SYMBOL_LEN) return nullptr;
+    auto it = stream_index_.find(order.symbol());
+    if (it == stream_index_.end()) {
+        streams_.emplace_back();
+        streams_.back().symbol = order.symbol();
+        it = stream_index_.emplace(order.symbol(), &streams_.back()).first;
+    }
+    order.setMboStream(it->second);
+    return it->second;
+}
+
+void MboFeed::push(EventType type, Order& order, uint64_t price, uint64_t qty) {
+    MboStream* s = stream(order);
+    if (!s || order.order_id().size() > MAX_ORDER_ID_LEN) {
+        // 잘라 실으면 다른 주문과 섞인다 — seq를 쓰지 않고 버린다
+        if (oversize_drops_.fetch_add(1, std::memory_order_relaxed) == 0) {
+            LOGGER_WARN("MBO event dropped (symbol/order_id too long):", order.order_id());
+        }
+        return;
+    }
+
+    Slot slot;
+    slot.stream = s;
+    slot.seq = ++s->next_seq;
+    slot.ts_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        clock_->wallNow().time_since_epoch()).count();
+    slot.price = price;
+    slot.qty = qty;
+    slot.type = type;
+    slot.is_buy = order.is_buy() ? 1 : 0;
+    slot.order_id_len = static_cast<uint8_t>(order.order_id().size());
+    std::memcpy(slot.order_id, order.order_id().data(), slot.order_id_len);
+
+    // 엔진 락 아래서 기다리지 않는다. seq는 소비됐으므로 수신자에게는 공백으로 보인다.
+    if (!ring_.tryPush(slot)) {
+        dropped_events_.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+// === 소비자 (배치 스레드) ===
+
+void MboFeed::drain() {
+    std::lock_guard<std::mutex> consume_lock(consume_mutex_);
+    if (consume() > 0) {
+        publishPending();
+    }
+}
+
+size_t MboFeed::consume() {
+    size_t consumed = 0;
+    Slot slot;
+    std::lock_guard<std::mutex> lock(state_mutex_);
+    while (ring_.tryPop(slot)) {
+        std::string order_id(slot.order_id, slot.order_id_len);
+        SymbolState& state = states_[slot.stream->symbol];
+
+        // 링이 가득 차 버려진 이벤트가 있었다: 이력은 공백을 건너 재생할 수 없으므로 비우고,
+        // 살아있는 주문 집합도 더는 믿을 수 없다(스냅샷 불가, gap_seq 기록).
+        if (slot.seq != state.last_seq + 1) {
+            state.gap_seq = slot.seq - 1;
+            state.history.clear();
+        }
+
+        std::string record;
+        appendRecord(record, slot.type, slot.is_buy != 0, slot.seq, slot.ts_ns,
+                     slot.price, slot.qty, slot.order_id, slot.order_id_len);
+        state.pending += record;
+        ++state.pending_count;
+
+        if (state.history.empty()) state.first_seq = slot.seq;
+        state.history.push_back(std::move(record));
+        while (state.history.size() > config_.history_per_symbol) {
+            state.history.pop_front();
+            ++state.first_seq;
+        }
+        state.last_seq = slot.seq;
+
+        apply(state, slot, order_id);
+        ++consumed;
+    }
+    event_count_.fetch_add(consumed, std::memory_order_relaxed);
+    return consumed;
+}
+
+void MboFeed::apply(SymbolState& state, const Slot& slot, const std::string& order_id) {
+    switch (slot.type) {
+    case ADD:
+        state.live[order_id] = LiveOrder{slot.price, slot.qty, slot.seq, slot.is_buy != 0};
+        break;
+    case CANCEL:
+        state.live.erase(order_id);
+        break;
+    case REPLACE: {
+        auto it = state.live.find(order_id);
+        if (it == state.live.end()) break;
+        if (slot.qty == 0) {
+            state.live.erase(it);
+            break;
+        }
+        // 가격이 바뀌면 시간 우선순위를 잃는다
+        if (slot.price != it->second.price) it->second.seq = slot.seq;
+        it->second.price = slot.price;
+        it->second.qty = slot.qty;
+        break;
+    }
+    case EXECUTE: {
+        auto it = state.live.find(order_id);
+        if (it == state.live.end()) break;
+        if (it->second.qty <= slot.qty) {
+            state.live.erase(it);
+        } else {
+            it->second.qty -= slot.qty;
+        }
+        break;
+    }
+    default:
+        break;
+    }
+}
+
+void MboFeed::publishPending() {
+    std::vector<std::pair<std::string, std::string>> batches;
+    {
+        std::lock_guard<std::mutex> lock(state_mutex_);
+        for (auto& [symbol, state] : states_) {
+            if (state.pending_count == 0) continue;
+            std::string payload;
+            payload.reserve(state.pending.size() + 32);
+            appendHeader(payload, KIND_LIVE, symbol, state.last_seq, state.pending_count);
+            payload += state.pending;
+            batches.emplace_back(symbol, std::move(payload));
+            state.pending.clear();
+            state.pending_count = 0;
+        }
+    }
+    // 발행은 락 밖에서 (sink가 느려도 recover()를 막지 않음)
+    for (const auto& [symbol, payload] : batches) {
+        if (sink_) sink_->publishMbo(symbol, payload);
+    }
+    batch_count_.fetch_add(batches.size(), std::memory_order_relaxed);
+}
+
+// === 복구 ===
+
+bool MboFeed::recover(const std::string& symbol, uint64_t from_seq, std::string& out) {
+    out.clear();
+    std::lock_guard<std::mutex> lock(state_mutex_);
+    auto it = states_.find(symbol);
+    if (it == states_.end()) return false;
+    const SymbolState& state = it->second;
+
+    // 버려진 이벤트 이전부터는 재생도 스냅샷도 만들 수 없다
+    if (from_seq < state.gap_seq) {
+        LOGGER_WARN("MBO recover across dropped events:", symbol, "from:", from_seq,
+                     "gap through:", state.gap_seq);
+        return false;
+    }
+
+    // 이미 최신
+    if (from_seq >= state.last_seq) {
+        appendHeader(out, KIND_LIVE, symbol, state.last_seq, 0);
+        return true;
+    }
+
+    // 이력으로 이어 붙일 수 있으면 재생
+    if (!state.history.empty() && from_seq + 1 >= state.first_seq) {
+        size_t begin = static_cast<size_t>(from_seq + 1 - state.first_seq);
+        uint32_t count = static_cast<uint32_t>(state.history.size() - begin);
+        appendHeader(out, KIND_LIVE, symbol, state.last_seq, count);
+        for (size_t i = begin; i < state.history.size(); ++i) {
+            out += state.history[i];
+        }
+        return true;
+    }
+
+    // 이력이 밀려났으면 스냅샷: 살아있는 주문을 시간 우선순위(seq) 순서로.
+    // 공백이 있었던 종목은 살아있는 주문 집합이 불완전하므로 스냅샷을 만들지 않는다.
+    if (state.gap_seq != 0) return false;
+    std::vector<std::pair<const std::string*, const LiveOrder*>> orders;
+    orders.reserve(state.live.size());
+    for (const auto& [id, live] : state.live) {
+        orders.emplace_back(&id, &live);
+    }
+    std::sort(orders.begin(), orders.end(), [](const auto& a, const auto& b) {
+        return a.second->seq < b.second->seq;
+    });
+    appendHeader(out, KIND_SNAPSHOT, symbol, state.last_seq,
+                 static_cast<uint32_t>(orders.size()));
+    for (const auto& [id, live] : orders) {
+        appendRecord(out, ADD, live->is_buy, live->seq, 0, live->price, live->qty,
+                     id->data(), id->size());
+    }
+    return true;
+}
+
+// === 인코딩 ===
+
+void MboFeed::appendHeader(std::string& out, char kind, const std::string& symbol,
+                           uint64_t last_seq, uint32_t count) {
+    size_t sym_len = std::min(symbol.size(), MAX_SYMBOL_LEN);
+    putU8(out, MBO_MAGIC);
+    putU8(out, MBO_VERSION);
+    putU8(out, static_cast<uint8_t>(kind));
+    putU8(out, static_cast<uint8_t>(sym_len));
+    out.append(symbol.data(), sym_len);
+    putU64(out, last_seq);
+    putU32(out, count);
+}
+
+void MboFeed::appendRecord(std::string& out, uint8_t type, bool is_buy, uint64_t seq,
+                           uint64_t ts_ns, uint64_t price, uint64_t qty,
+                           const char* order_id, size_t order_id_len) {
+    putU8(out, type);
+    putU8(out, is_buy ? 1 : 0);
+    putU64(out, seq);
+    putU64(out, ts_ns);
+    putU64(out, price);
+    putU64(out, qty);
+    putU8(out, static_cast<uint8_t>(order_id_len));
+    out.append(order_id, order_id_len);
+}
+
+bool MboFeed::decode(const std::string& data, Batch& out) {
+    size_t pos = 0;
+    uint8_t magic, version, kind, sym_len;
+    if (!getU8(data, pos, magic) || magic != MBO_MAGIC) return false;
+    if (!getU8(data, pos, version) || version != MBO_VERSION) return false;
+    if (!getU8(data, pos, kind) || !getU8(data, pos, sym_len)) return false;
+    if (pos + sym_len > data.size()) return false;
+    out.is_snapshot = (kind == KIND_SNAPSHOT);
+    out.symbol.assign(data, pos, sym_len);
+    pos += sym_len;
+    uint32_t count;
+    if (!getU64(data, pos, out.last_seq) || !getU32(data, pos, count)) return false;
+
+    out.records.clear();
+    out.records.reserve(count);
+    for (uint32_t i = 0; i < count; ++i) {
+        Record r;
+        uint8_t type, side, id_len;
+        if (!getU8(data, pos, type) || !getU8(data, pos, side) ||
+            !getU64(data, pos, r.seq) || !getU64(data, pos, r.ts_ns) ||
+            !getU64(data, pos, r.price) || !getU64(data, pos, r.qty) ||
+            !getU8(data, pos, id_len) || pos + id_len > data.size()) {
+            return false;
+        }
+        r.type = static_cast<EventType>(type);
+        r.is_buy = side != 0;
+        r.order_id.assign(data, pos, id_len);
+        pos += id_len;
+        out.records.push_back(std::move(r));
+    }
+    return pos == data.size();
+}
+
+} // namespace aws_wrapper
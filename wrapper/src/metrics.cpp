@@ -0,0 +1,172 @@
+#include "metrics.h"
+#include <cstdio>
+#include <limits>
+
+namespace aws_wrapper {
+
+namespace {
+
+// Prometheus histogram 경계: 1µs ~ 약 17s, 2배 간격 (2^k ns는 히스토그램 칸 경계와 일치)
+constexpr int LE_MIN_SHIFT = 10;
+constexpr int LE_MAX_SHIFT = 34;
+
+const double QUANTILES[] = {0.5, 0.9, 0.99, 0.999};
+
+std::string formatDouble(double v) {
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "%.9g", v);
+    return buf;
+}
+
+void writeHeader(std::string& out, const std::string& name, const std::string& help,
+                 const char* type) {
+    out += "# HELP " + name + " " + help + "\n";
+    out += "# TYPE " + name + " " + type + "\n";
+}
+
+}  // namespace
+
+// === LatencyHistogram ===
+
+uint64_t LatencyHistogram::bucketLower(size_t idx) {
+    if (idx < SUB_COUNT) return idx;
+    size_t octave = idx >> SUB_BITS;
+    uint64_t sub = idx & (SUB_COUNT - 1);
+    return (SUB_COUNT + sub) << (octave - 1);
+}
+
+uint64_t LatencyHistogram::bucketUpper(size_t idx) {
+    if (idx + 1 >= BUCKETS) return std::numeric_limits<uint64_t>::max();
+    return bucketLower(idx + 1) - 1;
+}
+
+uint64_t LatencyHistogram::percentile(double q) const {
+    uint64_t total = count();
+    if (total == 0) return 0;
+    if (q < 0.0) q = 0.0;
+    if (q > 1.0) q = 1.0;
+    // 순위 ceil(q*total) 번째 표본이 든 칸
+    uint64_t rank = static_cast<uint64_t>(q * static_cast<double>(total));
+    if (static_cast<double>(rank) < q * static_cast<double>(total)) ++rank;
+    if (rank == 0) rank = 1;
+
+    uint64_t seen = 0;
+    for (size_t i = 0; i < BUCKETS; ++i) {
+        seen += buckets_[i].load(std::memory_order_relaxed);
+        if (seen >= rank) {
+            // 최댓값보다 큰 상한은 보고하지 않는다
+            uint64_t upper = bucketUpper(i);
+            uint64_t max = maxNs();
+            return (max != 0 && upper > max) ? max : upper;
+        }
+    }
+    return maxNs();  // 기록 중 경합으로 count가 앞선 경우
+}
+
+uint64_t LatencyHistogram::countAtOrBelow(uint64_t limit_ns) const {
+    uint64_t n = 0;
+    for (size_t i = 0; i < BUCKETS && bucketUpper(i) <= limit_ns; ++i) {
+        n += buckets_[i].load(std::memory_order_relaxed);
+    }
+    return n;
+}
+
+// === Metrics ===
+
+void Metrics::addCollector(Collector collector) {
+    std::lock_guard<std::mutex> lock(collectors_mutex_);
+    collectors_.push_back(std::move(collector));
+}
+
+std::string Metrics::renderPrometheus() const {
+    std::string out;
+    out.reserve(8192);
+
+    writeCounter(out, "engine_orders_received_total", "Order records consumed from the stream",
+                 getOrdersReceived());
+    writeCounter(out, "engine_orders_accepted_total", "Orders accepted by the book",
+                 getOrdersAccepted());
+    writeCounter(out, "engine_orders_rejected_total", "Orders rejected (book or decode failure)",
+                 getOrdersRejected());
+    writeCounter(out, "engine_trades_executed_total", "Fills executed by the matcher",
+                 getTradesExecuted());
+    writeCounter(out, "engine_fills_published_total", "Fill events handed to the producer",
+                 getFillsPublished());
+    writeCounter(out, "engine_depth_published_total", "Depth snapshots built for publication",
+                 getDepthPublished());
+
+    writeHistogram(out, "engine_decode_latency_seconds",
+                   "Order record decode latency (JSON parse + Order)", decode_);
+    writeHistogram(out, "engine_match_latency_seconds",
+                   "EngineCore order API latency including lock wait", match_);
+    writeHistogram(out, "engine_publish_latency_seconds",
+                   "Kinesis PutRecord latency including retries", publish_);
+    writeHistogram(out, "engine_redis_rtt_seconds", "Redis command round trip", redis_rtt_);
+
+    std::lock_guard<std::mutex> lock(collectors_mutex_);
+    for (const auto& collector : collectors_) {
+        collector(out);
+    }
+    return out;
+}
+
+void Metrics::writeCounter(std::string& out, const std::string& name,
+                           const std::string& help, uint64_t value) {
+    writeHeader(out, name, help, "counter");
+    out += name + " " + std::to_string(value) + "\n";
+}
+
+void Metrics::writeGauge(std::string& out, const std::string& name,
+                         const std::string& help, double value) {
+    writeHeader(out, name, help, "gauge");
+    out += name + " " + formatDouble(value) + "\n";
+}
+
+void Metrics::writeHistogram(std::string& out, const std::string& name,
+                             const std::string& help, const LatencyHistogram& hist) {
+    writeHistogramFamily(out, name, help, "", {{"", &hist}});
+}
+
+void Metrics::writeHistogramFamily(
+    std::string& out, const std::string& name, const std::string& help,
+    const std::string& label,
+    const std::vector<std::pair<std::string, const LatencyHistogram*>>& series) {
+    // 라벨이 없으면 series는 하나이고 선택자를 비운다
+    auto selector = [&label](const std::string& value, const std::string& extra) {
+        std::string sel = label.empty() ? "" : label + "=\"" + value + "\"";
+        if (!extra.empty()) sel += (sel.empty() ? "" : ",") + extra;
+        return sel.empty() ? std::string() : "{" + sel + "}";
+    };
+
+    writeHeader(out, name, help, "histogram");
+    for (const auto& [value, hist] : series) {
+        // count를 먼저 읽어 +Inf 버킷이 하위 버킷보다 작아지지 않게 한다
+        uint64_t total = hist->count();
+        for (int shift = LE_MIN_SHIFT; shift <= LE_MAX_SHIFT; ++shift) {
+            uint64_t limit_ns = uint64_t(1) << shift;
+            uint64_t n = hist->countAtOrBelow(limit_ns - 1);
+            if (n > total) n = total;
+            out += name + "_bucket" +
+                   selector(value, "le=\"" + formatDouble(static_cast<double>(limit_ns) / 1e9) + "\"") +
+                   " " + std::to_string(n) + "\n";
+        }
+        out += name + "_bucket" + selector(value, "le=\"+Inf\"") + " " + std::to_string(total) + "\n";
+        out += name + "_sum" + selector(value, "") + " " +
+               formatDouble(static_cast<double>(hist->sumNs()) / 1e9) + "\n";
+        out += name + "_count" + selector(value, "") + " " + std::to_string(total) + "\n";
+    }
+
+    // 꼬리 지연 감시용 HDR 분위수 (버킷 경계보다 촘촘한 해상도)
+    const std::string qname = name.substr(0, name.rfind("_seconds")) + "_quantile_seconds";
+    writeHeader(out, qname, help + " (HDR quantile)", "gauge");
+    for (const auto& [value, hist] : series) {
+        for (double q : QUANTILES) {
+            out += qname + selector(value, "quantile=\"" + formatDouble(q) + "\"") + " " +
+                   formatDouble(static_cast<double>(hist->percentile(q)) / 1e9) + "\n";
+        }
+        out += qname + selector(value, "quantile=\"1\"") + " " +
+               formatDouble(static_cast<double>(hist->maxNs()) / 1e9) + "\n";
+    }
+}
+
+} // namespace aws_wrapper
@@ -0,0 +1,153 @@
+#include "metrics_http.h"
+#include "logger.h"
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+
+namespace aws_wrapper {
+
+namespace {
+
+constexpr int POLL_INTERVAL_MS = 200;     // stop() 반응 주기
+constexpr int CLIENT_TIMEOUT_MS = 1000;   // 느린 클라이언트가 스레드를 붙잡지 않도록
+constexpr size_t MAX_REQUEST_BYTES = 4096;
+
+void sendAll(int fd, const std::string& data) {
+    size_t sent = 0;
+    while (sent < data.size()) {
+        ssize_t n = ::send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+        if (n <= 0) {
+            if (n < 0 && errno == EINTR) continue;
+            return;
+        }
+        sent += static_cast<size_t>(n);
+    }
+}
+
+std::string response(const char* status, const char* content_type, const std::string& body) {
+    std::string out;
+    out.reserve(body.size() + 128);
+    out += "HTTP/1.0 ";
+    out += status;
+    out += "\r\nContent-Type: ";
+    out += content_type;
+    out += "\r\nContent-Length: " + std::to_string(body.size());
+    out += "\r\nConnection: close\r\n\r\n";
+    out += body;
+    return out;
+}
+
+}  // namespace
+
+MetricsHttpServer::MetricsHttpServer(int port, Renderer renderer)
+    : port_(port), renderer_(std::move(renderer)) {}
+
+MetricsHttpServer::~MetricsHttpServer() {
+    stop();
+}
+
+bool MetricsHttpServer::start() {
+    if (running_.load()) return true;
+
+    listen_fd_ = ::socket(AF_INET, SOCK_STREAM, 0);
+    if (listen_fd_ < 0) {
+        Logger::error("MetricsHttpServer: socket() failed:", std::strerror(errno));
+        return false;
+    }
+    int reuse = 1;
+    ::setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    addr.sin_port = htons(static_cast<uint16_t>(port_));
+    if (::bind(listen_fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0 ||
+        ::listen(listen_fd_, 16) < 0) {
+        Logger::error("MetricsHttpServer: bind/listen on port", port_, "failed:",
+                      std::strerror(errno));
+        ::close(listen_fd_);
+        listen_fd_ = -1;
+        return false;
+    }
+
+    // port 0 → 실제 배정된 포트
+    socklen_t len = sizeof(addr);
+    if (::getsockname(listen_fd_, reinterpret_cast<sockaddr*>(&addr), &len) == 0) {
+        port_ = ntohs(addr.sin_port);
+    }
+
+    running_ = true;
+    thread_ = std::thread(&MetricsHttpServer::run, this);
+    Logger::info("Metrics endpoint listening on port", port_, "(/metrics)");
+    return true;
+}
+
+void MetricsHttpServer::stop() {
+    if (!running_.exchange(false)) return;
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+    if (listen_fd_ >= 0) {
+        ::close(listen_fd_);
+        listen_fd_ = -1;
+    }
+    Logger::info("MetricsHttpServer stopped, requests served:", requests_.load());
+}
+
+void MetricsHttpServer::run() {
+    while (running_.load()) {
+        pollfd pfd{listen_fd_, POLLIN, 0};
+        int ready = ::poll(&pfd, 1, POLL_INTERVAL_MS);
+        if (ready <= 0) continue;
+
+        int client = ::accept(listen_fd_, nullptr, nullptr);
+        if (client < 0) continue;
+
+        timeval tv{CLIENT_TIMEOUT_MS / 1000, (CLIENT_TIMEOUT_MS % 1000) * 1000};
+        ::setsockopt(client, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+        ::setsockopt(client, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+        handle(client);
+        ::close(client);
+    }
+}
+
+void MetricsHttpServer::handle(int client_fd) {
+    // 헤더 끝(빈 줄)까지만 읽는다 — 본문 있는 요청은 받지 않는다
+    std::string request;
+    char buf[1024];
+    while (request.find("\r\n\r\n") == std::string::npos &&
+           request.find("\n\n") == std::string::npos &&
+           request.size() < MAX_REQUEST_BYTES) {
+        ssize_t n = ::recv(client_fd, buf, sizeof(buf), 0);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) break;
+        request.append(buf, static_cast<size_t>(n));
+    }
+    requests_.fetch_add(1, std::memory_order_relaxed);
+
+    // 요청 줄: METHOD SP PATH SP VERSION
+    std::string line = request.substr(0, request.find_first_of("\r\n"));
+    size_t sp1 = line.find(' ');
+    size_t sp2 = sp1 == std::string::npos ? std::string::npos : line.find(' ', sp1 + 1);
+    std::string method = line.substr(0, sp1);
+    std::string path = sp1 == std::string::npos ? "" : line.substr(sp1 + 1, sp2 - sp1 - 1);
+    path = path.substr(0, path.find('?'));
+
+    if (method != "GET") {
+        sendAll(client_fd, response("405 Method Not Allowed", "text/plain", "method not allowed\n"));
+    } else if (path == "/metrics") {
+        sendAll(client_fd, response("200 OK", "text/plain; version=0.0.4; charset=utf-8",
+                                    renderer_ ? renderer_() : std::string()));
+    } else if (path == "/healthz") {
+        sendAll(client_fd, response("200 OK", "text/plain", "ok\n"));
+    } else {
+        sendAll(client_fd, response("404 Not Found", "text/plain", "not found\n"));
+    }
+}
+
+} // namespace aws_wrapper
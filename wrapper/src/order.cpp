@@ -1,10 +1,12 @@
 #include "order.h"
 #include "logger.h"
+#include <cctype>
 #include <chrono>
+#include <cstdio>
 
 namespace aws_wrapper {
 
-std::shared_ptr<Order> Order::fromJson(const nlohmann::json& j) {
+std::shared_ptr<Order> Order::fromJson(const nlohmann::json& j, const EngineClock* clock) {
     auto order = std::make_shared<Order>();
     
     order->order_id_ = j.value("order_id", "");
@@ -37,16 +39,63 @@ std::shared_ptr<Order> Order::fromJson(const nlohmann::json& j) {
         }
     }
     
-    order->timestamp_ = j.value("timestamp", 
-        std::chrono::duration_cast<std::chrono::milliseconds>(
-            std::chrono::system_clock::now().time_since_epoch()).count());
+    // 타임스탬프가 없는 입력만 수신 시각으로 채운다 (입력 기반 시계에서는 마지막 입력 시각)
+    if (j.contains("timestamp")) {
+        order->timestamp_ = j["timestamp"].get<int64_t>();
+    } else {
+        order->timestamp_ = (clock ? *clock : EngineClock::real()).nowMs();
+    }
     
-    Logger::debug("Order parsed:", order->order_id_, order->symbol_, 
+    LOGGER_DEBUG("Order parsed:", order->order_id_, order->symbol_, 
                   order->is_buy_ ? "BUY" : "SELL", order->price_, order->order_qty_);
     
     return order;
 }
 
+int64_t Order::parseTimestampMs(const std::string& text) {
+    if (text.empty()) {
+        return -1;
+    }
+    // epoch ms 숫자
+    if (text.find_first_not_of("0123456789") == std::string::npos) {
+        return text.size() <= 15 ? std::stoll(text) : -1;
+    }
+
+    // YYYY-MM-DDTHH:MM:SS[.fff]Z
+    int y = 0, mo = 0, d = 0, h = 0, mi = 0, sec = 0, consumed = 0;
+    if (std::sscanf(text.c_str(), "%4d-%2d-%2dT%2d:%2d:%2d%n",
+                    &y, &mo, &d, &h, &mi, &sec, &consumed) != 6 ||
+        mo < 1 || mo > 12 || d < 1 || d > 31 || h > 23 || mi > 59 || sec > 60) {
+        return -1;
+    }
+    int64_t ms = 0;
+    size_t pos = static_cast<size_t>(consumed);
+    if (pos < text.size() && text[pos] == '.') {
+        // 소수 초는 앞 세 자리(ms)만 쓰고 나머지는 버린다
+        int digits = 0;
+        for (++pos; pos < text.size() && std::isdigit(static_cast<unsigned char>(text[pos])); ++pos) {
+            if (digits < 3) {
+                ms = ms * 10 + (text[pos] - '0');
+                ++digits;
+            }
+        }
+        for (; digits < 3; ++digits) ms *= 10;
+    }
+    if (pos != text.size() - 1 || text[pos] != 'Z') {
+        return -1;  // UTC(Z) 표기만 받는다 — toISOString 형식
+    }
+
+    // 그레고리력 날짜 → epoch 일수 (days_from_civil)
+    const int64_t yy = y - (mo <= 2 ? 1 : 0);
+    const int64_t era = (yy >= 0 ? yy : yy - 399) / 400;
+    const int64_t yoe = yy - era * 400;
+    const int64_t doy = (153 * (mo + (mo > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+    const int64_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    const int64_t days = era * 146097 + doe - 719468;
+
+    return ((days * 24 + h) * 60 + mi) * 60000 + sec * 1000LL + ms;
+}
+
 nlohmann::json Order::toJson() const {
     nlohmann::json j;
     j["order_id"] = order_id_;
@@ -73,7 +122,7 @@ void Order::fill(liquibook::book::Quantity fill_qty,
     filled_qty_ += fill_qty;
     filled_cost_ += fill_cost;
     
-    Logger::info("Order filled:", order_id_, "qty:", fill_qty, 
+    LOGGER_INFO("Order filled:", order_id_, "qty:", fill_qty, 
                  "cost:", fill_cost, "total_filled:", filled_qty_);
 }
 
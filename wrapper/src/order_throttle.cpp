@@ -0,0 +1,167 @@
+#include "order_throttle.h"
+#include "iproducer.h"
+#include "config.h"
+#include "logger.h"
+#include "metrics.h"
+#include <algorithm>
+#include <cmath>
+#include <functional>
+
+namespace aws_wrapper {
+
+namespace {
+
+double parseRate(const std::string& key) {
+    try {
+        return std::max(0.0, std::stod(Config::get(key, "0")));
+    } catch (...) {
+        return 0.0;
+    }
+}
+
+// 버스트 미설정이면 초당 한도만큼 (최소 1)
+double parseBurst(const std::string& key, double rate) {
+    try {
+        const double burst = std::stod(Config::get(key, "0"));
+        if (burst > 0.0) return std::max(1.0, burst);
+    } catch (...) {
+    }
+    return std::max(1.0, rate);
+}
+
+int64_t toNs(std::chrono::steady_clock::time_point t) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(t.time_since_epoch()).count();
+}
+
+} // namespace
+
+TokenBucketTable::TokenBucketTable(double rate, double burst)
+    : rate_(rate), burst_(burst), slots_(rate > 0.0 ? 64 : 0) {}
+
+TokenBucketTable::Slot& TokenBucketTable::slot(uint64_t key) {
+    if (key == 0) key = 1;
+    const size_t mask = slots_.size() - 1;
+    for (size_t i = key & mask;; i = (i + 1) & mask) {
+        Slot& s = slots_[i];
+        if (s.key == key) return s;
+        if (s.key == 0) {
+            if ((used_ + 1) * 2 > slots_.size()) {
+                grow();
+                return slot(key);
+            }
+            s.key = key;
+            s.tokens = burst_;
+            ++used_;
+            return s;
+        }
+    }
+}
+
+void TokenBucketTable::grow() {
+    std::vector<Slot> old(slots_.size() * 2);
+    old.swap(slots_);
+    const size_t mask = slots_.size() - 1;
+    for (const Slot& s : old) {
+        if (s.key == 0) continue;
+        size_t i = s.key & mask;
+        while (slots_[i].key != 0) i = (i + 1) & mask;
+        slots_[i] = s;
+    }
+}
+
+int64_t TokenBucketTable::waitNs(uint64_t key, std::chrono::steady_clock::time_point now) {
+    Slot& s = slot(key);
+    const int64_t now_ns = toNs(now);
+    if (s.last_ns != 0 && now_ns > s.last_ns) {
+        s.tokens = std::min(burst_, s.tokens + (now_ns - s.last_ns) * rate_ / 1e9);
+    }
+    s.last_ns = std::max(s.last_ns, now_ns);
+    last_ = &s;
+    if (s.tokens >= 1.0) return 0;
+    return static_cast<int64_t>(std::ceil((1.0 - s.tokens) / rate_ * 1e9));
+}
+
+void TokenBucketTable::take(uint64_t key) {
+    Slot& s = (last_ && last_->key == (key == 0 ? 1 : key)) ? *last_ : slot(key);
+    s.tokens -= 1.0;
+}
+
+OrderThrottle::OrderThrottle(IProducer* producer, const EngineClock* clock)
+    : producer_(producer),
+      clock_(clock ? clock : &EngineClock::real()),
+      users_(parseRate("THROTTLE_USER_RATE"),
+             parseBurst("THROTTLE_USER_BURST", parseRate("THROTTLE_USER_RATE"))),
+      symbols_(parseRate("THROTTLE_SYMBOL_RATE"),
+               parseBurst("THROTTLE_SYMBOL_BURST", parseRate("THROTTLE_SYMBOL_RATE"))) {
+    policy_ = Config::get("THROTTLE_POLICY", "reject") == "delay" ? Policy::DELAY
+                                                                   : Policy::REJECT;
+    max_delay_ = std::chrono::milliseconds(std::max(0, Config::getInt("THROTTLE_MAX_DELAY_MS", 50)));
+    reject_batch_ = static_cast<size_t>(std::max(1, Config::getInt("THROTTLE_REJECT_BATCH", 64)));
+    if (enabled()) {
+        LOGGER_INFO("Order throttle enabled: user", parseRate("THROTTLE_USER_RATE"),
+                     "/s, symbol", parseRate("THROTTLE_SYMBOL_RATE"), "/s, policy",
+                     policy_ == Policy::DELAY ? "delay" : "reject");
+    }
+}
+
+OrderThrottle::Verdict OrderThrottle::admit(const OrderPtr& order, bool is_replace) {
+    Verdict verdict;
+    if (!enabled()) return verdict;
+
+    const auto now = clock_->monotonicNow();
+    const uint64_t user_key = std::hash<std::string>{}(order->user_id());
+    const uint64_t symbol_key = std::hash<std::string>{}(order->symbol());
+    int64_t wait = 0;
+    if (users_.enabled()) wait = users_.waitNs(user_key, now);
+    if (symbols_.enabled()) wait = std::max(wait, symbols_.waitNs(symbol_key, now));
+
+    if (wait == 0 || (policy_ == Policy::DELAY && std::chrono::nanoseconds(wait) <= max_delay_)) {
+        if (users_.enabled()) users_.take(user_key);
+        if (symbols_.enabled()) symbols_.take(symbol_key);
+        if (wait > 0) {
+            verdict.delay = std::chrono::nanoseconds(wait);
+            delayed_orders_.fetch_add(1, std::memory_order_relaxed);
+            delay_ns_.fetch_add(static_cast<uint64_t>(wait), std::memory_order_relaxed);
+        }
+        return verdict;
+    }
+
+    verdict.admitted = false;
+    throttled_orders_.fetch_add(1, std::memory_order_relaxed);
+    throttled_qty_.fetch_add(order->order_qty(), std::memory_order_relaxed);
+    bool full;
+    {
+        std::lock_guard<std::mutex> lock(pending_mutex_);
+        pending_.push_back({order, is_replace});
+        full = pending_.size() >= reject_batch_;
+    }
+    if (full) flushRejected();
+    return verdict;
+}
+
+size_t OrderThrottle::flushRejected() {
+    std::vector<Pending> batch;
+    {
+        std::lock_guard<std::mutex> lock(pending_mutex_);
+        batch.swap(pending_);
+    }
+    for (const auto& entry : batch) {
+        const OrderPtr& order = entry.order;
+        Metrics::instance().incrementOrdersRejected();
+        if (producer_) {
+            // 정정 거부: 원 주문은 호가창에 남아 있으므로 REJECTED로 닫게 하면 안 된다
+            producer_->publishOrderStatus(order->symbol(), order->order_id(),
+                                          order->user_id(),
+                                          entry.replace ? "REPLACE_REJECTED" : "REJECTED",
+                                          "Throttled (order rate limit)",
+                                          order->price(), order->order_qty(),
+                                          order->is_buy(), order->order_type());
+        }
+    }
+    if (!batch.empty()) {
+        LOGGER_WARN("Throttled orders rejected:", batch.size());
+    }
+    return batch.size();
+}
+
+} // namespace aws_wrapper
@@ -0,0 +1,226 @@
+#include "pre_trade_risk.h"
+#include "order.h"
+#include "config.h"
+#include "logger.h"
+#include <algorithm>
+#include <sstream>
+
+namespace aws_wrapper {
+
+namespace {
+
+uint64_t parseLimit(const std::string& value) {
+    try {
+        return value.empty() ? 0 : std::stoull(value);
+    } catch (...) {
+        return 0;
+    }
+}
+
+// 명목가: 지정가는 주문 가격, 시장가는 기준가. 시장가 매수의 price는 라우터가 잔고로 정한
+// 지불 상한이지 체결 예상가가 아니다 — 기준가가 없거나 상한보다 높을 때만 상한을 쓴다.
+liquibook::book::Price notionalPrice(const Order& order, liquibook::book::Price reference) {
+    if (order.order_type() != "MARKET") return order.price() != 0 ? order.price() : reference;
+    if (order.price() != 0 && (reference == 0 || order.price() < reference)) return order.price();
+    return reference;
+}
+
+} // namespace
+
+PreTradeRisk::PreTradeRisk() {
+    defaults_.max_open_orders = static_cast<uint32_t>(
+        std::max(0, Config::getInt("RISK_MAX_OPEN_ORDERS", 0)));
+    defaults_.max_open_notional = parseLimit(Config::get("RISK_MAX_OPEN_NOTIONAL", "0"));
+    defaults_.max_order_qty = parseLimit(Config::get("RISK_MAX_ORDER_QTY", "0"));
+
+    // 종목별 덮어쓰기: SYM:주문수:명목금액:수량 (쉼표 구분)
+    std::istringstream entries(Config::get("RISK_SYMBOL_LIMITS", ""));
+    for (std::string entry; std::getline(entries, entry, ',');) {
+        std::istringstream fields(entry);
+        std::string symbol, orders, notional, qty;
+        std::getline(fields, symbol, ':');
+        std::getline(fields, orders, ':');
+        std::getline(fields, notional, ':');
+        std::getline(fields, qty, ':');
+        if (symbol.empty()) continue;
+        RiskLimits limits;
+        limits.max_open_orders = static_cast<uint32_t>(parseLimit(orders));
+        limits.max_open_notional = parseLimit(notional);
+        limits.max_order_qty = parseLimit(qty);
+        symbol_limits_[symbol] = limits;
+    }
+
+    enabled_ = defaults_.any();
+    for (const auto& [symbol, limits] : symbol_limits_) {
+        enabled_ = enabled_ || limits.any();
+    }
+    if (enabled_) {
+        LOGGER_INFO("Pre-trade risk enabled: open orders", defaults_.max_open_orders,
+                     ", open notional", defaults_.max_open_notional,
+                     ", order qty", defaults_.max_order_qty,
+                     ", symbol overrides", symbol_limits_.size());
+    }
+}
+
+const RiskLimits& PreTradeRisk::limits(const std::string& symbol) const {
+    auto it = symbol_limits_.find(symbol);
+    return it != symbol_limits_.end() ? it->second : defaults_;
+}
+
+uint32_t PreTradeRisk::internUser(const std::string& user_id) {
+    auto [it, inserted] = user_ids_.emplace(user_id, static_cast<uint32_t>(user_ids_.size()));
+    return it->second;
+}
+
+uint32_t PreTradeRisk::internSymbol(const std::string& symbol) {
+    auto [it, inserted] = symbol_ids_.emplace(symbol, static_cast<uint32_t>(tables_.size()));
+    if (inserted) {
+        tables_.emplace_back();
+        tables_.back().limits = limits(symbol);
+    }
+    return it->second;
+}
+
+PreTradeRisk::Exposure& PreTradeRisk::exposure(uint32_t table, uint32_t user) {
+    auto& users = tables_[table].users;
+    if (user >= users.size()) users.resize(user_ids_.size());
+    return users[user];
+}
+
+const char* PreTradeRisk::check(Order& order, liquibook::book::Price reference) {
+    if (!enabled_) return nullptr;
+
+    RiskTag& tag = order.riskTag();
+    tag.table = internSymbol(order.symbol());
+    tag.user = internUser(order.user_id());
+    tag.price = notionalPrice(order, reference);
+    tag.open = 0;
+    tag.counted = false;
+
+    const RiskLimits& lim = tables_[tag.table].limits;
+    const Exposure& e = exposure(tag.table, tag.user);
+    const uint64_t qty = order.order_qty();
+    if (lim.max_order_qty && qty > lim.max_order_qty) {
+        return "Order quantity exceeds risk limit";
+    }
+    if (lim.max_open_orders && e.open_orders >= lim.max_open_orders) {
+        return "Open order count risk limit reached";
+    }
+    if (lim.max_open_notional && e.open_notional + tag.price * qty > lim.max_open_notional) {
+        return "Open notional risk limit exceeded";
+    }
+    return nullptr;
+}
+
+void PreTradeRisk::reprice(Order& order) {
+    RiskTag& tag = order.riskTag();
+    if (!enabled_ || tag.table == RiskTag::NONE || tag.counted) return;
+    tag.price = order.price();
+}
+
+const char* PreTradeRisk::checkReplace(const Order& order, int64_t size_delta,
+                                       liquibook::book::Price new_price) const {
+    const RiskTag& tag = order.riskTag();
+    if (!enabled_ || !tag.counted) return nullptr;
+
+    const RiskLimits& lim = tables_[tag.table].limits;
+    const int64_t new_open = static_cast<int64_t>(tag.open) + size_delta;
+    if (new_open <= 0) return nullptr;   // 전량 취소 성격 — 노출이 줄기만 한다
+    const uint64_t open = static_cast<uint64_t>(new_open);
+    if (lim.max_order_qty && open > lim.max_order_qty) {
+        return "Order quantity exceeds risk limit";
+    }
+    if (lim.max_open_notional) {
+        const auto price = new_price != liquibook::book::PRICE_UNCHANGED ? new_price : tag.price;
+        const auto& users = tables_[tag.table].users;
+        const uint64_t current = tag.user < users.size() ? users[tag.user].open_notional : 0;
+        const uint64_t others = current - std::min(current, tag.price * tag.open);
+        if (others + price * open > lim.max_open_notional) {
+            return "Open notional risk limit exceeded";
+        }
+    }
+    return nullptr;
+}
+
+void PreTradeRisk::onAccept(Order& order) {
+    RiskTag& tag = order.riskTag();
+    if (!enabled_ || tag.table == RiskTag::NONE || tag.counted) return;
+    tag.open = order.open_qty();
+    tag.counted = true;
+    Exposure& e = exposure(tag.table, tag.user);
+    ++e.open_orders;
+    e.open_notional += tag.price * tag.open;
+}
+
+void PreTradeRisk::release(Order& order, liquibook::book::Quantity qty) {
+    RiskTag& tag = order.riskTag();
+    qty = std::min(qty, tag.open);
+    Exposure& e = exposure(tag.table, tag.user);
+    e.open_notional -= std::min(e.open_notional, tag.price * qty);
+    tag.open -= qty;
+    if (tag.open == 0) {
+        if (e.open_orders > 0) --e.open_orders;
+        tag.counted = false;
+    }
+}
+
+void PreTradeRisk::onFill(Order& order, liquibook::book::Quantity qty) {
+    if (!order.riskTag().counted) return;
+    release(order, qty);
+}
+
+void PreTradeRisk::onClose(Order& order) {
+    if (!order.riskTag().counted) return;
+    release(order, order.riskTag().open);
+}
+
+void PreTradeRisk::onReplace(Order& order, int64_t size_delta, liquibook::book::Price new_price) {
+    RiskTag& tag = order.riskTag();
+    if (!tag.counted) return;
+    Exposure& e = exposure(tag.table, tag.user);
+    e.open_notional -= std::min(e.open_notional, tag.price * tag.open);
+    const int64_t new_open = static_cast<int64_t>(tag.open) + size_delta;
+    tag.open = new_open > 0 ? static_cast<liquibook::book::Quantity>(new_open) : 0;
+    if (new_price != liquibook::book::PRICE_UNCHANGED) tag.price = new_price;
+    e.open_notional += tag.price * tag.open;
+    if (tag.open == 0) {
+        if (e.open_orders > 0) --e.open_orders;
+        tag.counted = false;
+    }
+}
+
+void PreTradeRisk::track(Order& order, liquibook::book::Price reference) {
+    if (!enabled_) return;
+    RiskTag& tag = order.riskTag();
+    tag.table = internSymbol(order.symbol());
+    tag.user = internUser(order.user_id());
+    tag.price = order.price() != 0 ? order.price() : reference;
+    tag.counted = false;
+    onAccept(order);
+}
+
+void PreTradeRisk::reset(const std::string& symbol) {
+    auto it = symbol_ids_.find(symbol);
+    if (it != symbol_ids_.end()) tables_[it->second].users.clear();
+}
+
+const PreTradeRisk::Exposure* PreTradeRisk::find(const std::string& symbol,
+                                                 const std::string& user_id) const {
+    auto sym = symbol_ids_.find(symbol);
+    auto user = user_ids_.find(user_id);
+    if (sym == symbol_ids_.end() || user == user_ids_.end()) return nullptr;
+    const auto& users = tables_[sym->second].users;
+    return user->second < users.size() ? &users[user->second] : nullptr;
+}
+
+uint32_t PreTradeRisk::openOrders(const std::string& symbol, const std::string& user_id) const {
+    const Exposure* e = find(symbol, user_id);
+    return e ? e->open_orders : 0;
+}
+
+uint64_t PreTradeRisk::openNotional(const std::string& symbol, const std::string& user_id) const {
+    const Exposure* e = find(symbol, user_id);
+    return e ? e->open_notional : 0;
+}
+
+} // namespace aws_wrapper
@@ -27,12 +27,12 @@ static const int BROADCAST_INTERVAL_SEC = 10;
 
 RankingManager::RankingManager(RedisClient* write_redis, RedisClient* read_redis)
     : write_redis_(write_redis), read_redis_(read_redis) {
-    Logger::info("RankingManager created");
+    LOGGER_INFO("RankingManager created");
 }
 
 RankingManager::~RankingManager() {
     stopSnapshotThread();
-    Logger::info("RankingManager destroyed");
+    LOGGER_INFO("RankingManager destroyed");
 }
 
 void RankingManager::setTotalShares(const std::string& symbol, uint64_t total_shares) {
@@ -55,7 +55,7 @@ void RankingManager::updateOnFill(const std::string& symbol,
                                    double change_pct,
                                    uint64_t total_shares) {
     if (!write_redis_) {
-        Logger::warn("RankingManager: write_redis is null, skipping update");
+        LOGGER_WARN("RankingManager: write_redis is null, skipping update");
         return;
     }
 
@@ -67,7 +67,7 @@ void RankingManager::updateOnFill(const std::string& symbol,
     // 시가총액 = 현재가 × 총 발행 주식 수
     uint64_t cached_shares = getTotalShares(symbol);
     if (cached_shares == 0) {
-        Logger::debug("RankingManager: totalShares not cached for", symbol, ", skipping marketcap update");
+        LOGGER_DEBUG("RankingManager: totalShares not cached for", symbol, ", skipping marketcap update");
     } else {
         double market_cap = static_cast<double>(price) * static_cast<double>(cached_shares);
         write_redis_->zadd(KEY_MARKETCAP, market_cap, symbol);
@@ -86,18 +86,18 @@ void RankingManager::updateOnFill(const std::string& symbol,
         write_redis_->zremrangebyrank(KEY_LOSERS, 0, -MAX_GAINERS_LOSERS - 1);
     }
 
-    Logger::debug("RankingManager: updated ranking for", symbol,
+    LOGGER_DEBUG("RankingManager: updated ranking for", symbol,
                   "price:", price, "qty:", fill_qty, "change:", change_pct, "%");
 }
 
 void RankingManager::startSnapshotThread() {
     if (running_.exchange(true)) {
-        Logger::warn("RankingManager: snapshot thread already running");
+        LOGGER_WARN("RankingManager: snapshot thread already running");
         return;
     }
 
     snapshot_thread_ = std::thread(&RankingManager::snapshotLoop, this);
-    Logger::info("RankingManager: snapshot thread started (interval:", BROADCAST_INTERVAL_SEC, "s)");
+    LOGGER_INFO("RankingManager: snapshot thread started (interval:", BROADCAST_INTERVAL_SEC, "s)");
 }
 
 void RankingManager::stopSnapshotThread() {
@@ -108,7 +108,7 @@ void RankingManager::stopSnapshotThread() {
     if (snapshot_thread_.joinable()) {
         snapshot_thread_.join();
     }
-    Logger::info("RankingManager: snapshot thread stopped");
+    LOGGER_INFO("RankingManager: snapshot thread stopped");
 }
 
 void RankingManager::snapshotLoop() {
@@ -118,7 +118,7 @@ void RankingManager::snapshotLoop() {
         try {
             computeAndBroadcastSnapshot();
         } catch (const std::exception& e) {
-            Logger::error("RankingManager: snapshot error:", e.what());
+            LOGGER_ERROR("RankingManager: snapshot error:", e.what());
         }
 
         // 10초 주기 대기
@@ -131,7 +131,7 @@ void RankingManager::snapshotLoop() {
 }
 
 int RankingManager::getCurrentKSTDay() const {
-    auto now = std::chrono::system_clock::now();
+    auto now = clock_->wallNow();
     auto epoch = std::chrono::duration_cast<std::chrono::seconds>(
         now.time_since_epoch()).count();
     // KST = UTC + 9h
@@ -150,7 +150,7 @@ void RankingManager::resetDailyVolumeIfNeeded() {
     // KST 날짜가 변경됨 → 거래량 sorted set 초기화
     read_redis_->del(KEY_VOLUME);
     last_volume_reset_kst_day_ = today_kst;
-    Logger::info("RankingManager: daily volume reset (KST day:", today_kst, ")");
+    LOGGER_INFO("RankingManager: daily volume reset (KST day:", today_kst, ")");
 }
 
 void RankingManager::computeAndBroadcastSnapshot() {
@@ -165,7 +165,7 @@ void RankingManager::computeAndBroadcastSnapshot() {
 
     // Pub/Sub 브로드캐스트
     long long subscribers = read_redis_->publish(CHANNEL_BROADCAST, snapshot_json);
-    Logger::debug("RankingManager: snapshot broadcast to", subscribers, "subscribers");
+    LOGGER_DEBUG("RankingManager: snapshot broadcast to", subscribers, "subscribers");
 }
 
 std::string RankingManager::buildSnapshotJson() {
@@ -231,7 +231,7 @@ std::string RankingManager::buildSnapshotJson() {
 }
 
 std::string RankingManager::getCurrentISOTime() const {
-    auto now = std::chrono::system_clock::now();
+    auto now = clock_->wallNow();
     auto time_t_now = std::chrono::system_clock::to_time_t(now);
     auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
         now.time_since_epoch()) % 1000;
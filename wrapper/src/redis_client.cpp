@@ -1,12 +1,15 @@
 #include "redis_client.h"
 #include "logger.h"
+#include "metrics.h"
+#include "latency_trace.h"
 #include <chrono>
+#include <cstdarg>
 
 namespace aws_wrapper {
 
 RedisClient::RedisClient(const std::string& host, int port)
     : host_(host), port_(port) {
-    Logger::info("RedisClient created, host:", host, "port:", port);
+    LOGGER_INFO("RedisClient created, host:", host, "port:", port);
 }
 
 RedisClient::~RedisClient() {
@@ -15,6 +18,24 @@ RedisClient::~RedisClient() {
     }
 }
 
+// 모든 명령은 이 두 경로로 나가며 왕복 시간을 redis_rtt 히스토그램과
+// (주문 처리 중이면) 해당 주문 트레이스의 Redis I/O에 남긴다
+redisReply* RedisClient::command(const char* format, ...) {
+    ScopedLatency rtt(Metrics::instance().redisRtt());
+    TraceIoScope trace_io(TraceIo::REDIS);
+    va_list ap;
+    va_start(ap, format);
+    void* reply = redisvCommand(context_, format, ap);
+    va_end(ap);
+    return static_cast<redisReply*>(reply);
+}
+
+redisReply* RedisClient::commandArgv(int argc, const char** argv, const size_t* argvlen) {
+    ScopedLatency rtt(Metrics::instance().redisRtt());
+    TraceIoScope trace_io(TraceIo::REDIS);
+    return static_cast<redisReply*>(redisCommandArgv(context_, argc, argv, argvlen));
+}
+
 bool RedisClient::connect() {
     if (context_) {
         redisFree(context_);
@@ -26,11 +47,11 @@ bool RedisClient::connect() {
 
     if (context_ == nullptr || context_->err) {
         if (context_) {
-            Logger::error("Redis connection failed:", context_->errstr);
+            LOGGER_ERROR("Redis connection failed:", context_->errstr);
             redisFree(context_);
             context_ = nullptr;
         } else {
-            Logger::error("Redis connection failed: can't allocate context");
+            LOGGER_ERROR("Redis connection failed: can't allocate context");
         }
         state_ = ConnectionState::DISCONNECTED;
         return false;
@@ -41,7 +62,7 @@ bool RedisClient::connect() {
     struct timeval cmd_timeout = {3, 0};  // 3 seconds for read/write operations
     redisSetTimeout(context_, cmd_timeout);
 
-    Logger::info("Redis connected to:", host_, ":", port_, "(cmd_timeout: 3s)");
+    LOGGER_INFO("Redis connected to:", host_, ":", port_, "(cmd_timeout: 3s)");
     state_ = ConnectionState::CONNECTED;
     current_reconnect_attempts_ = 0;  // Reset on successful connection
     last_health_check_ = std::chrono::steady_clock::now();
@@ -52,23 +73,23 @@ bool RedisClient::connect() {
 
 void RedisClient::setAutoReconnect(bool enabled) {
     auto_reconnect_enabled_ = enabled;
-    Logger::info("Redis auto-reconnect:", enabled ? "enabled" : "disabled");
+    LOGGER_INFO("Redis auto-reconnect:", enabled ? "enabled" : "disabled");
 }
 
 void RedisClient::setMaxReconnectAttempts(int attempts) {
     max_reconnect_attempts_ = attempts;
-    Logger::info("Redis max reconnect attempts set to:", attempts);
+    LOGGER_INFO("Redis max reconnect attempts set to:", attempts);
 }
 
 void RedisClient::setReconnectDelay(int initial_ms, int max_ms) {
     reconnect_delay_ms_ = initial_ms;
     max_reconnect_delay_ms_ = max_ms;
-    Logger::info("Redis reconnect delay:", initial_ms, "ms to", max_ms, "ms");
+    LOGGER_INFO("Redis reconnect delay:", initial_ms, "ms to", max_ms, "ms");
 }
 
 void RedisClient::setHealthCheckInterval(int interval_ms) {
     health_check_interval_ms_ = interval_ms;
-    Logger::info("Redis health check interval:", interval_ms, "ms");
+    LOGGER_INFO("Redis health check interval:", interval_ms, "ms");
 }
 
 bool RedisClient::isHealthy() {
@@ -90,7 +111,7 @@ int RedisClient::calculateBackoffDelay() {
 
 void RedisClient::markDisconnected() {
     if (state_ == ConnectionState::CONNECTED) {
-        Logger::warn("Redis connection lost - marking disconnected");
+        LOGGER_WARN("Redis connection lost - marking disconnected");
         state_ = ConnectionState::DISCONNECTED;
     }
 
@@ -114,7 +135,7 @@ bool RedisClient::attemptReconnect() {
         }
 
         // Close circuit and retry
-        Logger::info("Redis circuit breaker closed - attempting reconnect");
+        LOGGER_INFO("Redis circuit breaker closed - attempting reconnect");
         state_ = ConnectionState::DISCONNECTED;
         current_reconnect_attempts_ = 0;
     }
@@ -133,7 +154,7 @@ bool RedisClient::attemptReconnect() {
 
     // Check if we've exceeded max attempts
     if (current_reconnect_attempts_ >= max_reconnect_attempts_) {
-        Logger::warn("Redis reconnect attempts exceeded - opening circuit breaker for",
+        LOGGER_WARN("Redis reconnect attempts exceeded - opening circuit breaker for",
                      circuit_breaker_timeout_ms_, "ms");
         state_ = ConnectionState::CIRCUIT_OPEN;
         circuit_breaker_opened_at_ = now;
@@ -144,16 +165,16 @@ bool RedisClient::attemptReconnect() {
     last_reconnect_attempt_ = now;
     current_reconnect_attempts_++;
 
-    Logger::info("Redis reconnect attempt", current_reconnect_attempts_, "/",
+    LOGGER_INFO("Redis reconnect attempt", current_reconnect_attempts_, "/",
                  max_reconnect_attempts_, "after", backoff_delay, "ms backoff");
 
     bool success = connect();
 
     if (success) {
-        Logger::info("Redis reconnected successfully after", current_reconnect_attempts_, "attempts");
+        LOGGER_INFO("Redis reconnected successfully after", current_reconnect_attempts_, "attempts");
         return true;
     } else {
-        Logger::warn("Redis reconnect failed, attempt", current_reconnect_attempts_);
+        LOGGER_WARN("Redis reconnect failed, attempt", current_reconnect_attempts_);
         return false;
     }
 }
@@ -174,10 +195,10 @@ bool RedisClient::performHealthCheck() {
     }
 
     // Use PING command for health check
-    auto reply = static_cast<redisReply*>(redisCommand(context_, "PING"));
+    auto reply = static_cast<redisReply*>(command("PING"));
 
     if (!reply) {
-        Logger::warn("Redis health check failed - connection appears dead:",
+        LOGGER_WARN("Redis health check failed - connection appears dead:",
                      context_->errstr);
         markDisconnected();
         return false;
@@ -188,7 +209,7 @@ bool RedisClient::performHealthCheck() {
     freeReplyObject(reply);
 
     if (!healthy) {
-        Logger::warn("Redis health check failed - unexpected PING response");
+        LOGGER_WARN("Redis health check failed - unexpected PING response");
         markDisconnected();
         return false;
     }
@@ -203,7 +224,7 @@ bool RedisClient::ensureConnection() {
         if (isHealthCheckDue()) {
             if (!performHealthCheck()) {
                 // Health check failed, will try to reconnect below
-                Logger::warn("Redis health check failed during ensureConnection");
+                LOGGER_WARN("Redis health check failed during ensureConnection");
             } else {
                 return true;  // Healthy connection
             }
@@ -224,16 +245,58 @@ bool RedisClient::set(const std::string& key, const std::string& value) {
     if (!ensureConnection()) return false;
 
     auto reply = static_cast<redisReply*>(
-        redisCommand(context_, "SET %s %s", key.c_str(), value.c_str()));
+        command("SET %s %s", key.c_str(), value.c_str()));
+
+    if (!reply) {
+        LOGGER_ERROR("Redis SET failed:", context_->errstr);
+        markDisconnected();
+
+        // Try one immediate reconnect
+        if (auto_reconnect_enabled_ && attemptReconnect()) {
+            reply = static_cast<redisReply*>(
+                command("SET %s %s", key.c_str(), value.c_str()));
+            if (reply) {
+                bool success = (reply->type != REDIS_REPLY_ERROR);
+                freeReplyObject(reply);
+                return success;
+            }
+        }
+        return false;
+    }
+
+    bool success = (reply->type != REDIS_REPLY_ERROR);
+    freeReplyObject(reply);
+    return success;
+}
+
+bool RedisClient::mset(const std::vector<std::pair<std::string, std::string>>& kvs) {
+    if (kvs.empty()) return true;
+    if (!ensureConnection()) return false;
+
+    std::vector<const char*> argv;
+    std::vector<size_t> argvlen;
+    argv.reserve(1 + kvs.size() * 2);
+    argvlen.reserve(1 + kvs.size() * 2);
+    argv.push_back("MSET");
+    argvlen.push_back(4);
+    for (const auto& [key, value] : kvs) {
+        argv.push_back(key.data());
+        argvlen.push_back(key.size());
+        argv.push_back(value.data());
+        argvlen.push_back(value.size());
+    }
+
+    auto reply = static_cast<redisReply*>(
+        commandArgv(static_cast<int>(argv.size()), argv.data(), argvlen.data()));
 
     if (!reply) {
-        Logger::error("Redis SET failed:", context_->errstr);
+        LOGGER_ERROR("Redis MSET failed:", context_->errstr);
         markDisconnected();
 
         // Try one immediate reconnect
         if (auto_reconnect_enabled_ && attemptReconnect()) {
             reply = static_cast<redisReply*>(
-                redisCommand(context_, "SET %s %s", key.c_str(), value.c_str()));
+                commandArgv(static_cast<int>(argv.size()), argv.data(), argvlen.data()));
             if (reply) {
                 bool success = (reply->type != REDIS_REPLY_ERROR);
                 freeReplyObject(reply);
@@ -253,7 +316,7 @@ bool RedisClient::setEx(const std::string& key, const std::string& value,
     if (!ensureConnection()) return false;
 
     auto reply = static_cast<redisReply*>(
-        redisCommand(context_, "SETEX %s %d %s",
+        command("SETEX %s %d %s",
                      key.c_str(), ttl_seconds, value.c_str()));
 
     if (!reply) {
@@ -270,7 +333,7 @@ std::optional<std::string> RedisClient::get(const std::string& key) {
     if (!ensureConnection()) return std::nullopt;
 
     auto reply = static_cast<redisReply*>(
-        redisCommand(context_, "GET %s", key.c_str()));
+        command("GET %s", key.c_str()));
 
     if (!reply) {
         markDisconnected();
@@ -290,7 +353,7 @@ bool RedisClient::del(const std::string& key) {
     if (!context_) return false;
     
     auto reply = static_cast<redisReply*>(
-        redisCommand(context_, "DEL %s", key.c_str()));
+        command("DEL %s", key.c_str()));
     
     if (!reply) return false;
     
@@ -302,7 +365,7 @@ bool RedisClient::exists(const std::string& key) {
     if (!context_) return false;
     
     auto reply = static_cast<redisReply*>(
-        redisCommand(context_, "EXISTS %s", key.c_str()));
+        command("EXISTS %s", key.c_str()));
     
     if (!reply) return false;
     
@@ -322,7 +385,7 @@ bool RedisClient::saveSnapshot(const std::string& symbol,
     if (!set(key, data)) return false;
     if (!set(ts_key, std::to_string(now))) return false;
     
-    Logger::info("Snapshot saved to Redis:", symbol);
+    LOGGER_INFO("Snapshot saved to Redis:", symbol);
     return true;
 }
 
@@ -336,7 +399,7 @@ std::vector<std::string> RedisClient::keys(const std::string& pattern) {
     if (!context_) return result;
     
     auto reply = static_cast<redisReply*>(
-        redisCommand(context_, "KEYS %s", pattern.c_str()));
+        command("KEYS %s", pattern.c_str()));
     
     if (!reply) return result;
     
@@ -356,10 +419,10 @@ bool RedisClient::lpush(const std::string& key, const std::string& value) {
     if (!ensureConnection()) return false;
 
     auto reply = static_cast<redisReply*>(
-        redisCommand(context_, "LPUSH %s %s", key.c_str(), value.c_str()));
+        command("LPUSH %s %s", key.c_str(), value.c_str()));
 
     if (!reply) {
-        Logger::error("Redis LPUSH failed:", context_->errstr);
+        LOGGER_ERROR("Redis LPUSH failed:", context_->errstr);
         markDisconnected();
         return false;
     }
@@ -373,10 +436,10 @@ bool RedisClient::ltrim(const std::string& key, long start, long stop) {
     if (!context_) return false;
     
     auto reply = static_cast<redisReply*>(
-        redisCommand(context_, "LTRIM %s %ld %ld", key.c_str(), start, stop));
+        command("LTRIM %s %ld %ld", key.c_str(), start, stop));
     
     if (!reply) {
-        Logger::error("Redis LTRIM failed:", context_->errstr);
+        LOGGER_ERROR("Redis LTRIM failed:", context_->errstr);
         return false;
     }
     
@@ -390,7 +453,7 @@ std::vector<std::string> RedisClient::lrange(const std::string& key, long start,
     if (!context_) return result;
     
     auto reply = static_cast<redisReply*>(
-        redisCommand(context_, "LRANGE %s %ld %ld", key.c_str(), start, stop));
+        command("LRANGE %s %ld %ld", key.c_str(), start, stop));
     
     if (!reply) return result;
     
@@ -411,7 +474,7 @@ std::vector<std::string> RedisClient::smembers(const std::string& key) {
     if (!context_) return result;
     
     auto reply = static_cast<redisReply*>(
-        redisCommand(context_, "SMEMBERS %s", key.c_str()));
+        command("SMEMBERS %s", key.c_str()));
     
     if (!reply) return result;
     
@@ -431,7 +494,7 @@ bool RedisClient::sismember(const std::string& key, const std::string& member) {
     if (!ensureConnection()) return false;
 
     auto reply = static_cast<redisReply*>(
-        redisCommand(context_, "SISMEMBER %s %s", key.c_str(), member.c_str()));
+        command("SISMEMBER %s %s", key.c_str(), member.c_str()));
 
     if (!reply) {
         markDisconnected();
@@ -449,10 +512,10 @@ bool RedisClient::zadd(const std::string& key, double score, const std::string&
     if (!context_) return false;
 
     auto reply = static_cast<redisReply*>(
-        redisCommand(context_, "ZADD %s %f %s", key.c_str(), score, member.c_str()));
+        command("ZADD %s %f %s", key.c_str(), score, member.c_str()));
 
     if (!reply) {
-        Logger::error("Redis ZADD failed:", context_->errstr);
+        LOGGER_ERROR("Redis ZADD failed:", context_->errstr);
         return false;
     }
 
@@ -465,10 +528,10 @@ double RedisClient::zincrby(const std::string& key, double increment, const std:
     if (!context_) return 0.0;
 
     auto reply = static_cast<redisReply*>(
-        redisCommand(context_, "ZINCRBY %s %f %s", key.c_str(), increment, member.c_str()));
+        command("ZINCRBY %s %f %s", key.c_str(), increment, member.c_str()));
 
     if (!reply) {
-        Logger::error("Redis ZINCRBY failed:", context_->errstr);
+        LOGGER_ERROR("Redis ZINCRBY failed:", context_->errstr);
         return 0.0;
     }
 
@@ -489,10 +552,10 @@ std::vector<std::pair<std::string, double>> RedisClient::zrevrange(
     redisReply* reply;
     if (withScores) {
         reply = static_cast<redisReply*>(
-            redisCommand(context_, "ZREVRANGE %s %ld %ld WITHSCORES", key.c_str(), start, stop));
+            command("ZREVRANGE %s %ld %ld WITHSCORES", key.c_str(), start, stop));
     } else {
         reply = static_cast<redisReply*>(
-            redisCommand(context_, "ZREVRANGE %s %ld %ld", key.c_str(), start, stop));
+            command("ZREVRANGE %s %ld %ld", key.c_str(), start, stop));
     }
 
     if (!reply) return result;
@@ -526,10 +589,10 @@ std::vector<std::pair<std::string, double>> RedisClient::zrange(
     redisReply* reply;
     if (withScores) {
         reply = static_cast<redisReply*>(
-            redisCommand(context_, "ZRANGE %s %ld %ld WITHSCORES", key.c_str(), start, stop));
+            command("ZRANGE %s %ld %ld WITHSCORES", key.c_str(), start, stop));
     } else {
         reply = static_cast<redisReply*>(
-            redisCommand(context_, "ZRANGE %s %ld %ld", key.c_str(), start, stop));
+            command("ZRANGE %s %ld %ld", key.c_str(), start, stop));
     }
 
     if (!reply) return result;
@@ -559,10 +622,10 @@ bool RedisClient::zremrangebyrank(const std::string& key, long start, long stop)
     if (!context_) return false;
 
     auto reply = static_cast<redisReply*>(
-        redisCommand(context_, "ZREMRANGEBYRANK %s %ld %ld", key.c_str(), start, stop));
+        command("ZREMRANGEBYRANK %s %ld %ld", key.c_str(), start, stop));
 
     if (!reply) {
-        Logger::error("Redis ZREMRANGEBYRANK failed:", context_->errstr);
+        LOGGER_ERROR("Redis ZREMRANGEBYRANK failed:", context_->errstr);
         return false;
     }
 
@@ -577,10 +640,10 @@ long long RedisClient::publish(const std::string& channel, const std::string& me
     if (!context_) return 0;
 
     auto reply = static_cast<redisReply*>(
-        redisCommand(context_, "PUBLISH %s %s", channel.c_str(), message.c_str()));
+        command("PUBLISH %s %s", channel.c_str(), message.c_str()));
 
     if (!reply) {
-        Logger::error("Redis PUBLISH failed:", context_->errstr);
+        LOGGER_ERROR("Redis PUBLISH failed:", context_->errstr);
         return 0;
     }
 
@@ -599,7 +662,7 @@ bool RedisClient::hset(const std::string& key, const std::string& field, const s
     if (!ensureConnection()) return false;
 
     auto reply = static_cast<redisReply*>(
-        redisCommand(context_, "HSET %s %s %s", key.c_str(), field.c_str(), value.c_str()));
+        command("HSET %s %s %s", key.c_str(), field.c_str(), value.c_str()));
 
     if (!reply) {
         markDisconnected();
@@ -615,7 +678,7 @@ std::optional<std::string> RedisClient::hget(const std::string& key, const std::
     if (!context_) return std::nullopt;
     
     auto reply = static_cast<redisReply*>(
-        redisCommand(context_, "HGET %s %s", key.c_str(), field.c_str()));
+        command("HGET %s %s", key.c_str(), field.c_str()));
     
     if (!reply) return std::nullopt;
     
@@ -633,7 +696,7 @@ std::map<std::string, std::string> RedisClient::hgetall(const std::string& key)
     if (!context_) return result;
     
     auto reply = static_cast<redisReply*>(
-        redisCommand(context_, "HGETALL %s", key.c_str()));
+        command("HGETALL %s", key.c_str()));
     
     if (!reply) return result;
     
@@ -682,10 +745,10 @@ std::string RedisClient::eval(const std::string& script, int numKeys,
     }
     
     auto reply = static_cast<redisReply*>(
-        redisCommandArgv(context_, static_cast<int>(argv.size()), argv.data(), argvlen.data()));
+        commandArgv(static_cast<int>(argv.size()), argv.data(), argvlen.data()));
     
     if (!reply) {
-        Logger::error("Redis EVAL failed:", context_->errstr);
+        LOGGER_ERROR("Redis EVAL failed:", context_->errstr);
         return "";
     }
     
@@ -695,7 +758,7 @@ std::string RedisClient::eval(const std::string& script, int numKeys,
     } else if (reply->type == REDIS_REPLY_INTEGER) {
         result = std::to_string(reply->integer);
     } else if (reply->type == REDIS_REPLY_ERROR) {
-        Logger::error("Redis EVAL error:", reply->str);
+        LOGGER_ERROR("Redis EVAL error:", reply->str);
     }
     
     freeReplyObject(reply);
@@ -711,7 +774,7 @@ std::string epochToYMDHM(int64_t epoch) {
     // UTC 시간 구조체 얻기
     struct tm* tm_utc = gmtime(&utc_time);
     if (!tm_utc) {
-        Logger::warn("gmtime() failed for epoch:", epoch);
+        LOGGER_WARN("gmtime() failed for epoch:", epoch);
         return "000000000000";
     }
     
@@ -720,7 +783,7 @@ std::string epochToYMDHM(int64_t epoch) {
     time_t kst_time = utc_time + (9 * 3600);
     struct tm* tm_kst = gmtime(&kst_time);
     if (!tm_kst) {
-        Logger::warn("gmtime() failed for KST epoch:", kst_time);
+        LOGGER_WARN("gmtime() failed for KST epoch:", kst_time);
         return "000000000000";
     }
     
@@ -807,10 +870,10 @@ bool RedisClient::updateCandle(const std::string& symbol, uint64_t price, uint64
     std::string result = eval(luaScript, 2, keys, args);
     
     if (result == "OK") {
-        Logger::debug("Candle updated:", symbol, "price:", price, "qty:", qty);
+        LOGGER_DEBUG("Candle updated:", symbol, "price:", price, "qty:", qty);
         return true;
     } else {
-        Logger::warn("Candle update failed:", symbol);
+        LOGGER_WARN("Candle update failed:", symbol);
         return false;
     }
 }
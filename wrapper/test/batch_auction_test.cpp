@@ -0,0 +1,130 @@
+// 배치 경매 검증 — BATCH_AUCTION_SYMBOLS 종목은 주문을 구간(100ms)마다 모아 단일가로 체결하고,
+// 구간당 depth 발행은 최대 1회. 다른 종목은 그대로 연속 매매.
+#include "engine_core.h"
+#include "market_data_handler.h"
+#include "iproducer.h"
+#include "metrics.h"
+#include "order.h"
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <string>
+
+using namespace aws_wrapper;
+
+struct MockProducer : public IProducer {
+    int fills = 0;
+    int cancels = 0;
+    void publishFill(const std::string&, const std::string&, const std::string&,
+                     const std::string&, const std::string&, uint64_t, uint64_t,
+                     bool, bool, bool) override { ++fills; }
+    void publishTrade(const std::string&, uint64_t, uint64_t) override {}
+    void publishDepth(const std::string&, const nlohmann::json&) override {}
+    void publishOrderStatus(const std::string&, const std::string&,
+                            const std::string&, const std::string& status,
+                            const std::string&, uint64_t, uint64_t, bool,
+                            const std::string&) override {
+        if (status == "CANCELLED") ++cancels;
+    }
+    void flush(int) override {}
+};
+
+static OrderPtr mk(const std::string& id, const std::string& user, const std::string& sym,
+                   bool buy, uint64_t price, uint64_t qty) {
+    auto o = std::make_shared<Order>();
+    o->setOrderId(id); o->setUserId(user); o->setSymbol(sym);
+    o->setIsBuy(buy); o->setPrice(price); o->setOrderQty(qty); o->setOrderType("LIMIT");
+    return o;
+}
+
+static int failures = 0;
+static void check(bool c, const std::string& n) {
+    std::cout << (c ? "  PASS  " : "  FAIL  ") << n << "\n";
+    if (!c) ++failures;
+}
+
+static uint64_t published() { return Metrics::instance().getDepthPublished(); }
+
+int main() {
+    std::cout << "=== 배치 경매 검증 ===\n";
+    setenv("PRICE_BAND_PCT", "0", 1);
+    setenv("VI_DYNAMIC_PCT", "0", 1);
+    setenv("OPENING_AUCTION_SECONDS", "0", 1);
+    setenv("BATCH_AUCTION_SYMBOLS", "FBA,OTHER", 1);
+    setenv("BATCH_AUCTION_INTERVAL_MS", "100", 1);
+
+    SimulatedClock clock(1700000000000);
+    MockProducer prod;
+    MarketDataHandler handler(&prod);
+    EngineCore engine(&handler, nullptr, &clock);
+    check(engine.batchAuctionInterval() == std::chrono::milliseconds(100), "구간 100ms");
+
+    // ── ① 구간 동안 주문은 교차해도 체결·depth 발행 없이 모인다 ──
+    const uint64_t depth_start = published();
+    auto b1 = mk("b1", "userA", "FBA", true, 1000, 5);
+    auto s1 = mk("s1", "userB", "FBA", false, 990, 3);
+    auto s2 = mk("s2", "userC", "FBA", false, 1000, 4);
+    auto ioc = mk("i1", "userD", "FBA", true, 980, 2);
+    ioc->setConditions(liquibook::book::oc_immediate_or_cancel);
+    engine.addOrder(b1);
+    engine.addOrder(s1);
+    engine.addOrder(s2);
+    engine.addOrder(ioc);
+    check(engine.inAuction("FBA"), "배치 경매 중");
+    check(prod.fills == 0, "구간 중 체결 없음");
+    check(published() == depth_start, "구간 중 depth 발행 없음");
+
+    // 연속 매매 종목은 영향 없음
+    engine.addOrder(mk("c1", "userA", "CON", true, 500, 1));
+    engine.addOrder(mk("c2", "userB", "CON", false, 500, 1));
+    check(prod.fills > 0 && !engine.inAuction("CON"), "다른 종목은 연속 체결");
+    const int fills_con = prod.fills;
+
+    // 구간이 끝나기 전 tick은 아무것도 하지 않는다
+    clock.advance(std::chrono::milliseconds(99));
+    engine.runDueAuctions();
+    check(prod.fills == fills_con, "구간 종료 전 체결 없음");
+
+    // ── ② 구간 종료: 체결량이 최대인 1000에서 5 체결 (990이면 3) ──
+    clock.advance(std::chrono::milliseconds(1));
+    const int cancels_before = prod.cancels;
+    uint64_t before = published();
+    engine.runDueAuctions();
+    {
+        auto c = engine.getCounters();
+        check(c.batch_auctions == 1 && c.auction_volume == 5, "배치 체결 1회, 수량 5");
+        check(b1->filled_qty() == 5 && s1->filled_qty() == 3 && s2->filled_qty() == 2,
+              "가격 우선 배분 (990 전량, 1000 일부)");
+        check(handler.getLastPrice("FBA") == 1000, "단일가 1000");
+        check(prod.cancels - cancels_before == 1 && !engine.hasOrder("FBA", "i1"),
+              "미체결 IOC는 구간 끝에 취소");
+        check(published() - before == 1, "구간당 depth 발행 1회");
+        check(engine.inAuction("FBA"), "다음 구간 경매 시작");
+
+        DepthView view;
+        engine.getDepth("FBA", 5, view);
+        check(view.bids.empty(), "잔여 매수 없음");
+        check(view.asks.size() == 1 && view.asks[0].price == 1000 && view.asks[0].qty == 2,
+              "잔여 매도 1000 x 2");
+    }
+
+    // ── ③ 빈 구간: 체결·발행 없음 ──
+    clock.advance(std::chrono::milliseconds(100));
+    before = published();
+    engine.runDueAuctions();
+    check(engine.getCounters().batch_auctions == 1, "교차 없는 구간은 체결 안 함");
+    check(published() == before, "변화 없는 구간은 depth 발행 없음");
+
+    // ── ④ 다음 구간의 주문은 그 구간 끝에 체결 ──
+    auto b2 = mk("b2", "userE", "FBA", true, 1000, 2);
+    engine.addOrder(b2);
+    check(b2->filled_qty() == 0, "접수 즉시 체결하지 않음");
+    clock.advance(std::chrono::milliseconds(100));
+    engine.runDueAuctions();
+    check(b2->filled_qty() == 2 && s2->filled_qty() == 4, "다음 구간 끝에 체결");
+    check(engine.getCounters().batch_auctions == 2, "배치 체결 누적 2회");
+
+    std::cout << "=== " << (failures == 0 ? "ALL PASS" : std::to_string(failures) + " FAIL")
+              << " ===\n";
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,181 @@
+// 복원용 일괄 등재(bulk load) 검증 — 매칭 우회 등재, 호가 집계, 시간 우선순위,
+// 교차 배치 거부(무음 체결 대신 실패), 스냅샷 복원 경로 연동, created_at 순서 복원.
+#include "engine_core.h"
+#include "market_data_handler.h"
+#include "iproducer.h"
+#include "order.h"
+#include <nlohmann/json.hpp>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace aws_wrapper;
+
+struct MockProducer : public IProducer {
+    int fills = 0;
+    int statuses = 0;
+    std::vector<std::string> buyers;   // 체결된 매수 주문 순서
+    std::vector<std::string> sellers;  // 체결된 매도 주문 순서
+    void publishFill(const std::string&, const std::string& buy_order, const std::string& sell_order,
+                     const std::string&, const std::string&, uint64_t, uint64_t,
+                     bool, bool, bool) override {
+        ++fills;
+        buyers.push_back(buy_order);
+        sellers.push_back(sell_order);
+    }
+    void publishTrade(const std::string&, uint64_t, uint64_t) override {}
+    void publishDepth(const std::string&, const nlohmann::json&) override {}
+    void publishOrderStatus(const std::string&, const std::string&,
+                            const std::string&, const std::string&,
+                            const std::string&, uint64_t, uint64_t, bool,
+                            const std::string&) override { ++statuses; }
+    void flush(int) override {}
+};
+
+static OrderPtr mk(const std::string& id, const std::string& user, const std::string& sym,
+                   bool buy, uint64_t price, uint64_t qty) {
+    auto o = std::make_shared<Order>();
+    o->setOrderId(id); o->setUserId(user); o->setSymbol(sym);
+    o->setIsBuy(buy); o->setPrice(price); o->setOrderQty(qty); o->setOrderType("LIMIT");
+    return o;
+}
+
+static int failures = 0;
+static void check(bool c, const std::string& n) {
+    std::cout << (c ? "  PASS  " : "  FAIL  ") << n << "\n";
+    if (!c) ++failures;
+}
+
+int main() {
+    setenv("PRICE_BAND_PCT", "0", 1);
+    setenv("VI_DYNAMIC_PCT", "0", 1);
+    std::cout << "=== 복원용 일괄 등재 검증 ===\n";
+
+    // ── ① 정렬되지 않은 입력도 측면별 가격 우선으로 등재, 같은 가격은 입력 순서 유지 ──
+    {
+        MockProducer p; MarketDataHandler h(&p); EngineCore e(&h);
+        std::vector<OrderPtr> batch = {
+            mk("a2", "userA", "AAA", false, 105, 30),
+            mk("b1", "userB", "AAA", true, 99, 20),
+            mk("b0", "userB", "AAA", true, 100, 10),
+            mk("a1", "userA", "AAA", false, 101, 40),
+            mk("b2", "userC", "AAA", true, 100, 15),
+        };
+        check(e.bulkLoadOrders("AAA", batch), "일괄 등재 성공");
+        check(e.hasOrder("AAA", "b0") && e.hasOrder("AAA", "a2"), "등재된 주문이 맵에 존재");
+        check(p.statuses == 0, "주문별 ACCEPTED 이벤트 없음");
+
+        DepthView view;
+        check(e.getDepth("AAA", 0, view), "호가 조회");
+        check(view.bids.size() == 2 && view.asks.size() == 2, "매수 2단계 / 매도 2단계");
+        check(view.bids[0].price == 100 && view.bids[0].qty == 25 &&
+              view.bids[0].order_count == 2, "최우선 매수 100: 25주 2건");
+        check(view.asks[0].price == 101 && view.asks[0].qty == 40, "최우선 매도 101: 40주");
+
+        // 같은 가격 100에서는 입력 순서(b0 → b2)대로 체결
+        e.addOrder(mk("s", "userD", "AAA", false, 100, 20));
+        check(p.fills == 2 && p.buyers[0] == "b0" && p.buyers[1] == "b2",
+              "★ 같은 가격은 입력 순서가 시간 우선순위");
+
+        // 앵커 리플레이가 같은 주문을 재전달해도 이중 등록 없음
+        check(!e.addOrder(mk("a1", "userA", "AAA", false, 101, 40)), "등재분 재유입 거부(dedup 시딩)");
+    }
+
+    // ── ② 교차 배치는 체결 없이 전체 거부 ───────────────────────────────
+    {
+        MockProducer p; MarketDataHandler h(&p); EngineCore e(&h);
+        std::vector<OrderPtr> crossed = {
+            mk("b0", "userB", "BBB", true, 101, 10),
+            mk("a0", "userA", "BBB", false, 100, 10),
+        };
+        check(!e.bulkLoadOrders("BBB", crossed), "★ 자기 교차 배치 거부");
+        check(!e.hasOrder("BBB", "b0") && !e.hasOrder("BBB", "a0"), "거부 시 아무것도 등재 안 됨");
+        check(p.fills == 0, "무음 체결 없음");
+
+        // 기존 북과 교차하는 배치도 거부
+        e.addOrder(mk("rest", "userA", "BBB", false, 100, 10));
+        std::vector<OrderPtr> into_book = { mk("b1", "userB", "BBB", true, 100, 10) };
+        check(!e.bulkLoadOrders("BBB", into_book), "★ 기존 북과 교차하는 배치 거부");
+        std::vector<OrderPtr> passive = { mk("b2", "userB", "BBB", true, 99, 10) };
+        check(e.bulkLoadOrders("BBB", passive), "교차하지 않는 배치는 기존 북 위에 등재");
+        check(p.fills == 0, "체결 없음");
+    }
+
+    // ── ③ 스냅샷 복원: 교차 스냅샷은 조용히 체결시키지 않고 실패 ─────────
+    {
+        MockProducer p1; MarketDataHandler h1(&p1); EngineCore e1(&h1);
+        e1.addOrder(mk("b0", "userB", "CCC", true, 100, 10));
+        e1.addOrder(mk("a0", "userA", "CCC", false, 102, 10));
+        std::string snap = e1.snapshotOrderBook("CCC");
+
+        MockProducer p2; MarketDataHandler h2(&p2); EngineCore e2(&h2);
+        check(e2.restoreOrderBook("CCC", snap), "정상 스냅샷 복원");
+        DepthView view;
+        check(e2.getDepth("CCC", 0, view) && view.bids.size() == 1 && view.asks.size() == 1 &&
+              view.bids[0].qty == 10 && view.asks[0].qty == 10, "복원 후 호가 집계 일치");
+
+        // 매도 가격을 매수 아래로 조작한 교차 스냅샷
+        auto j = nlohmann::json::parse(snap);
+        for (auto& o : j["orders"]) {
+            if (o["order_id"] == "a0") o["price"] = 99;
+        }
+        std::string crossed = j.dump();
+        MockProducer p3; MarketDataHandler h3(&p3); EngineCore e3(&h3);
+        check(!e3.restoreOrderBook("CCC", crossed), "★ 교차 스냅샷 복원 실패");
+        check(!e3.hasOrder("CCC", "b0") && !e3.hasOrder("CCC", "a0"), "교차 스냅샷은 북을 남기지 않음");
+        check(p3.fills == 0, "무음 체결 없음");
+    }
+
+    // ── ④ DB 복원: 스캔 순서가 뒤섞여도 created_at 순으로 단계별 FIFO ───────
+    {
+        check(Order::parseTimestampMs("2026-10-19T03:04:05.678Z") == 1792379045678LL,
+              "ISO-8601 created_at → epoch ms");
+        check(Order::parseTimestampMs("2026-10-19T03:04:05Z") == 1792379045000LL,
+              "소수 초 없는 created_at");
+        check(Order::parseTimestampMs("1792379045678") == 1792379045678LL, "epoch ms 숫자");
+        check(Order::parseTimestampMs("2026-10-19 03:04:05") == -1 &&
+              Order::parseTimestampMs("") == -1, "해석 불가 → -1");
+
+        // 스캔 순서 (order_id, side, price, created_at) — 단계마다 접수 순서와 다르게 섞는다
+        struct Row { const char* id; bool buy; uint64_t price; const char* created_at; };
+        const Row rows[] = {
+            {"b100-3", true, 100, "2026-10-19T03:00:00.300Z"},
+            {"a102-2", false, 102, "2026-10-19T03:00:01.200Z"},
+            {"b99-2", true, 99, "2026-10-19T03:00:00.020Z"},
+            {"b100-1", true, 100, "2026-10-19T03:00:00.100Z"},
+            {"a101-2", false, 101, "2026-10-19T03:00:00.999Z"},
+            {"a102-1", false, 102, "2026-10-19T03:00:00.050Z"},
+            {"b99-1", true, 99, "2026-10-19T03:00:00.010Z"},
+            {"a101-1", false, 101, "2026-10-19T02:59:59.999Z"},
+            {"b100-2", true, 100, "2026-10-19T03:00:00.200Z"},
+            {"a101-3", false, 101, "2026-10-19T03:00:01.000Z"},
+        };
+        std::vector<OrderPtr> batch;
+        for (const auto& r : rows) {
+            auto o = mk(r.id, std::string("user-") + r.id, "DDD", r.buy, r.price, 10);
+            o->setTimestamp(Order::parseTimestampMs(r.created_at));
+            batch.push_back(o);
+        }
+        EngineCore::sortByArrival(batch);
+
+        MockProducer p; MarketDataHandler h(&p); EngineCore e(&h);
+        check(e.bulkLoadOrders("DDD", batch), "뒤섞인 복원 묶음 일괄 등재");
+
+        // 매수 두 단계를 한 번에 쓸어 체결 순서 확인
+        e.addOrder(mk("sweep-s", "userS", "DDD", false, 99, 50));
+        const std::vector<std::string> want_buys = {"b100-1", "b100-2", "b100-3", "b99-1", "b99-2"};
+        check(p.buyers == want_buys, "★ 매수 100/99 단계 모두 created_at 순 체결");
+
+        // 매도 두 단계
+        p.sellers.clear();
+        e.addOrder(mk("sweep-b", "userS", "DDD", true, 102, 50));
+        const std::vector<std::string> want_sells = {"a101-1", "a101-2", "a101-3", "a102-1", "a102-2"};
+        check(p.sellers == want_sells, "★ 매도 101/102 단계 모두 created_at 순 체결");
+    }
+
+    std::cout << "=== " << (failures == 0 ? "ALL PASS" : std::to_string(failures) + " FAIL")
+              << " ===\n";
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,151 @@
+// 단일가 경매 검증 — VI halt 중 주문을 매칭 없이 모았다가 halt가 끝나면 한 가격으로 일괄 체결.
+// 시나리오: VI 재개 경매(runDueAuctions) / 신규 종목 개시 경매(경매 후 첫 주문이 체결을 유발).
+#include "engine_core.h"
+#include "market_data_handler.h"
+#include "iproducer.h"
+#include "metrics.h"
+#include "order.h"
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <string>
+
+using namespace aws_wrapper;
+
+struct MockProducer : public IProducer {
+    int fills = 0;
+    int rejects = 0;
+    int cancels = 0;
+    void publishFill(const std::string&, const std::string&, const std::string&,
+                     const std::string&, const std::string&, uint64_t, uint64_t,
+                     bool, bool, bool) override { ++fills; }
+    void publishTrade(const std::string&, uint64_t, uint64_t) override {}
+    void publishDepth(const std::string&, const nlohmann::json&) override {}
+    void publishOrderStatus(const std::string&, const std::string&,
+                            const std::string&, const std::string& status,
+                            const std::string&, uint64_t, uint64_t, bool,
+                            const std::string&) override {
+        if (status == "REJECTED") ++rejects;
+        if (status == "CANCELLED") ++cancels;
+    }
+    void flush(int) override {}
+};
+
+static OrderPtr mk(const std::string& id, const std::string& user, const std::string& sym,
+                   bool buy, uint64_t price, uint64_t qty) {
+    auto o = std::make_shared<Order>();
+    o->setOrderId(id); o->setUserId(user); o->setSymbol(sym);
+    o->setIsBuy(buy); o->setPrice(price); o->setOrderQty(qty); o->setOrderType("LIMIT");
+    return o;
+}
+
+static int failures = 0;
+static void check(bool c, const std::string& n) {
+    std::cout << (c ? "  PASS  " : "  FAIL  ") << n << "\n";
+    if (!c) ++failures;
+}
+
+static uint64_t published() { return Metrics::instance().getDepthPublished(); }
+
+int main() {
+    std::cout << "=== 단일가 경매 검증 ===\n";
+    setenv("PRICE_BAND_PCT", "0", 1);
+    setenv("VI_DYNAMIC_PCT", "0.03", 1);
+    setenv("VI_HALT_SECONDS", "60", 1);
+    setenv("VI_AUCTION", "1", 1);
+    setenv("OPENING_AUCTION_SECONDS", "0", 1);
+
+    // ── ① VI 재개 경매 ──
+    {
+        SimulatedClock clock(1700000000000);
+        MockProducer prod;
+        MarketDataHandler handler(&prod);
+        EngineCore engine(&handler, nullptr, &clock);
+
+        // 기준가 1000 → 1100 체결로 +10% 급변 → halt
+        engine.addOrder(mk("p1", "userX", "AAA", true, 1000, 1));
+        engine.addOrder(mk("p2", "userY", "AAA", false, 1000, 1));
+        engine.addOrder(mk("x1", "userX", "AAA", false, 1100, 1));
+        engine.addOrder(mk("x2", "userY", "AAA", true, 1100, 1));
+        check(engine.isHalted("AAA"), "1100 체결로 halt");
+
+        // halt 중 주문은 거부되지 않고 교차한 채로 모인다
+        const int fills_before = prod.fills;
+        auto b1 = mk("b1", "userA", "AAA", true, 1050, 10);
+        auto b2 = mk("b2", "userB", "AAA", true, 1020, 10);
+        auto s1 = mk("s1", "userC", "AAA", false, 1010, 15);
+        auto s2 = mk("s2", "userD", "AAA", false, 1040, 10);
+        check(engine.addOrder(b1) && engine.addOrder(b2) &&
+              engine.addOrder(s1) && engine.addOrder(s2), "halt 중 주문 접수");
+        check(engine.inAuction("AAA"), "경매 진행 중");
+        check(prod.fills == fills_before, "경매 중 체결 없음");
+        check(engine.getCounters().vi_halt_rejects == 0, "halt 거부 없음");
+
+        // IOC도 경매에 참여하고, 체결되지 않은 몫은 경매 종료 시 취소된다
+        auto ioc = mk("i1", "userE", "AAA", true, 900, 1);
+        ioc->setConditions(liquibook::book::oc_immediate_or_cancel);
+        engine.addOrder(ioc);
+        check(prod.rejects == 0 && prod.cancels == 0 && engine.hasOrder("AAA", "i1"),
+              "경매 중 IOC 대기");
+
+        // halt가 끝나기 전에는 체결하지 않는다
+        clock.advance(std::chrono::seconds(59));
+        engine.runDueAuctions();
+        check(engine.inAuction("AAA"), "halt 중에는 경매 유지");
+
+        // 1010과 1020 모두 15 체결·불균형 5 → 기준가 1000에 가까운 1010
+        clock.advance(std::chrono::seconds(1));
+        const uint64_t depth_before = published();
+        engine.runDueAuctions();
+        auto c = engine.getCounters();
+        check(!engine.inAuction("AAA"), "halt 종료 → 경매 종료");
+        check(c.auctions_uncrossed == 1 && c.auction_volume == 15, "경매 1회, 체결량 15");
+        check(b1->filled_qty() == 10 && b2->filled_qty() == 5 && s1->filled_qty() == 15,
+              "가격 우선으로 배분 (1050 전량, 1020 일부)");
+        check(s2->filled_qty() == 0, "1040 매도는 미체결");
+        check(prod.cancels == 1 && !engine.hasOrder("AAA", "i1"), "미체결 IOC 취소");
+        check(handler.getLastPrice("AAA") == 1010, "단일가 1010");
+        check(engine.viReferencePrice("AAA") == 1010, "VI 기준가 = 단일가");
+        check(!engine.isHalted("AAA"), "경매 체결로 재-halt 없음");
+        check(published() - depth_before == 1, "경매 체결 → depth 발행 1회");
+
+        DepthView view;
+        engine.getDepth("AAA", 5, view);
+        check(view.bids.size() == 1 && view.bids[0].price == 1020 && view.bids[0].qty == 5,
+              "잔여 매수 1020 x 5");
+        check(view.asks.size() == 1 && view.asks[0].price == 1040, "잔여 매도 1040");
+
+        // 이후는 연속 매매
+        engine.addOrder(mk("s3", "userF", "AAA", false, 1020, 5));
+        check(b2->filled_qty() == 10, "재개 후 연속 체결");
+    }
+
+    // ── ② 신규 종목 개시 경매 ──
+    {
+        setenv("OPENING_AUCTION_SECONDS", "30", 1);
+        SimulatedClock clock(1700000000000);
+        MockProducer prod;
+        MarketDataHandler handler(&prod);
+        EngineCore engine(&handler, nullptr, &clock);
+
+        auto b1 = mk("b1", "userA", "NEW", true, 500, 5);
+        auto s1 = mk("s1", "userB", "NEW", false, 490, 5);
+        engine.addOrder(b1);
+        engine.addOrder(s1);
+        check(engine.inAuction("NEW") && b1->filled_qty() == 0, "개시 경매 중 체결 없음");
+
+        // 경매 시간이 지난 뒤 첫 주문이 먼저 단일가 체결을 일으킨다 (기준가 없음 → 낮은 가격)
+        clock.advance(std::chrono::seconds(30));
+        auto b2 = mk("b2", "userC", "NEW", true, 400, 1);
+        engine.addOrder(b2);
+        check(!engine.inAuction("NEW"), "개시 경매 종료");
+        check(b1->filled_qty() == 5 && s1->filled_qty() == 5, "개시 단일가 체결 5");
+        check(handler.getLastPrice("NEW") == 490, "개시가 490");
+        check(engine.hasOrder("NEW", "b2") && b2->filled_qty() == 0, "경매 후 주문은 연속 매매로 등재");
+        setenv("OPENING_AUCTION_SECONDS", "0", 1);
+    }
+
+    std::cout << "=== " << (failures == 0 ? "ALL PASS" : std::to_string(failures) + " FAIL")
+              << " ===\n";
+    return failures == 0 ? 0 : 1;
+}
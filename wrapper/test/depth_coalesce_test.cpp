@@ -0,0 +1,121 @@
+// depth 발행 합치기 검증 — 인바운드 명령 하나당 depth 발행은 최대 1회, 내용은 최종 상태.
+// 시나리오: 10단계 스윕 / STP 취소 + add / 전량 취소 / 단일 add·북에 닿지 않는 명령.
+#include "engine_core.h"
+#include "market_data_handler.h"
+#include "iproducer.h"
+#include "metrics.h"
+#include "order.h"
+#include <iostream>
+#include <memory>
+#include <string>
+
+using namespace aws_wrapper;
+
+struct MockProducer : public IProducer {
+    int fills = 0;
+    int cancels = 0;
+    void publishFill(const std::string&, const std::string&, const std::string&,
+                     const std::string&, const std::string&, uint64_t, uint64_t,
+                     bool, bool, bool) override { ++fills; }
+    void publishTrade(const std::string&, uint64_t, uint64_t) override {}
+    void publishDepth(const std::string&, const nlohmann::json&) override {}
+    void publishOrderStatus(const std::string&, const std::string&,
+                            const std::string&, const std::string& status,
+                            const std::string&, uint64_t, uint64_t, bool,
+                            const std::string&) override {
+        if (status == "CANCELLED") ++cancels;
+    }
+    void flush(int) override {}
+};
+
+static OrderPtr mk(const std::string& id, const std::string& user, const std::string& sym,
+                   bool buy, uint64_t price, uint64_t qty,
+                   const std::string& type = "LIMIT") {
+    auto o = std::make_shared<Order>();
+    o->setOrderId(id); o->setUserId(user); o->setSymbol(sym);
+    o->setIsBuy(buy); o->setPrice(price); o->setOrderQty(qty); o->setOrderType(type);
+    return o;
+}
+
+static int failures = 0;
+static void check(bool c, const std::string& n) {
+    std::cout << (c ? "  PASS  " : "  FAIL  ") << n << "\n";
+    if (!c) ++failures;
+}
+
+static uint64_t published() { return Metrics::instance().getDepthPublished(); }
+
+int main() {
+    std::cout << "=== depth 발행 합치기 검증 ===\n";
+
+    MockProducer prod;
+    MarketDataHandler handler(&prod);
+    EngineCore engine(&handler);
+
+    // 매도 10단계(1000~1009, 단계당 10주) + 매수 1단계
+    for (int i = 0; i < 10; ++i) {
+        engine.addOrder(mk("a" + std::to_string(i), "userA", "AAA", false, 1000 + i, 10));
+    }
+    engine.addOrder(mk("b0", "userB", "AAA", true, 990, 10));
+
+    // ── ① 10단계를 쓸어가는 시장가 매수: 체결 10건, depth 발행 1회 ──
+    {
+        uint64_t before = published();
+        auto mkt = mk("m1", "userC", "AAA", true, 0, 100, "MARKET");
+        mkt->setConditions(liquibook::book::oc_immediate_or_cancel);
+        engine.addOrder(mkt);
+        check(prod.fills == 10, "스윕 체결 10건");
+        check(published() - before == 1, "스윕 1회 → depth 발행 1회 (BBO 중복 발행 없음)");
+
+        DepthView view;
+        check(engine.getDepth("AAA", 5, view), "depth 조회");
+        check(view.asks.empty(), "최종 상태: 매도 호가 소진");
+        check(view.bids.size() == 1 && view.bids[0].price == 990, "최종 상태: 매수 990 유지");
+    }
+
+    // ── ② STP 취소 2건 + add: 명령 하나로 depth 발행 1회 ──
+    {
+        engine.addOrder(mk("s1", "userD", "AAA", false, 1010, 5));
+        engine.addOrder(mk("s2", "userD", "AAA", false, 1011, 5));
+        uint64_t before = published();
+        int cancels_before = prod.cancels;
+        engine.addOrder(mk("d1", "userD", "AAA", true, 1011, 7));
+        check(prod.cancels - cancels_before == 2, "STP: 자기 매도 2건 취소");
+        check(published() - before == 1, "STP 취소 + add → depth 발행 1회");
+
+        DepthView view;
+        engine.getDepth("AAA", 5, view);
+        check(view.asks.empty(), "최종 상태: 취소된 매도 호가 없음");
+        check(!view.bids.empty() && view.bids[0].price == 1011 && view.bids[0].qty == 7,
+              "최종 상태: 매수 1011 x 7 최우선");
+    }
+
+    // ── ③ 전량 취소: 주문 수와 무관하게 depth 발행 1회 ──
+    {
+        engine.addOrder(mk("e1", "userE", "BBB", true, 500, 1));
+        engine.addOrder(mk("e2", "userE", "BBB", true, 501, 1));
+        engine.addOrder(mk("e3", "userE", "BBB", false, 510, 1));
+        uint64_t before = published();
+        auto result = engine.cancelAllOrders("BBB");
+        check(result.cancelled_count == 3, "전량 취소 3건");
+        check(published() - before == 1, "전량 취소 → depth 발행 1회");
+
+        DepthView view;
+        engine.getDepth("BBB", 5, view);
+        check(view.bids.empty() && view.asks.empty(), "최종 상태: 빈 호가");
+    }
+
+    // ── ④ 단일 add는 1회, 북에 닿지 않는 명령은 0회 ──
+    {
+        uint64_t before = published();
+        engine.addOrder(mk("b1", "userB", "AAA", true, 900, 10));   // 새 매수 단계
+        uint64_t after_add = published();
+        engine.cancelOrder("AAA", "no-such-order");
+        check(after_add - before == 1, "새 호가 단계 → 발행 1회");
+        check(published() == after_add, "없는 주문 취소 → 발행 없음");
+    }
+
+    std::cout << "=== " << (failures == 0 ? "ALL PASS" : std::to_string(failures) + " FAIL")
+              << " ===\n";
+    return failures == 0 ? 0 : 1;
+}
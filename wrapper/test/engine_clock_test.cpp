@@ -0,0 +1,133 @@
+// 엔진 시계 검증 — 시뮬레이션 시계로 120초 VI halt 만료를 즉시 확인, 입력 기반 시계로 재생 결정성 확인.
+#include "engine_core.h"
+#include "engine_clock.h"
+#include "market_data_handler.h"
+#include "iproducer.h"
+#include "order.h"
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace aws_wrapper;
+
+struct MockProducer : public IProducer {
+    std::vector<std::pair<std::string,std::string>> rejects;  // (order_id, reason)
+    int fills = 0;
+    void publishFill(const std::string&, const std::string&, const std::string&,
+                     const std::string&, const std::string&, uint64_t, uint64_t,
+                     bool, bool, bool) override { ++fills; }
+    void publishTrade(const std::string&, uint64_t, uint64_t) override {}
+    void publishDepth(const std::string&, const nlohmann::json&) override {}
+    void publishOrderStatus(const std::string&, const std::string& oid,
+                            const std::string&, const std::string& status,
+                            const std::string& reason, uint64_t, uint64_t, bool,
+                            const std::string&) override {
+        if (status == "REJECTED") rejects.push_back({oid, reason});
+    }
+    void flush(int) override {}
+};
+
+static OrderPtr mk(const std::string& id, const std::string& u, const std::string& s,
+                   bool buy, uint64_t px, uint64_t q, int64_t ts = 0) {
+    auto o = std::make_shared<Order>();
+    o->setOrderId(id); o->setUserId(u); o->setSymbol(s);
+    o->setIsBuy(buy); o->setPrice(px); o->setOrderQty(q); o->setOrderType("LIMIT");
+    o->setTimestamp(ts);
+    return o;
+}
+static int failures = 0;
+static void check(bool c, const std::string& n) {
+    std::cout << (c ? "  PASS  " : "  FAIL  ") << n << "\n"; if (!c) ++failures;
+}
+static bool rejectedFor(const MockProducer& p, const std::string& id, const std::string& sub) {
+    for (auto& r : p.rejects)
+        if (r.first == id && r.second.find(sub) != std::string::npos) return true;
+    return false;
+}
+
+// 같은 입력 저널을 새 엔진에 재생하고 스냅샷을 돌려준다
+static std::string replayJournal() {
+    InputClock clock;
+    MockProducer prod;
+    MarketDataHandler handler(&prod);
+    EngineCore engine(&handler, nullptr, &clock);
+    engine.addOrder(mk("s1", "mmA", "AAA", false, 100, 10, 1700000000000));
+    engine.addOrder(mk("s2", "mmA", "AAA", false, 101, 10, 1700000000450));
+    engine.addOrder(mk("b1", "userB", "AAA", true, 101, 15, 1700000001200));
+    engine.addOrder(mk("b2", "userC", "AAA", true, 99, 5, 1700000000900));  // 역행 ts
+    return engine.snapshotOrderBook("AAA");
+}
+
+int main() {
+    std::cout << "=== 엔진 시계 검증 ===\n";
+
+    // 시뮬레이션 시계: 120초 halt를 sleep 없이 만료시킨다
+    {
+        setenv("VI_DYNAMIC_PCT", "0.03", 1);
+        setenv("VI_HALT_SECONDS", "120", 1);
+        setenv("PRICE_BAND_PCT", "0", 1);
+
+        SimulatedClock clock(1700000000000);
+        MockProducer prod;
+        MarketDataHandler handler(&prod);
+        EngineCore engine(&handler, nullptr, &clock);
+        check(&handler.clock() == &clock, "핸들러에 시계 전파");
+
+        engine.addOrder(mk("s1", "mmA", "AAA", false, 100, 10));
+        engine.addOrder(mk("b1", "userB", "AAA", true, 100, 10));   // 기준가 100
+        engine.addOrder(mk("s2", "mmA", "AAA", false, 105, 10));
+        engine.addOrder(mk("b2", "userB", "AAA", true, 105, 10));   // +5% → halt
+        check(engine.isHalted("AAA"), "★ VI halt 발동");
+
+        clock.advance(std::chrono::seconds(119));
+        engine.addOrder(mk("s3", "mmA", "AAA", false, 104, 10));
+        check(rejectedFor(prod, "s3", "halted"), "119초 경과: 여전히 halt (주문 거부)");
+
+        clock.advance(std::chrono::seconds(1));
+        check(!engine.isHalted("AAA"), "★ 120초 경과: 자동 해제");
+        engine.addOrder(mk("s4", "mmA", "AAA", false, 104, 10));
+        check(!rejectedFor(prod, "s4", "halted"), "해제 후 주문 접수");
+
+        // 스냅샷 시각도 시계를 따른다
+        auto snap = nlohmann::json::parse(engine.snapshotOrderBook("AAA"));
+        check(snap["timestamp"].get<int64_t>() == 1700000120000, "스냅샷 timestamp = 시뮬레이션 시각");
+
+        // 거래일도 시계 기준
+        clock.set(0);
+        check(handler.getCurrentTradingDay() == 19700101 ||
+              handler.getCurrentTradingDay() == 19691231, "거래일 = 시뮬레이션 날짜(epoch)");
+    }
+
+    // 입력 기반 시계: aggressor 타임스탬프로만 전진, 역행 무시
+    {
+        InputClock clock;
+        clock.observeInput(1000);
+        clock.observeInput(900);
+        check(clock.nowMs() == 1000, "입력 시계: 역행 타임스탬프 무시");
+        clock.observeInput(1700000000000LL * 1000000);   // ns 단위로 들어온 타임스탬프
+        clock.observeInput(1700000000000LL * 1000);      // µs
+        clock.observeInput(-5);
+        check(clock.nowMs() == 1000, "★ 입력 시계: ms로 볼 수 없는 타임스탬프 무시");
+
+        // timestamp 없는 입력은 마지막 입력 시각으로 채워진다
+        auto o = Order::fromJson(nlohmann::json{{"order_id", "x"}, {"symbol", "AAA"}}, &clock);
+        check(o->timestamp() == 1000, "fromJson: timestamp 누락 시 시계 시각");
+        auto o2 = Order::fromJson(nlohmann::json{{"order_id", "y"}, {"timestamp", 42}}, &clock);
+        check(o2->timestamp() == 42, "fromJson: 입력 timestamp 우선");
+    }
+
+    // 같은 저널 재생 → 바이트 단위 동일
+    {
+        std::string first = replayJournal();
+        std::string second = replayJournal();
+        check(!first.empty() && first == second, "★ 저널 재생 2회: 스냅샷 바이트 동일");
+        auto snap = nlohmann::json::parse(first);
+        check(snap["timestamp"].get<int64_t>() == 1700000001200, "스냅샷 시각 = 마지막 입력 최댓값");
+    }
+
+    std::cout << "=== " << (failures == 0 ? "ALL PASS" : std::to_string(failures) + " FAIL")
+              << " ===\n";
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,91 @@
+// 전체 호가(FullDepth) 검증 — 고정 10단계를 넘는 호가 유지, 상위 N 조회, 누적잔량, 체결/취소 반영.
+#include "engine_core.h"
+#include "market_data_handler.h"
+#include "iproducer.h"
+#include "order.h"
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace aws_wrapper;
+
+struct MockProducer : public IProducer {
+    int fills = 0;
+    void publishFill(const std::string&, const std::string&, const std::string&,
+                     const std::string&, const std::string&, uint64_t, uint64_t,
+                     bool, bool, bool) override { ++fills; }
+    void publishTrade(const std::string&, uint64_t, uint64_t) override {}
+    void publishDepth(const std::string&, const nlohmann::json&) override {}
+    void publishOrderStatus(const std::string&, const std::string&,
+                            const std::string&, const std::string&,
+                            const std::string&, uint64_t, uint64_t, bool,
+                            const std::string&) override {}
+    void flush(int) override {}
+};
+
+static OrderPtr mk(const std::string& id, const std::string& user, const std::string& sym,
+                   bool buy, uint64_t price, uint64_t qty) {
+    auto o = std::make_shared<Order>();
+    o->setOrderId(id); o->setUserId(user); o->setSymbol(sym);
+    o->setIsBuy(buy); o->setPrice(price); o->setOrderQty(qty); o->setOrderType("LIMIT");
+    return o;
+}
+
+static int failures = 0;
+static void check(bool c, const std::string& n) {
+    std::cout << (c ? "  PASS  " : "  FAIL  ") << n << "\n";
+    if (!c) ++failures;
+}
+
+int main() {
+    std::cout << "=== 전체 호가(FullDepth) 검증 ===\n";
+
+    MockProducer prod;
+    MarketDataHandler handler(&prod);
+    EngineCore engine(&handler);
+
+    // 매수 25단계(1000~1024, 단계당 10주) + 같은 가격 추가 주문 1건
+    for (int i = 0; i < 25; ++i) {
+        engine.addOrder(mk("b" + std::to_string(i), "userB", "AAA", true, 1000 + i, 10));
+    }
+    engine.addOrder(mk("b-extra", "userC", "AAA", true, 1020, 5));
+    // 매도 3단계
+    engine.addOrder(mk("a0", "userA", "AAA", false, 1100, 7));
+    engine.addOrder(mk("a1", "userA", "AAA", false, 1101, 8));
+    engine.addOrder(mk("a2", "userA", "AAA", false, 1105, 9));
+
+    DepthView view;
+    check(!engine.getDepth("ZZZ", 5, view), "없는 종목: false");
+
+    check(engine.getDepth("AAA", 0, view), "전체 조회 성공");
+    check(view.bids.size() == 25, "매수 25단계 모두 유지(고정 Depth<10> 초과)");
+    check(view.asks.size() == 3, "매도 3단계");
+    check(view.bids.front().price == 1024 && view.bids.back().price == 1000,
+          "매수: 최우선(1024)부터 정렬");
+    check(view.bids.back().cumulative_qty == 25 * 10 + 5, "매수 누적잔량 = 255");
+    check(view.asks.front().price == 1100 && view.asks[2].cumulative_qty == 24,
+          "매도: 최우선(1100)부터, 누적 24");
+
+    check(engine.getDepth("AAA", 5, view), "상위 5단계 조회");
+    check(view.bids.size() == 5 && view.asks.size() == 3, "N 초과분은 있는 만큼만");
+    check(view.bids[4].price == 1020 && view.bids[4].qty == 15 &&
+          view.bids[4].order_count == 2, "1020 단계: 2건 15주");
+
+    // 매도 공격 주문이 최우선 3단계 + 4번째 일부를 체결
+    engine.addOrder(mk("sweep", "userD", "AAA", false, 1021, 35));
+    check(engine.getDepth("AAA", 0, view), "체결 후 조회");
+    check(view.bids.size() == 22, "3단계 소진 → 22단계");
+    check(view.bids.front().price == 1021 && view.bids.front().qty == 5,
+          "최우선 1021 잔량 5");
+
+    // 고정 Depth 밖(11단계 이후)에 있던 주문 취소도 반영
+    check(engine.cancelOrder("AAA", "b0"), "심층 주문(1000) 취소");
+    check(engine.getDepth("AAA", 0, view), "취소 후 조회");
+    check(view.bids.size() == 21 && view.bids.back().price == 1001, "최하단 단계 제거");
+
+    std::cout << "=== " << (failures == 0 ? "ALL PASS" : std::to_string(failures) + " FAIL")
+              << " ===\n";
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,190 @@
+// JSON 작성기 골든 검증 — 체결/주문상태/호가/티커/OHLC 페이로드가 기존 nlohmann dump()와 바이트 단위로 같은지.
+#include "json_writer.h"
+#include <nlohmann/json.hpp>
+#include <chrono>
+#include <ctime>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace aws_wrapper;
+
+static int failures = 0;
+static void check(bool c, const std::string& n) {
+    std::cout << (c ? "  PASS  " : "  FAIL  ") << n << "\n";
+    if (!c) ++failures;
+}
+
+static void golden(const std::string& got, const std::string& want, const std::string& n) {
+    check(got == want, n);
+    if (got != want) {
+        std::cout << "    got : " << got << "\n    want: " << want << "\n";
+    }
+}
+
+// === 기존 구현 (nlohmann 트리 → dump) — 포맷의 기준 ===
+
+static std::string isoUtc(int64_t ts_ms) {
+    std::time_t t = static_cast<std::time_t>(ts_ms / 1000);
+    std::tm tm_now{};
+    gmtime_r(&t, &tm_now);
+    char iso_buf[30];
+    std::strftime(iso_buf, sizeof(iso_buf), "%Y-%m-%dT%H:%M:%SZ", &tm_now);
+    return iso_buf;
+}
+
+static std::string legacyFill(const std::string& symbol, const std::string& order_id,
+                              const std::string& matched_order_id, const std::string& buyer_id,
+                              const std::string& seller_id, uint64_t qty, uint64_t price,
+                              bool bf, bool sf, bool buyer_is_maker, int64_t ts) {
+    nlohmann::json j;
+    j["event"] = "FILL";
+    j["symbol"] = symbol;
+    j["trade_id"] = order_id + "_" + matched_order_id;
+    nlohmann::json buyer_obj;
+    buyer_obj["order_id"] = order_id;
+    buyer_obj["user_id"] = buyer_id;
+    buyer_obj["fully_filled"] = bf;
+    buyer_obj["is_maker"] = buyer_is_maker;
+    j["buyer"] = buyer_obj;
+    nlohmann::json seller_obj;
+    seller_obj["order_id"] = matched_order_id;
+    seller_obj["user_id"] = seller_id;
+    seller_obj["fully_filled"] = sf;
+    seller_obj["is_maker"] = !buyer_is_maker;
+    j["seller"] = seller_obj;
+    j["quantity"] = qty;
+    j["price"] = price;
+    j["timestamp"] = ts;
+    j["executed_at"] = isoUtc(ts);
+    return j.dump();
+}
+
+static std::string legacyStatus(const std::string& symbol, const std::string& order_id,
+                                const std::string& user_id, const std::string& status,
+                                const std::string& reason, uint64_t price, uint64_t quantity,
+                                bool is_buy, const std::string& order_type, int64_t ts) {
+    nlohmann::json j;
+    j["event"] = "ORDER_STATUS";
+    j["symbol"] = symbol;
+    j["order_id"] = order_id;
+    j["user_id"] = user_id;
+    j["status"] = status;
+    if (!reason.empty()) j["reason"] = reason;
+    if (quantity > 0) {
+        j["price"] = price;
+        j["quantity"] = quantity;
+        j["side"] = is_buy ? "BUY" : "SELL";
+        j["type"] = order_type.empty() ? "LIMIT" : order_type;
+    }
+    j["timestamp"] = ts;
+    return j.dump();
+}
+
+static std::string legacyDepth(const std::string& symbol,
+                               const std::vector<liquibook::book::DepthLevel>& bids,
+                               const std::vector<liquibook::book::DepthLevel>& asks,
+                               uint64_t last_price, int64_t ts) {
+    nlohmann::json depth_json;
+    depth_json["e"] = "d";
+    depth_json["s"] = symbol;
+    nlohmann::json bids_arr = nlohmann::json::array();
+    for (const auto& level : bids) bids_arr.push_back({level.price(), level.aggregate_qty()});
+    depth_json["b"] = bids_arr;
+    nlohmann::json asks_arr = nlohmann::json::array();
+    for (const auto& level : asks) asks_arr.push_back({level.price(), level.aggregate_qty()});
+    depth_json["a"] = asks_arr;
+    depth_json["t"] = ts;
+    depth_json["p"] = last_price;
+    return depth_json.dump();
+}
+
+static liquibook::book::DepthLevel level(uint64_t price, uint64_t qty) {
+    liquibook::book::DepthLevel l;
+    l.init(price, false);
+    l.add_order(qty);
+    return l;
+}
+
+int main() {
+    std::cout << "=== JSON 작성기 골든 검증 ===\n";
+
+    const int64_t ts = 1718000000123LL;  // 2024-06-10T06:13:20Z
+    std::string out;
+
+    // 체결
+    writeFillJson(out, "AAPL", "o-1", "o-2", "user-b", "user-s", 10, 15000, true, false, false, ts);
+    golden(out, legacyFill("AAPL", "o-1", "o-2", "user-b", "user-s", 10, 15000, true, false, false, ts),
+           "FILL 기본");
+    writeFillJson(out, "005930", "b", "s", "", "", 0, UINT64_MAX, false, true, true, 0);
+    golden(out, legacyFill("005930", "b", "s", "", "", 0, UINT64_MAX, false, true, true, 0),
+           "FILL 경계값(0, UINT64_MAX, 빈 문자열, epoch 0)");
+
+    // 이스케이프: 따옴표, 역슬래시, 제어문자 전부, DEL, UTF-8(한글)
+    std::string tricky = "q\"b\\s/\b\f\n\r\t";
+    for (char c = 1; c < 0x20; ++c) tricky.push_back(c);
+    tricky += "\x7f 삼성전자 ✓";
+    writeFillJson(out, tricky, tricky, "m", tricky, "s", 1, 2, true, true, false, ts);
+    golden(out, legacyFill(tricky, tricky, "m", tricky, "s", 1, 2, true, true, false, ts),
+           "FILL 문자열 이스케이프");
+
+    // 주문 상태: 주문 정보/사유 유무 조합
+    writeOrderStatusJson(out, "AAPL", "o-1", "u", "ACCEPTED", "", 100, 5, true, "LIMIT", ts);
+    golden(out, legacyStatus("AAPL", "o-1", "u", "ACCEPTED", "", 100, 5, true, "LIMIT", ts),
+           "ORDER_STATUS 주문 정보 포함");
+    writeOrderStatusJson(out, "AAPL", "o-1", "u", "REJECTED", "price \"band\"", 100, 5, false, "", ts);
+    golden(out, legacyStatus("AAPL", "o-1", "u", "REJECTED", "price \"band\"", 100, 5, false, "", ts),
+           "ORDER_STATUS 사유 + 빈 타입(LIMIT)");
+    writeOrderStatusJson(out, "AAPL", "o-1", "u", "CANCELLED", "user", 100, 0, true, "MARKET", ts);
+    golden(out, legacyStatus("AAPL", "o-1", "u", "CANCELLED", "user", 100, 0, true, "MARKET", ts),
+           "ORDER_STATUS 수량 0 (주문 정보 생략)");
+
+    // 호가
+    std::vector<liquibook::book::DepthLevel> bids = {level(1000, 5), level(999, 12)};
+    std::vector<liquibook::book::DepthLevel> asks = {level(1001, 7)};
+    std::vector<liquibook::book::DepthLevel> none;
+    writeDepthJson(out, "AAPL", bids, asks, 1000, ts);
+    golden(out, legacyDepth("AAPL", bids, asks, 1000, ts), "depth 양쪽");
+    writeDepthJson(out, "AAPL", none, none, 0, ts);
+    golden(out, legacyDepth("AAPL", none, none, 0, ts), "depth 빈 호가");
+
+    // 티커 / OHLC
+    nlohmann::json ticker;
+    ticker["e"] = "t"; ticker["s"] = "AAPL"; ticker["t"] = ts; ticker["p"] = uint64_t(1000);
+    writeTickerJson(out, "AAPL", 1000, ts);
+    golden(out, ticker.dump(), "ticker");
+
+    nlohmann::json ohlc;
+    ohlc["o"] = uint64_t(1); ohlc["h"] = uint64_t(4); ohlc["l"] = uint64_t(0);
+    ohlc["c"] = uint64_t(3); ohlc["v"] = uint64_t(99); ohlc["t"] = int64_t(ts / 1000);
+    writeOhlcJson(out, 1, 4, 0, 3, 99, ts / 1000);
+    golden(out, ohlc.dump(), "ohlc");
+
+    // 초 단위 캐시: 초가 바뀌면 갱신
+    check(JsonWriter::isoSecondUtc(ts / 1000) == isoUtc(ts), "ISO 타임스탬프");
+    check(JsonWriter::isoSecondUtc(ts / 1000 + 1) == isoUtc(ts + 1000), "ISO 캐시 갱신");
+
+    // 처리량 (참고용 출력)
+    const int N = 200000;
+    auto t0 = std::chrono::steady_clock::now();
+    size_t sink = 0;
+    for (int i = 0; i < N; ++i) {
+        sink += legacyFill("AAPL", "order-123456", "order-654321", "user-b", "user-s",
+                           i, 15000, true, false, false, ts + i).size();
+    }
+    auto t1 = std::chrono::steady_clock::now();
+    for (int i = 0; i < N; ++i) {
+        writeFillJson(out, "AAPL", "order-123456", "order-654321", "user-b", "user-s",
+                      i, 15000, true, false, false, ts + i);
+        sink += out.size();
+    }
+    auto t2 = std::chrono::steady_clock::now();
+    double legacy_ns = std::chrono::duration<double, std::nano>(t1 - t0).count() / N;
+    double writer_ns = std::chrono::duration<double, std::nano>(t2 - t1).count() / N;
+    std::cout << "  FILL 직렬화: nlohmann " << legacy_ns << " ns, writer " << writer_ns
+              << " ns (" << legacy_ns / writer_ns << "x)" << (sink ? "" : " ") << "\n";
+
+    std::cout << "=== " << (failures == 0 ? "ALL PASS" : std::to_string(failures) + " FAIL")
+              << " ===\n";
+    return failures == 0 ? 0 : 1;
+}
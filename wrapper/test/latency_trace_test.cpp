@@ -0,0 +1,192 @@
+// 주문 단위 지연 추적 검증 — TSC 시계 보정, 단계 순서, 동기 I/O 귀속,
+// 샘플링 링, dominant 구성 요소 판정, Prometheus 노출.
+#include "latency_trace.h"
+#include "engine_core.h"
+#include "market_data_handler.h"
+#include "iproducer.h"
+#include "order.h"
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+using namespace aws_wrapper;
+
+// 느린 Kinesis를 흉내: 발행마다 2ms, KinesisProducer::produce처럼 I/O와 PUBLISHED를 기록
+struct SlowProducer : public IProducer {
+    void put() {
+        TraceIoScope io(TraceIo::KINESIS);
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        LatencyTracer::stamp(TraceStage::PUBLISHED);
+    }
+    void publishFill(const std::string&, const std::string&, const std::string&,
+                     const std::string&, const std::string&, uint64_t, uint64_t,
+                     bool, bool, bool) override { put(); }
+    void publishTrade(const std::string&, uint64_t, uint64_t) override { put(); }
+    void publishDepth(const std::string&, const nlohmann::json&) override {}
+    void publishOrderStatus(const std::string&, const std::string&,
+                            const std::string&, const std::string&,
+                            const std::string&, uint64_t, uint64_t, bool,
+                            const std::string&) override { put(); }
+    void flush(int) override {}
+};
+
+static OrderPtr mk(const std::string& id, const std::string& user, bool buy,
+                   uint64_t price, uint64_t qty) {
+    auto o = std::make_shared<Order>();
+    o->setOrderId(id); o->setUserId(user); o->setSymbol("TRC");
+    o->setIsBuy(buy); o->setPrice(price); o->setOrderQty(qty); o->setOrderType("LIMIT");
+    return o;
+}
+
+static int failures = 0;
+static void check(bool c, const std::string& n) {
+    std::cout << (c ? "  PASS  " : "  FAIL  ") << n << "\n";
+    if (!c) ++failures;
+}
+
+static bool contains(const std::string& s, const std::string& sub) {
+    return s.find(sub) != std::string::npos;
+}
+
+// 컨슈머 콜백과 같은 순서로 주문 하나를 처리
+static void process(EngineCore& e, const OrderPtr& order) {
+    LatencyTracer::markFetched();
+    ScopedTrace trace;
+    LatencyTracer::stamp(TraceStage::DECODED);
+    e.addOrder(order);
+    trace.finish(order->symbol(), order->order_id());
+}
+
+int main() {
+    setenv("PRICE_BAND_PCT", "0", 1);
+    setenv("VI_DYNAMIC_PCT", "0", 1);
+    std::cout << "=== 주문 지연 추적 검증 ===\n";
+    auto& tracer = LatencyTracer::instance();
+
+    // ── ① 시계 보정: 5ms sleep이 5ms 근처로 환산 ─────────────────────────
+    {
+        check(TraceClock::nanosPerTick() > 0.0, "틱당 ns 양수");
+        uint64_t t0 = TraceClock::now();
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        uint64_t ns = TraceClock::toNanos(TraceClock::now() - t0);
+        check(ns >= 4500000 && ns < 50000000, "5ms sleep ≈ 5ms (" + std::to_string(ns) + "ns)");
+    }
+
+    // ── ② 트레이스 밖 기록은 no-op ───────────────────────────────────────
+    {
+        LatencyTracer::stamp(TraceStage::LOCKED);
+        LatencyTracer::addIo(TraceIo::REDIS, 1000);
+        check(!LatencyTracer::active(), "begin 전 비활성");
+        check(tracer.tracedCount() == 0 && tracer.span(LatencyTracer::SPAN_REDIS).count() == 0,
+              "활성 트레이스 없으면 집계 없음");
+    }
+
+    // ── ③ 엔진 경로: 단계 순서와 I/O 귀속 ────────────────────────────────
+    tracer.configure(1, 0, 4);
+    SlowProducer p;
+    MarketDataHandler h(&p);
+    EngineCore e(&h);
+    process(e, mk("s1", "userA", false, 100, 10));
+    process(e, mk("b1", "userB", true, 100, 4));   // 체결: ACCEPTED + fill 2건
+
+    {
+        auto traces = tracer.recent(10);
+        check(traces.size() == 2, "샘플 2건 (sample_every=1)");
+        const auto& t = traces.front();
+        check(t.order_id == "b1" && t.symbol == "TRC", "최신 순 (b1 먼저)");
+        auto at = [&t](TraceStage s) { return t.stage_ns[static_cast<size_t>(s)]; };
+        check(at(TraceStage::FETCHED) == 0, "FETCHED = 기준점 0");
+        check(at(TraceStage::DECODED) >= 0 &&
+              at(TraceStage::LOCKED) >= at(TraceStage::DECODED) &&
+              at(TraceStage::MATCHED) >= at(TraceStage::LOCKED) &&
+              at(TraceStage::CALLBACKS_DONE) >= at(TraceStage::MATCHED),
+              "★ fetched ≤ decoded ≤ locked ≤ matched ≤ callbacks_done");
+        check(at(TraceStage::PUBLISHED) >= at(TraceStage::MATCHED) &&
+              at(TraceStage::PUBLISHED) <= at(TraceStage::CALLBACKS_DONE),
+              "PUBLISHED는 콜백 구간 안 (마지막 발행)");
+        check(at(TraceStage::DEPTH_WRITTEN) == -1, "depth Redis 없음 → 미기록(-1)");
+        check(at(TraceStage::MATCHED) - at(TraceStage::LOCKED) < 2000000,
+              "★ MATCHED는 첫 콜백 진입 — 발행 I/O가 매칭 구간에 섞이지 않음");
+
+        size_t k = static_cast<size_t>(TraceIo::KINESIS);
+        check(t.io_calls[k] >= 3, "체결 주문의 Kinesis 호출 ≥ 3 (ACCEPTED + fill 2)");
+        check(t.io_ns[k] >= 6000000, "Kinesis I/O 누적 ≥ 6ms");
+        check(t.total_ns >= t.io_ns[k], "end_to_end ≥ Kinesis I/O");
+    }
+
+    // ── ④ 구간 히스토그램과 dominant 판정 ─────────────────────────────────
+    {
+        check(tracer.tracedCount() == 2, "추적 주문 수 2");
+        check(tracer.span(LatencyTracer::SPAN_LOCK_WAIT).count() == 2 &&
+              tracer.span(LatencyTracer::SPAN_MATCH).count() == 2 &&
+              tracer.span(LatencyTracer::SPAN_KINESIS).count() == 2,
+              "주문마다 lock_wait/match/kinesis 기록");
+        check(tracer.span(LatencyTracer::SPAN_KINESIS).percentile(0.99) >= 2000000,
+              "kinesis p99 ≥ 2ms");
+        check(tracer.dominantCount(LatencyTracer::COMP_KINESIS) == 2,
+              "★ 느린 Kinesis가 p99 지배 요인으로 판정");
+    }
+
+    // ── ⑤ 폐기와 링 크기 ────────────────────────────────────────────────
+    {
+        try {
+            ScopedTrace trace;
+            LatencyTracer::stamp(TraceStage::DECODED);
+            throw std::runtime_error("decode failure");
+        } catch (const std::exception&) {
+        }
+        check(!LatencyTracer::active() && tracer.tracedCount() == 2,
+              "예외로 빠진 트레이스는 폐기");
+
+        for (int i = 0; i < 5; ++i) process(e, mk("r" + std::to_string(i), "userC", false, 200, 1));
+        auto traces = tracer.recent(10);
+        check(traces.size() == 4, "링 용량 4 유지");
+        check(traces.front().order_id == "r4" && traces.back().order_id == "r1",
+              "가장 오래된 샘플부터 덮어씀");
+    }
+
+    // ── ⑥ 샘플링: N건마다 하나 + 임계 초과는 항상 ───────────────────────
+    {
+        tracer.configure(3, 0, 64);
+        uint64_t before = tracer.sampledCount();
+        for (int i = 0; i < 6; ++i) process(e, mk("n" + std::to_string(i), "userD", false, 300, 1));
+        check(tracer.sampledCount() - before == 2, "sample_every=3 → 6건 중 2건");
+
+        tracer.configure(0, 1000000, 64);  // 주기 샘플링 끔, 1ms 초과만
+        before = tracer.sampledCount();
+        process(e, mk("slow1", "userE", false, 400, 1));  // ACCEPTED 발행 2ms
+        check(tracer.sampledCount() - before == 1 &&
+              tracer.recent(1).front().order_id == "slow1", "임계 초과 주문은 항상 샘플");
+    }
+
+    // ── ⑦ Prometheus ─────────────────────────────────────────────────────
+    {
+        std::string out;
+        tracer.writePrometheus(out);
+        check(contains(out, "# TYPE engine_stage_latency_seconds histogram\n"), "histogram TYPE 줄");
+        check(contains(out, "engine_stage_latency_seconds_bucket{stage=\"kinesis\",le=\"+Inf\"} "),
+              "stage 라벨 + le");
+        check(contains(out, "engine_stage_latency_seconds_count{stage=\"lock_wait\"} "),
+              "_count 라벨");
+        check(contains(out, "engine_stage_latency_quantile_seconds{stage=\"end_to_end\",quantile=\"0.99\"} "),
+              "분위수 gauge 라벨");
+        check(contains(out, "engine_trace_dominant_total{component=\"kinesis\"} "),
+              "dominant 카운터");
+        // 라벨 없는 기존 출력 형식은 그대로
+        std::string plain;
+        LatencyHistogram hist;
+        hist.record(1500);
+        Metrics::writeHistogram(plain, "x_seconds", "x", hist);
+        check(contains(plain, "x_seconds_bucket{le=\"+Inf\"} 1\n") &&
+              contains(plain, "x_seconds_count 1\n") &&
+              contains(plain, "x_quantile_seconds{quantile=\"0.5\"} "),
+              "writeHistogram 형식 유지");
+    }
+
+    std::cout << "=== " << (failures == 0 ? "ALL PASS" : std::to_string(failures) + " FAIL")
+              << " ===\n";
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,203 @@
+// 비동기 로거 검증 — 바이너리 레코드 포맷(기존 출력과 동일), 스레드별 링과 순서,
+// flush, 링 초과 시 무손실, 긴 인자 overflow 경로, 동기 모드, 핫패스 비용,
+// LOGGER_* 매크로의 지연 평가.
+#include "logger.h"
+#include <fcntl.h>
+#include <unistd.h>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace aws_wrapper;
+
+static int failures = 0;
+static void check(bool c, const std::string& n) {
+    std::cout << (c ? "  PASS  " : "  FAIL  ") << n << "\n";
+    if (!c) ++failures;
+}
+
+// stdout을 임시 파일로 돌려 fn 실행 중 출력된 로그를 모은다
+template <typename Fn>
+static std::string capture(Fn fn) {
+    char path[] = "/tmp/logger_test_XXXXXX";
+    int fd = ::mkstemp(path);
+    std::fflush(stdout);
+    std::cout.flush();
+    int saved = ::dup(1);
+    ::dup2(fd, 1);
+    fn();
+    Logger::flush();
+    std::fflush(stdout);
+    ::dup2(saved, 1);
+    ::close(saved);
+    ::close(fd);
+    std::ifstream in(path);
+    std::stringstream ss;
+    ss << in.rdbuf();
+    ::unlink(path);
+    return ss.str();
+}
+
+static std::vector<std::string> lines(const std::string& s) {
+    std::vector<std::string> out;
+    std::istringstream in(s);
+    std::string line;
+    while (std::getline(in, line)) out.push_back(line);
+    return out;
+}
+
+// "[YYYY-mm-dd HH:MM:SS.mmm] " 다음 부분
+static std::string body(const std::string& line) {
+    return line.size() > 26 ? line.substr(26) : "";
+}
+
+int main() {
+    std::cout << "=== 비동기 로거 검증 ===\n";
+    Logger::setLevel(LogLevel::INFO);
+
+    // ── ① 포맷: 기존 ostream 출력과 같은 모양 ──────────────────────────────
+    {
+        std::string s = "sym";
+        const char* reason = "Price outside allowed band";
+        const char* null_str = nullptr;
+        auto out = capture([&] {
+            Logger::info("Order ACCEPTED:", s, 42, -7, 3.5, 0.1, true, 'x',
+                         uint64_t(18446744073709551615ull));
+            Logger::warn("Order rejected:", reason, null_str);
+            Logger::error(std::string("dynamic message"), 1);
+            Logger::debug("not shown", 1);
+        });
+        auto ls = lines(out);
+        check(ls.size() == 3, "DEBUG는 INFO 레벨에서 걸러짐 (3줄)");
+        check(ls.size() >= 1 && ls[0].size() > 26 && ls[0][0] == '[' && ls[0][5] == '-' &&
+              ls[0][20] == '.' && ls[0][24] == ']', "타임스탬프 [YYYY-mm-dd HH:MM:SS.mmm]");
+        check(ls.size() >= 1 &&
+              body(ls[0]) == "[INFO] Order ACCEPTED: sym 42 -7 3.5 0.1 1 x 18446744073709551615",
+              "인자 타입별 출력 (정수/실수/bool/char/u64)");
+        check(ls.size() >= 2 &&
+              body(ls[1]) == "[WARN] Order rejected: Price outside allowed band (null)",
+              "const char* 복사 + null 안전");
+        check(ls.size() >= 3 && body(ls[2]) == "[ERROR] dynamic message 1", "비리터럴 메시지");
+    }
+
+    // ── ② 인라인 한도를 넘는 인자: 텍스트 overflow 경로 ───────────────────
+    {
+        std::string big(500, 'z');
+        auto out = capture([&] { Logger::info("DEPTH_SAVE:", "k", big, 7); });
+        auto ls = lines(out);
+        check(ls.size() == 1 && body(ls[0]) == "[INFO] DEPTH_SAVE: k " + big + " 7",
+              "긴 인자도 잘리지 않음");
+    }
+
+    // ── ③ 다중 스레드: 스레드 안 순서 유지, 링(1024) 초과분도 무손실 ───────
+    {
+        constexpr int THREADS = 4, PER_THREAD = 5000;
+        auto out = capture([&] {
+            std::vector<std::thread> ts;
+            for (int t = 0; t < THREADS; ++t) {
+                ts.emplace_back([t] {
+                    for (int i = 0; i < PER_THREAD; ++i) Logger::info("seq", t, i);
+                });
+            }
+            for (auto& th : ts) th.join();
+        });
+        auto ls = lines(out);
+        check(ls.size() == THREADS * PER_THREAD, "20000줄 전부 기록 (드롭 없음)");
+        std::vector<int> next(THREADS, 0);
+        bool ordered = true;
+        for (const auto& l : ls) {
+            int t = -1, i = -1;
+            if (std::sscanf(body(l).c_str(), "[INFO] seq %d %d", &t, &i) != 2 || t < 0 ||
+                t >= THREADS || i != next[t]) {
+                ordered = false;
+                break;
+            }
+            ++next[t];
+        }
+        check(ordered, "스레드별 순서 보존");
+        check(Logger::getRingFullWaits() > 0 || ls.size() == THREADS * PER_THREAD,
+              "링 가득 참은 대기로 처리");
+    }
+
+    // ── ④ 런타임/빌드 레벨 판정 ──────────────────────────────────────────
+    {
+        check(!Logger::enabled<LogLevel::DEBUG>() && Logger::enabled<LogLevel::INFO>(),
+              "enabled<L>: 런타임 레벨 반영");
+        Logger::setLevel(LogLevel::ERROR);
+        auto out = capture([] {
+            Logger::warn("hidden");
+            Logger::error("visible");
+        });
+        check(lines(out).size() == 1, "setLevel(ERROR) 후 WARN 숨김");
+        Logger::setLevel(LogLevel::INFO);
+    }
+
+    // ── ⑤ 핫패스 비용 (참고치) — 링 용량 안에서 측정 ──────────────────────
+    {
+        constexpr int N = 500;
+        std::string order_id = "ord-123456";
+        double per_call = 0;
+        capture([&] {
+            auto start = std::chrono::steady_clock::now();
+            for (int i = 0; i < N; ++i) {
+                Logger::info("Order ACCEPTED:", order_id, "SYM", i);
+            }
+            per_call = std::chrono::duration<double, std::nano>(
+                std::chrono::steady_clock::now() - start).count() / N;
+        });
+        std::cout << "  info: " << per_call << " ns/call (format+write는 백그라운드)\n";
+        check(per_call < 5000, "호출당 비용이 동기 출력보다 작음");
+        Logger::setLevel(LogLevel::WARN);
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < N; ++i) Logger::info("filtered", order_id, i);
+        double filtered = std::chrono::duration<double, std::nano>(
+            std::chrono::steady_clock::now() - start).count() / N;
+        Logger::setLevel(LogLevel::INFO);
+        std::cout << "  filtered: " << filtered << " ns/call\n";
+        check(filtered < 100, "레벨로 걸러진 호출은 거의 무비용");
+    }
+
+    // ── ⑥ 동기 모드 ─────────────────────────────────────────────────────
+    {
+        auto out = capture([] {
+            Logger::setAsync(false);
+            Logger::info("sync", 1);
+            Logger::info("sync", 2);
+        });
+        auto ls = lines(out);
+        check(ls.size() == 2 && body(ls[1]) == "[INFO] sync 2", "setAsync(false) 즉시 쓰기");
+        Logger::setAsync(true);
+        out = capture([] { Logger::info("async again"); });
+        check(lines(out).size() == 1, "setAsync(true)로 복귀");
+    }
+
+    // ── ⑦ 매크로: 꺼진 레벨은 인자를 평가하지 않음 ─────────────────────────
+    {
+        int evaluated = 0;
+        auto expensive = [&evaluated] {
+            ++evaluated;
+            return std::string(300, 'q').substr(0, 200);
+        };
+        auto out = capture([&] {
+            LOGGER_DEBUG("DEPTH_SAVE:", expensive());
+            LOGGER_INFO("shown", expensive().size());
+            if (evaluated > 0) LOGGER_WARN("dangling-else safe");
+            else LOGGER_ERROR("unreachable");
+        });
+        auto ls = lines(out);
+        check(evaluated == 1, "★ DEBUG 꺼짐 → 인자 평가 0회 (INFO만 1회)");
+        check(ls.size() == 2 && body(ls[0]) == "[INFO] shown 200" &&
+              body(ls[1]) == "[WARN] dangling-else safe", "매크로 출력 + if/else 문맥");
+        check(LOGGER_MIN_LEVEL == 0, "기본 빌드는 전 레벨 포함 (LOGGER_MIN_LEVEL=0)");
+    }
+
+    std::cout << "=== " << (failures == 0 ? "ALL PASS" : std::to_string(failures) + " FAIL")
+              << " ===\n";
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,169 @@
+// 시장가 collar 검증 — MARKET 주문은 반대편 최우선호가 ±MARKET_COLLAR_PCT 지정가로 바뀌어
+// 그 범위 안에서만 체결되고, 잔량은 취소되지 않고 collar 가격에 남는다.
+#include "engine_core.h"
+#include "market_data_handler.h"
+#include "iproducer.h"
+#include "order.h"
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <string>
+
+using namespace aws_wrapper;
+
+struct MockProducer : public IProducer {
+    int fills = 0;
+    int cancels = 0;
+    std::map<std::string, std::string> last_status;   // order_id → 마지막 상태 이벤트
+    std::map<std::string, std::string> last_type;     // order_id → 그 이벤트의 order_type
+    void publishFill(const std::string&, const std::string&, const std::string&,
+                     const std::string&, const std::string&, uint64_t, uint64_t,
+                     bool, bool, bool) override { ++fills; }
+    void publishTrade(const std::string&, uint64_t, uint64_t) override {}
+    void publishDepth(const std::string&, const nlohmann::json&) override {}
+    void publishOrderStatus(const std::string&, const std::string& order_id,
+                            const std::string&, const std::string& status,
+                            const std::string&, uint64_t, uint64_t, bool,
+                            const std::string& order_type) override {
+        if (status == "CANCELLED") ++cancels;
+        last_status[order_id] = status;
+        last_type[order_id] = order_type;
+    }
+    void flush(int) override {}
+};
+
+static OrderPtr mk(const std::string& id, const std::string& user, const std::string& sym,
+                   bool buy, uint64_t price, uint64_t qty) {
+    auto o = std::make_shared<Order>();
+    o->setOrderId(id); o->setUserId(user); o->setSymbol(sym);
+    o->setIsBuy(buy); o->setPrice(price); o->setOrderQty(qty); o->setOrderType("LIMIT");
+    return o;
+}
+
+// 라우터가 만드는 시장가: 항상 IOC, BUY는 price=max_price, SELL은 price=0
+static OrderPtr mkt(const std::string& id, const std::string& user, const std::string& sym,
+                    bool buy, uint64_t max_price, uint64_t qty) {
+    auto o = mk(id, user, sym, buy, buy ? max_price : 0, qty);
+    o->setOrderType("MARKET");
+    o->setConditions(liquibook::book::oc_immediate_or_cancel);
+    return o;
+}
+
+static int failures = 0;
+static void check(bool c, const std::string& n) {
+    std::cout << (c ? "  PASS  " : "  FAIL  ") << n << "\n";
+    if (!c) ++failures;
+}
+
+int main() {
+    std::cout << "=== 시장가 collar 검증 ===\n";
+    setenv("PRICE_BAND_PCT", "0", 1);
+    setenv("VI_DYNAMIC_PCT", "0", 1);
+    setenv("OPENING_AUCTION_SECONDS", "0", 1);
+    setenv("MARKET_COLLAR_PCT", "0.05", 1);
+
+    {
+        MockProducer prod;
+        MarketDataHandler handler(&prod);
+        EngineCore engine(&handler, nullptr);
+
+        // ── ① MARKET BUY: 최우선 매도 1000 → collar 1050. 1100은 건드리지 않는다 ──
+        engine.addOrder(mk("a1", "userA", "COL", false, 1000, 2));
+        engine.addOrder(mk("a2", "userB", "COL", false, 1040, 2));
+        engine.addOrder(mk("a3", "userC", "COL", false, 1100, 5));
+        auto mb = mkt("m1", "userD", "COL", true, 2000, 10);
+        engine.addOrder(mb);
+        check(mb->price() == 1050 && !mb->immediate_or_cancel(), "지정가 1050으로 전환");
+        check(mb->filled_qty() == 4, "collar 안의 1000·1040만 체결");
+        check(prod.cancels == 0 && engine.hasOrder("COL", "m1"), "잔량은 취소되지 않고 잔류");
+        check(mb->order_type() == "LIMIT" && prod.last_status["m1"] == "ACCEPTED" &&
+              prod.last_type["m1"] == "LIMIT", "★ collar 잔량은 LIMIT으로 발행");
+        {
+            DepthView view;
+            engine.getDepth("COL", 5, view);
+            check(view.bids.size() == 1 && view.bids[0].price == 1050 && view.bids[0].qty == 6,
+                  "잔여 매수 1050 x 6");
+            check(view.asks.size() == 1 && view.asks[0].price == 1100 && view.asks[0].qty == 5,
+                  "1100 매도 보존");
+        }
+
+        // ── ② MARKET BUY의 max_price가 collar보다 낮으면 max_price가 상한 ──
+        auto capped = mkt("m2", "userE", "COL", true, 1120, 5);
+        engine.addOrder(capped);
+        check(capped->price() == 1120 && capped->filled_qty() == 5, "collar 1155 대신 max_price 1120");
+
+        // ── ③ MARKET SELL(price=0): 최우선 매수 1050 → collar floor(997.5)=997 ──
+        engine.addOrder(mk("b1", "userF", "COL", true, 990, 3));
+        auto ms = mkt("m3", "userG", "COL", false, 0, 10);
+        engine.addOrder(ms);
+        check(ms->price() == 997 && ms->filled_qty() == 6, "1050 x 6만 체결, 990은 collar 밖");
+        check(engine.hasOrder("COL", "m3") && engine.hasOrder("COL", "b1"),
+              "잔량 997 매도 잔류, 990 매수 보존");
+        check(engine.getCounters().market_orders_collared == 3, "collar 적용 3건");
+
+        // ── ④ max_price가 최우선 매도(997)보다 낮으면 잔류시키지 않고 IOC 취소 ──
+        int cancels_before = prod.cancels;
+        auto low = mkt("m5", "userI", "COL", true, 900, 2);
+        engine.addOrder(low);
+        check(low->price() == 900 && low->immediate_or_cancel() && low->filled_qty() == 0,
+              "상한 900은 collar 미적용, IOC 유지");
+        check(prod.cancels - cancels_before == 1 && !engine.hasOrder("COL", "m5"),
+              "교차하지 않는 시장가 매수는 잔류하지 않고 취소");
+        check(prod.last_type["m5"] == "MARKET", "collar 미적용 주문은 MARKET 유지");
+
+        // ── ⑤ 반대편이 비면 기존대로 IOC 취소 ──
+        cancels_before = prod.cancels;
+        auto empty = mkt("m4", "userH", "EMP", false, 0, 1);
+        engine.addOrder(empty);
+        check(empty->price() == 0 && prod.cancels - cancels_before == 1 &&
+              !engine.hasOrder("EMP", "m4"), "반대편 없음 → IOC 취소");
+        check(engine.getCounters().market_orders_collared == 3, "collar 미적용");
+    }
+
+    // ── ⑥ collar 잔량은 지정가 — 재유입(스냅샷·복원 경로)에서 가격 밴드 검사를 받는다 ──
+    {
+        setenv("MARKET_COLLAR_PCT", "0.05", 1);
+        MockProducer prod;
+        MarketDataHandler handler(&prod);
+        EngineCore engine(&handler, nullptr);
+        engine.addOrder(mk("a1", "userA", "BND", false, 1000, 2));
+        auto mb = mkt("m1", "userB", "BND", true, 2000, 5);
+        engine.addOrder(mb);
+        check(mb->price() == 1050 && mb->filled_qty() == 2, "collar 1050, 2주 체결");
+        auto restored = Order::fromJson(mb->toJson());
+        check(restored->order_type() == "LIMIT" && restored->price() == 1050,
+              "스냅샷의 collar 잔량은 LIMIT 1050");
+
+        // 밴드 ±10% 엔진에서 직전 체결가 900 → 1050은 밴드(990) 밖
+        setenv("PRICE_BAND_PCT", "0.1", 1);
+        MockProducer prod2;
+        MarketDataHandler handler2(&prod2);
+        EngineCore engine2(&handler2, nullptr);
+        engine2.addOrder(mk("s1", "userC", "BND", false, 900, 1));
+        engine2.addOrder(mk("b1", "userD", "BND", true, 900, 1));
+        check(!engine2.addOrder(restored) && prod2.last_status["m1"] == "REJECTED",
+              "★ collar 잔량 재유입은 가격 밴드로 거부");
+        check(engine2.getCounters().price_band_rejects == 1, "밴드 거부 1건");
+        setenv("PRICE_BAND_PCT", "0", 1);
+    }
+
+    // ── ⑦ 비활성(0)이면 MARKET SELL이 매수호가 전 구간을 쓸고 잔량 취소 ──
+    {
+        setenv("MARKET_COLLAR_PCT", "0", 1);
+        MockProducer prod;
+        MarketDataHandler handler(&prod);
+        EngineCore engine(&handler, nullptr);
+        engine.addOrder(mk("b1", "userA", "OFF", true, 1000, 1));
+        engine.addOrder(mk("b2", "userB", "OFF", true, 500, 1));
+        auto ms = mkt("m1", "userC", "OFF", false, 0, 3);
+        engine.addOrder(ms);
+        check(ms->filled_qty() == 2 && prod.cancels == 1 && !engine.hasOrder("OFF", "m1"),
+              "비활성: 전 구간 체결 후 잔량 취소");
+        check(engine.getCounters().market_orders_collared == 0, "비활성: collar 없음");
+    }
+
+    std::cout << "=== " << (failures == 0 ? "ALL PASS" : std::to_string(failures) + " FAIL")
+              << " ===\n";
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,205 @@
+// 주문 단위(MBO) 피드 검증 — add/execute/cancel/replace 이벤트, 스톱은 발동 시 ADD, 종목별 연속 seq, 디코딩, 재생/스냅샷 복구, 링 가득 참 시 버림과 공백.
+#include "engine_core.h"
+#include "market_data_handler.h"
+#include "mbo_feed.h"
+#include "iproducer.h"
+#include "order.h"
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace aws_wrapper;
+
+struct MockProducer : public IProducer {
+    std::vector<std::string> mbo;
+    void publishFill(const std::string&, const std::string&, const std::string&,
+                     const std::string&, const std::string&, uint64_t, uint64_t,
+                     bool, bool, bool) override {}
+    void publishTrade(const std::string&, uint64_t, uint64_t) override {}
+    void publishDepth(const std::string&, const nlohmann::json&) override {}
+    void publishOrderStatus(const std::string&, const std::string&,
+                            const std::string&, const std::string&,
+                            const std::string&, uint64_t, uint64_t, bool,
+                            const std::string&) override {}
+    void publishMbo(const std::string&, const std::string& payload) override {
+        mbo.push_back(payload);
+    }
+    void flush(int) override {}
+};
+
+static OrderPtr mk(const std::string& id, const std::string& user, const std::string& sym,
+                   bool buy, uint64_t price, uint64_t qty) {
+    auto o = std::make_shared<Order>();
+    o->setOrderId(id); o->setUserId(user); o->setSymbol(sym);
+    o->setIsBuy(buy); o->setPrice(price); o->setOrderQty(qty); o->setOrderType("LIMIT");
+    return o;
+}
+
+static int failures = 0;
+static void check(bool c, const std::string& n) {
+    std::cout << (c ? "  PASS  " : "  FAIL  ") << n << "\n";
+    if (!c) ++failures;
+}
+
+// 발행된 배치를 모두 디코딩해 종목의 레코드를 순서대로 모은다
+static std::vector<MboFeed::Record> collect(const MockProducer& prod, const std::string& sym,
+                                            bool& ok) {
+    std::vector<MboFeed::Record> out;
+    ok = true;
+    for (const auto& payload : prod.mbo) {
+        MboFeed::Batch batch;
+        if (!MboFeed::decode(payload, batch)) { ok = false; continue; }
+        if (batch.symbol != sym) continue;
+        out.insert(out.end(), batch.records.begin(), batch.records.end());
+    }
+    return out;
+}
+
+int main() {
+    std::cout << "=== 주문 단위(MBO) 피드 검증 ===\n";
+
+    MockProducer prod;
+    MarketDataHandler handler(&prod);
+    MboFeed::Config config;
+    config.ring_capacity = 64;
+    config.history_per_symbol = 4;  // 이력 밀림 → 스냅샷 경로 검증용
+    MboFeed feed(&prod, config);
+    handler.setMboFeed(&feed);
+    EngineCore engine(&handler);
+
+    engine.addOrder(mk("s1", "userA", "AAA", false, 1000, 10));   // A
+    engine.addOrder(mk("s2", "userA", "AAA", false, 1001, 10));   // A
+    engine.addOrder(mk("b1", "userB", "AAA", true, 1000, 4));     // A, E(s1), E(b1)
+    engine.addOrder(mk("z1", "userC", "ZZZ", true, 500, 1));      // 다른 종목
+    check(engine.cancelOrder("AAA", "s2"), "s2 취소");             // X
+    check(engine.replaceOrder("AAA", "s1", 2, 999), "s1 정정(+2, 999)"); // R
+    feed.drain();
+
+    bool ok = false;
+    auto recs = collect(prod, "AAA", ok);
+    check(ok, "모든 배치 디코딩 성공");
+    check(recs.size() == 7, "AAA 이벤트 7건");
+    bool contiguous = true;
+    for (size_t i = 0; i < recs.size(); ++i) {
+        if (recs[i].seq != i + 1) contiguous = false;
+    }
+    check(contiguous, "종목별 seq 1부터 연속");
+
+    if (recs.size() == 7) {
+        check(recs[0].type == MboFeed::ADD && recs[0].order_id == "s1" && !recs[0].is_buy &&
+              recs[0].price == 1000 && recs[0].qty == 10, "A s1 SELL 1000x10");
+        check(recs[2].type == MboFeed::ADD && recs[2].order_id == "b1" && recs[2].is_buy,
+              "A b1 BUY");
+        check(recs[3].type == MboFeed::EXECUTE && recs[3].qty == 4 && recs[3].price == 1000 &&
+              recs[4].type == MboFeed::EXECUTE && recs[4].qty == 4,
+              "E 양측 4주 @1000");
+        check(recs[5].type == MboFeed::CANCEL && recs[5].order_id == "s2" && recs[5].qty == 10,
+              "X s2 잔량 10");
+        check(recs[6].type == MboFeed::REPLACE && recs[6].order_id == "s1" &&
+              recs[6].price == 999 && recs[6].qty == 8, "R s1 → 999x8 (잔량 6 + 2)");
+    }
+
+    auto zrecs = collect(prod, "ZZZ", ok);
+    check(zrecs.size() == 1 && zrecs[0].seq == 1, "ZZZ는 독립된 seq");
+
+    // 복구: 최신
+    std::string data;
+    MboFeed::Batch batch;
+    check(!feed.recover("NONE", 0, data), "없는 종목: false");
+    check(feed.recover("AAA", 7, data) && MboFeed::decode(data, batch) &&
+          batch.records.empty() && batch.last_seq == 7, "최신 소비자: 빈 배치");
+
+    // 복구: 이력 안(최근 4건 = seq 4~7)에서 재생
+    check(feed.recover("AAA", 5, data) && MboFeed::decode(data, batch) &&
+          !batch.is_snapshot && batch.records.size() == 2 &&
+          batch.records[0].seq == 6 && batch.records[1].seq == 7, "seq 5 이후 재생: 6, 7");
+
+    // 복구: 이력이 밀려남 → 스냅샷 (살아있는 주문 s1 999x8만)
+    check(feed.recover("AAA", 1, data) && MboFeed::decode(data, batch) &&
+          batch.is_snapshot && batch.last_seq == 7, "seq 1 이후: 스냅샷");
+    check(batch.records.size() == 1 && batch.records[0].order_id == "s1" &&
+          batch.records[0].price == 999 && batch.records[0].qty == 8,
+          "스냅샷: s1 999x8 (체결 b1·취소 s2 제외)");
+
+    // 깨진 입력
+    check(!MboFeed::decode(data.substr(0, data.size() - 1), batch), "잘린 배치: 디코딩 실패");
+
+    // 스톱: 발동 전에는 이벤트 없음, 발동 시 ADD가 그 체결보다 먼저
+    engine.addOrder(mk("p1", "userA", "STP", false, 1000, 1));    // 직전 체결가 1000
+    engine.addOrder(mk("p2", "userC", "STP", true, 1000, 1));
+    engine.addOrder(mk("t1", "userA", "STP", false, 1005, 1));
+    engine.addOrder(mk("t2", "userA", "STP", false, 1008, 5));
+    auto st1 = mk("st1", "userB", "STP", true, 1010, 3);
+    st1->setStopPrice(1005);
+    engine.addOrder(st1);                                          // 대기 (이벤트 없음)
+    auto st2 = mk("st2", "userD", "STP", false, 900, 2);
+    st2->setStopPrice(900);
+    engine.addOrder(st2);                                          // 대기 (이벤트 없음)
+    check(engine.cancelOrder("STP", "st2"), "발동 전 스톱 st2 취소");
+    engine.addOrder(mk("t3", "userC", "STP", true, 1005, 1));     // 1005 체결 → st1 발동
+    feed.drain();
+    auto srecs = collect(prod, "STP", ok);
+    bool no_st2 = true;
+    int st1_add = -1, st1_first_exec = -1;
+    for (size_t i = 0; i < srecs.size(); ++i) {
+        const auto& r = srecs[i];
+        no_st2 = no_st2 && r.order_id != "st2";
+        if (r.order_id != "st1") continue;
+        if (r.type == MboFeed::ADD && st1_add < 0) st1_add = static_cast<int>(i);
+        if (r.type == MboFeed::EXECUTE && st1_first_exec < 0) st1_first_exec = static_cast<int>(i);
+    }
+    check(no_st2, "발동 전 스톱의 접수·취소는 MBO에 나가지 않는다");
+    check(st1_add >= 0 && srecs[st1_add].price == 1010 && srecs[st1_add].qty == 3 &&
+          srecs[st1_add - 1].order_id == "t3", "st1 ADD 1010x3은 발동(t3 체결) 시점에");
+    check(st1_first_exec > st1_add, "st1 체결은 ADD 뒤에");
+    check(feed.recover("STP", 0, data) && MboFeed::decode(data, batch) && batch.is_snapshot &&
+          batch.records.size() == 1 && batch.records[0].order_id == "t2" &&
+          batch.records[0].qty == 2, "스냅샷: t2 1008x2만 (스톱 없음)");
+
+    // 링이 가득 차면 매칭 스레드는 기다리지 않고 버린다 → seq 공백, 공백 이전으로는 복구 불가
+    {
+        MockProducer gap_prod;
+        MboFeed::Config small;
+        small.ring_capacity = 4;
+        MboFeed gap_feed(&gap_prod, small);
+        std::vector<OrderPtr> orders;
+        for (int i = 0; i < 6; ++i) {
+            orders.push_back(mk("g" + std::to_string(i), "userA", "GAP", true, 100 + i, 1));
+            gap_feed.onAdd(*orders.back());
+        }
+        const uint64_t dropped = gap_feed.getDroppedEvents();
+        check(dropped > 0, "작은 링: 기다리지 않고 버림");
+        gap_feed.drain();
+        auto late = mk("g6", "userA", "GAP", true, 106, 1);
+        gap_feed.onAdd(*late);
+        gap_feed.drain();
+        auto grecs = collect(gap_prod, "GAP", ok);
+        check(grecs.size() == 7 - dropped && grecs.back().seq == 7, "버린 만큼 seq 공백");
+        check(!gap_feed.recover("GAP", 0, data), "공백 이전부터는 복구 불가");
+        check(gap_feed.recover("GAP", 6, data) && MboFeed::decode(data, batch) &&
+              !batch.is_snapshot && batch.records.size() == 1 && batch.records[0].seq == 7,
+              "공백 이후부터는 재생");
+
+        // 슬롯보다 긴 주문 ID는 잘라 싣지 않고 seq 없이 버린다
+        auto long_id = mk(std::string(MboFeed::MAX_ORDER_ID_LEN + 1, 'x'), "userA", "GAP",
+                          true, 107, 1);
+        gap_feed.onAdd(*long_id);
+        gap_feed.drain();
+        check(gap_feed.getOversizeDrops() == 1 &&
+              collect(gap_prod, "GAP", ok).size() == grecs.size(), "긴 주문 ID: 버리고 집계");
+    }
+
+    // 배치 스레드 경로
+    feed.start();
+    engine.addOrder(mk("s3", "userA", "AAA", false, 1010, 3));
+    feed.stop();
+    recs = collect(prod, "AAA", ok);
+    check(!recs.empty() && recs.back().order_id == "s3" && recs.back().seq == 8,
+          "배치 스레드 발행: s3 seq 8");
+
+    std::cout << "=== " << (failures == 0 ? "ALL PASS" : std::to_string(failures) + " FAIL")
+              << " ===\n";
+    return failures == 0 ? 0 : 1;
+}
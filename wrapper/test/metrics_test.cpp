@@ -0,0 +1,192 @@
+// 메트릭 서브시스템 검증 — 스트라이프 카운터, HDR 히스토그램 버킷/분위수,
+// Prometheus 텍스트 노출, /metrics HTTP 엔드포인트, 엔진 내부 카운터 노출.
+#include "metrics.h"
+#include "metrics_http.h"
+#include "engine_core.h"
+#include "market_data_handler.h"
+#include "iproducer.h"
+#include "order.h"
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace aws_wrapper;
+
+struct MockProducer : public IProducer {
+    void publishFill(const std::string&, const std::string&, const std::string&,
+                     const std::string&, const std::string&, uint64_t, uint64_t,
+                     bool, bool, bool) override {}
+    void publishTrade(const std::string&, uint64_t, uint64_t) override {}
+    void publishDepth(const std::string&, const nlohmann::json&) override {}
+    void publishOrderStatus(const std::string&, const std::string&,
+                            const std::string&, const std::string&,
+                            const std::string&, uint64_t, uint64_t, bool,
+                            const std::string&) override {}
+    void flush(int) override {}
+};
+
+static OrderPtr mk(const std::string& id, const std::string& user, bool buy,
+                   uint64_t price, uint64_t qty) {
+    auto o = std::make_shared<Order>();
+    o->setOrderId(id); o->setUserId(user); o->setSymbol("MET");
+    o->setIsBuy(buy); o->setPrice(price); o->setOrderQty(qty); o->setOrderType("LIMIT");
+    return o;
+}
+
+static int failures = 0;
+static void check(bool c, const std::string& n) {
+    std::cout << (c ? "  PASS  " : "  FAIL  ") << n << "\n";
+    if (!c) ++failures;
+}
+
+static bool contains(const std::string& s, const std::string& sub) {
+    return s.find(sub) != std::string::npos;
+}
+
+// 루프백으로 요청 한 번 보내고 응답 전체를 돌려준다
+static std::string httpGet(int port, const std::string& path) {
+    int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(static_cast<uint16_t>(port));
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) {
+        ::close(fd);
+        return "";
+    }
+    std::string req = "GET " + path + " HTTP/1.1\r\nHost: localhost\r\n\r\n";
+    ::send(fd, req.data(), req.size(), 0);
+    std::string resp;
+    char buf[4096];
+    ssize_t n;
+    while ((n = ::recv(fd, buf, sizeof(buf), 0)) > 0) resp.append(buf, static_cast<size_t>(n));
+    ::close(fd);
+    return resp;
+}
+
+int main() {
+    setenv("PRICE_BAND_PCT", "0", 1);
+    setenv("VI_DYNAMIC_PCT", "0", 1);
+    std::cout << "=== 메트릭 서브시스템 검증 ===\n";
+
+    // ── ① 히스토그램 버킷: 연속·단조, 상대 오차 ≤ 12.5% ──────────────────
+    {
+        bool contiguous = true;
+        for (size_t i = 0; i + 1 < LatencyHistogram::BUCKETS; ++i) {
+            contiguous = contiguous &&
+                LatencyHistogram::bucketUpper(i) + 1 == LatencyHistogram::bucketLower(i + 1);
+        }
+        check(contiguous, "버킷 경계가 빈틈없이 이어짐");
+
+        bool roundtrip = true, precise = true;
+        for (uint64_t v : {0ull, 1ull, 7ull, 8ull, 15ull, 16ull, 1000ull, 1023ull, 1024ull,
+                           123456789ull, 1ull << 40, ~0ull}) {
+            size_t b = LatencyHistogram::bucketOf(v);
+            roundtrip = roundtrip && LatencyHistogram::bucketLower(b) <= v &&
+                        v <= LatencyHistogram::bucketUpper(b);
+            if (v >= 8 && v < (1ull << 62)) {
+                uint64_t width = LatencyHistogram::bucketUpper(b) - LatencyHistogram::bucketLower(b) + 1;
+                precise = precise && width * 8 <= LatencyHistogram::bucketLower(b);
+            }
+        }
+        check(roundtrip, "값이 자기 버킷 [lower, upper] 안에 든다");
+        check(precise, "버킷 폭 ≤ 하한/8 (상대 오차 12.5%)");
+    }
+
+    // ── ② 분위수: 1~100000ns 균등 분포 ─────────────────────────────────
+    {
+        LatencyHistogram h;
+        for (uint64_t v = 1; v <= 100000; ++v) h.record(v);
+        check(h.count() == 100000 && h.maxNs() == 100000, "count / max");
+        check(h.sumNs() == 100000ull * 100001 / 2, "sum");
+        uint64_t p50 = h.percentile(0.5), p99 = h.percentile(0.99);
+        check(p50 >= 50000 && p50 <= 50000 * 9 / 8, "p50 ≈ 50µs (상한 보고, 오차 ≤ 12.5%)");
+        check(p99 >= 99000 && p99 <= 100000, "p99 ≈ 99µs (max로 제한)");
+        check(h.percentile(1.0) == 100000, "p100 == max");
+        check(h.countAtOrBelow(1023) == 1023, "≤1023ns 표본 수 정확");
+        LatencyHistogram empty;
+        check(empty.percentile(0.99) == 0, "빈 히스토그램 분위수 0");
+    }
+
+    // ── ③ 스트라이프 카운터: 여러 스레드 증가가 합산된다 ───────────────────
+    {
+        StripedCounter c;
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 8; ++t) {
+            threads.emplace_back([&c] { for (int i = 0; i < 100000; ++i) c.add(); });
+        }
+        for (auto& t : threads) t.join();
+        check(c.load() == 800000, "8스레드 × 100000 = 800000");
+    }
+
+    // ── ④ 엔진 연동: 체결 카운트, 엔진 내부 카운터 ──────────────────────
+    MockProducer p;
+    MarketDataHandler h(&p);
+    EngineCore e(&h);
+    uint64_t trades_before = Metrics::instance().getTradesExecuted();
+    e.addOrder(mk("s1", "userA", false, 100, 10));
+    e.addOrder(mk("b1", "userB", true, 100, 4));
+    check(!e.addOrder(mk("b1", "userB", true, 100, 4)), "중복 주문 거부");
+    check(Metrics::instance().getTradesExecuted() == trades_before + 1,
+          "★ trades_executed가 체결마다 증가");
+    auto c = e.getCounters();
+    check(c.trades_executed == 1 && c.duplicates_rejected == 1 && c.symbols == 1 &&
+          c.resting_orders == 1, "엔진 카운터 스냅샷 (체결 1, 중복 1, 종목 1, 잔존 1)");
+
+    Metrics::instance().matchLatency().record(2500);
+    Metrics::instance().addCollector([&e](std::string& out) {
+        Metrics::writeCounter(out, "engine_duplicates_rejected_total", "dedup",
+                              e.getCounters().duplicates_rejected);
+    });
+
+    // ── ⑤ Prometheus 텍스트 ─────────────────────────────────────────────
+    {
+        std::string text = Metrics::instance().renderPrometheus();
+        check(contains(text, "# TYPE engine_trades_executed_total counter\n"), "counter TYPE 줄");
+        check(contains(text, "# TYPE engine_match_latency_seconds histogram\n"), "histogram TYPE 줄");
+        check(contains(text, "engine_match_latency_seconds_bucket{le=\"+Inf\"} "), "+Inf 버킷");
+        check(contains(text, "engine_match_latency_quantile_seconds{quantile=\"0.99\"} "),
+              "분위수 gauge");
+        check(contains(text, "engine_duplicates_rejected_total 1\n"), "★ 컬렉터로 엔진 카운터 노출");
+
+        // 누적 버킷은 단조 증가
+        bool monotonic = true;
+        uint64_t prev = 0;
+        size_t pos = 0;
+        const std::string key = "engine_match_latency_seconds_bucket{";
+        while ((pos = text.find(key, pos)) != std::string::npos) {
+            size_t sp = text.find("} ", pos);
+            uint64_t v = std::stoull(text.substr(sp + 2, text.find('\n', sp) - sp - 2));
+            monotonic = monotonic && v >= prev;
+            prev = v;
+            pos = sp;
+        }
+        check(monotonic && prev >= 1, "누적 버킷 단조 증가");
+    }
+
+    // ── ⑥ HTTP 엔드포인트 ────────────────────────────────────────────────
+    {
+        MetricsHttpServer server(0, [] { return Metrics::instance().renderPrometheus(); });
+        check(server.start(), "임의 포트 바인드");
+        std::string resp = httpGet(server.port(), "/metrics");
+        check(resp.rfind("HTTP/1.0 200 OK", 0) == 0, "/metrics 200");
+        check(contains(resp, "Content-Type: text/plain; version=0.0.4"), "Prometheus content type");
+        check(contains(resp, "engine_orders_received_total"), "본문에 메트릭");
+        check(httpGet(server.port(), "/healthz").rfind("HTTP/1.0 200 OK", 0) == 0, "/healthz 200");
+        check(httpGet(server.port(), "/nope").rfind("HTTP/1.0 404", 0) == 0, "알 수 없는 경로 404");
+        check(server.getRequestCount() == 3, "요청 수 집계");
+        server.stop();
+        check(httpGet(server.port(), "/metrics").empty(), "stop 후 연결 거부");
+    }
+
+    std::cout << "=== " << (failures == 0 ? "ALL PASS" : std::to_string(failures) + " FAIL")
+              << " ===\n";
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,146 @@
+// 유입 제한 검증 — 유저별·종목별 토큰 버킷, 거부/지연 정책, REJECTED 일괄 발행, 처리량 카운터.
+#include "order_throttle.h"
+#include "iproducer.h"
+#include "order.h"
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <string>
+
+using namespace aws_wrapper;
+
+struct MockProducer : public IProducer {
+    int rejects = 0;
+    int replace_rejects = 0;
+    std::string last_replace_reject_id;
+    void publishFill(const std::string&, const std::string&, const std::string&,
+                     const std::string&, const std::string&, uint64_t, uint64_t,
+                     bool, bool, bool) override {}
+    void publishTrade(const std::string&, uint64_t, uint64_t) override {}
+    void publishDepth(const std::string&, const nlohmann::json&) override {}
+    void publishOrderStatus(const std::string&, const std::string& order_id,
+                            const std::string&, const std::string& status,
+                            const std::string&, uint64_t, uint64_t, bool,
+                            const std::string&) override {
+        if (status == "REJECTED") ++rejects;
+        if (status == "REPLACE_REJECTED") {
+            ++replace_rejects;
+            last_replace_reject_id = order_id;
+        }
+    }
+    void flush(int) override {}
+};
+
+static OrderPtr mk(const std::string& id, const std::string& user, const std::string& sym,
+                   uint64_t qty = 1) {
+    auto o = std::make_shared<Order>();
+    o->setOrderId(id); o->setUserId(user); o->setSymbol(sym);
+    o->setIsBuy(true); o->setPrice(1000); o->setOrderQty(qty); o->setOrderType("LIMIT");
+    return o;
+}
+
+static int failures = 0;
+static void check(bool c, const std::string& n) {
+    std::cout << (c ? "  PASS  " : "  FAIL  ") << n << "\n";
+    if (!c) ++failures;
+}
+
+int main() {
+    std::cout << "=== 유입 제한 검증 ===\n";
+
+    // ── ① 비활성: 전부 통과 ──
+    {
+        MockProducer prod;
+        OrderThrottle throttle(&prod);
+        check(!throttle.enabled(), "설정 없으면 비활성");
+        bool all = true;
+        for (int i = 0; i < 1000; ++i) all = all && throttle.admit(mk("o", "u", "S")).admitted;
+        check(all && throttle.throttledOrders() == 0, "비활성: 전부 통과");
+    }
+
+    // ── ② 유저 버킷, 거부 정책: 초당 10건, 버스트 2 ──
+    setenv("THROTTLE_USER_RATE", "10", 1);
+    setenv("THROTTLE_USER_BURST", "2", 1);
+    setenv("THROTTLE_REJECT_BATCH", "3", 1);
+    {
+        SimulatedClock clock(1700000000000);
+        MockProducer prod;
+        OrderThrottle throttle(&prod, &clock);
+        check(throttle.enabled() && throttle.policy() == OrderThrottle::Policy::REJECT,
+              "유저 10/s, 거부 정책");
+        check(throttle.admit(mk("a1", "userA", "AAA")).admitted &&
+              throttle.admit(mk("a2", "userA", "BBB")).admitted, "버스트 2건 통과");
+        check(!throttle.admit(mk("a3", "userA", "AAA", 7)).admitted, "3번째 거부");
+        check(throttle.admit(mk("b1", "userB", "AAA")).admitted, "다른 유저는 영향 없음");
+        check(prod.rejects == 0, "REJECTED는 바로 발행하지 않고 모은다");
+        check(throttle.throttledOrders() == 1 && throttle.throttledQty() == 7, "제한 1건, 수량 7");
+
+        // 배치(3건)가 차면 한 번에 발행
+        throttle.admit(mk("a4", "userA", "AAA"));
+        throttle.admit(mk("a5", "userA", "AAA"));
+        check(prod.rejects == 3, "배치가 차면 3건 일괄 발행");
+        throttle.admit(mk("a6", "userA", "AAA"));
+        check(throttle.flushRejected() == 1 && prod.rejects == 4, "남은 1건은 flush로 발행");
+
+        // 100ms 뒤 토큰 1개 보충
+        clock.advance(std::chrono::milliseconds(100));
+        check(throttle.admit(mk("a7", "userA", "AAA")).admitted, "100ms 뒤 1건 통과");
+        check(!throttle.admit(mk("a8", "userA", "AAA")).admitted, "그다음은 다시 거부");
+
+        // 테이블 확장: 유저 수천 명도 각자 버킷
+        bool all = true;
+        for (int i = 0; i < 5000; ++i) {
+            all = all && throttle.admit(mk("m", "user" + std::to_string(i), "AAA")).admitted;
+        }
+        check(all, "5000명 각자 첫 주문 통과 (테이블 확장)");
+        throttle.flushRejected();
+    }
+
+    // ── ③ 지연 정책: 토큰을 빌려 예약하고 기다린다, 한도를 넘으면 거부 ──
+    setenv("THROTTLE_USER_BURST", "1", 1);
+    setenv("THROTTLE_POLICY", "delay", 1);
+    setenv("THROTTLE_MAX_DELAY_MS", "150", 1);
+    {
+        SimulatedClock clock(1700000000000);
+        MockProducer prod;
+        OrderThrottle throttle(&prod, &clock);
+        auto v1 = throttle.admit(mk("d1", "userA", "AAA"));
+        auto v2 = throttle.admit(mk("d2", "userA", "AAA"));
+        auto v3 = throttle.admit(mk("d3", "userA", "AAA"));
+        auto v4 = throttle.admit(mk("d4", "userA", "AAA"));
+        check(v1.admitted && v1.delay.count() == 0, "첫 주문 즉시");
+        check(v2.admitted && v2.delay == std::chrono::milliseconds(100), "두 번째 100ms 지연");
+        check(!v3.admitted && !v4.admitted, "한도(150ms) 넘는 지연은 거부");
+        check(throttle.delayedOrders() == 1 && throttle.throttledOrders() == 2, "지연 1건, 거부 2건");
+        clock.advance(std::chrono::milliseconds(200));
+        auto v5 = throttle.admit(mk("d5", "userA", "AAA"));
+        check(v5.admitted && v5.delay.count() == 0, "예약한 토큰을 갚은 뒤 즉시 통과");
+    }
+    unsetenv("THROTTLE_POLICY");
+    unsetenv("THROTTLE_USER_RATE");
+    unsetenv("THROTTLE_USER_BURST");
+
+    // ── ④ 종목 버킷: 유저가 달라도 같은 종목이면 함께 제한 ──
+    setenv("THROTTLE_SYMBOL_RATE", "1", 1);
+    {
+        SimulatedClock clock(1700000000000);
+        MockProducer prod;
+        OrderThrottle throttle(&prod, &clock);
+        check(throttle.admit(mk("s1", "userA", "HOT")).admitted, "HOT 첫 주문 통과");
+        check(!throttle.admit(mk("s2", "userB", "HOT")).admitted, "다른 유저라도 HOT은 제한");
+        check(throttle.admit(mk("s3", "userB", "COLD")).admitted, "다른 종목은 통과");
+        throttle.flushRejected();
+        check(prod.rejects == 1, "거부 1건 발행");
+
+        // 정정이 제한되면 원 주문은 살아 있으므로 REJECTED가 아니라 REPLACE_REJECTED
+        check(!throttle.admit(mk("s1", "userA", "HOT"), true).admitted, "HOT 정정도 제한");
+        throttle.flushRejected();
+        check(prod.rejects == 1 && prod.replace_rejects == 1 &&
+              prod.last_replace_reject_id == "s1", "제한된 정정은 REPLACE_REJECTED로 발행");
+    }
+    unsetenv("THROTTLE_SYMBOL_RATE");
+
+    std::cout << "=== " << (failures == 0 ? "ALL PASS" : std::to_string(failures) + " FAIL")
+              << " ===\n";
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,147 @@
+// 주문 전 리스크 검증 — 유저별 미체결 주문 수·명목금액·주문 수량 한도가 접수·체결·취소·정정에
+// 따라 증감하고, 종목별로 덮어쓸 수 있으며, 복원 후에도 노출이 유지된다.
+#include "engine_core.h"
+#include "market_data_handler.h"
+#include "iproducer.h"
+#include "order.h"
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <string>
+
+using namespace aws_wrapper;
+
+struct MockProducer : public IProducer {
+    int rejects = 0;
+    int replace_rejects = 0;
+    std::string last_reason;
+    void publishFill(const std::string&, const std::string&, const std::string&,
+                     const std::string&, const std::string&, uint64_t, uint64_t,
+                     bool, bool, bool) override {}
+    void publishTrade(const std::string&, uint64_t, uint64_t) override {}
+    void publishDepth(const std::string&, const nlohmann::json&) override {}
+    void publishOrderStatus(const std::string&, const std::string&,
+                            const std::string&, const std::string& status,
+                            const std::string& reason, uint64_t, uint64_t, bool,
+                            const std::string&) override {
+        if (status == "REJECTED") { ++rejects; last_reason = reason; }
+        if (status == "REPLACE_REJECTED") ++replace_rejects;
+    }
+    void flush(int) override {}
+};
+
+static OrderPtr mk(const std::string& id, const std::string& user, const std::string& sym,
+                   bool buy, uint64_t price, uint64_t qty) {
+    auto o = std::make_shared<Order>();
+    o->setOrderId(id); o->setUserId(user); o->setSymbol(sym);
+    o->setIsBuy(buy); o->setPrice(price); o->setOrderQty(qty); o->setOrderType("LIMIT");
+    return o;
+}
+
+// 라우터가 만드는 시장가: 항상 IOC, BUY는 price=max_price, SELL은 price=0
+static OrderPtr mkt(const std::string& id, const std::string& user, const std::string& sym,
+                    bool buy, uint64_t max_price, uint64_t qty) {
+    auto o = mk(id, user, sym, buy, buy ? max_price : 0, qty);
+    o->setOrderType("MARKET");
+    o->setConditions(liquibook::book::oc_immediate_or_cancel);
+    return o;
+}
+
+static int failures = 0;
+static void check(bool c, const std::string& n) {
+    std::cout << (c ? "  PASS  " : "  FAIL  ") << n << "\n";
+    if (!c) ++failures;
+}
+
+int main() {
+    std::cout << "=== 주문 전 리스크 검증 ===\n";
+    setenv("PRICE_BAND_PCT", "0", 1);
+    setenv("VI_DYNAMIC_PCT", "0", 1);
+    setenv("OPENING_AUCTION_SECONDS", "0", 1);
+    setenv("RISK_MAX_OPEN_ORDERS", "3", 1);
+    setenv("RISK_MAX_OPEN_NOTIONAL", "10000", 1);
+    setenv("RISK_MAX_ORDER_QTY", "50", 1);
+    setenv("RISK_SYMBOL_LIMITS", "BIG:0:0:0", 1);
+    setenv("MARKET_COLLAR_PCT", "0.05", 1);
+
+    MockProducer prod;
+    MarketDataHandler handler(&prod);
+    EngineCore engine(&handler);
+    const PreTradeRisk& risk = engine.risk();
+    check(risk.enabled(), "한도 설정 → 활성");
+
+    // ── ① 주문 1건 수량 한도 ──
+    check(!engine.addOrder(mk("q1", "userA", "AAA", true, 100, 60)), "수량 60 > 50 거부");
+    check(prod.rejects == 1 && prod.last_reason == "Order quantity exceeds risk limit",
+          "REJECTED 사유 발행");
+    check(risk.openOrders("AAA", "userA") == 0, "거부된 주문은 노출 없음");
+
+    // ── ② 미체결 주문 수 한도 ──
+    auto a1 = mk("a1", "userA", "AAA", true, 100, 10);
+    auto a2 = mk("a2", "userA", "AAA", true, 100, 10);
+    auto a3 = mk("a3", "userA", "AAA", true, 99, 10);
+    check(engine.addOrder(a1) && engine.addOrder(a2) && engine.addOrder(a3), "3건 접수");
+    check(risk.openOrders("AAA", "userA") == 3 && risk.openNotional("AAA", "userA") == 2990,
+          "미체결 3건, 명목 2990");
+    check(!engine.addOrder(mk("a4", "userA", "AAA", true, 98, 1)), "4번째 거부");
+    check(engine.addOrder(mk("b1", "userB", "AAA", true, 98, 1)), "다른 유저는 별도 한도");
+
+    // ── ③ 취소하면 한도가 풀린다 ──
+    engine.cancelOrder("AAA", "a3");
+    check(risk.openOrders("AAA", "userA") == 2 && risk.openNotional("AAA", "userA") == 2000,
+          "취소 → 2건, 명목 2000");
+
+    // ── ④ 체결: 전량 체결은 주문 수에서 빠지고, 부분 체결은 잔량만큼 명목이 준다 ──
+    engine.addOrder(mk("s1", "userC", "AAA", false, 100, 15));
+    check(a1->filled_qty() == 10 && a2->filled_qty() == 5, "a1 전량, a2 5 체결");
+    check(risk.openOrders("AAA", "userA") == 1 && risk.openNotional("AAA", "userA") == 500,
+          "체결 → 1건, 명목 500");
+    check(risk.openOrders("AAA", "userC") == 0 && risk.openNotional("AAA", "userC") == 0,
+          "전량 체결한 aggressor는 노출 없음");
+
+    // ── ⑤ 명목금액 한도 (같은 금액까지는 허용) ──
+    check(!engine.addOrder(mk("n1", "userD", "AAA", false, 1000, 11)), "명목 11000 거부");
+    check(prod.last_reason == "Open notional risk limit exceeded", "명목 한도 사유");
+    auto n2 = mk("n2", "userD", "AAA", false, 1000, 10);
+    check(engine.addOrder(n2) && risk.openNotional("AAA", "userD") == 10000, "명목 10000 접수");
+
+    // ── ⑥ 정정: 늘어나는 노출은 검사, 줄어드는 정정은 반영 ──
+    check(!engine.replaceOrder("AAA", "n2", 1, 0), "수량 +1 정정 거부");
+    check(prod.replace_rejects == 1 && n2->order_qty() == 10, "REPLACE_REJECTED, 수량 유지");
+    check(engine.replaceOrder("AAA", "n2", 0, 900) && risk.openNotional("AAA", "userD") == 9000,
+          "가격 900 정정 → 명목 9000");
+    check(engine.replaceOrder("AAA", "n2", 1, 0) && risk.openNotional("AAA", "userD") == 9900,
+          "이제 수량 +1 정정 가능 → 9900");
+
+    // ── ⑦ 종목별 덮어쓰기: BIG은 무제한 ──
+    check(engine.addOrder(mk("big", "userA", "BIG", true, 1000, 1000)), "BIG은 한도 없음");
+
+    // ── ⑧ 복원해도 노출이 유지된다 ──
+    const uint32_t before_orders = risk.openOrders("AAA", "userA");
+    const uint64_t before_notional = risk.openNotional("AAA", "userD");
+    check(engine.restoreOrderBook("AAA", engine.snapshotOrderBook("AAA")), "AAA 복원");
+    check(risk.openOrders("AAA", "userA") == before_orders &&
+          risk.openNotional("AAA", "userD") == before_notional, "복원 후 노출 동일");
+    engine.cancelOrder("AAA", "n2");
+    check(risk.openOrders("AAA", "userD") == 0 && risk.openNotional("AAA", "userD") == 0,
+          "복원된 주문 취소 → 노출 해제");
+
+    // ── ⑨ 시장가 매수: price(지불 상한)가 아니라 반대편 최우선호가·collar 가격으로 명목 ──
+    engine.addOrder(mk("ms1", "userE", "MKT", false, 100, 10));
+    auto mb1 = mkt("mb1", "userF", "MKT", true, 100000, 5);
+    check(engine.addOrder(mb1) && mb1->filled_qty() == 5,
+          "상한 100000 x 5 시장가 매수 통과 (최우선 매도 100 기준)");
+    auto mb2 = mkt("mb2", "userF", "MKT", true, 100000, 10);
+    check(engine.addOrder(mb2) && mb2->price() == 105 && mb2->filled_qty() == 5,
+          "collar 105까지 5 체결, 잔량 잔류");
+    check(risk.openOrders("MKT", "userF") == 1 && risk.openNotional("MKT", "userF") == 525,
+          "잔량 명목 = collar 가격 105 x 5");
+    engine.cancelOrder("MKT", "mb2");
+    check(risk.openNotional("MKT", "userF") == 0, "취소 → 명목 해제");
+
+    check(engine.getCounters().risk_rejects == 4, "리스크 거부 4건 (주문 3, 정정 1)");
+
+    std::cout << "=== " << (failures == 0 ? "ALL PASS" : std::to_string(failures) + " FAIL")
+              << " ===\n";
+    return failures == 0 ? 0 : 1;
+}
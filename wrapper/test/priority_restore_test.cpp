@@ -0,0 +1,132 @@
+// 시간 우선순위 보존 복원 검증 — 스냅샷이 가격 단계별 대기열 순서(queue_seq)를 싣고,
+// 복원이 그 순서 그대로 대기열을 다시 쌓는지. 세션을 캡처해 스냅샷 시점부터
+// (a) 원래 엔진에서 계속 진행한 체결과 (b) 복원한 엔진에 같은 입력을 재생한 체결을
+// 바이트 단위로 비교한다.
+#include "engine_core.h"
+#include "engine_clock.h"
+#include "market_data_handler.h"
+#include "iproducer.h"
+#include "order.h"
+#include <nlohmann/json.hpp>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace aws_wrapper;
+
+// 체결 이벤트를 인자 그대로 한 줄씩 기록
+struct MockProducer : public IProducer {
+    std::string fills;
+    void publishFill(const std::string& symbol, const std::string& buy_order,
+                     const std::string& sell_order, const std::string& buyer,
+                     const std::string& seller, uint64_t qty, uint64_t price,
+                     bool buyer_filled, bool seller_filled, bool buyer_is_maker) override {
+        fills += symbol + "|" + buy_order + "|" + sell_order + "|" + buyer + "|" + seller + "|" +
+                 std::to_string(qty) + "@" + std::to_string(price) + "|" +
+                 (buyer_filled ? "1" : "0") + (seller_filled ? "1" : "0") +
+                 (buyer_is_maker ? "M" : "T") + "\n";
+    }
+    void publishTrade(const std::string&, uint64_t, uint64_t) override {}
+    void publishDepth(const std::string&, const nlohmann::json&) override {}
+    void publishOrderStatus(const std::string&, const std::string&,
+                            const std::string&, const std::string&,
+                            const std::string&, uint64_t, uint64_t, bool,
+                            const std::string&) override {}
+    void flush(int) override {}
+};
+
+static OrderPtr mk(const std::string& id, const std::string& u, bool buy,
+                   uint64_t px, uint64_t q, int64_t ts) {
+    auto o = std::make_shared<Order>();
+    o->setOrderId(id); o->setUserId(u); o->setSymbol("PRI");
+    o->setIsBuy(buy); o->setPrice(px); o->setOrderQty(q); o->setOrderType("LIMIT");
+    o->setTimestamp(ts);
+    return o;
+}
+
+static int failures = 0;
+static void check(bool c, const std::string& n) {
+    std::cout << (c ? "  PASS  " : "  FAIL  ") << n << "\n";
+    if (!c) ++failures;
+}
+
+// 스냅샷 이전 구간: order_id 사전순과 도착 순서가 다르게 쌓는다
+static void buildSession(EngineCore& e) {
+    e.addOrder(mk("z-first", "userA", false, 100, 10, 1000));
+    e.addOrder(mk("a-second", "userB", false, 100, 10, 1001));
+    e.addOrder(mk("m-third", "userC", false, 100, 5, 1002));
+    e.addOrder(mk("k-move", "userD", false, 101, 10, 1003));
+    e.addOrder(mk("y-bid", "userE", true, 99, 10, 1004));
+    e.addOrder(mk("b-bid", "userF", true, 99, 10, 1005));
+    e.addOrder(mk("p1", "userG", true, 100, 3, 1006));               // z-first 부분체결(잔량 7)
+    // liquibook은 정정 시 주문을 다시 넣으므로 감량·가격 정정 모두 대기열 맨 뒤로 간다
+    e.replaceOrder("PRI", "a-second", -2, liquibook::book::PRICE_UNCHANGED);
+    e.replaceOrder("PRI", "k-move", 0, 100);
+}
+
+// 스냅샷 이후 구간 (재생 대상 입력)
+static void replayTail(EngineCore& e) {
+    e.addOrder(mk("t1", "userH", true, 100, 12, 2000));
+    e.addOrder(mk("t2", "userI", false, 99, 15, 2001));
+    e.addOrder(mk("t3", "userJ", true, 100, 20, 2002));
+    e.addOrder(mk("t4", "userK", false, 98, 10, 2003));
+}
+
+int main() {
+    setenv("PRICE_BAND_PCT", "0", 1);
+    setenv("VI_DYNAMIC_PCT", "0", 1);
+    std::cout << "=== 시간 우선순위 보존 복원 검증 ===\n";
+
+    InputClock clock_live;
+    MockProducer live;
+    MarketDataHandler h1(&live);
+    EngineCore e1(&h1, nullptr, &clock_live);
+    buildSession(e1);
+    const std::string snap = e1.snapshotOrderBook("PRI");
+    live.fills.clear();
+    replayTail(e1);
+
+    // 스냅샷은 북 우선순위 순서로 queue_seq를 싣는다
+    auto j = nlohmann::json::parse(snap);
+    std::vector<std::string> ids;
+    bool seq_ok = true;
+    uint64_t expect = 0;
+    for (const auto& o : j["orders"]) {
+        ids.push_back(o["order_id"].get<std::string>());
+        seq_ok = seq_ok && o.value("queue_seq", uint64_t(0)) == ++expect;
+    }
+    check(seq_ok, "queue_seq가 1부터 연속");
+    check(ids.size() == 6 && ids[0] == "y-bid" && ids[1] == "b-bid" &&
+          ids[2] == "z-first" && ids[3] == "m-third" && ids[4] == "a-second" &&
+          ids[5] == "k-move",
+          "★ 스냅샷 주문 순서 = 대기열 순서(도착순, 정정분은 맨 뒤)");
+
+    InputClock clock_restored;
+    MockProducer restored;
+    MarketDataHandler h2(&restored);
+    EngineCore e2(&h2, nullptr, &clock_restored);
+    check(e2.restoreOrderBook("PRI", snap), "스냅샷 복원");
+    replayTail(e2);
+
+    check(!live.fills.empty(), "재생 구간에서 체결 발생");
+    check(live.fills.rfind("PRI|t1|z-first|", 0) == 0, "첫 체결은 대기열 선두(z-first)");
+    check(restored.fills == live.fills, "★ 복원 후 재생 체결 == 원래 세션 체결 (바이트 단위)");
+    if (restored.fills != live.fills) {
+        std::cout << "--- live ---\n" << live.fills << "--- restored ---\n" << restored.fills;
+    }
+
+    // 구 스냅샷(queue_seq 없음)은 접수 시각 순으로 대기열을 세운다
+    for (auto& o : j["orders"]) o.erase("queue_seq");
+    MockProducer legacy;
+    MarketDataHandler h3(&legacy);
+    EngineCore e3(&h3);
+    check(e3.restoreOrderBook("PRI", j.dump()), "구 스냅샷 복원");
+    e3.addOrder(mk("t1", "userH", true, 100, 12, 2000));
+    check(legacy.fills.rfind("PRI|t1|z-first|", 0) == 0, "구 스냅샷도 접수 시각 순(z-first 선두)");
+
+    std::cout << "=== " << (failures == 0 ? "ALL PASS" : std::to_string(failures) + " FAIL")
+              << " ===\n";
+    return failures == 0 ? 0 : 1;
+}
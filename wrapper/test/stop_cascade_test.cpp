@@ -0,0 +1,95 @@
+// 스톱 연쇄 상한 검증 — STOP_CASCADE_LIMIT를 넘는 스톱은 발동 순서대로 대기했다가
+// 그 종목의 다음 주문 앞에 제출된다. 대기 중인 스톱도 스냅샷에 실린다.
+#include "engine_core.h"
+#include "market_data_handler.h"
+#include "iproducer.h"
+#include "order.h"
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <string>
+
+using namespace aws_wrapper;
+
+struct MockProducer : public IProducer {
+    int fills = 0;
+    void publishFill(const std::string&, const std::string&, const std::string&,
+                     const std::string&, const std::string&, uint64_t, uint64_t,
+                     bool, bool, bool) override { ++fills; }
+    void publishTrade(const std::string&, uint64_t, uint64_t) override {}
+    void publishDepth(const std::string&, const nlohmann::json&) override {}
+    void publishOrderStatus(const std::string&, const std::string&,
+                            const std::string&, const std::string&,
+                            const std::string&, uint64_t, uint64_t, bool,
+                            const std::string&) override {}
+    void flush(int) override {}
+};
+
+static OrderPtr mk(const std::string& id, const std::string& user, bool buy,
+                   uint64_t price, uint64_t qty, uint64_t stop = 0) {
+    auto o = std::make_shared<Order>();
+    o->setOrderId(id); o->setUserId(user); o->setSymbol("AAA");
+    o->setIsBuy(buy); o->setPrice(price); o->setOrderQty(qty);
+    o->setOrderType(price == 0 ? "MARKET" : "LIMIT");
+    o->setStopPrice(stop);
+    return o;
+}
+
+static int failures = 0;
+static void check(bool c, const std::string& n) {
+    std::cout << (c ? "  PASS  " : "  FAIL  ") << n << "\n";
+    if (!c) ++failures;
+}
+
+int main() {
+    std::cout << "=== 스톱 연쇄 상한 검증 ===\n";
+    setenv("PRICE_BAND_PCT", "0", 1);
+    setenv("VI_DYNAMIC_PCT", "0", 1);
+    setenv("STOP_CASCADE_LIMIT", "1", 1);
+
+    MockProducer prod;
+    MarketDataHandler handler(&prod);
+    EngineCore engine(&handler);
+
+    // 직전 체결가 1000 확보 + 매도 1010 x1, 1020 x1
+    engine.addOrder(mk("p1", "userX", true, 1000, 1));
+    engine.addOrder(mk("p2", "userY", false, 1000, 1));
+    engine.addOrder(mk("a1", "userA", false, 1010, 1));
+    engine.addOrder(mk("a2", "userA", false, 1020, 1));
+
+    // 스톱 시장가 매수: 1005 도달 → s1이 1010에 체결 → 1010 도달 → s2 발동
+    auto s1 = mk("s1", "userB", true, 0, 1, 1005);
+    auto s2 = mk("s2", "userB", true, 0, 1, 1010);
+    engine.addOrder(s1);
+    engine.addOrder(s2);
+    check(engine.getCounters().stops_triggered == 0, "체결가 1000: 스톱 미발동");
+
+    // ── ① 1005 체결 한 번: 상한 1이라 s1만 제출, s2는 대기 ──
+    engine.addOrder(mk("t1", "userC", true, 1005, 1));
+    engine.addOrder(mk("t2", "userD", false, 1005, 1));
+    {
+        auto c = engine.getCounters();
+        check(s1->filled_qty() == 1, "s1 체결 (1010)");
+        check(s2->filled_qty() == 0, "s2 대기 (미제출)");
+        check(c.stops_triggered == 1, "제출된 스톱 1건");
+        check(c.stop_cascades_capped == 1, "상한에 걸린 연쇄 1회");
+        check(engine.snapshotOrderBook("AAA").find("\"s2\"") != std::string::npos,
+              "대기 중인 s2가 스냅샷에 포함");
+    }
+
+    // ── ② 다음 명령: s2가 먼저 제출되어 1020에 체결 ──
+    engine.addOrder(mk("b1", "userE", true, 900, 1));
+    {
+        auto c = engine.getCounters();
+        check(s2->filled_qty() == 1, "s2 체결 (1020)");
+        check(c.stops_triggered == 2, "제출된 스톱 누적 2건");
+        check(c.stop_cascades_capped == 1, "추가 상한 없음");
+        DepthView view;
+        engine.getDepth("AAA", 5, view);
+        check(view.asks.empty(), "매도 호가 소진");
+    }
+
+    std::cout << "=== " << (failures == 0 ? "ALL PASS" : std::to_string(failures) + " FAIL")
+              << " ===\n";
+    return failures == 0 ? 0 : 1;
+}